@@ -0,0 +1,21 @@
+#!/bin/sh
+# compares the timings of the regression tests of vsprintf_bench.c with bench_baseline.json
+# usage: ./bench_regression.sh [--update] [options of vsprintf_bench.c like --tolerance 30 or --repeat 51]
+BASELINE=bench_baseline.json
+UPDATE=
+if [ "$1" = "--update" ]; then
+   UPDATE=1
+   shift
+fi
+rm -f ./_vsprintf_bench
+cc -Wall -O3 $CFLAGS -o _vsprintf_bench -I . vsprintf_bench.c sfprintf.c callback_printf.c cbk_formats.c cbk_record.c -lpthread || exit $?
+if [ -n "$UPDATE" ]; then
+   OLD=
+   [ -f $BASELINE ] && OLD="--baseline $BASELINE"
+   ./_vsprintf_bench --json $OLD --write-baseline _bench_baseline.json "$@" > _bench_results.json || exit $?
+   mv _bench_baseline.json $BASELINE
+   echo "$BASELINE updated"
+   exit 0
+fi
+./_vsprintf_bench --json --baseline $BASELINE "$@" > _bench_results.json
+exit $?
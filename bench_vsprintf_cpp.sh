@@ -0,0 +1,7 @@
+#!/bin/sh
+rm -f ./_vsprintf_bench_cpp
+cc -Wall -O3 -c -o _callback_printf.o -I . callback_printf.c
+c++ -std=c++20 -Wall -O3 -o _vsprintf_bench_cpp -I . vsprintf_bench_cpp.cpp _callback_printf.o
+rm -f _callback_printf.o
+./_vsprintf_bench_cpp "$@"
+exit $?
@@ -121,9 +121,15 @@
 #include <errno.h>
 #include <limits.h>
 #include <float.h> /* LDBL_MAX */
+#include <stdlib.h> /* malloc */
 
 #include <callback_printf.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PRINTF_SSE2 1
+#endif
+
 #ifdef _WIN32
 #pragma warning(disable : 4100 4127 4706 4710)
 
@@ -134,6 +140,46 @@
 
 #endif
 
+/* va_list is an array on some ABIs and an argument of %@ is passed as pointer to its first element then */
+#if !defined(PRINTF_VA_LIST_IS_ARRAY)
+#if !defined(_WIN32) && (defined(__x86_64__) || defined(__s390__) || (defined(__powerpc__) && !defined(__powerpc64__)))
+#define PRINTF_VA_LIST_IS_ARRAY 1
+#else
+#define PRINTF_VA_LIST_IS_ARRAY 0
+#endif
+#endif
+
+/* thread local profiling counters if CALLBACK_PRINTF_PROFILE is defined */
+#ifdef CALLBACK_PRINTF_PROFILE
+
+#if defined(_MSC_VER)
+#define PRINTF_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define PRINTF_THREAD_LOCAL __thread
+#else
+#define PRINTF_THREAD_LOCAL _Thread_local
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PRINTF_PROFILE_TSC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define PRINTF_PROFILE_TSC 1
+#else
+#include <time.h>
+#endif
+
+static PRINTF_THREAD_LOCAL PRINTF_PROFILE printf_profile;           /* counters of the current thread */
+static PRINTF_THREAD_LOCAL uint64_t       printf_profile_callbacks; /* number of callbacks of the current thread */
+static PRINTF_THREAD_LOCAL unsigned int   printf_profile_countdown; /* conversions until the next timed one */
+static unsigned int                       printf_profile_interval;  /* time every n-th conversion or 0 */
+
+#define PRINTF_PROFILE_CALLBACK() (++printf_profile_callbacks)
+#else
+#define PRINTF_PROFILE_CALLBACK()
+#endif
+
 /* ========================================================================= *\
 \* ========================================================================= */
 
@@ -737,26 +783,73 @@ static const char * lower_digits = "0123456789abcdefghijklmnopqrstuvwxyz";
 static const char * upper_digits = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
 
 
-static size_t cbk_print_number(void *            pUserData,      /* user specific context for the callback */
-                               PRINTF_CALLBACK * pCB,            /* data write callback */
-                               const char *      pvalue,         /* number string to to write out */
-                               size_t            length,         /* length of number string */
-                               const char *      padding,        /* pointer to padding bytes to fill in after prefix before the numeric value */
-                               char              sign_char,      /* optional sign character to fill in */
-                               uint8_t           prefix_base,    /* if nonzero base for C style prefixing of octals and hexadecimals if prefixeng is required required */
-                               uint8_t           uppercase,      /* whether to use uppercase letters for prefix */
-                               uint8_t           left_justified, /* left justified value witin the output data field */
-                               size_t            minwidth,       /* minimum width of value to print */
-                               size_t            fieldwidth)     /* minimum field width */
+/* ------------------------------------------------------------------------- *\
+   Reserve and commit sinks of callback_printf_sink. callback_printf_sink
+   calls callback_printf with sink_write_callback as callback and the
+   PRINTF_SINK as user data. The emitters recognize that callback and write
+   their output directly into the memory of the sink if the sink provides
+   enough space. Otherwise they use the copy callback of the sink.
+\* ------------------------------------------------------------------------- */
+
+static void sink_write_callback(void * pUserData, const char * pSrc, size_t Length)
 {
-    size_t zRet = 0;
-    char   prefix[8];
-    char * pf = prefix;
-    size_t prelen;  /* length of sign and prefix */
+   PRINTF_SINK * psk = (PRINTF_SINK *) pUserData;
+   PRINTF_PROFILE_CALLBACK();
+   psk->pCB(psk->pUserData, pSrc, Length);
+} /* void sink_write_callback(void * pUserData, const char * pSrc, size_t Length) */
 
-    /* ------------------------------------------------------------------------- *\
-       prepare prefix value
-    \* ------------------------------------------------------------------------- */
+/* sink_reserve returns sink memory for Length bytes or NULL if pCB doesn't belong to a reserve and commit sink or if there is not enough space */
+static char * sink_reserve(void * pUserData, PRINTF_CALLBACK * pCB, size_t Length)
+{
+   PRINTF_SINK * psk = (PRINTF_SINK *) pUserData;
+
+   if((pCB != &sink_write_callback) || !psk->pReserve)
+      return (NULL);
+
+   return (psk->pReserve(psk->pUserData, Length));
+} /* char * sink_reserve(void * pUserData, PRINTF_CALLBACK * pCB, size_t Length) */
+
+/* sink_commit commits Length bytes of the memory that sink_reserve returned */
+static void sink_commit(void * pUserData, size_t Length)
+{
+   PRINTF_SINK * psk = (PRINTF_SINK *) pUserData;
+   PRINTF_PROFILE_CALLBACK();
+   psk->pCommit(psk->pUserData, Length);
+} /* void sink_commit(void * pUserData, size_t Length) */
+
+/* sink_fill fills Length bytes of sink memory with the character c and returns the end position */
+static char * sink_fill(char * pd, char c, size_t Length)
+{
+   while(Length--)
+      *pd++ = c;
+
+   return (pd);
+} /* char * sink_fill(char * pd, char c, size_t Length) */
+
+/* sink_copy copies Length bytes into the sink memory and returns the end position */
+static char * sink_copy(char * pd, const char * ps, size_t Length)
+{
+   while(Length--)
+      *pd++ = *ps++;
+
+   return (pd);
+} /* char * sink_copy(char * pd, const char * ps, size_t Length) */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   number_prefix writes the sign character and the C style prefix of a
+   number and returns the length of the prefix.
+\* ------------------------------------------------------------------------- */
+
+static size_t number_prefix(char *  prefix,      /* buffer for at least 3 characters */
+                            char    sign_char,   /* optional sign character to fill in */
+                            uint8_t prefix_base, /* if nonzero base for C style prefixing of octals and hexadecimals if prefixeng is required required */
+                            uint8_t uppercase,   /* whether to use uppercase letters for prefix */
+                            size_t  length,      /* length of number string */
+                            size_t  minwidth)    /* minimum width of value to print */
+{
+    char * pf = prefix;
 
     if (sign_char)
        *pf++ = sign_char;
@@ -785,7 +878,112 @@ static size_t cbk_print_number(void *            pUserData,      /* user specifi
        }
     }
 
-    prelen = pf - prefix;
+    return (pf - prefix);
+} /* size_t number_prefix(...) */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   sink_reserve_number reserves the sink memory for the whole output of a
+   number and fills in the prefix and the padding. It returns the position
+   of the digits within the sink memory or NULL if the sink does not
+   provide the memory. The caller has to write the digits and to commit
+   the returned length *pzRet.
+\* ------------------------------------------------------------------------- */
+
+static char * sink_reserve_number(void *            pUserData,      /* user specific context for the callback */
+                                  PRINTF_CALLBACK * pCB,            /* data write callback */
+                                  size_t            length,         /* length of number string */
+                                  const char *      padding,        /* pointer to padding bytes to fill in after prefix before the numeric value */
+                                  char              sign_char,      /* optional sign character to fill in */
+                                  uint8_t           prefix_base,    /* if nonzero base for C style prefixing of octals and hexadecimals if prefixeng is required required */
+                                  uint8_t           uppercase,      /* whether to use uppercase letters for prefix */
+                                  uint8_t           left_justified, /* left justified value witin the output data field */
+                                  size_t            minwidth,       /* minimum width of value to print */
+                                  size_t            fieldwidth,     /* minimum field width */
+                                  size_t *          pzRet)          /* returns the length of the whole output */
+{
+    char   prefix[8];
+    size_t prelen = number_prefix(prefix, sign_char, prefix_base, uppercase, length, minwidth);
+    size_t fill   = 0;
+    size_t zRet;
+    char * pd;
+    char * pDigits;
+
+    if(minwidth > length)
+        minwidth -= length;
+    else
+        minwidth = 0;
+
+    zRet = minwidth + length + prelen;
+
+    if(fieldwidth > zRet)
+    {
+       fill = fieldwidth - zRet;
+       zRet = fieldwidth;
+    }
+
+    pd = sink_reserve(pUserData, pCB, zRet);
+    if(!pd)
+       return (NULL);
+
+    if(padding == pzeros)
+    {
+       pd = sink_copy(pd, prefix, prelen);
+       if(!left_justified)
+          pd = sink_fill(pd, '0', fill);
+    }
+    else
+    {
+       if(!left_justified)
+          pd = sink_fill(pd, ' ', fill);
+       pd = sink_copy(pd, prefix, prelen);
+    }
+
+    pDigits = sink_fill(pd, '0', minwidth);
+
+    if(left_justified)
+       sink_fill(pDigits + length, ' ', fill);
+
+    *pzRet = zRet;
+    return (pDigits);
+} /* char * sink_reserve_number(...) */
+
+
+
+static size_t cbk_print_number(void *            pUserData,      /* user specific context for the callback */
+                               PRINTF_CALLBACK * pCB,            /* data write callback */
+                               const char *      pvalue,         /* number string to to write out */
+                               size_t            length,         /* length of number string */
+                               const char *      padding,        /* pointer to padding bytes to fill in after prefix before the numeric value */
+                               char              sign_char,      /* optional sign character to fill in */
+                               uint8_t           prefix_base,    /* if nonzero base for C style prefixing of octals and hexadecimals if prefixeng is required required */
+                               uint8_t           uppercase,      /* whether to use uppercase letters for prefix */
+                               uint8_t           left_justified, /* left justified value witin the output data field */
+                               size_t            minwidth,       /* minimum width of value to print */
+                               size_t            fieldwidth)     /* minimum field width */
+{
+    size_t zRet = 0;
+    char   prefix[8];
+    size_t prelen;  /* length of sign and prefix */
+    char * pd;
+
+    if(pCB == &sink_write_callback)
+    { /* write the whole output directly into the memory of the sink */
+       pd = sink_reserve_number(pUserData, pCB, length, padding, sign_char, prefix_base, uppercase, left_justified, minwidth, fieldwidth, &zRet);
+       if(pd)
+       {
+          sink_copy(pd, pvalue, length);
+          sink_commit(pUserData, zRet);
+          return (zRet);
+       }
+    }
+
+    /* ------------------------------------------------------------------------- *\
+       prepare prefix value
+    \* ------------------------------------------------------------------------- */
+
+    prelen = number_prefix(prefix, sign_char, prefix_base, uppercase, length, minwidth);
 
     /* ------------------------------------------------------------------------- *\
        generate the output
@@ -912,16 +1110,44 @@ static size_t cbk_print_u64(void *            pUserData,      /* user specific c
     char *       pe       = buf + sizeof(buf);
     char *       ps       = pe;
     uint64_t     x        = value;
+    char *       pm       = NULL;                                                             /* position of the digits within the sink memory */
 
     if(base < 2)
        goto Exit;
 
+    if(x && (pCB == &sink_write_callback) && ((base == 10) || (base == 16)))
+    { /* write the digits directly into the memory of the sink */
+       size_t   n = 1;
+       uint64_t p = base;
+
+       if(base == 10)
+       {
+          while((n < 20) && (x >= p))
+          {
+             p *= 10;
+             ++n;
+          }
+       }
+       else
+       {
+          while((n < sizeof(x) * 2) && (x >> (n * 4)))
+             ++n;
+       }
+
+       pm = sink_reserve_number(pUserData, pCB, n, padding, sign_char, prefixing ? base : 0, digit == upper_digits, left_justified, minwidth, fieldwidth, &zRet);
+       if(pm)
+       {
+          pe = pm + n;
+          ps = pe;
+       }
+    }
+
     if (!x)
     {
-       prefixing = 0; /* no prefixing of 0x according to the C standard */
-
-       if (precision)  /* required by C and Posix standards :o( */
+       if (precision || (prefixing && (base == 8)))  /* required by C and Posix standards :o( the octal prefix is the zero itself */
           *--ps = '0';
+
+       prefixing = 0; /* no prefixing of 0x according to the C standard */
     }
     else if (base == 10)
     {
@@ -981,7 +1207,10 @@ static size_t cbk_print_u64(void *            pUserData,      /* user specific c
        }  while (x);
     }
 
-    zRet = cbk_print_number(pUserData, pCB, ps, (size_t)(pe - ps), padding, sign_char, prefixing ? base : 0, digit == upper_digits, left_justified, minwidth, fieldwidth);
+    if(pm)
+       sink_commit(pUserData, zRet);
+    else
+       zRet = cbk_print_number(pUserData, pCB, ps, (size_t)(pe - ps), padding, sign_char, prefixing ? base : 0, digit == upper_digits, left_justified, minwidth, fieldwidth);
 
     Exit:;
     return (zRet);
@@ -1014,16 +1243,44 @@ static size_t cbk_print_u32(void *            pUserData,      /* user specific c
     char *       pe       = buf + sizeof(buf);
     char *       ps       = pe;
     uint32_t     x        = value;
+    char *       pm       = NULL;                                                             /* position of the digits within the sink memory */
 
     if(base < 2)
        goto Exit;
 
+    if(x && (pCB == &sink_write_callback) && ((base == 10) || (base == 16)))
+    { /* write the digits directly into the memory of the sink */
+       size_t   n = 1;
+       uint32_t p = base;
+
+       if(base == 10)
+       {
+          while((n < 10) && (x >= p))
+          {
+             p *= 10;
+             ++n;
+          }
+       }
+       else
+       {
+          while((n < sizeof(x) * 2) && (x >> (n * 4)))
+             ++n;
+       }
+
+       pm = sink_reserve_number(pUserData, pCB, n, padding, sign_char, prefixing ? base : 0, digit == upper_digits, left_justified, minwidth, fieldwidth, &zRet);
+       if(pm)
+       {
+          pe = pm + n;
+          ps = pe;
+       }
+    }
+
     if (!x)
     {
-       prefixing = 0; /* no prefixing of 0x according to the C standard */
-
-       if (precision)  /* required by C and Posix standards :o( */
+       if (precision || (prefixing && (base == 8)))  /* required by C and Posix standards :o( the octal prefix is the zero itself */
           *--ps = '0';
+
+       prefixing = 0; /* no prefixing of 0x according to the C standard */
     }
     else if (base == 10)
     {
@@ -1083,7 +1340,10 @@ static size_t cbk_print_u32(void *            pUserData,      /* user specific c
        }  while (x);
     }
 
-    zRet = cbk_print_number(pUserData, pCB, ps, (size_t)(pe - ps), padding, sign_char, prefixing ? base : 0, digit == upper_digits, left_justified, minwidth, fieldwidth);
+    if(pm)
+       sink_commit(pUserData, zRet);
+    else
+       zRet = cbk_print_number(pUserData, pCB, ps, (size_t)(pe - ps), padding, sign_char, prefixing ? base : 0, digit == upper_digits, left_justified, minwidth, fieldwidth);
 
     Exit:;
     return (zRet);
@@ -1859,6 +2119,8 @@ static size_t cbk_print_long_double(void *            pUserData,      /* user sp
    const char *  digit     = uppercase ? upper_digits : lower_digits;
    char buf[240];
    size_t length = 0;
+   char * pv = buf;   /* output position of the value */
+   char * pm = NULL;  /* output position within the sink memory */
 
    /*  test for NAN and INF first */
    if (!(value == value))
@@ -1903,6 +2165,13 @@ static size_t cbk_print_long_double(void *            pUserData,      /* user sp
 
       if (value == 0.0)
       {
+         float   f = (float) value;
+         int32_t i;
+         smemcpy(&i, &f, 4);
+
+         if(i < 0)
+            sign_char = '-'; /* negative zero */
+
          mant  = 0.0;
          iexpo = 0;
       }
@@ -1923,6 +2192,14 @@ static size_t cbk_print_long_double(void *            pUserData,      /* user sp
 
       format |= 0x20; /* compare lower case letters only */
 
+      if((pCB == &sink_write_callback) && (format != 'g'))
+      { /* write the output directly into the memory of the sink if no padding is required (%g output gets trimmed after writing) */
+         size_t prelen = (sign_char ? 1 : 0) + (((format == 'a') || (prefixing && ((base == 16) || (base == 2)))) ? 2 : 0);
+
+         if((fieldwidth <= prelen + 1) && (pm = sink_reserve(pUserData, pCB, prelen + sizeof(buf))))
+            pv = pm + prelen;
+      }
+
       if(format == 'g')
       {
          long double round;
@@ -1950,14 +2227,14 @@ static size_t cbk_print_long_double(void *            pUserData,      /* user sp
                ++iexpo;
             }
 
-            length = print_long_double_f(buf, mant, iexpo, base, minwidth - 1 - E, prefixing, digit);  /* print floating point numbers without an exponent and adjusted precision */
+            length = print_long_double_f(pv, mant, iexpo, base, minwidth - 1 - E, prefixing, digit);  /* print floating point numbers without an exponent and adjusted precision */
 
-            if(!prefixing && (minwidth > (size_t)(E + 1)))
+            if(!prefixing && ((E < 0) || (minwidth > (size_t)(E + 1))))
             { /* remove trailing zeros */
-               while(length && (buf[length-1] == '0'))
+               while(length && (pv[length-1] == '0'))
                   --length;
 
-               if(length && (buf[length-1] == '.'))
+               if(length && (pv[length-1] == '.'))
                   --length;
             }
          }
@@ -1972,14 +2249,14 @@ static size_t cbk_print_long_double(void *            pUserData,      /* user sp
                ++iexpo;
             }
 
-            length = print_long_double_e(buf, mant, iexpo, base, minwidth - 1, prefixing, digit); /* print floating point number with adjusted precision */
+            length = print_long_double_e(pv, mant, iexpo, base, minwidth - 1, prefixing, digit); /* print floating point number with adjusted precision */
 
-            if(!prefixing)
+            if(!prefixing && (minwidth > 1))
             {
-               char * ps = buf + 1; /* points to decimal point now */
+               char * ps = pv + 1; /* points to decimal point now */
                char * pe = ps + 1;
 
-               while((size_t) (pe - buf) < length)
+               while((size_t) (pe - pv) < length)
                {
                   if(*pe == digit[0xe])
                      break; /* stop at begin of the exponent */
@@ -1990,10 +2267,10 @@ static size_t cbk_print_long_double(void *            pUserData,      /* user sp
 
                if (ps != pe)
                { /* copy exponent to the position that ps points to and remove the unused zeros */
-                  while((size_t) (pe - buf) < length)
+                  while((size_t) (pe - pv) < length)
                      *ps++ = *pe++;
 
-                  length = ps - buf;
+                  length = ps - pv;
                }
             }
          }
@@ -2012,7 +2289,7 @@ static size_t cbk_print_long_double(void *            pUserData,      /* user sp
             ++iexpo;
          }
 
-         length = print_long_double_e(buf, mant, iexpo, 0, minwidth, prefixing, digit);  /* print floating point number with an exponent */
+         length = print_long_double_e(pv, mant, iexpo, 0, minwidth, prefixing, digit);  /* print floating point number with an exponent */
          prefixing = 16;
       }
       else if((format == 'e') || (iexpo > 80))
@@ -2029,7 +2306,7 @@ static size_t cbk_print_long_double(void *            pUserData,      /* user sp
             ++iexpo;
          }
 
-         length = print_long_double_e(buf, mant, iexpo, base, minwidth, prefixing, digit);  /* print floating point number with an exponent */
+         length = print_long_double_e(pv, mant, iexpo, base, minwidth, prefixing, digit);  /* print floating point number with an exponent */
          if(prefixing)
             prefixing = (((base == 16) || (base == 2)) ? base : (uint8_t) 0);
       }
@@ -2050,13 +2327,21 @@ static size_t cbk_print_long_double(void *            pUserData,      /* user sp
             ++iexpo;
          }
 
-         length = print_long_double_f(buf, mant, iexpo, base, minwidth, prefixing, digit);  /* print floating point numbers without an exponent */
+         length = print_long_double_f(pv, mant, iexpo, base, minwidth, prefixing, digit);  /* print floating point numbers without an exponent */
          if(prefixing)
             prefixing = (((base == 16) || (base == 2)) ? base : (uint8_t) 0);
       }
    }
 
-   zRet = cbk_print_number(pUserData, pCB, buf, length, padding, sign_char, prefixing, uppercase, left_justified, 0 /* minwidth */, fieldwidth);
+   if(pm)
+   {
+      zRet = number_prefix(pm, sign_char, prefixing, uppercase, length, 0) + length;
+      sink_commit(pUserData, zRet);
+   }
+   else
+   {
+      zRet = cbk_print_number(pUserData, pCB, buf, length, padding, sign_char, prefixing, uppercase, left_justified, 0 /* minwidth */, fieldwidth);
+   }
 
    return (zRet);
 } /* size_t cbk_print_long_double (...) */
@@ -2337,6 +2622,8 @@ static size_t cbk_print_double(void *            pUserData,      /* user specifi
    const char *  digit     = uppercase ? upper_digits : lower_digits;
    char buf[128];
    size_t length = 0;
+   char * pv = buf;   /* output position of the value */
+   char * pm = NULL;  /* output position within the sink memory */
 
    /*  test for NAN and INF first */
    if (!(value == value))
@@ -2381,6 +2668,13 @@ static size_t cbk_print_double(void *            pUserData,      /* user specifi
 
       if (value == 0.0)
       {
+         float   f = (float) value;
+         int32_t i;
+         smemcpy(&i, &f, 4);
+
+         if(i < 0)
+            sign_char = '-'; /* negative zero */
+
          mant  = 0.0;
          iexpo = 0;
       }
@@ -2401,6 +2695,14 @@ static size_t cbk_print_double(void *            pUserData,      /* user specifi
 
       format |= 0x20; /* compare lower case letters only */
 
+      if((pCB == &sink_write_callback) && (format != 'g'))
+      { /* write the output directly into the memory of the sink if no padding is required (%g output gets trimmed after writing) */
+         size_t prelen = (sign_char ? 1 : 0) + (((format == 'a') || (prefixing && ((base == 16) || (base == 2)))) ? 2 : 0);
+
+         if((fieldwidth <= prelen + 1) && (pm = sink_reserve(pUserData, pCB, prelen + sizeof(buf))))
+            pv = pm + prelen;
+      }
+
       if(format == 'g')
       {
          double round;
@@ -2427,14 +2729,14 @@ static size_t cbk_print_double(void *            pUserData,      /* user specifi
                ++iexpo;
             }
 
-            length = print_double_f(buf, mant, iexpo, base, minwidth - 1 - E, prefixing, digit);  /* print floating point numbers without an exponent and adjusted precision */
+            length = print_double_f(pv, mant, iexpo, base, minwidth - 1 - E, prefixing, digit);  /* print floating point numbers without an exponent and adjusted precision */
 
-            if(!prefixing && (minwidth > (size_t)(E + 1)))
+            if(!prefixing && ((E < 0) || (minwidth > (size_t)(E + 1))))
             { /* remove trailing zeros */
-               while(length && (buf[length-1] == '0'))
+               while(length && (pv[length-1] == '0'))
                   --length;
 
-               if(length && (buf[length-1] == '.'))
+               if(length && (pv[length-1] == '.'))
                   --length;
             }
          }
@@ -2449,14 +2751,14 @@ static size_t cbk_print_double(void *            pUserData,      /* user specifi
                ++iexpo;
             }
 
-            length = print_double_e(buf, mant, iexpo, base, minwidth - 1, prefixing, digit); /* print floating point number with adjusted precision */
+            length = print_double_e(pv, mant, iexpo, base, minwidth - 1, prefixing, digit); /* print floating point number with adjusted precision */
 
-            if(!prefixing)
+            if(!prefixing && (minwidth > 1))
             {
-               char * ps = buf + 1; /* points to decimal point now */
+               char * ps = pv + 1; /* points to decimal point now */
                char * pe = ps + 1;
 
-               while((size_t) (pe - buf) < length)
+               while((size_t) (pe - pv) < length)
                {
                   if(*pe == digit[0xe])
                      break; /* stop at begin of the exponent */
@@ -2467,10 +2769,10 @@ static size_t cbk_print_double(void *            pUserData,      /* user specifi
 
                if (ps != pe)
                { /* copy exponent to the position that ps points to and remove the unused zeros */
-                  while((size_t) (pe - buf) < length)
+                  while((size_t) (pe - pv) < length)
                      *ps++ = *pe++;
 
-                  length = ps - buf;
+                  length = ps - pv;
                }
             }
          }
@@ -2480,8 +2782,9 @@ static size_t cbk_print_double(void *            pUserData,      /* user specifi
       }
       else if(format == 'a')
       {
-         /* ensure right rounding according to the required length of the mantissa */
-         mant += 0.5 / powi(16, (int32_t) minwidth);
+         /* ensure right rounding according to the required length of the mantissa unless all bits are printed */
+         if(minwidth * 4 < DBL_MANT_DIG - 1)
+            mant += 0.5 / powi(16, (int32_t) minwidth);
 
          if(mant >= base)
          {/* ensure that */
@@ -2489,7 +2792,7 @@ static size_t cbk_print_double(void *            pUserData,      /* user specifi
             ++iexpo;
          }
 
-         length = print_double_e(buf, mant, iexpo, 0, minwidth, prefixing, digit);  /* print floating point number with an exponent */
+         length = print_double_e(pv, mant, iexpo, 0, minwidth, prefixing, digit);  /* print floating point number with an exponent */
          prefixing = 16;
       }
       else if((format == 'e') || (iexpo > 48))
@@ -2506,7 +2809,7 @@ static size_t cbk_print_double(void *            pUserData,      /* user specifi
             ++iexpo;
          }
 
-         length = print_double_e(buf, mant, iexpo, base, minwidth, prefixing, digit);  /* print floating point number with an exponent */
+         length = print_double_e(pv, mant, iexpo, base, minwidth, prefixing, digit);  /* print floating point number with an exponent */
          if(prefixing)
             prefixing = (((base == 16) || (base == 2)) ? base : (uint8_t) 0);
       }
@@ -2526,12 +2829,20 @@ static size_t cbk_print_double(void *            pUserData,      /* user specifi
             ++iexpo;
          }
 
-         length = print_double_f(buf, mant, iexpo, base, minwidth, prefixing, digit);  /* print floating point numbers without an exponent */
+         length = print_double_f(pv, mant, iexpo, base, minwidth, prefixing, digit);  /* print floating point numbers without an exponent */
          if(prefixing)
             prefixing = (((base == 16) || (base == 2)) ? base : (uint8_t) 0);
       }
    }
-   zRet = cbk_print_number(pUserData, pCB, buf, length, padding, sign_char, prefixing, uppercase, left_justified, 0 /* minwidth */, fieldwidth);
+   if(pm)
+   {
+      zRet = number_prefix(pm, sign_char, prefixing, uppercase, length, 0) + length;
+      sink_commit(pUserData, zRet);
+   }
+   else
+   {
+      zRet = cbk_print_number(pUserData, pCB, buf, length, padding, sign_char, prefixing, uppercase, left_justified, 0 /* minwidth */, fieldwidth);
+   }
 
    return (zRet);
 } /* size_t cbk_print_double (...) */
@@ -2551,8 +2862,23 @@ static size_t cbk_print_char(void *            pUserData,      /* user specific
                              uint8_t           left_justified)
 {
    size_t zRet;
+   char * pd;
 
-   if (minimum_width <= length)
+   if((pCB == &sink_write_callback) && (pd = sink_reserve(pUserData, pCB, minimum_width > length ? minimum_width : length)))
+   { /* write the output directly into the memory of the sink */
+      zRet = minimum_width > length ? minimum_width : length;
+
+      if(!left_justified)
+         pd = sink_fill(pd, ' ', zRet - length);
+
+      pd = sink_fill(pd, c, length);
+
+      if(left_justified)
+         sink_fill(pd, ' ', zRet - length);
+
+      sink_commit(pUserData, zRet);
+   }
+   else if (minimum_width <= length)
    {
       zRet = length;
       while (length--)
@@ -2606,6 +2932,7 @@ size_t cbk_print_string(void *            pUserData,      /* user specific conte
                         uint8_t           left_justified)
 {
    size_t zRet;
+   char * pd;
 
    if (minimum_width <= length)
    {
@@ -2613,6 +2940,20 @@ size_t cbk_print_string(void *            pUserData,      /* user specific conte
       if(length)
          pCB(pUserData, ps, length);
    }
+   else if((pCB == &sink_write_callback) && (pd = sink_reserve(pUserData, pCB, minimum_width)))
+   { /* write the padded output directly into the memory of the sink */
+      zRet = minimum_width;
+
+      if(!left_justified)
+         pd = sink_fill(pd, ' ', minimum_width - length);
+
+      pd = sink_copy(pd, ps, length);
+
+      if(left_justified)
+         sink_fill(pd, ' ', minimum_width - length);
+
+      sink_commit(pUserData, zRet);
+   }
    else
    {
       zRet = minimum_width;
@@ -2668,7 +3009,22 @@ static size_t cbk_print_wstring(void *            pUserData,      /* user specif
 
    iUtf8Encode (NULL, &length, &psrc, &src_length, char_size);  /* calculate the length of output that is related to the source data */
 
-   if (minimum_width <= length)
+   if((pCB == &sink_write_callback) && (pb = sink_reserve(pUserData, pCB, minimum_width > length ? minimum_width : length)))
+   { /* encode the output directly into the memory of the sink */
+      size_t size = length;
+      zRet = minimum_width > length ? minimum_width : length;
+
+      if(!left_justified)
+         pb = sink_fill(pb, ' ', zRet - length);
+
+      iUtf8Encode ((void **)&pb, &size, &psrc, &src_length, char_size);
+
+      if(left_justified)
+         sink_fill(pb, ' ', zRet - length);
+
+      sink_commit(pUserData, zRet);
+   }
+   else if (minimum_width <= length)
    {
       zRet = length;
 
@@ -2729,305 +3085,1168 @@ static size_t cbk_print_wstring(void *            pUserData,      /* user specif
 
 
 
-/* ------------------------------------------------------------------------- *\
-   callback_printf generates vsnprintf like character output by calling a
-   user defined write callback for the parts of the generated character data.
-   The function returns the length of the overall written data but does not
-   terminate the written output data string.
-   See implementation of svsnprintf implementation for a sample of usage.
-\* ------------------------------------------------------------------------- */
+/* ========================================================================= *\
+   Escaped strings %Js, %Qs and %qs
+\* ========================================================================= */
 
-size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFmt, va_list val)
+/* esc_special returns whether a character needs an escape sequence */
+static int esc_special(char mode, uint32_t c)
 {
-   size_t       zRet = 0;
-   const char * pf   = pFmt;
+   if(mode == 'J')
+      return ((c < 0x20) || (c == '"') || (c == '\\'));
 
-   if(!pCB)
-      goto Exit;
+   return (c == (uint32_t) ((mode == 'Q') ? '"' : '\''));
+} /* int esc_special(char mode, uint32_t c) */
 
-   if(!pf)
+/* esc_unquoted returns whether a character may be printed without the quotes of a CSV field or a shell word */
+static int esc_unquoted(char mode, uint32_t c)
+{
+   if(mode == 'Q')
+      return ((c != ',') && (c != '"') && (c != '\r') && (c != '\n'));
+
+   return ((c < 0x80) && ((CharType[c] & 0x03) || (c == '@') || (c == '%') || (c == '+') || (c == '=') ||
+                          (c == ':') || (c == ',') || (c == '.') || (c == '/') || (c == '-')));
+} /* int esc_unquoted(char mode, uint32_t c) */
+
+/* esc_sequence writes the escape sequence of a special character and returns its length */
+static size_t esc_sequence(char * pd, char mode, uint8_t c)
+{
+   if(mode == 'Q')
+   { /* doubled quote of CSV */
+      pd[0] = '"';
+      pd[1] = '"';
+      return (2);
+   }
+
+   if(mode == 'q')
+   { /* end the quoted shell word, add an escaped quote and continue the quoted word */
+      pd[0] = '\'';
+      pd[1] = '\\';
+      pd[2] = '\'';
+      pd[3] = '\'';
+      return (4);
+   }
+
+   pd[0] = '\\';
+
+   switch(c)
    {
-      pCB(pUserData, pf, 0);
-      goto Exit;
+      case '"':  pd[1] = '"';  return (2);
+      case '\\': pd[1] = '\\'; return (2);
+      case '\b': pd[1] = 'b';  return (2);
+      case '\f': pd[1] = 'f';  return (2);
+      case '\n': pd[1] = 'n';  return (2);
+      case '\r': pd[1] = 'r';  return (2);
+      case '\t': pd[1] = 't';  return (2);
+      default:   break;
    }
 
-   while(*pf && (*pf != '%'))
-      ++pf;
+   pd[1] = 'u';
+   pd[2] = '0';
+   pd[3] = '0';
+   pd[4] = LowerDigit[c >> 4];
+   pd[5] = LowerDigit[c & 0xf];
+   return (6);
+} /* size_t esc_sequence(char * pd, char mode, uint8_t c) */
 
-   if(pf != pFmt)
-   { /* print the leading string that contains no argument format specifications */
-      zRet = (size_t) (pf - pFmt);
-      pCB(pUserData, pFmt, zRet);
-      pFmt = pf;  /* end of format string or first format specification */
+/* esc_run returns the number of leading bytes that don't need any escape sequence */
+static size_t esc_run(const char * ps, size_t Length, char mode)
+{
+   size_t i = 0;
+
+#ifdef PRINTF_SSE2
+   /* the special characters of CSV and shell are a single quote character, control characters are special in JSON only */
+   __m128i q = _mm_set1_epi8((mode == 'q') ? '\'' : '"');
+   __m128i b = _mm_set1_epi8((mode == 'J') ? '\\' : ((mode == 'q') ? '\'' : '"'));
+   __m128i c = _mm_set1_epi8((char) ((mode == 'J') ? 0x1f : 0));
+
+   for(; i + 16 <= Length; i += 16)
+   {
+      __m128i v = _mm_loadu_si128((const __m128i *) (ps + i));
+      __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, q), _mm_cmpeq_epi8(v, b)), _mm_cmpeq_epi8(_mm_max_epu8(v, c), c));
+
+      if(_mm_movemask_epi8(m))
+         break;
    }
+#endif
 
-   while(*pf)
+   while((i < Length) && !esc_special(mode, (uint8_t) ps[i]))
+      ++i;
+
+   return (i);
+} /* size_t esc_run(const char * ps, size_t Length, char mode) */
+
+/* esc_write copies the runs of clean bytes and the escape sequences of the special ones and returns the output length */
+static size_t esc_write(void * pUserData, PRINTF_CALLBACK * pCB, const char * ps, size_t Length, char mode)
+{
+   size_t zRet = 0;
+   char   seq[8];
+
+   while(Length)
    {
-      if(*(++pf) == '%')
-      {  /* find begin of next format string and write out all the characters at once */
-         const char * pe = pf + 1;
-         while(*pe && (*pe != '%'))
-            ++pe;
+      size_t n = esc_run(ps, Length, mode);
 
-         pCB(pUserData, pf, pe - pf); /* write the string data */
-         zRet += (size_t)(pe - pf);
-         pf = pe; /* begin of next format to check */
-      }
-      else
+      if(n)
       {
-         uint8_t blank_padding  = 1;           /* whether to use blanks instead of zeros for legth padding */
-         char    sign_char      = '\0';        /* '+' or ' ' for prefixing positive integers with plus */
-         uint8_t prefixing      = 0;           /* '#' flag for prefix octals with '0', hexadecimals and pointers with '0x' or '0X' or adding a decimal point to floats */
-         uint8_t left_justified = 0;           /* '-' flag left justified output */
-         size_t  precision      = ~(size_t) 0; /* precision of output width */
-         size_t  minimum_width  = 0;           /* minimum output width */
+         pCB(pUserData, ps, n);
+         zRet   += n;
+         ps     += n;
+         Length -= n;
+      }
 
-         const char * ps = pf;
-         const char * pe = ps;
-         char fc; /* format character */
+      if(Length)
+      {
+         n = esc_sequence(seq, mode, (uint8_t) *ps++);
+         pCB(pUserData, seq, n);
+         zRet += n;
+         --Length;
+      }
+   }
 
-         if(!IS_PRINTF_FMT_END(*pe))
-         {
-            if (IS_DIGIT(*ps))
-            {
-               /* size_t idx = (*ps - '0'); */
+   return (zRet);
+} /* size_t esc_write(...) */
 
-               while(IS_DIGIT(*(++ps)))
-               {
-                  /* idx = (idx * 10) + (*ps - '0'); */
-               }
+/* esc_unit returns a character of a string of char_size bytes wide characters or of a char string if char_size is 0 */
+static uint32_t esc_unit(const void * pv, size_t i, size_t char_size)
+{
+   if(char_size == 2)
+      return (((const uint16_t *) pv)[i]);
 
-               if (*ps == '$')
-               { /* we do not yet handle indexed arguments */
-                  pCB(pUserData, ps, 0);
-                  goto Exit;
-               }
+   if(char_size == 4)
+      return (((const uint32_t *) pv)[i]);
 
-               ps = pf; /* may be a minimum width */
-            }
+   return (((const uint8_t *) pv)[i]);
+} /* uint32_t esc_unit(const void * pv, size_t i, size_t char_size) */
 
-            while(IS_PRINTF_FMT_FLAG(*ps))
-            {
-               if(*ps == '0')
-                  blank_padding = 0;
-               else if(*ps == '-')
-                  left_justified = 1;
-               else if(*ps == '#')
-                  prefixing = 1;
-               else if(*ps == '+')
-                  sign_char = '+';
-               else if(*ps == ' ')
-               {
-                  if(sign_char != '+')
-                     sign_char = ' ';
-               }
-               ++ps;
-            }
 
-            if(IS_DIGIT(*ps))
-            {
-               minimum_width = *ps++ - '0';
-               while(IS_DIGIT(*ps))
-                  minimum_width = (minimum_width * 10) + (*ps++ - '0');
-            }
-            else if(*ps == '*')
-            {
-               if(IS_DIGIT(*(++ps)))
-               { /* handle indexed arguments */
-                  size_t idx = (*ps - '0');
+/* ------------------------------------------------------------------------- *\
+   cbk_print_escaped prints a string with the escaping of JSON strings ('J'),
+   CSV fields ('Q') or shell words ('q'). CSV fields and shell words get
+   quoted if necessary or always if quote is set. JSON strings get their
+   double quotes only if quote is set. Wide character strings are converted
+   to UTF-8 in blocks which are escaped in the same pass. The length of the
+   output is calculated in advance only if a minimum width requires it.
+\* ------------------------------------------------------------------------- */
+static size_t cbk_print_escaped(void *            pUserData,      /* user specific context for the callback */
+                                PRINTF_CALLBACK * pCB,            /* data write callback */
+                                char              mode,           /* 'J', 'Q' or 'q' */
+                                uint8_t           quote,          /* whether the output should always be quoted */
+                                const void *      pv,             /* pointer to the string */
+                                size_t            char_size,      /* size of a wide character or 0 for char strings */
+                                size_t            precision,      /* maximum number of characters */
+                                size_t            minimum_width,  /* minimum output field width */
+                                uint8_t           left_justified) /* whether the output should be left justified */
+{
+   size_t zRet     = 0;
+   size_t length   = 0; /* number of source characters */
+   size_t width    = 0; /* length of the output */
+   char   qc       = (mode == 'q') ? '\'' : '"';
+   int    escaping;
+   size_t i;
+
+   if(!pv)
+   {
+      pv        = "<NULL>";
+      char_size = 0;
+   }
 
-                  while(IS_DIGIT(*(++ps)))
-                     idx = (idx * 10) + (*ps - '0');
+   if(!char_size)
+   {
+      const char * pa = (const char *) pv;
 
-                  if (*ps != '$')
-                  { /* invalid format */
-                     pCB(pUserData, ps, 0);
-                     goto Exit;
-                  }
+      while((length < precision) && pa[length])
+         ++length;
+   }
+   else
+   {
+      while((length < precision) && esc_unit(pv, length, char_size))
+         ++length;
+   }
 
-                  /* we do not yet support this :o( */
-                  pCB(pUserData, ps, 0);
-                  goto Exit;
-               }
-               else
-               {
-                  int i = va_arg(val, int);
+   if(!quote && (mode != 'J'))
+   {
+      quote = (uint8_t) (!length && (mode == 'q'));
 
-                  if(i < 0)
-                  {/* handle this according to the C standard */
-                     left_justified = 1;
-                     i = -i;
-                  }
+      for(i = 0; !quote && (i < length); ++i)
+         quote = (uint8_t) !esc_unquoted(mode, esc_unit(pv, i, char_size));
+   }
 
-                  minimum_width = (size_t) i;
-               }
-            }
+   escaping = quote || (mode == 'J');
 
-            if(left_justified)
-               blank_padding = 1;
+   if(minimum_width)
+   { /* the length of the output is required for the padding */
+      char   seq[8];
+      void * psrc       = (void *) pv;
+      size_t src_length = length * char_size;
 
-            if(*ps == '.')
-            {
-               if(IS_DIGIT(*(++ps)))
-               {
-                  precision = *ps++ - '0';
-                  while(IS_DIGIT(*ps))
-                     precision = (precision * 10) + (*ps++ - '0');
-               }
-               else if(*ps == '*')
-               {
-                  if(IS_DIGIT(*(++ps)))
-                  { /* handle indexed arguments */
-                     size_t idx = (*ps - '0');
+      if(char_size)
+         iUtf8Encode (NULL, &width, &psrc, &src_length, char_size);
+      else
+         width = length;
 
-                     while(IS_DIGIT(*(++ps)))
-                        idx = (idx * 10) + (*ps - '0');
+      for(i = 0; escaping && (i < length); ++i)
+      {
+         uint32_t c = esc_unit(pv, i, char_size);
 
-                     if (*ps != '$')
-                     { /* invalid format */
-                        pCB(pUserData, ps, 0);
-                        goto Exit;
-                     }
+         if((c < 0x80) && esc_special(mode, c))
+            width += esc_sequence(seq, mode, (uint8_t) c) - 1;
+      }
 
-                     /* we do not yet support this :o( */
-                     pCB(pUserData, ps, 0);
-                     goto Exit;
-                  }
-                  else
-                  {
-                     int i = va_arg(val, int);
-                     if(i >= 0)
-                        precision = (size_t) i;
-                  }
-               }
-            }
+      width += quote ? 2 : 0;
 
-            /*  Let's find the end of the format specification. */
-            pe = ps;
-            while(!IS_PRINTF_FMT_END(*pe))
-               ++pe;
-         }
+      if(!left_justified && (width < minimum_width))
+         zRet += cbk_print_string(pUserData, pCB, "", 0, minimum_width - width, 0);
+   }
 
-         /* pe points to the terminating format character now while ps points to the begin of type specification. */
-         fc = *pe;
+   if(quote)
+   {
+      pCB(pUserData, &qc, 1);
+      ++zRet;
+   }
+
+   if(!char_size)
+   {
+      if(escaping)
+         zRet += esc_write(pUserData, pCB, (const char *) pv, length, mode);
+      else if(length)
+      {
+         pCB(pUserData, (const char *) pv, length);
+         zRet += length;
+      }
+   }
+   else
+   {
+      char   buf[512];
+      void * psrc       = (void *) pv;
+      size_t src_length = length * char_size;
+
+      while(src_length)
+      {
+         char * pb   = buf;
+         size_t size = sizeof(buf);
 
-         if(fc == 's')
+         iUtf8Encode ((void **)&pb, &size, &psrc, &src_length, char_size);
+
+         if(escaping)
+            zRet += esc_write(pUserData, pCB, buf, (size_t) (pb - buf), mode);
+         else
          {
-            if(pe == ps)
-            {
-               const char * pa = va_arg(val, char *);
-               size_t length = precision; /* maximum length to be printed */
-               if(!pa)
-                  pa = "<NULL>";
-               ps = pa;
-               while (length-- && *ps)
-                  ++ps;
+            pCB(pUserData, buf, (size_t) (pb - buf));
+            zRet += (size_t) (pb - buf);
+         }
+      }
+   }
 
-               length = (size_t) (ps - pa); /* contains string len to be printed now */
-               zRet += cbk_print_string(pUserData, pCB, pa, length, minimum_width, left_justified);
-            }
-            else if(pe == (ps + 1))
-            {
-               char s0 = *ps;
-               if(s0 == 'l')
-               {
-                  wchar_t * pa = va_arg(val, wchar_t *);
-                  wchar_t * pe = pa;
-                  size_t length = precision; /* maximum length to be printed */
-                  if(!pa)
-                  {
-                     pa = (wchar_t *) L"<NULL>";
-                     pe = pa;
-                  }
+   if(quote)
+   {
+      pCB(pUserData, &qc, 1);
+      ++zRet;
+   }
 
-                  while (length-- && *pe)
-                     ++pe;
+   if(left_justified && (width < minimum_width))
+      zRet += cbk_print_string(pUserData, pCB, "", 0, minimum_width - width, 0);
 
-                  length = (size_t) (pe - pa); /* contains string len to be printed now */
-                  zRet += cbk_print_wstring(pUserData, pCB, pa, length, sizeof(wchar_t), minimum_width, left_justified);
-               }
-               else
-               {
-                  pCB(pUserData, ps, 0);
-                  goto Exit;
-               }
-            }
-            else if(pe == (ps + 2))
-            {
-               char s0 = *ps;
-               if(s0 == 'l')
-               {
-                  char s1 = *(ps+1);
-                  if(s1 == '4')
-                  { /* character of 4 bytes width */
-                     static uint32_t warn[] = {'<', 'N', 'U', 'L', 'L', '>', '\0'};
-                     uint32_t * pa = va_arg(val, uint32_t *);
-                     uint32_t * pe = pa;
-                     size_t length = precision; /* maximum length to be printed */
+   return (zRet);
+} /* size_t cbk_print_escaped(...) */
 
-                     if(!pa)
-                     {
-                        pa = warn;
-                        pe = pa;
-                     }
 
-                     while (length-- && *pe)
-                        ++pe;
 
-                     length = (size_t) (pe - pa); /* contains string len to be printed now */
-                     zRet += cbk_print_wstring(pUserData, pCB, pa, length, sizeof(uint32_t), minimum_width, left_justified);
-                  }
-                  else if(s1 == '2')
-                  { /* character of 2 bytes width */
-                     static uint16_t warn[] = {'<', 'N', 'U', 'L', 'L', '>', '\0'};
-                     uint16_t * pa = va_arg(val, uint16_t *);
-                     uint16_t * pe = pa;
-                     size_t length = precision; /* maximum length to be printed */
+/* ========================================================================= *\
+   Named formatters
+\* ========================================================================= */
 
-                     if(!pa)
-                     {
-                        pa = warn;
-                        pe = pa;
-                     }
+#define NAMED_MAX_LENGTH 32 /* maximum length of the name of a formatter */
 
-                     while (length-- && *pe)
-                        ++pe;
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define NAMED_LOAD(pp)              (*(void * volatile *) (pp))
+#define NAMED_PUBLISH(pp, pold, pn) (_InterlockedCompareExchangePointer((void * volatile *) (pp), (pn), (pold)) == (pold))
+#else
+#define NAMED_LOAD(pp)              __atomic_load_n((pp), __ATOMIC_ACQUIRE)
+#define NAMED_PUBLISH(pp, pold, pn) __atomic_compare_exchange_n((pp), &(pold), (pn), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#endif
 
-                     length = (size_t) (pe - pa); /* contains string len to be printed now */
-                     zRet += cbk_print_wstring(pUserData, pCB, pa, length, sizeof(uint16_t), minimum_width, left_justified);
-                  }
-                  else if(s1 == '1')
-                  { /* character of 1 byte width */
-                     static uint8_t warn[] = {'<', 'N', 'U', 'L', 'L', '>', '\0'};
-                     uint8_t * pa = va_arg(val, uint8_t *);
-                     uint8_t * pe = pa;
-                     size_t length = precision; /* maximum length to be printed */
+typedef struct NAMED_SLOT_S NAMED_SLOT;
+struct NAMED_SLOT_S
+{
+   char                Name[NAMED_MAX_LENGTH]; /* name without termination */
+   size_t              Length;                 /* length of the name or 0 for an empty slot */
+   PRINTF_V_CALLBACK * pcb;                    /* callback of the name */
+};
 
-                     if(!pa)
-                     {
-                        pa = warn;
-                        pe = pa;
-                     }
+typedef struct NAMED_TABLE_S NAMED_TABLE;
+struct NAMED_TABLE_S
+{
+   NAMED_TABLE * pPrev; /* replaced table which might still be in use */
+   uint32_t      Seed;  /* seed of the hash function that maps every name to its own slot */
+   uint32_t      Mask;  /* number of slots - 1 */
+   size_t        Count; /* number of names */
+   NAMED_SLOT    Slot[1];
+};
 
-                     while (length-- && *pe)
-                        ++pe;
+static NAMED_TABLE * named_table = NULL; /* current table of the named formatters */
 
-                     length = (size_t) (pe - pa); /* contains string len to be printed now */
-                     zRet += cbk_print_wstring(pUserData, pCB, pa, length, sizeof(uint8_t), minimum_width, left_justified);
-                  }
-                  else
-                  { /* unknown format */
-                     pCB(pUserData, ps, 0);
-                     goto Exit;
-                  }
-               }
-               else
-               { /* unknown format */
-                  pCB(pUserData, ps, 0);
-                  goto Exit;
-               }
-            }
-            else
+/* named_hash is the FNV-1a hash of a name with a seed */
+static uint32_t named_hash(const char * pName, size_t Length, uint32_t Seed)
+{
+   uint32_t h = 2166136261u ^ Seed;
+
+   while(Length--)
+   {
+      h ^= (uint8_t) *pName++;
+      h *= 16777619u;
+   }
+
+   return (h ^ (h >> 15));
+} /* uint32_t named_hash(const char * pName, size_t Length, uint32_t Seed) */
+
+/* named_equal compares a name with the name of a slot */
+static int named_equal(const NAMED_SLOT * pSlot, const char * pName, size_t Length)
+{
+   size_t i;
+
+   if(pSlot->Length != Length)
+      return (0);
+
+   for(i = 0; i < Length; ++i)
+      if(pSlot->Name[i] != pName[i])
+         return (0);
+
+   return (1);
+} /* int named_equal(const NAMED_SLOT * pSlot, const char * pName, size_t Length) */
+
+/* named_build tries to place the names into the slots of a table without any collision */
+static int named_build(NAMED_TABLE * pt, const NAMED_SLOT * pNames, size_t Count)
+{
+   uint32_t seed;
+
+   for(seed = 1; seed <= 1024; ++seed)
+   {
+      size_t i;
+
+      for(i = 0; i <= pt->Mask; ++i)
+         pt->Slot[i].Length = 0;
+
+      for(i = 0; i < Count; ++i)
+      {
+         NAMED_SLOT * ps = &pt->Slot[named_hash(pNames[i].Name, pNames[i].Length, seed) & pt->Mask];
+
+         if(ps->Length)
+            break; /* collision */
+
+         *ps = pNames[i];
+      }
+
+      if(i == Count)
+      {
+         pt->Seed  = seed;
+         pt->Count = Count;
+         return (1);
+      }
+   }
+
+   return (0);
+} /* int named_build(NAMED_TABLE * pt, const NAMED_SLOT * pNames, size_t Count) */
+
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_register adds a list of named formatters and publishes a
+   new perfect hash table of all names.
+\* ------------------------------------------------------------------------- */
+
+int callback_printf_register(const PRINTF_NAMED_FORMATTER * pList, size_t Count)
+{
+   int           iRet   = EINVAL;
+   NAMED_SLOT *  pNames = NULL;
+   NAMED_TABLE * pt     = NULL;
+   NAMED_TABLE * pold;
+   size_t        i;
+
+   if(!pList && Count)
+      goto Exit;
+
+   for(i = 0; i < Count; ++i)
+   { /* check the names */
+      const char * pn = pList[i].pName;
+      size_t       n  = 0;
+
+      if(!pn || !pList[i].pcb)
+         goto Exit;
+
+      while(((pn[n] >= 'a') && (pn[n] <= 'z')) || ((pn[n] >= 'A') && (pn[n] <= 'Z')) || IS_DIGIT(pn[n]) || (pn[n] == '_'))
+         ++n;
+
+      if(!n || pn[n] || (n > NAMED_MAX_LENGTH))
+         goto Exit;
+   }
+
+   pold = (NAMED_TABLE *) NAMED_LOAD(&named_table);
+
+   for(;;)
+   {
+      size_t   total = (pold ? pold->Count : 0) + Count;
+      uint32_t slots = 8;
+      size_t   n     = 0;
+
+      iRet = ENOMEM;
+      free(pNames);
+      pNames = (NAMED_SLOT *) malloc((total ? total : 1) * sizeof(NAMED_SLOT));
+      if(!pNames)
+         goto Exit;
+
+      if(pold)
+      {
+         for(i = 0; i <= pold->Mask; ++i)
+            if(pold->Slot[i].Length)
+               pNames[n++] = pold->Slot[i];
+      }
+
+      iRet = EEXIST;
+      for(i = 0; i < Count; ++i)
+      {
+         const char * pn  = pList[i].pName;
+         size_t       len = 0;
+         size_t       k;
+
+         while(pn[len])
+            ++len;
+
+         for(k = 0; k < n; ++k)
+            if(named_equal(&pNames[k], pn, len))
+               goto Exit;
+
+         for(k = 0; k < len; ++k)
+            pNames[n].Name[k] = pn[k];
+
+         pNames[n].Length = len;
+         pNames[n].pcb    = pList[i].pcb;
+         ++n;
+      }
+
+      while(slots < 2 * total)
+         slots <<= 1;
+
+      for(;;)
+      {
+         iRet = ENOMEM;
+         pt = (NAMED_TABLE *) malloc(sizeof(NAMED_TABLE) + (slots - 1) * sizeof(NAMED_SLOT));
+         if(!pt)
+            goto Exit;
+
+         pt->pPrev = pold;
+         pt->Mask  = slots - 1;
+
+         if(named_build(pt, pNames, n))
+            break;
+
+         free(pt);
+         pt = NULL;
+         slots <<= 1;
+      }
+
+      if(NAMED_PUBLISH(&named_table, pold, pt))
+         break;
+
+      /* another thread published a table in the meantime */
+      free(pt);
+      pt   = NULL;
+      pold = (NAMED_TABLE *) NAMED_LOAD(&named_table);
+   }
+
+   pt   = NULL;
+   iRet = 0;
+
+   Exit:;
+   free(pt);
+   free(pNames);
+   return (iRet);
+} /* int callback_printf_register(const PRINTF_NAMED_FORMATTER * pList, size_t Count) */
+
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_named returns the callback of a registered name or NULL.
+\* ------------------------------------------------------------------------- */
+
+PRINTF_V_CALLBACK * callback_printf_named(const char * pName, size_t Length)
+{
+   const NAMED_TABLE * pt = (const NAMED_TABLE *) NAMED_LOAD(&named_table);
+   const NAMED_SLOT *  ps;
+
+   if(!pt || !pName)
+      return (NULL);
+
+   ps = &pt->Slot[named_hash(pName, Length, pt->Seed) & pt->Mask];
+   return (named_equal(ps, pName, Length) ? ps->pcb : NULL);
+} /* PRINTF_V_CALLBACK * callback_printf_named(const char * pName, size_t Length) */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   PRINTF_ARGS is the argument array of callback_printfa. printf_core gets
+   its arguments from the va_list if there is no argument array.
+\* ------------------------------------------------------------------------- */
+
+typedef struct PRINTF_ARGS_S PRINTF_ARGS;
+struct PRINTF_ARGS_S
+{
+   const PRINTF_ARG * pArg;    /* next argument */
+   const PRINTF_ARG * pEnd;    /* end of the argument array */
+   int                Missing; /* an argument was missing */
+};
+
+/* arg_next returns the next argument of the array or a zero argument if there are no more arguments */
+static const PRINTF_ARG * arg_next(PRINTF_ARGS * pArgs)
+{
+   static const PRINTF_ARG none = { 0 };
+
+   if(pArgs->pArg < pArgs->pEnd)
+      return (pArgs->pArg++);
+
+   pArgs->Missing = 1;
+   return (&none);
+} /* const PRINTF_ARG * arg_next(PRINTF_ARGS * pArgs) */
+
+/* arg_int returns the argument as integer */
+static uint64_t arg_int(const PRINTF_ARG * pa)
+{
+   if(pa->Type == PRINTF_ARG_DOUBLE)
+      return ((pa->v.d < 0.0) ? (uint64_t) (int64_t) pa->v.d : (uint64_t) pa->v.d);
+
+   if(pa->Type == PRINTF_ARG_LDOUBLE)
+      return ((pa->v.ld < 0.0) ? (uint64_t) (int64_t) pa->v.ld : (uint64_t) pa->v.ld);
+
+   if(pa->Type == PRINTF_ARG_PTR)
+      return ((uint64_t) (uintptr_t) pa->v.p);
+
+   return (pa->v.u);
+} /* uint64_t arg_int(const PRINTF_ARG * pa) */
+
+/* arg_ldouble returns the argument as long double */
+static long double arg_ldouble(const PRINTF_ARG * pa)
+{
+   if(pa->Type == PRINTF_ARG_DOUBLE)
+      return ((long double) pa->v.d);
+
+   if(pa->Type == PRINTF_ARG_LDOUBLE)
+      return (pa->v.ld);
+
+   if(pa->Type == PRINTF_ARG_INT)
+      return ((long double) pa->v.i);
+
+   return ((long double) pa->v.u);
+} /* long double arg_ldouble(const PRINTF_ARG * pa) */
+
+/* arg_double returns the argument as double */
+static double arg_double(const PRINTF_ARG * pa)
+{
+   if(pa->Type == PRINTF_ARG_DOUBLE)
+      return (pa->v.d);
+
+   return ((double) arg_ldouble(pa));
+} /* double arg_double(const PRINTF_ARG * pa) */
+
+/* arg_ptr returns the argument as pointer */
+static void * arg_ptr(const PRINTF_ARG * pa)
+{
+   if((pa->Type == PRINTF_ARG_PTR) || !pa->Type)
+      return ((void *) pa->v.p);
+
+   return (NULL);
+} /* void * arg_ptr(const PRINTF_ARG * pa) */
+
+/* arg_func returns the argument as %v callback */
+static PRINTF_V_CALLBACK * arg_func(const PRINTF_ARG * pa)
+{
+   return ((pa->Type == PRINTF_ARG_FUNC) ? pa->v.f : NULL);
+} /* PRINTF_V_CALLBACK * arg_func(const PRINTF_ARG * pa) */
+
+/* ------------------------------------------------------------------------- *\
+   PRINTF_STAGE collects the output of a right justified %@ on the stack for
+   printing the padding in front of it without formatting the nested output
+   twice. Longer output is just counted and formatted again.
+\* ------------------------------------------------------------------------- */
+#define PRINTF_NESTED_STAGE 256 /* size of the staging buffer of %@ */
+
+typedef struct PRINTF_STAGE_S PRINTF_STAGE;
+struct PRINTF_STAGE_S
+{
+   char *       pBuf;   /* staging buffer of PRINTF_NESTED_STAGE bytes */
+   size_t       Length; /* length of the output */
+   const char * pError; /* position of an invalid format */
+   int          Error;  /* the nested format is invalid */
+};
+
+static void printf_stage_callback(void * pUserData, const char * pSrc, size_t Length)
+{
+   PRINTF_STAGE * pst = (PRINTF_STAGE *) pUserData;
+
+   if(!Length)
+   {
+      if(!pst->Error)
+      {
+         pst->Error  = 1;
+         pst->pError = pSrc;
+      }
+   }
+   else
+   {
+      if(pst->Length + Length <= PRINTF_NESTED_STAGE)
+         smemcpy(pst->pBuf + pst->Length, pSrc, Length);
+
+      pst->Length += Length;
+   }
+} /* void printf_stage_callback(void * pUserData, const char * pSrc, size_t Length) */
+
+
+/* ------------------------------------------------------------------------- *\
+   Profiling of the conversions. printf_core and callback_printf_spec
+   replace the write callback by printf_profile_callback for counting the
+   callbacks. Reserve and commit sinks and the staging of %@ aren't wrapped,
+   the sink functions count their callbacks themselves. A PRINTF_PROFILE_MARK
+   remembers the counters at the begin of a conversion.
+\* ------------------------------------------------------------------------- */
+#ifdef CALLBACK_PRINTF_PROFILE
+
+typedef struct PRINTF_PROFILE_WRAP_S PRINTF_PROFILE_WRAP;
+struct PRINTF_PROFILE_WRAP_S
+{
+   void *            pUserData; /* user data of the wrapped callback */
+   PRINTF_CALLBACK * pCB;       /* wrapped callback */
+};
+
+typedef struct PRINTF_PROFILE_MARK_S PRINTF_PROFILE_MARK;
+struct PRINTF_PROFILE_MARK_S
+{
+   size_t   Bytes;     /* output length at the begin of the conversion */
+   uint64_t Callbacks; /* number of callbacks at the begin of the conversion */
+   uint64_t Ticks;     /* time stamp at the begin of a timed conversion */
+   int      Timed;     /* the conversion is timed */
+};
+
+static const char * printf_profile_names[PRINTF_PROFILE_COUNT] =
+{
+   "text", "d", "u", "o", "x", "b", "f", "e", "g", "a", "c", "lc", "s", "ls", "Js", "p", "n", "v", "{}", "@"
+};
+
+/* printf_profile_ticks returns the current time stamp */
+static uint64_t printf_profile_ticks(void)
+{
+#ifdef PRINTF_PROFILE_TSC
+   return ((uint64_t) __rdtsc());
+#else
+   struct timespec ts;
+   timespec_get(&ts, TIME_UTC);
+   return ((uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec);
+#endif
+} /* uint64_t printf_profile_ticks(void) */
+
+static void printf_profile_callback(void * pUserData, const char * pSrc, size_t Length)
+{
+   PRINTF_PROFILE_WRAP * pw = (PRINTF_PROFILE_WRAP *) pUserData;
+   ++printf_profile_callbacks;
+   pw->pCB(pw->pUserData, pSrc, Length);
+} /* void printf_profile_callback(void * pUserData, const char * pSrc, size_t Length) */
+
+/* printf_profile_wrap replaces the callback by printf_profile_callback if it isn't counted already */
+static void printf_profile_wrap(PRINTF_PROFILE_WRAP * pw, void ** ppUserData, PRINTF_CALLBACK ** ppCB)
+{
+   if((*ppCB != &printf_profile_callback) && (*ppCB != &sink_write_callback) && (*ppCB != &printf_stage_callback))
+   {
+      pw->pUserData = *ppUserData;
+      pw->pCB       = *ppCB;
+      *ppUserData   = pw;
+      *ppCB         = &printf_profile_callback;
+   }
+} /* void printf_profile_wrap(PRINTF_PROFILE_WRAP * pw, void ** ppUserData, PRINTF_CALLBACK ** ppCB) */
+
+/* printf_profile_begin marks the begin of a conversion */
+static void printf_profile_begin(PRINTF_PROFILE_MARK * pm, size_t Bytes)
+{
+   pm->Bytes     = Bytes;
+   pm->Callbacks = printf_profile_callbacks;
+   pm->Timed     = 0;
+
+   if(printf_profile_interval && (printf_profile_countdown-- <= 1))
+   {
+      printf_profile_countdown = printf_profile_interval;
+      pm->Timed                = 1;
+      pm->Ticks                = printf_profile_ticks();
+   }
+} /* void printf_profile_begin(PRINTF_PROFILE_MARK * pm, size_t Bytes) */
+
+/* printf_profile_end adds a conversion of the type Conversion to the counters */
+static void printf_profile_end(PRINTF_PROFILE_MARK * pm, int Conversion, size_t Bytes)
+{
+   PRINTF_PROFILE_COUNTER * pc;
+
+   if(Conversion < 0)
+      return;
+
+   pc = &printf_profile.Conv[Conversion];
+
+   if(pm->Timed)
+   {
+      pc->Ticks += printf_profile_ticks() - pm->Ticks;
+      ++pc->Samples;
+   }
+
+   ++pc->Calls;
+   pc->Bytes     += Bytes - pm->Bytes;
+   pc->Callbacks += printf_profile_callbacks - pm->Callbacks;
+} /* void printf_profile_end(PRINTF_PROFILE_MARK * pm, int Conversion, size_t Bytes) */
+
+/* printf_profile_text counts literal text of a format string that is written by a single callback */
+static void printf_profile_text(size_t Length)
+{
+   PRINTF_PROFILE_COUNTER * pc = &printf_profile.Conv[PRINTF_PROFILE_TEXT];
+
+   ++pc->Calls;
+   ++pc->Callbacks;
+   pc->Bytes += Length;
+} /* void printf_profile_text(size_t Length) */
+
+/* printf_profile_type returns the type of the conversion fc with wide characters or escaping or -1 for an unsupported one */
+static int printf_profile_type(char fc, int wide, int escaped)
+{
+   switch(fc)
+   {
+      case 'd': case 'i': return (PRINTF_PROFILE_D);
+      case 'u':           return (PRINTF_PROFILE_U);
+      case 'o':           return (PRINTF_PROFILE_O);
+      case 'x': case 'X': return (PRINTF_PROFILE_X);
+      case 'b': case 'B': return (PRINTF_PROFILE_B);
+      case 'f': case 'F': return (PRINTF_PROFILE_F);
+      case 'e': case 'E': return (PRINTF_PROFILE_E);
+      case 'g': case 'G': return (PRINTF_PROFILE_G);
+      case 'a': case 'A': return (PRINTF_PROFILE_A);
+      case 'c':           return (wide ? PRINTF_PROFILE_LCHAR : PRINTF_PROFILE_CHAR);
+      case 'C':           return (PRINTF_PROFILE_LCHAR);
+      case 's':           return (escaped ? PRINTF_PROFILE_ESC : (wide ? PRINTF_PROFILE_LSTR : PRINTF_PROFILE_STR));
+      case 'S':           return (PRINTF_PROFILE_LSTR);
+      case 'p': case 'P': return (PRINTF_PROFILE_P);
+      case 'n':           return (PRINTF_PROFILE_N);
+      case 'v': case 'V': return (PRINTF_PROFILE_V);
+      case '}':           return (PRINTF_PROFILE_NAMED);
+      case '@':           return (PRINTF_PROFILE_NESTED);
+      default:            return (-1);
+   }
+} /* int printf_profile_type(char fc, int wide, int escaped) */
+
+#define PROFILE_STATE                     PRINTF_PROFILE_WRAP prof_wrap; PRINTF_PROFILE_MARK prof_mark;
+#define PROFILE_WRAP()                    printf_profile_wrap(&prof_wrap, &pUserData, &pCB)
+#define PROFILE_BEGIN()                   printf_profile_begin(&prof_mark, zRet)
+#define PROFILE_END(fc, wide, escaped)    printf_profile_end(&prof_mark, printf_profile_type(fc, wide, escaped), zRet)
+#define PROFILE_TEXT(length)              printf_profile_text(length)
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_profile_snapshot copies the counters of the thread
+\* ------------------------------------------------------------------------- */
+void callback_printf_profile_snapshot(PRINTF_PROFILE * pProfile)
+{
+   if(pProfile)
+      *pProfile = printf_profile;
+} /* void callback_printf_profile_snapshot(PRINTF_PROFILE * pProfile) */
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_profile_reset clears the counters of the thread
+\* ------------------------------------------------------------------------- */
+void callback_printf_profile_reset(void)
+{
+   static const PRINTF_PROFILE empty; /* zero initialized counters */
+   printf_profile = empty;
+} /* void callback_printf_profile_reset(void) */
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_profile_merge adds the counters of a snapshot to pTotal
+\* ------------------------------------------------------------------------- */
+void callback_printf_profile_merge(PRINTF_PROFILE * pTotal, const PRINTF_PROFILE * pProfile)
+{
+   int i;
+
+   if(!pTotal || !pProfile)
+      return;
+
+   for(i = 0; i < PRINTF_PROFILE_COUNT; ++i)
+   {
+      pTotal->Conv[i].Calls     += pProfile->Conv[i].Calls;
+      pTotal->Conv[i].Bytes     += pProfile->Conv[i].Bytes;
+      pTotal->Conv[i].Callbacks += pProfile->Conv[i].Callbacks;
+      pTotal->Conv[i].Samples   += pProfile->Conv[i].Samples;
+      pTotal->Conv[i].Ticks     += pProfile->Conv[i].Ticks;
+   }
+} /* void callback_printf_profile_merge(PRINTF_PROFILE * pTotal, const PRINTF_PROFILE * pProfile) */
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_profile_sampling sets the interval of timed conversions
+\* ------------------------------------------------------------------------- */
+void callback_printf_profile_sampling(unsigned int Interval)
+{
+   printf_profile_interval = Interval;
+} /* void callback_printf_profile_sampling(unsigned int Interval) */
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_profile_name returns the name of a conversion type
+\* ------------------------------------------------------------------------- */
+const char * callback_printf_profile_name(int Conversion)
+{
+   if((Conversion < 0) || (Conversion >= PRINTF_PROFILE_COUNT))
+      return (NULL);
+
+   return (printf_profile_names[Conversion]);
+} /* const char * callback_printf_profile_name(int Conversion) */
+
+#else
+#define PROFILE_STATE
+#define PROFILE_WRAP()
+#define PROFILE_BEGIN()
+#define PROFILE_END(fc, wide, escaped)
+#define PROFILE_TEXT(length)
+#endif
+
+/* the argument access of printf_core */
+#define GET_INT(type)  (pArgs ? (type) arg_int(arg_next(pArgs))     : va_arg(val, type))
+#define GET_DBL(type)  (pArgs ? (type) arg_double(arg_next(pArgs))  : va_arg(val, type))
+#define GET_LDBL(type) (pArgs ? (type) arg_ldouble(arg_next(pArgs)) : va_arg(val, type))
+#define GET_PTR(type)  (pArgs ? (type) arg_ptr(arg_next(pArgs))     : va_arg(val, type))
+
+
+/* ------------------------------------------------------------------------- *\
+   printf_core is the implementation of callback_printf and
+   callback_printfa. The arguments are taken from pArgs if it is not NULL
+   and from val otherwise.
+\* ------------------------------------------------------------------------- */
+
+static size_t printf_core(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFmt, va_list val, PRINTF_ARGS * pArgs)
+{
+   size_t       zRet = 0;
+   const char * pf   = pFmt;
+   PROFILE_STATE
+
+   if(!pCB)
+      goto Exit;
+
+   PROFILE_WRAP();
+
+   if(!pf)
+   {
+      pCB(pUserData, pf, 0);
+      goto Exit;
+   }
+
+   while(*pf && (*pf != '%'))
+      ++pf;
+
+   if(pf != pFmt)
+   { /* print the leading string that contains no argument format specifications */
+      zRet = (size_t) (pf - pFmt);
+      pCB(pUserData, pFmt, zRet);
+      PROFILE_TEXT(zRet);
+      pFmt = pf;  /* end of format string or first format specification */
+   }
+
+   while(*pf)
+   {
+      if(*(++pf) == '%')
+      {  /* find begin of next format string and write out all the characters at once */
+         const char * pe = pf + 1;
+         while(*pe && (*pe != '%'))
+            ++pe;
+
+         pCB(pUserData, pf, pe - pf); /* write the string data */
+         PROFILE_TEXT((size_t)(pe - pf));
+         zRet += (size_t)(pe - pf);
+         pf = pe; /* begin of next format to check */
+      }
+      else
+      {
+         uint8_t blank_padding  = 1;           /* whether to use blanks instead of zeros for legth padding */
+         char    sign_char      = '\0';        /* '+' or ' ' for prefixing positive integers with plus */
+         uint8_t prefixing      = 0;           /* '#' flag for prefix octals with '0', hexadecimals and pointers with '0x' or '0X' or adding a decimal point to floats */
+         uint8_t left_justified = 0;           /* '-' flag left justified output */
+         size_t  precision      = ~(size_t) 0; /* precision of output width */
+         size_t  minimum_width  = 0;           /* minimum output width */
+
+         const char * ps = pf;
+         const char * pe = ps;
+         char fc; /* format character */
+
+         PROFILE_BEGIN();
+
+         if(pArgs && (pArgs->pArg >= pArgs->pEnd))
+         { /* every format specification requires an argument of the array */
+            pCB(pUserData, ps, 0);
+            goto Exit;
+         }
+
+         if(!IS_PRINTF_FMT_END(*pe))
+         {
+            if (IS_DIGIT(*ps))
+            {
+               /* size_t idx = (*ps - '0'); */
+
+               while(IS_DIGIT(*(++ps)))
+               {
+                  /* idx = (idx * 10) + (*ps - '0'); */
+               }
+
+               if (*ps == '$')
+               { /* we do not yet handle indexed arguments */
+                  pCB(pUserData, ps, 0);
+                  goto Exit;
+               }
+
+               ps = pf; /* may be a minimum width */
+            }
+
+            while(IS_PRINTF_FMT_FLAG(*ps))
+            {
+               if(*ps == '0')
+                  blank_padding = 0;
+               else if(*ps == '-')
+                  left_justified = 1;
+               else if(*ps == '#')
+                  prefixing = 1;
+               else if(*ps == '+')
+                  sign_char = '+';
+               else if(*ps == ' ')
+               {
+                  if(sign_char != '+')
+                     sign_char = ' ';
+               }
+               ++ps;
+            }
+
+            if(IS_DIGIT(*ps))
+            {
+               minimum_width = *ps++ - '0';
+               while(IS_DIGIT(*ps))
+                  minimum_width = (minimum_width * 10) + (*ps++ - '0');
+            }
+            else if(*ps == '*')
+            {
+               if(IS_DIGIT(*(++ps)))
+               { /* handle indexed arguments */
+                  size_t idx = (*ps - '0');
+
+                  while(IS_DIGIT(*(++ps)))
+                     idx = (idx * 10) + (*ps - '0');
+
+                  if (*ps != '$')
+                  { /* invalid format */
+                     pCB(pUserData, ps, 0);
+                     goto Exit;
+                  }
+
+                  /* we do not yet support this :o( */
+                  pCB(pUserData, ps, 0);
+                  goto Exit;
+               }
+               else
+               {
+                  int i = GET_INT(int);
+
+                  if(i < 0)
+                  {/* handle this according to the C standard */
+                     left_justified = 1;
+                     i = -i;
+                  }
+
+                  minimum_width = (size_t) i;
+               }
+            }
+
+            if(left_justified)
+               blank_padding = 1;
+
+            if(*ps == '.')
+            {
+               if(IS_DIGIT(*(++ps)))
+               {
+                  precision = *ps++ - '0';
+                  while(IS_DIGIT(*ps))
+                     precision = (precision * 10) + (*ps++ - '0');
+               }
+               else if(*ps == '*')
+               {
+                  if(IS_DIGIT(*(++ps)))
+                  { /* handle indexed arguments */
+                     size_t idx = (*ps - '0');
+
+                     while(IS_DIGIT(*(++ps)))
+                        idx = (idx * 10) + (*ps - '0');
+
+                     if (*ps != '$')
+                     { /* invalid format */
+                        pCB(pUserData, ps, 0);
+                        goto Exit;
+                     }
+
+                     /* we do not yet support this :o( */
+                     pCB(pUserData, ps, 0);
+                     goto Exit;
+                  }
+                  else
+                  {
+                     int i = GET_INT(int);
+                     if(i >= 0)
+                        precision = (size_t) i;
+                  }
+               }
+            }
+
+            /*  Let's find the end of the format specification. */
+            pe = ps;
+            if(*pe == '{')
+            { /* %{name} of a named formatter ends with the closing brace */
+               while(*pe && (*pe != '}'))
+                  ++pe;
+            }
+            else
+            {
+               while(!IS_PRINTF_FMT_END(*pe))
+                  ++pe;
+            }
+         }
+
+         /* pe points to the terminating format character now while ps points to the begin of type specification. */
+         fc = *pe;
+
+         if((fc == 's') && (pe > ps) && ((*ps == 'J') || (*ps == 'Q') || (*ps == 'q')))
+         { /* escaped string of JSON, CSV or shell */
+            size_t size = ~(size_t) 0;
+
+            if(pe == ps + 1)
+               size = 0;
+            else if((pe == ps + 2) && (ps[1] == 'l'))
+               size = sizeof(wchar_t);
+            else if((pe == ps + 3) && (ps[1] == 'l') && ((ps[2] == '1') || (ps[2] == '2') || (ps[2] == '4')))
+               size = (size_t) (ps[2] - '0');
+
+            if(size == ~(size_t) 0)
+            { /* unknown format */
+               pCB(pUserData, ps, 0);
+               goto Exit;
+            }
+
+            zRet += cbk_print_escaped(pUserData, pCB, *ps, prefixing, GET_PTR(const void *), size, precision, minimum_width, left_justified);
+         }
+         else if(fc == 's')
+         {
+            if(pe == ps)
+            {
+               const char * pa = GET_PTR(char *);
+               size_t length = precision; /* maximum length to be printed */
+               if(!pa)
+                  pa = "<NULL>";
+               ps = pa;
+               while (length-- && *ps)
+                  ++ps;
+
+               length = (size_t) (ps - pa); /* contains string len to be printed now */
+               zRet += cbk_print_string(pUserData, pCB, pa, length, minimum_width, left_justified);
+            }
+            else if(pe == (ps + 1))
+            {
+               char s0 = *ps;
+               if(s0 == 'l')
+               {
+                  wchar_t * pa = GET_PTR(wchar_t *);
+                  wchar_t * pe = pa;
+                  size_t length = precision; /* maximum length to be printed */
+                  if(!pa)
+                  {
+                     pa = (wchar_t *) L"<NULL>";
+                     pe = pa;
+                  }
+
+                  while (length-- && *pe)
+                     ++pe;
+
+                  length = (size_t) (pe - pa); /* contains string len to be printed now */
+                  zRet += cbk_print_wstring(pUserData, pCB, pa, length, sizeof(wchar_t), minimum_width, left_justified);
+               }
+               else
+               {
+                  pCB(pUserData, ps, 0);
+                  goto Exit;
+               }
+            }
+            else if(pe == (ps + 2))
+            {
+               char s0 = *ps;
+               if(s0 == 'l')
+               {
+                  char s1 = *(ps+1);
+                  if(s1 == '4')
+                  { /* character of 4 bytes width */
+                     static uint32_t warn[] = {'<', 'N', 'U', 'L', 'L', '>', '\0'};
+                     uint32_t * pa = GET_PTR(uint32_t *);
+                     uint32_t * pe = pa;
+                     size_t length = precision; /* maximum length to be printed */
+
+                     if(!pa)
+                     {
+                        pa = warn;
+                        pe = pa;
+                     }
+
+                     while (length-- && *pe)
+                        ++pe;
+
+                     length = (size_t) (pe - pa); /* contains string len to be printed now */
+                     zRet += cbk_print_wstring(pUserData, pCB, pa, length, sizeof(uint32_t), minimum_width, left_justified);
+                  }
+                  else if(s1 == '2')
+                  { /* character of 2 bytes width */
+                     static uint16_t warn[] = {'<', 'N', 'U', 'L', 'L', '>', '\0'};
+                     uint16_t * pa = GET_PTR(uint16_t *);
+                     uint16_t * pe = pa;
+                     size_t length = precision; /* maximum length to be printed */
+
+                     if(!pa)
+                     {
+                        pa = warn;
+                        pe = pa;
+                     }
+
+                     while (length-- && *pe)
+                        ++pe;
+
+                     length = (size_t) (pe - pa); /* contains string len to be printed now */
+                     zRet += cbk_print_wstring(pUserData, pCB, pa, length, sizeof(uint16_t), minimum_width, left_justified);
+                  }
+                  else if(s1 == '1')
+                  { /* character of 1 byte width */
+                     static uint8_t warn[] = {'<', 'N', 'U', 'L', 'L', '>', '\0'};
+                     uint8_t * pa = GET_PTR(uint8_t *);
+                     uint8_t * pe = pa;
+                     size_t length = precision; /* maximum length to be printed */
+
+                     if(!pa)
+                     {
+                        pa = warn;
+                        pe = pa;
+                     }
+
+                     while (length-- && *pe)
+                        ++pe;
+
+                     length = (size_t) (pe - pa); /* contains string len to be printed now */
+                     zRet += cbk_print_wstring(pUserData, pCB, pa, length, sizeof(uint8_t), minimum_width, left_justified);
+                  }
+                  else
+                  { /* unknown format */
+                     pCB(pUserData, ps, 0);
+                     goto Exit;
+                  }
+               }
+               else
+               { /* unknown format */
+                  pCB(pUserData, ps, 0);
+                  goto Exit;
+               }
+            }
+            else
             { /* unknown format */
                pCB(pUserData, ps, 0);
                goto Exit;
@@ -3037,7 +4256,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
          {
             if(pe == ps)
             {
-               char c = (char) va_arg(val, int);
+               char c = (char) GET_INT(int);
                zRet += cbk_print_char(pUserData, pCB, c, (precision == ~(size_t) 0) ? 1 : precision, minimum_width, left_justified);
             }
             else if(pe == (ps + 1))
@@ -3045,7 +4264,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
                char s0 = *ps;
                if(s0 == 'l')
                {
-                  wchar_t wc = (wchar_t) va_arg(val, unsigned int);
+                  wchar_t wc = (wchar_t) GET_INT(unsigned int);
                   zRet += cbk_print_wstring(pUserData, pCB, &wc, 1, sizeof(wchar_t), minimum_width, left_justified);
                }
                else
@@ -3063,17 +4282,17 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
 
                   if(s1 == '4')
                   { /* character of 4 bytes width */
-                     uint32_t wc = va_arg(val, uint32_t);
+                     uint32_t wc = GET_INT(uint32_t);
                      zRet += cbk_print_wstring(pUserData, pCB, &wc, 1, sizeof(uint32_t), minimum_width, left_justified);
                   }
                   else if(s1 == '2')
                   { /* character of 2 bytes width */
-                     uint16_t wc = (uint16_t) va_arg(val, unsigned int);
+                     uint16_t wc = (uint16_t) GET_INT(unsigned int);
                      zRet += cbk_print_wstring(pUserData, pCB, &wc, 1, sizeof(uint16_t), minimum_width, left_justified);
                   }
                   else if(s1 == '1')
                   { /* character of 1 byte width */
-                     uint8_t wc = (uint8_t) va_arg(val, unsigned int);
+                     uint8_t wc = (uint8_t) GET_INT(unsigned int);
                      zRet += cbk_print_wstring(pUserData, pCB, &wc, 1, sizeof(uint8_t), minimum_width, left_justified);
                   }
                   else
@@ -3103,7 +4322,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
                    utype u;\
                    if((fc == 'd') || (fc == 'i'))\
                    {\
-                      itype i = (itype) va_arg(val, va_itype);\
+                      itype i = (itype) GET_INT(va_itype);\
                       if(i >= 0)\
                       {\
                          u = (utype) i;\
@@ -3116,7 +4335,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
                    }\
                    else\
                    {\
-                      u = (utype) va_arg(val, va_utype);\
+                      u = (utype) GET_INT(va_utype);\
                       sign_char = '\0'; /* do not print any sign character */\
                    }\
                    if(sizeof(u) <= 4)\
@@ -3198,7 +4417,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
                {
                   if(s1 == '*')
                   {
-                     base = (uint8_t) va_arg(val, int);
+                     base = (uint8_t) GET_INT(int);
 
                      if(base > 36)
                      { /* unsupported base */
@@ -3256,7 +4475,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
                {
                   if(s1 == '*')
                   {
-                     base = (uint8_t) va_arg(val, int);
+                     base = (uint8_t) GET_INT(int);
 
                      if(base > 36)
                      { /* unsupported base */
@@ -3312,7 +4531,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
 
                   if(s1 == '*')
                   {
-                     base = (uint8_t) va_arg(val, int);
+                     base = (uint8_t) GET_INT(int);
 
                      if(base > 36)
                      { /* unsupported base */
@@ -3390,7 +4609,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
                {
                   if(s1 == '*')
                   {
-                     base = (uint8_t) va_arg(val, int);
+                     base = (uint8_t) GET_INT(int);
 
                      if(base > 36)
                      { /* unsupported base */
@@ -3450,7 +4669,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
          {
             if(pe == ps)
             {
-               void * pv = va_arg(val, void *);
+               void * pv = GET_PTR(void *);
 
                if(sizeof(pv) <= 4)
                   zRet += cbk_print_u32(pUserData, pCB, (uint32_t) (ptrdiff_t) pv, fc, '\0' /*sign_char */, prefixing, left_justified, 1, 8, minimum_width);
@@ -3467,7 +4686,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
          {
             if(pe == ps)
             {
-               double dbl = va_arg(val, double);
+               double dbl = GET_DBL(double);
                zRet += cbk_print_double(pUserData, pCB, dbl, 10, sign_char, fc, prefixing, left_justified, blank_padding, (precision == ~(size_t) 0) ? 6 : precision, minimum_width);
             }
             else if(pe == (ps + 1)) 
@@ -3476,7 +4695,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
 
                if(s0 == 'L')
                {
-                  long double ldbl = va_arg(val, long double);
+                  long double ldbl = GET_LDBL(long double);
                   zRet += cbk_print_long_double(pUserData, pCB, ldbl, 10, sign_char, fc, prefixing, left_justified, blank_padding, (precision == ~(size_t) 0) ? 6 : precision, minimum_width);
                }
                else
@@ -3497,8 +4716,8 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
 
                   if(s1 == '*')
                   {
-                     base = (uint8_t) va_arg(val, int);
-                     dbl  = va_arg(val, double);
+                     base = (uint8_t) GET_INT(int);
+                     dbl  = GET_DBL(double);
 
                      if(base > 36)
                      { /* unsupported base */
@@ -3508,7 +4727,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
                   }
                   else if(IS_DIGIT(s1))
                   {
-                     dbl  = va_arg(val, double);
+                     dbl  = GET_DBL(double);
                      base = (uint8_t) (s1 - '0');
                   }
                   else
@@ -3543,8 +4762,8 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
 
                   if(s1 == '*')
                   {
-                     base = (uint8_t) va_arg(val, int);
-                     ldbl = va_arg(val, long double);
+                     base = (uint8_t) GET_INT(int);
+                     ldbl = GET_LDBL(long double);
 
                      if(base > 36)
                      { /* unsupported base */
@@ -3554,7 +4773,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
                   }
                   else if(IS_DIGIT(s1))
                   {
-                     ldbl = va_arg(val, long double);
+                     ldbl = GET_LDBL(long double);
                      base = (uint8_t) (s1 - '0');
                   }
                   else
@@ -3586,7 +4805,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
          {
             if(pe == ps)
             {
-               double dbl = va_arg(val, double);
+               double dbl = GET_DBL(double);
                zRet += cbk_print_double(pUserData, pCB, dbl, 2, sign_char, fc, prefixing, left_justified, blank_padding, (precision == ~(size_t) 0) ? (size_t) ((DBL_MANT_DIG + 3) / 4) : precision, minimum_width);
             }
             else if(pe == (ps + 1))
@@ -3595,7 +4814,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
 
                if(s0 == 'L')
                {
-                  long double ldbl = va_arg(val, long double);
+                  long double ldbl = GET_LDBL(long double);
                   zRet += cbk_print_long_double(pUserData, pCB, ldbl, 2, sign_char, fc, prefixing, left_justified, blank_padding, (precision == ~(size_t) 0) ? (size_t) ((LDBL_MANT_DIG + 3) / 4) : precision, minimum_width);
                }
                else
@@ -3614,7 +4833,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
          {
             if(pe == ps)
             {
-               wchar_t * pa = va_arg(val, wchar_t *);
+               wchar_t * pa = GET_PTR(wchar_t *);
                wchar_t * pe = pa;
                size_t length = precision; /* maximum length to be printed */
                if(!pa)
@@ -3638,7 +4857,7 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
          {
             if(pe == ps)
             {
-               wchar_t wc = (wchar_t) va_arg(val, unsigned int);
+               wchar_t wc = (wchar_t) GET_INT(unsigned int);
                zRet += cbk_print_wstring(pUserData, pCB, &wc, 1, sizeof(wchar_t), minimum_width, left_justified);
             }
             else
@@ -3649,9 +4868,15 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
          }
          else if(fc == 'n')
          {
+            if(pArgs && ((pArgs->pArg >= pArgs->pEnd) || (pArgs->pArg->Type != PRINTF_ARG_PTR) || !pArgs->pArg->v.p))
+            { /* %n of an argument array requires a valid pointer */
+               pCB(pUserData, ps, 0);
+               goto Exit;
+            }
+
             if(pe == ps)
             {
-               int * pl = va_arg(val, int *);
+               int * pl = GET_PTR(int *);
                *pl = (int) zRet;
             }
             else if(pe == (ps + 1))
@@ -3660,22 +4885,22 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
 
                if(s0 == 'l')
                {
-                  long * pl = va_arg(val, long *);
+                  long * pl = GET_PTR(long *);
                   *pl = (long) zRet;
                }
                else if((s0 == 'z') || (s0 == 't') || (s0 == 'I'))
                {
-                  ptrdiff_t * pl = va_arg(val, ptrdiff_t *);
+                  ptrdiff_t * pl = GET_PTR(ptrdiff_t *);
                   *pl = (ptrdiff_t) zRet;
                }
                else if(s0 == 'h')
                {
-                  short * pl = va_arg(val, short *);
+                  short * pl = GET_PTR(short *);
                   *pl = (short) zRet;
                }
                else if(s0 == 'j')
                {
-                  intmax_t * pl = va_arg(val, intmax_t *);
+                  intmax_t * pl = GET_PTR(intmax_t *);
                   *pl = (intmax_t) zRet;
                }
                else
@@ -3693,219 +4918,958 @@ size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFm
                {
                   if(s1 == '8')
                   { /* integer of 8 bytes width */
-                     int64_t * pl = va_arg(val, int64_t *);
+                     int64_t * pl = GET_PTR(int64_t *);
                      *pl = (int64_t) zRet;
                   }
                   else if(s1 == '4')
                   { /* integer of 4 bytes width */
-                     int32_t * pl = va_arg(val, int32_t *);
+                     int32_t * pl = GET_PTR(int32_t *);
                      *pl = (int32_t) zRet;
                   }
                   else if(s1 == '2')
                   { /* integer of 2 bytes width */
-                     int16_t * pl = va_arg(val, int16_t *);
+                     int16_t * pl = GET_PTR(int16_t *);
                      *pl = (int16_t) zRet;
                   }
-                  else if(s1 == '1')
-                  { /* integer of 1 byte width */
-                     int8_t * pl = va_arg(val, int8_t *);
-                     *pl = (int8_t) zRet;
+                  else if(s1 == '1')
+                  { /* integer of 1 byte width */
+                     int8_t * pl = GET_PTR(int8_t *);
+                     *pl = (int8_t) zRet;
+                  }
+                  else if(s1 == 'l')
+                  {
+                     long long * pl = GET_PTR(long long *);
+                     *pl = (long long) zRet;
+                  }
+                  else
+                  { /* unknown format */
+                     pCB(pUserData, ps, 0);
+                     goto Exit;
+                  }
+               }
+               else if((s0 == 'h') && (s1 == 'h'))
+               {
+                  char * pl = GET_PTR(char *);
+                  *pl = (char) zRet;
+               }
+               else if (((s0 == 'w') || (s0 == 'I')) && (s1 == '8'))
+               { /* integer of 1 byte width */
+                  int8_t * pl = GET_PTR(int8_t *);
+                  *pl = (int8_t) zRet;
+               }
+               else
+               { /* unknown format */
+                  pCB(pUserData, ps, 0);
+                  goto Exit;
+               }
+            }
+            else if (pe == (ps + 3))
+            {
+               char s0 = *ps;
+               char s1 = *(ps + 1);
+               char s2 = *(ps + 3);
+
+               if ((s0 == 'w') || (s0 == 'I'))
+               {
+                  if ((s1 == '6') && (s2 == '4'))
+                  { /* integer of 8 bytes width */
+                     int64_t * pl = GET_PTR(int64_t *);
+                     *pl = (int64_t) zRet;
+                  }
+                  else if ((s1 == '3') && (s2 == '2'))
+                  { /* integer of 4 bytes width */
+                     int32_t * pl = GET_PTR(int32_t *);
+                     *pl = (int32_t)zRet;
+                  }
+                  else if ((s1 == '1') && (s2 == '6'))
+                  { /* integer of 2 bytes width */
+                     int16_t * pl = GET_PTR(int16_t *);
+                     *pl = (int16_t)zRet;
+                  }
+                  else
+                  { /* unknown format */
+                     pCB(pUserData, ps, 0);
+                     goto Exit;
+                  }
+               }
+               else
+               { /* unknown format */
+                  pCB(pUserData, ps, 0);
+                  goto Exit;
+               }
+            }
+            else
+            { /* unknown format */
+               pCB(pUserData, pe, 0);
+               goto Exit;
+            }
+         }
+         else if(fc == 'v')
+         {
+            if(pe == ps)
+            {
+               PRINTF_V_CALLBACK * pcbk   = pArgs ? arg_func(arg_next(pArgs)) : va_arg(val, PRINTF_V_CALLBACK *);
+               void *              pvdata = GET_PTR(void *);
+
+               if(!pcbk)
+               {
+                  pCB(pUserData, ps, 0);
+                  goto Exit;
+               }
+
+               zRet += pcbk(pUserData, pCB, pvdata, precision, minimum_width, left_justified, prefixing);
+            }
+            else
+            { /* unknown format */
+               pCB(pUserData, ps, 0);
+               goto Exit;
+            }
+         }
+         else if(fc == '}')
+         { /* named formatter */
+            PRINTF_V_CALLBACK * pcbk   = callback_printf_named(ps + 1, (size_t) (pe - ps - 1));
+            void *              pvdata = GET_PTR(void *);
+
+            if(!pcbk)
+            {
+               pCB(pUserData, ps, 0);
+               goto Exit;
+            }
+
+            zRet += pcbk(pUserData, pCB, pvdata, precision, minimum_width, left_justified, prefixing);
+         }
+         else if(fc == 'V')
+         {
+            if(pe == ps)
+            {
+               PRINTF_V_DATA * pcd = GET_PTR(PRINTF_V_DATA *);
+
+               if(!pcd || !pcd->pcb)
+               {
+                  pCB(pUserData, ps, 0);
+                  goto Exit;
+               }
+
+               zRet += pcd->pcb(pUserData, pCB, pcd, precision, minimum_width, left_justified, prefixing);
+            }
+            else
+            { /* unknown format */
+               pCB(pUserData, ps, 0);
+               goto Exit;
+            }
+         }
+         else if(fc == '@')
+         {
+            if(pe == ps)
+            {
+               const char *            pf2 = GET_PTR(const char *);
+               const PRINTF_ARG_LIST * pl  = NULL;
+               va_list                 va2;
+               size_t                  width;
+               int                     staged = 0; /* the output was printed from the staging buffer */
+
+               if(pArgs)
+               {
+                  pl = GET_PTR(const PRINTF_ARG_LIST *);
+               }
+               else
+               {
+#if PRINTF_VA_LIST_IS_ARRAY
+                  va_copy(va2, *(va_list *) va_arg(val, void *)); /* va_copy() keeps the argument unchanged */
+#else
+                  va_list      va1 = va_arg(val, va_list);
+                  va_copy(va2, va1); /* va_copy() keeps the argument unchanged */
+#endif
+               }
+
+               if(minimum_width && !left_justified)
+               { /* the output is collected on the stack for printing the padding in front of it */
+                  char         stage[PRINTF_NESTED_STAGE];
+                  PRINTF_STAGE st;
+
+                  st.pBuf   = stage;
+                  st.Length = 0;
+                  st.pError = NULL;
+                  st.Error  = 0;
+
+                  if(pArgs)
+                  {
+                     width = callback_printfa(&st, &printf_stage_callback, pf2, pl ? pl->pArgs : NULL, pl ? pl->Count : 0);
+                  }
+                  else
+                  {
+                     va_list  va3;
+                     va_copy(va3, va2);
+
+                     width = callback_printf(&st, &printf_stage_callback, pf2, va3);
+
+                     va_end(va3);
                   }
-                  else if(s1 == 'l')
+
+                  if (width < minimum_width)
                   {
-                     long long * pl = va_arg(val, long long *);
-                     *pl = (long long) zRet;
+                     minimum_width -= width;
+                     zRet += minimum_width;
+
+                     while (minimum_width > 32)
+                     {
+                        pCB(pUserData, pblanks, 32);
+                        minimum_width -= 32;
+                     }
+
+                     pCB(pUserData, pblanks, minimum_width);
+                     minimum_width = 0;
                   }
-                  else
-                  { /* unknown format */
-                     pCB(pUserData, ps, 0);
-                     goto Exit;
+
+                  if(st.Length <= PRINTF_NESTED_STAGE)
+                  { /* no second pass for output that fits into the staging buffer */
+                     if(!pArgs)
+                        va_end(va2);
+
+                     if(st.Length)
+                        pCB(pUserData, stage, st.Length);
+
+                     if(st.Error) /* report the invalid nested format like the second pass would do */
+                        pCB(pUserData, st.pError, 0);
+
+                     zRet += width;
+
+                     minimum_width = 0;
+                     staged        = 1;
                   }
                }
-               else if((s0 == 'h') && (s1 == 'h'))
+
+               if(staged)
                {
-                  char * pl = va_arg(val, char *);
-                  *pl = (char) zRet;
+                  width = 0;
                }
-               else if (((s0 == 'w') || (s0 == 'I')) && (s1 == '8'))
-               { /* integer of 1 byte width */
-                  int8_t * pl = va_arg(val, int8_t *);
-                  *pl = (int8_t) zRet;
+               else if(pArgs)
+               {
+                  width = callback_printfa(pUserData, pCB, pf2, pl ? pl->pArgs : NULL, pl ? pl->Count : 0);
                }
                else
-               { /* unknown format */
-                  pCB(pUserData, ps, 0);
-                  goto Exit;
+               {
+                  width = callback_printf(pUserData, pCB, pf2, va2);
+                  va_end(va2);
                }
-            }
-            else if (pe == (ps + 3))
-            {
-               char s0 = *ps;
-               char s1 = *(ps + 1);
-               char s2 = *(ps + 3);
 
-               if ((s0 == 'w') || (s0 == 'I'))
+               if(width >= minimum_width)
                {
-                  if ((s1 == '6') && (s2 == '4'))
-                  { /* integer of 8 bytes width */
-                     int64_t * pl = va_arg(val, int64_t *);
-                     *pl = (int64_t) zRet;
-                  }
-                  else if ((s1 == '3') && (s2 == '2'))
-                  { /* integer of 4 bytes width */
-                     int32_t * pl = va_arg(val, int32_t *);
-                     *pl = (int32_t)zRet;
-                  }
-                  else if ((s1 == '1') && (s2 == '6'))
-                  { /* integer of 2 bytes width */
-                     int16_t * pl = va_arg(val, int16_t *);
-                     *pl = (int16_t)zRet;
-                  }
-                  else
-                  { /* unknown format */
-                     pCB(pUserData, ps, 0);
-                     goto Exit;
-                  }
+                  zRet += width;
                }
                else
-               { /* unknown format */
-                  pCB(pUserData, ps, 0);
-                  goto Exit;
+               { /* add the missing blanks */
+                  zRet += minimum_width;
+                  minimum_width -= width;
+
+                  while (minimum_width > 32)
+                  {
+                     pCB(pUserData, pblanks, 32);
+                     minimum_width -= 32;
+                  }
+
+                  pCB(pUserData, pblanks, minimum_width);
                }
             }
             else
             { /* unknown format */
-               pCB(pUserData, pe, 0);
+               pCB(pUserData, ps, 0);
                goto Exit;
             }
          }
-         else if(fc == 'v')
-         {
-            if(pe == ps)
-            {
-               PRINTF_V_CALLBACK * pcbk   = va_arg(val, PRINTF_V_CALLBACK *);
-               void *              pvdata = va_arg(val, void *);
+         else
+         { /* unknown format specification -> skip all remaining string data */
+            pCB(pUserData, ps, 0);
+            goto Exit;
+         }
+
+         PROFILE_END(fc, (pe > ps) && (*ps == 'l'), (fc == 's') && (pe > ps) && ((*ps == 'J') || (*ps == 'Q') || (*ps == 'q')));
+
+         if(pArgs && pArgs->Missing)
+         { /* not enough arguments in the argument array */
+            pCB(pUserData, pe, 0);
+            goto Exit;
+         }
+
+         /* find begin of next format string */
+         pf = ++pe;
+         while(*pf && (*pf != '%'))
+            ++pf;
+
+         if(pf != pe)
+         {/* print the intermediate text until end of format string or the next percent character */
+            pCB(pUserData, pe, pf - pe);
+            PROFILE_TEXT((size_t)(pf - pe));
+            zRet += (size_t)(pf - pe);
+         }
+      }
+   }
+
+   Exit:;
+   return (zRet);
+} /* size_t printf_core(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFmt, va_list val, PRINTF_ARGS * pArgs) */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   PRINTF_COALESCE collects the small fragments of the output of
+   callback_printf and callback_printfa in a staging buffer on the stack for
+   passing them to the callback at once. Errors and fragments of at least
+   PRINTF_COALESCE_DIRECT bytes like long strings flush the staging buffer
+   and are passed directly. Reserve and commit sinks like those of sfprintf
+   and sfdprintf, the staging of %@ and callback_printfv collect the output
+   already and aren't coalesced. A
+   PRINTF_COALESCE_SIZE of 0 disables the coalescing.
+\* ------------------------------------------------------------------------- */
+#ifndef PRINTF_COALESCE_SIZE
+#define PRINTF_COALESCE_SIZE   256 /* size of the staging buffer */
+#endif
+#define PRINTF_COALESCE_DIRECT  64 /* minimum length of fragments that are passed directly */
+
+#if PRINTF_COALESCE_SIZE
+typedef struct PRINTF_COALESCE_S PRINTF_COALESCE;
+struct PRINTF_COALESCE_S
+{
+   void *            pUserData;                 /* user data of the callback */
+   PRINTF_CALLBACK * pCB;                       /* callback of the user */
+   size_t            Used;                      /* number of collected bytes */
+   char              Buf[PRINTF_COALESCE_SIZE]; /* staging buffer */
+};
+
+static void printfv_write_callback(void * pUserData, const char * pSrc, size_t Length);
+
+/* printf_coalesce_flush passes the collected bytes to the callback of the user */
+static void printf_coalesce_flush(PRINTF_COALESCE * pco)
+{
+   if(pco->Used)
+   {
+      pco->pCB(pco->pUserData, pco->Buf, pco->Used);
+      pco->Used = 0;
+   }
+} /* void printf_coalesce_flush(PRINTF_COALESCE * pco) */
+
+static void printf_coalesce_callback(void * pUserData, const char * pSrc, size_t Length)
+{
+   PRINTF_COALESCE * pco = (PRINTF_COALESCE *) pUserData;
+
+   if(Length && (Length < PRINTF_COALESCE_DIRECT))
+   {
+      if(pco->Used + Length > PRINTF_COALESCE_SIZE)
+         printf_coalesce_flush(pco);
+
+      smemcpy(pco->Buf + pco->Used, pSrc, Length);
+      pco->Used += Length;
+   }
+   else
+   { /* long fragments and errors keep their position in the output */
+      printf_coalesce_flush(pco);
+      pco->pCB(pco->pUserData, pSrc, Length);
+   }
+} /* void printf_coalesce_callback(void * pUserData, const char * pSrc, size_t Length) */
+
+/* printf_coalescing returns whether the output for pCB gets coalesced */
+static int printf_coalescing(PRINTF_CALLBACK * pCB)
+{
+   return (pCB && (pCB != &printf_coalesce_callback) && (pCB != &sink_write_callback) &&
+           (pCB != &printf_stage_callback) && (pCB != &printfv_write_callback));
+} /* int printf_coalescing(PRINTF_CALLBACK * pCB) */
+#endif
+
+
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf generates vsnprintf like character output by calling a
+   user defined write callback for the parts of the generated character data.
+   The function returns the length of the overall written data but does not
+   terminate the written output data string.
+   See implementation of svsnprintf implementation for a sample of usage.
+\* ------------------------------------------------------------------------- */
+
+size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFmt, va_list val)
+{
+#if PRINTF_COALESCE_SIZE
+   if(printf_coalescing(pCB))
+   {
+      PRINTF_COALESCE co;
+      size_t          zRet;
+
+      co.pUserData = pUserData;
+      co.pCB       = pCB;
+      co.Used      = 0;
+
+      zRet = printf_core(&co, &printf_coalesce_callback, pFmt, val, NULL);
+      printf_coalesce_flush(&co);
+
+      return (zRet);
+   }
+#endif
+
+   return (printf_core(pUserData, pCB, pFmt, val, NULL));
+} /* size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFmt, va_list val) */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   printf_array provides the unused va_list for printf_core in case of an
+   argument array.
+\* ------------------------------------------------------------------------- */
+
+static size_t printf_array(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFmt, PRINTF_ARGS * pArgs, ...)
+{
+   size_t  zRet;
+   va_list val;
+
+   va_start(val, pArgs);
+   zRet = printf_core(pUserData, pCB, pFmt, val, pArgs);
+   va_end(val);
+
+   return (zRet);
+} /* size_t printf_array(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFmt, PRINTF_ARGS * pArgs, ...) */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   callback_printfa generates the same output like callback_printf but takes
+   the arguments from an array of typed arguments.
+\* ------------------------------------------------------------------------- */
+
+size_t callback_printfa(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFmt, const PRINTF_ARG * pArgs, size_t Count)
+{
+   PRINTF_ARGS args;
+
+   args.pArg    = pArgs;
+   args.pEnd    = pArgs ? pArgs + Count : pArgs;
+   args.Missing = 0;
+
+#if PRINTF_COALESCE_SIZE
+   if(printf_coalescing(pCB))
+   {
+      PRINTF_COALESCE co;
+      size_t          zRet;
+
+      co.pUserData = pUserData;
+      co.pCB       = pCB;
+      co.Used      = 0;
+
+      zRet = printf_array(&co, &printf_coalesce_callback, pFmt, &args);
+      printf_coalesce_flush(&co);
+
+      return (zRet);
+   }
+#endif
+
+   return (printf_array(pUserData, pCB, pFmt, &args));
+} /* size_t callback_printfa(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFmt, const PRINTF_ARG * pArgs, size_t Count) */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_spec prints a single conversion of a format string that
+   was parsed in advance. The conversions s, c, p, the integer and the
+   floating point formats are supported. The arguments of '*' for width,
+   precision and base precede the value like in the format string.
+\* ------------------------------------------------------------------------- */
+
+size_t callback_printf_spec(void * pUserData, PRINTF_CALLBACK * pCB, const PRINTF_SPEC * pSpec, const PRINTF_ARG * pArgs, size_t Count)
+{
+   size_t      zRet           = 0;
+   PRINTF_ARGS args;
+   char        fc             = pSpec->Conv;
+   uint8_t     size           = pSpec->Size;
+   uint8_t     base           = pSpec->Base;
+   uint8_t     left_justified = (pSpec->Flags & PRINTF_SPEC_LEFT) ? 1 : 0;
+   uint8_t     prefixing      = (pSpec->Flags & PRINTF_SPEC_ALT)  ? 1 : 0;
+   uint8_t     blank_padding  = (pSpec->Flags & PRINTF_SPEC_ZERO) ? 0 : 1;
+   char        sign_char      = (pSpec->Flags & PRINTF_SPEC_PLUS) ? '+' : ((pSpec->Flags & PRINTF_SPEC_SPACE) ? ' ' : '\0');
+   size_t      minimum_width  = pSpec->Width;
+   size_t      precision      = pSpec->Precision;
+   PROFILE_STATE
+
+   if(!pCB)
+      goto Exit;
+
+   PROFILE_WRAP();
+   PROFILE_BEGIN();
+
+   args.pArg    = pArgs;
+   args.pEnd    = pArgs ? pArgs + Count : pArgs;
+   args.Missing = 0;
+
+   if(pSpec->Flags & PRINTF_SPEC_WIDTH_ARG)
+   {
+      int i = (int) arg_int(arg_next(&args));
+
+      if(i < 0)
+      {/* handle this according to the C standard */
+         left_justified = 1;
+         i = -i;
+      }
+
+      minimum_width = (size_t) i;
+   }
+
+   if(left_justified)
+      blank_padding = 1;
+
+   if(pSpec->Flags & PRINTF_SPEC_PREC_ARG)
+   {
+      int i = (int) arg_int(arg_next(&args));
+      precision = (i >= 0) ? (size_t) i : ~(size_t) 0;
+   }
+
+   if(pSpec->Flags & PRINTF_SPEC_BASE_ARG)
+   {
+      base = (uint8_t) arg_int(arg_next(&args));
+
+      if(base > 36)
+      { /* unsupported base */
+         pCB(pUserData, NULL, 0);
+         goto Exit;
+      }
+   }
+
+   if(args.pArg >= args.pEnd)
+   { /* missing value */
+      pCB(pUserData, NULL, 0);
+      goto Exit;
+   }
+
+   if(IS_PRINTF_FMT_INT(fc))
+   {
+      uint64_t u = arg_int(arg_next(&args));
+
+      if(size && (size < 8))
+         u &= ((uint64_t) 1 << (size * 8)) - 1;
+      else if(!size)
+         u &= 0xffffffffu;
+
+      if((fc == 'd') || (fc == 'i'))
+      {
+         uint64_t sign = (uint64_t) 1 << ((size ? size : 4) * 8 - 1);
+
+         if(u & sign)
+         {/* negative signed integer -> convert it to a positive unsigned one and set the sign character */
+            u = (~u + 1) & ((sign << 1) - 1);
+            if(!u)
+               u = sign;
+
+            sign_char = '-';
+         }
+      }
+      else
+      {
+         sign_char = '\0'; /* do not print any sign character */
+      }
+
+      if(pSpec->Flags & (PRINTF_SPEC_BASE | PRINTF_SPEC_BASE_ARG))
+         fc = (char) base;
+
+      if((size && (size <= 4)) || (!size && (u <= 0xffffffffu)))
+         zRet = cbk_print_u32(pUserData, pCB, (uint32_t) u, fc, sign_char, prefixing, left_justified, blank_padding, precision, minimum_width);
+      else
+         zRet = cbk_print_u64(pUserData, pCB, u, fc, sign_char, prefixing, left_justified, blank_padding, precision, minimum_width);
+   }
+   else if(IS_PRINTF_FMT_FLT(fc) || ((fc | 0x20) == 'a'))
+   {
+      const PRINTF_ARG * pa = arg_next(&args);
+
+      if((fc | 0x20) == 'a')
+      {
+         base = 2;
+         if(precision == ~(size_t) 0)
+            precision = (size == 16) ? (size_t) ((LDBL_MANT_DIG + 3) / 4) : (size_t) ((DBL_MANT_DIG + 3) / 4);
+      }
+      else if(!(pSpec->Flags & (PRINTF_SPEC_BASE | PRINTF_SPEC_BASE_ARG)) || !base)
+      {
+         base = 10;
+      }
+      else if (base == 1)
+      {
+         base = 16;
+      }
+
+      if(precision == ~(size_t) 0)
+         precision = 6;
+
+      if(size == 16)
+         zRet = cbk_print_long_double(pUserData, pCB, arg_ldouble(pa), base, sign_char, fc, prefixing, left_justified, blank_padding, precision, minimum_width);
+      else
+         zRet = cbk_print_double(pUserData, pCB, arg_double(pa), base, sign_char, fc, prefixing, left_justified, blank_padding, precision, minimum_width);
+   }
+   else if((fc == 'p') || (fc == 'P'))
+   {
+      void * pv = arg_ptr(arg_next(&args));
+
+      if(sizeof(pv) <= 4)
+         zRet = cbk_print_u32(pUserData, pCB, (uint32_t) (ptrdiff_t) pv, fc, '\0' /*sign_char */, prefixing, left_justified, 1, 8, minimum_width);
+      else
+         zRet = cbk_print_u64(pUserData, pCB, (uint64_t) (ptrdiff_t) pv, fc, '\0' /*sign_char */, prefixing, left_justified, 1, 16, minimum_width);
+   }
+   else if(fc == 'c')
+   {
+      uint32_t wc = (uint32_t) arg_int(arg_next(&args));
+
+      if(!size)
+      {
+         zRet = cbk_print_char(pUserData, pCB, (char) wc, (precision == ~(size_t) 0) ? 1 : precision, minimum_width, left_justified);
+      }
+      else if(size == 1)
+      {
+         uint8_t c = (uint8_t) wc;
+         zRet = cbk_print_wstring(pUserData, pCB, &c, 1, 1, minimum_width, left_justified);
+      }
+      else if(size == 2)
+      {
+         uint16_t c = (uint16_t) wc;
+         zRet = cbk_print_wstring(pUserData, pCB, &c, 1, 2, minimum_width, left_justified);
+      }
+      else
+      {
+         zRet = cbk_print_wstring(pUserData, pCB, &wc, 1, 4, minimum_width, left_justified);
+      }
+   }
+   else if(fc == 's')
+   {
+      const void * pv     = arg_ptr(arg_next(&args));
+      size_t       length = 0;
 
-               if(!pcbk)
-               {
-                  pCB(pUserData, ps, 0);
-                  goto Exit;
-               }
+      if(pSpec->Flags & (PRINTF_SPEC_JSON | PRINTF_SPEC_CSV | PRINTF_SPEC_SHELL))
+      {
+         char mode = (pSpec->Flags & PRINTF_SPEC_JSON) ? 'J' : ((pSpec->Flags & PRINTF_SPEC_CSV) ? 'Q' : 'q');
+         zRet = cbk_print_escaped(pUserData, pCB, mode, prefixing, pv, size, precision, minimum_width, left_justified);
+      }
+      else if(!size)
+      {
+         const char * pa = pv ? (const char *) pv : "<NULL>";
 
-               zRet += pcbk(pUserData, pCB, pvdata, precision, minimum_width, left_justified, prefixing);
-            }
-            else
-            { /* unknown format */
-               pCB(pUserData, ps, 0);
-               goto Exit;
-            }
-         }
-         else if(fc == 'V')
-         {
-            if(pe == ps)
-            {
-               PRINTF_V_DATA * pcd = va_arg(val, PRINTF_V_DATA *);
+         while((length < precision) && pa[length])
+            ++length;
 
-               if(!pcd || !pcd->pcb)
-               {
-                  pCB(pUserData, ps, 0);
-                  goto Exit;
-               }
+         zRet = cbk_print_string(pUserData, pCB, pa, length, minimum_width, left_justified);
+      }
+      else if(size == 1)
+      {
+         static uint8_t warn[] = {'<', 'N', 'U', 'L', 'L', '>', '\0'};
+         const uint8_t * pa = pv ? (const uint8_t *) pv : warn;
 
-               zRet += pcd->pcb(pUserData, pCB, pcd, precision, minimum_width, left_justified, prefixing);
-            }
-            else
-            { /* unknown format */
-               pCB(pUserData, ps, 0);
-               goto Exit;
-            }
-         }
-         else if(fc == '@')
-         {
-            if(pe == ps)
-            {
-               const char * pf2 = va_arg(val, const char *);
-               va_list      va1 = va_arg(val, va_list);
-               va_list      va2;
-               size_t       width;
+         while((length < precision) && pa[length])
+            ++length;
 
-               va_copy(va2, va1); /* va_copy() keeps the argument unchanged */
+         zRet = cbk_print_wstring(pUserData, pCB, (void *) pa, length, 1, minimum_width, left_justified);
+      }
+      else if(size == 2)
+      {
+         static uint16_t warn[] = {'<', 'N', 'U', 'L', 'L', '>', '\0'};
+         const uint16_t * pa = pv ? (const uint16_t *) pv : warn;
 
-               if(minimum_width && !left_justified)
-               {
-                  va_list  va3;
-                  va_copy(va3, va2);
+         while((length < precision) && pa[length])
+            ++length;
 
-                  width = svsnprintf(NULL, 0, pf2, va3); /* we need to detect the output length first */
+         zRet = cbk_print_wstring(pUserData, pCB, (void *) pa, length, 2, minimum_width, left_justified);
+      }
+      else
+      {
+         static uint32_t warn[] = {'<', 'N', 'U', 'L', 'L', '>', '\0'};
+         const uint32_t * pa = pv ? (const uint32_t *) pv : warn;
 
-                  va_end(va3);
+         while((length < precision) && pa[length])
+            ++length;
 
-                  if (width < minimum_width)
-                  {
-                     minimum_width -= width;
-                     zRet += minimum_width;
+         zRet = cbk_print_wstring(pUserData, pCB, (void *) pa, length, 4, minimum_width, left_justified);
+      }
+   }
+   else
+   { /* unsupported conversion */
+      pCB(pUserData, NULL, 0);
+   }
 
-                     while (minimum_width > 32)
-                     {
-                        pCB(pUserData, pblanks, 32);
-                        minimum_width -= 32;
-                     }
+   PROFILE_END(pSpec->Conv, size != 0, (pSpec->Flags & (PRINTF_SPEC_JSON | PRINTF_SPEC_CSV | PRINTF_SPEC_SHELL)) != 0);
 
-                     pCB(pUserData, pblanks, minimum_width);
-                     minimum_width = 0;
-                  }
-               }
+   Exit:;
+   return (zRet);
+} /* size_t callback_printf_spec(void * pUserData, PRINTF_CALLBACK * pCB, const PRINTF_SPEC * pSpec, const PRINTF_ARG * pArgs, size_t Count) */
 
-               width = callback_printf(pUserData, pCB, pf2, va2);
 
-               va_end(va2);
 
-               if(width >= minimum_width)
-               {
-                  zRet += width;
-               }
-               else
-               { /* add the missing blanks */
-                  zRet += minimum_width;
-                  minimum_width -= width;
+/* ========================================================================= *\
+   Vectored output of callback_printf
+\* ========================================================================= */
 
-                  while (minimum_width > 32)
-                  {
-                     pCB(pUserData, pblanks, 32);
-                     minimum_width -= 32;
-                  }
+#define PRINTF_V_ENTRIES   16   /* number of fragments that are collected for a call of the vectored callback */
+#define PRINTF_V_STAGING  256   /* size of the staging buffer for small fragments */
+#define PRINTF_V_SMALL     32   /* maximum length of fragments that are copied into the staging buffer */
 
-                  pCB(pUserData, pblanks, minimum_width);
-               }
-            }
-            else
-            { /* unknown format */
-               pCB(pUserData, ps, 0);
-               goto Exit;
-            }
-         }
-         else
-         { /* unknown format specification -> skip all remaining string data */
-            pCB(pUserData, ps, 0);
-            goto Exit;
-         }
+/* ------------------------------------------------------------------------- *\
+   PRINTF_V_STATE collects the fragments for callback_printfv.
+\* ------------------------------------------------------------------------- */
 
-         /* find begin of next format string */
-         pf = ++pe;
-         while(*pf && (*pf != '%'))
-            ++pf;
+typedef struct PRINTF_V_STATE_S PRINTF_V_STATE;
+struct PRINTF_V_STATE_S
+{
+   void *              pUserData;               /* user specific context for the vectored callback */
+   PRINTF_CALLBACK_V * pCBV;                    /* vectored callback */
+   const char *        pFmt;                    /* begin of the format string */
+   const char *        pFmtEnd;                 /* end of the format string */
+   size_t              Count;                   /* number of collected fragments */
+   size_t              Used;                    /* used length of the staging buffer */
+   PRINTF_IOVEC        Vec[PRINTF_V_ENTRIES];   /* collected fragments */
+   char                Buf[PRINTF_V_STAGING];   /* staging buffer for small fragments */
+};
 
-         if(pf != pe)
-         {/* print the intermediate text until end of format string or the next percent character */
-            pCB(pUserData, pe, pf - pe);
-            zRet += (size_t)(pf - pe);
+
+/* ------------------------------------------------------------------------- *\
+   printfv_flush calls the vectored callback for all collected fragments.
+\* ------------------------------------------------------------------------- */
+
+static void printfv_flush(PRINTF_V_STATE * pvs)
+{
+   if(pvs->Count)
+   {
+      pvs->pCBV(pvs->pUserData, pvs->Vec, pvs->Count);
+      pvs->Count = 0;
+      pvs->Used  = 0;
+   }
+} /* void printfv_flush(PRINTF_V_STATE * pvs) */
+
+
+/* ------------------------------------------------------------------------- *\
+   printfv_write_callback is the callback for callback_printf that is used
+   by callback_printfv. Small fragments are copied to the staging buffer.
+   Fragments of the format string and the padding characters are collected
+   as references. Other big fragments may be temporary data of the calling
+   function and are passed to the vectored callback immediately.
+\* ------------------------------------------------------------------------- */
+
+static void printfv_write_callback(void * pUserData, const char * pSrc, size_t Length)
+{
+   PRINTF_V_STATE * pvs = (PRINTF_V_STATE *) pUserData;
+   PRINTF_IOVEC *   pv;
+
+   if(!Length)
+   { /* error in format string */
+      if(pvs->Count == PRINTF_V_ENTRIES)
+         printfv_flush(pvs);
+
+      pv = pvs->Vec + pvs->Count++;
+      pv->pSrc   = pSrc;
+      pv->Length = 0;
+      printfv_flush(pvs);
+   }
+   else if(Length <= PRINTF_V_SMALL)
+   {
+      char * pd;
+
+      if(pvs->Used + Length > PRINTF_V_STAGING)
+         printfv_flush(pvs);
+
+      pd = pvs->Buf + pvs->Used;
+
+      if(pvs->Count && (pv = pvs->Vec + pvs->Count - 1) && (pv->pSrc + pv->Length == pd))
+      { /* append to the previous fragment */
+         pv->Length += Length;
+      }
+      else
+      {
+         if(pvs->Count == PRINTF_V_ENTRIES)
+         {
+            printfv_flush(pvs);
+            pd = pvs->Buf;
          }
+
+         pv = pvs->Vec + pvs->Count++;
+         pv->pSrc   = pd;
+         pv->Length = Length;
       }
+
+      pvs->Used += Length;
+
+      while(Length--)
+         *pd++ = *pSrc++;
+   }
+   else
+   {
+      if(pvs->Count == PRINTF_V_ENTRIES)
+         printfv_flush(pvs);
+
+      pv = pvs->Vec + pvs->Count++;
+      pv->pSrc   = pSrc;
+      pv->Length = Length;
+
+      if(((pSrc < pvs->pFmt) || (pSrc >= pvs->pFmtEnd)) && (pSrc != pblanks) && (pSrc != pzeros))
+         printfv_flush(pvs); /* the data may be invalid after returning */
    }
+} /* void printfv_write_callback(void * pUserData, const char * pSrc, size_t Length) */
+
+
+/* ------------------------------------------------------------------------- *\
+   callback_printfv generates vsnprintf like character output by calling a
+   user defined vectored write callback for the collected fragments of the
+   generated character data.
+\* ------------------------------------------------------------------------- */
+
+size_t callback_printfv(void * pUserData, PRINTF_CALLBACK_V * pCBV, const char * pFmt, va_list val)
+{
+   size_t         zRet = 0;
+   PRINTF_V_STATE vs;
+   const char *   pe = pFmt;
+
+   if(!pCBV)
+      goto Exit;
+
+   if(pe)
+      while(*pe)
+         ++pe;
+
+   vs.pUserData = pUserData;
+   vs.pCBV      = pCBV;
+   vs.pFmt      = pFmt;
+   vs.pFmtEnd   = pe;
+   vs.Count     = 0;
+   vs.Used      = 0;
+
+   zRet = callback_printf(&vs, &printfv_write_callback, pFmt, val);
+
+   printfv_flush(&vs);
 
    Exit:;
    return (zRet);
-} /* size_t callback_printf(void * pUserData, PRINTF_CALLBACK * pCB, const char * pFmt, va_list val) */
+} /* size_t callback_printfv(void * pUserData, PRINTF_CALLBACK_V * pCBV, const char * pFmt, va_list val) */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_sink generates the same output like callback_printf but
+   the numbers, the padded strings and the characters are written directly
+   into the memory that the reserve callback of the sink provides. The copy
+   callback of the sink is used for the remaining output and if the reserve
+   callback returns NULL.
+\* ------------------------------------------------------------------------- */
+
+size_t callback_printf_sink(PRINTF_SINK * pSink, const char * pFmt, va_list val)
+{
+   size_t zRet = 0;
+
+   if(!pSink || !pSink->pCB)
+      goto Exit;
+
+   if(!pSink->pReserve || !pSink->pCommit)
+      zRet = callback_printf(pSink->pUserData, pSink->pCB, pFmt, val);
+   else
+      zRet = callback_printf(pSink, &sink_write_callback, pFmt, val);
+
+   Exit:;
+   return (zRet);
+} /* size_t callback_printf_sink(PRINTF_SINK * pSink, const char * pFmt, va_list val) */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_sink_callback returns the callback that writes into a
+   PRINTF_SINK that is passed as user data.
+\* ------------------------------------------------------------------------- */
+
+PRINTF_CALLBACK * callback_printf_sink_callback(void)
+{
+   return (&sink_write_callback);
+} /* PRINTF_CALLBACK * callback_printf_sink_callback(void) */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   callback_printfa_sink is the variant of callback_printf_sink for an
+   array of typed arguments.
+\* ------------------------------------------------------------------------- */
+
+size_t callback_printfa_sink(PRINTF_SINK * pSink, const char * pFmt, const PRINTF_ARG * pArgs, size_t Count)
+{
+   size_t zRet = 0;
+
+   if(!pSink || !pSink->pCB)
+      goto Exit;
+
+   if(!pSink->pReserve || !pSink->pCommit)
+      zRet = callback_printfa(pSink->pUserData, pSink->pCB, pFmt, pArgs, Count);
+   else
+      zRet = callback_printfa(pSink, &sink_write_callback, pFmt, pArgs, Count);
+
+   Exit:;
+   return (zRet);
+} /* size_t callback_printfa_sink(PRINTF_SINK * pSink, const char * pFmt, const PRINTF_ARG * pArgs, size_t Count) */
+
+
+/* ========================================================================= *\
+   Fragment statistics of the output
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_fragments_init clears the counters of a PRINTF_FRAGMENTS
+   and sets the callback that gets the output passed through.
+\* ------------------------------------------------------------------------- */
+
+void callback_printf_fragments_init(PRINTF_FRAGMENTS * pFragments, void * pUserData, PRINTF_CALLBACK * pCB)
+{
+   int i;
+
+   pFragments->pUserData = pUserData;
+   pFragments->pCB       = pCB;
+   pFragments->Fragments = 0;
+   pFragments->Bytes     = 0;
+   pFragments->Errors    = 0;
+
+   for(i = 0; i < PRINTF_FRAGMENT_BUCKETS; ++i)
+      pFragments->Histogram[i] = 0;
+} /* void callback_printf_fragments_init(PRINTF_FRAGMENTS * pFragments, void * pUserData, PRINTF_CALLBACK * pCB) */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_fragments counts a fragment in the size class of its
+   length and passes it to the wrapped callback. A fragment of length zero
+   is an error report and is counted separately.
+\* ------------------------------------------------------------------------- */
+
+void callback_printf_fragments(void * pUserData, const char * pSrc, size_t Length)
+{
+   PRINTF_FRAGMENTS * pfs = (PRINTF_FRAGMENTS *) pUserData;
+
+   if(!Length)
+   {
+      ++pfs->Errors;
+   }
+   else
+   {
+      size_t n      = Length - 1;
+      int    bucket = 0;
+
+      while(n && (bucket < PRINTF_FRAGMENT_BUCKETS - 1))
+      { /* 1, 2, 3-4, 5-8 ... */
+         n >>= 1;
+         ++bucket;
+      }
+
+      ++pfs->Histogram[bucket];
+      ++pfs->Fragments;
+      pfs->Bytes += Length;
+   }
+
+   if(pfs->pCB)
+      pfs->pCB(pfs->pUserData, pSrc, Length);
+} /* void callback_printf_fragments(void * pUserData, const char * pSrc, size_t Length) */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_fragment_bucket returns the maximum fragment length of a
+   size class of the histogram or 0 for the last one without a limit.
+\* ------------------------------------------------------------------------- */
+
+size_t callback_printf_fragment_bucket(int Bucket)
+{
+   if((Bucket < 0) || (Bucket >= PRINTF_FRAGMENT_BUCKETS - 1))
+      return (0);
+
+   return ((size_t) 1 << Bucket);
+} /* size_t callback_printf_fragment_bucket(int Bucket) */
 
 
 /* ========================================================================= *\
@@ -3970,6 +5934,26 @@ static void vsnprintf_write_callback(void * pUserData, const char * pSrc, size_t
 } /* void  vsnprintf_write_callback(void * pUserData, const char * pSrc, size_t Length) */
 
 
+/* ------------------------------------------------------------------------- *\
+   vsnprintf_reserve and vsnprintf_commit let callback_printf_sink write
+   directly into the destination buffer as long as the data fit into it.
+\* ------------------------------------------------------------------------- */
+
+static char * vsnprintf_reserve(void * pUserData, size_t Length)
+{
+   STRING_WRITE_DATA * pwd = (STRING_WRITE_DATA *) pUserData;
+   return ((Length <= pwd->DstSize) ? pwd->pDst : NULL);
+} /* char * vsnprintf_reserve(void * pUserData, size_t Length) */
+
+static void vsnprintf_commit(void * pUserData, size_t Length)
+{
+   STRING_WRITE_DATA * pwd = (STRING_WRITE_DATA *) pUserData;
+   pwd->pDst    += Length;
+   pwd->DstSize -= Length;
+} /* void vsnprintf_commit(void * pUserData, size_t Length) */
+
+
+
 
 /* ------------------------------------------------------------------------- *\
    svsprintf is a wrapper for vsprintf that bases on callback_printf.
@@ -3987,7 +5971,15 @@ size_t svsnprintf(char * pDst, size_t n, const char * pFmt, va_list val)
       0
    };
 
-   size_t zRet = callback_printf(&swd, &vsnprintf_write_callback, pFmt, val);
+   PRINTF_SINK sink =
+   {
+      &swd,
+      &vsnprintf_write_callback,
+      &vsnprintf_reserve,
+      &vsnprintf_commit
+   };
+
+   size_t zRet = callback_printf_sink(&sink, pFmt, val);
 
    if(n <= zRet)
    {
@@ -4023,7 +6015,15 @@ size_t svsprintf(char * pDst, const char * pFmt, va_list val)
       0
    };
 
-   size_t zRet = callback_printf(&swd, &vsnprintf_write_callback, pFmt, val);
+   PRINTF_SINK sink =
+   {
+      &swd,
+      &vsnprintf_write_callback,
+      &vsnprintf_reserve,
+      &vsnprintf_commit
+   };
+
+   size_t zRet = callback_printf_sink(&sink, pFmt, val);
    pDst[zRet] = '\0';
 
    if(swd.Err)
@@ -4115,7 +6115,15 @@ size_t svsnprintfu(char * pDst, size_t n, const char * pFmt, va_list val)
       0
    };
 
-   size_t zRet = callback_printf(&swd, &vsnprintf_write_callback, pFmt, val);
+   PRINTF_SINK sink =
+   {
+      &swd,
+      &vsnprintf_write_callback,
+      &vsnprintf_reserve,
+      &vsnprintf_commit
+   };
+
+   size_t zRet = callback_printf_sink(&sink, pFmt, val);
 
    if(swd.Err)
       errno = swd.Err;
@@ -4142,7 +6150,15 @@ size_t svsprintfu(char * pDst, const char * pFmt, va_list val)
       0
    };
 
-   size_t zRet = callback_printf(&swd, &vsnprintf_write_callback, pFmt, val);
+   PRINTF_SINK sink =
+   {
+      &swd,
+      &vsnprintf_write_callback,
+      &vsnprintf_reserve,
+      &vsnprintf_commit
+   };
+
+   size_t zRet = callback_printf_sink(&sink, pFmt, val);
 
    if(swd.Err)
       errno = swd.Err;
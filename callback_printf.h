@@ -231,11 +231,98 @@ typedef void (PRINTF_CALLBACK) (void * pUserData, const char * pSrc, size_t Leng
    callback_printf generates vsnprintf like character output by calling a
    user defined write callback for the parts of the generated character data.
    The function returns the length of the overall written data but does not
-   terminate the written output data string.
+   terminate the written output data string. Small parts are collected in a
+   buffer of 256 bytes on the stack and passed at once, long strings are
+   passed directly.
    See implementation of svsnprintf implementation for a sample of usage.
 \* ------------------------------------------------------------------------- */
 size_t callback_printf (void * pUserData, PRINTF_CALLBACK * pCB, const char * pFmt, va_list val);
 
+/* ------------------------------------------------------------------------- *\
+   PRINTF_IOVEC describes a single fragment of the output of callback_printfv.
+\* ------------------------------------------------------------------------- */
+typedef struct PRINTF_IOVEC_S PRINTF_IOVEC;
+struct PRINTF_IOVEC_S
+{
+   const char * pSrc;   /* pointer to the data of the fragment */
+   size_t       Length; /* length of the data of the fragment */
+};
+
+/* ------------------------------------------------------------------------- *\
+  User defined vectored callback function for callback_printfv for writing
+  Count fragments of the output data at once. If the length of a fragment
+  is zero then there is an error in format string and pSrc points to the
+  problematic position in format string if it is not NULL. Such a fragment
+  is always the last one of the last call.
+\* ------------------------------------------------------------------------- */
+typedef void (PRINTF_CALLBACK_V) (void * pUserData, const PRINTF_IOVEC * pVec, size_t Count);
+
+/* ------------------------------------------------------------------------- *\
+   callback_printfv generates the same output like callback_printf but
+   collects the fragments in a little array on the stack and calls the
+   vectored callback only if that array is full or at the end of the output.
+   Small fragments are copied into a staging buffer on the stack and adjacent
+   ones are merged into a single fragment. The fragments are valid during
+   the call of the callback only.
+\* ------------------------------------------------------------------------- */
+size_t callback_printfv (void * pUserData, PRINTF_CALLBACK_V * pCBV, const char * pFmt, va_list val);
+
+/* ------------------------------------------------------------------------- *\
+   User defined reserve and commit callbacks of a sink. PRINTF_RESERVE
+   returns a pointer to at least Length bytes of the sink memory or NULL if
+   there is not enough space. PRINTF_COMMIT appends Length bytes of the
+   reserved memory to the output.
+\* ------------------------------------------------------------------------- */
+typedef char * (PRINTF_RESERVE) (void * pUserData, size_t Length);
+typedef void   (PRINTF_COMMIT)  (void * pUserData, size_t Length);
+
+typedef struct PRINTF_SINK_S PRINTF_SINK;
+struct PRINTF_SINK_S
+{
+   void *            pUserData; /* user specific context of the callbacks */
+   PRINTF_CALLBACK * pCB;       /* copy callback for the data that are not written into reserved memory */
+   PRINTF_RESERVE *  pReserve;  /* reserves sink memory or NULL if unsupported */
+   PRINTF_COMMIT *   pCommit;   /* commits the reserved memory */
+};
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_sink generates the same output like callback_printf but
+   the numbers, the padded strings and characters are written directly into
+   the reserved memory of the sink. %v and %V callbacks get the PRINTF_SINK
+   as user data and must use the provided callback for their output.
+\* ------------------------------------------------------------------------- */
+size_t callback_printf_sink (PRINTF_SINK * pSink, const char * pFmt, va_list val);
+
+/* ------------------------------------------------------------------------- *\
+   PRINTF_FRAGMENTS is the user data of callback_printf_fragments, a
+   diagnostic callback that counts the fragments of the output and their
+   sizes before it passes them to the wrapped callback. The histogram counts
+   the fragments of 1, 2, 3-4, 5-8, 9-16, 17-32, 33-64, 65-128, 129-256 and
+   more bytes.
+\* ------------------------------------------------------------------------- */
+#define PRINTF_FRAGMENT_BUCKETS 10 /* number of size classes of the histogram */
+
+typedef struct PRINTF_FRAGMENTS_S PRINTF_FRAGMENTS;
+struct PRINTF_FRAGMENTS_S
+{
+   void *            pUserData;                          /* user data of the wrapped callback */
+   PRINTF_CALLBACK * pCB;                                /* wrapped callback or NULL for just counting */
+   size_t            Fragments;                          /* number of fragments */
+   size_t            Bytes;                              /* number of bytes of all fragments */
+   size_t            Errors;                             /* number of reported errors of the format string */
+   size_t            Histogram[PRINTF_FRAGMENT_BUCKETS]; /* number of fragments per size class */
+};
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_fragments_init clears the counters and sets the wrapped
+   callback. callback_printf_fragments is the callback that gets the
+   PRINTF_FRAGMENTS as user data. callback_printf_fragment_bucket returns
+   the maximum fragment size of a size class or 0 for the last one.
+\* ------------------------------------------------------------------------- */
+void   callback_printf_fragments_init  (PRINTF_FRAGMENTS * pFragments, void * pUserData, PRINTF_CALLBACK * pCB);
+void   callback_printf_fragments       (void * pUserData, const char * pSrc, size_t Length);
+size_t callback_printf_fragment_bucket (int Bucket);
+
 
 /* ========================================================================= *\
    User defined output function for %v or %V option
@@ -320,6 +407,230 @@ struct PRINTF_V_DATA_S
 #endif
 
 
+/* ========================================================================= *\
+   Named formatters for %{name}
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   PRINTF_NAMED_FORMATTER registers a PRINTF_V_CALLBACK under a name. A
+   %{name} in the format string takes a single void * argument and calls
+   the callback like %v but without the additional function pointer. The
+   flags, the width and the precision may precede the brace, e.g. %-40{ipv6}.
+   A name consists of up to 32 letters, digits and '_'.
+\* ------------------------------------------------------------------------- */
+typedef struct PRINTF_NAMED_FORMATTER_S PRINTF_NAMED_FORMATTER;
+struct PRINTF_NAMED_FORMATTER_S
+{
+   const char *        pName; /* name of the formatter */
+   PRINTF_V_CALLBACK * pcb;   /* output function callback */
+};
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_register adds a list of named formatters. Every call
+   builds a new immutable perfect hash table of all names and publishes it
+   atomically, so the lookup of the names is lock free. Registering is
+   meant for the startup of an application because the replaced tables are
+   kept for threads that might still use them. The function returns 0 on
+   success, EINVAL for an invalid name, EEXIST for a name that is already
+   registered or ENOMEM.
+\* ------------------------------------------------------------------------- */
+int callback_printf_register (const PRINTF_NAMED_FORMATTER * pList, size_t Count);
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_named returns the callback of a registered name or NULL.
+   The result of a registered name never changes and may be cached.
+\* ------------------------------------------------------------------------- */
+PRINTF_V_CALLBACK * callback_printf_named (const char * pName, size_t Length);
+
+
+
+/* ========================================================================= *\
+   Typed argument arrays instead of a va_list
+\* ========================================================================= */
+
+#define PRINTF_ARG_INT     1 /* signed integer in i */
+#define PRINTF_ARG_UINT    2 /* unsigned integer in u */
+#define PRINTF_ARG_DOUBLE  3 /* floating point number in d */
+#define PRINTF_ARG_LDOUBLE 4 /* long double in ld */
+#define PRINTF_ARG_PTR     5 /* pointer in p */
+#define PRINTF_ARG_FUNC    6 /* PRINTF_V_CALLBACK pointer in f for %v */
+
+/* ------------------------------------------------------------------------- *\
+   PRINTF_ARG is a single typed argument of callback_printfa. The value gets
+   converted to the type that the format specification requires. So a
+   float argument for %d is printed as integer and an integer for %f as
+   floating point number.
+\* ------------------------------------------------------------------------- */
+typedef struct PRINTF_ARG_S PRINTF_ARG;
+struct PRINTF_ARG_S
+{
+   int Type;                /* PRINTF_ARG_INT, PRINTF_ARG_UINT, ... */
+   union
+   {
+      int64_t             i;
+      uint64_t            u;
+      double              d;
+      long double         ld;
+      const void *        p;
+      PRINTF_V_CALLBACK * f;
+   } v;
+};
+
+/* ------------------------------------------------------------------------- *\
+   PRINTF_ARG_LIST is the argument of a %@ nested format specification in
+   an argument array. The format string is the argument in front of it.
+\* ------------------------------------------------------------------------- */
+typedef struct PRINTF_ARG_LIST_S PRINTF_ARG_LIST;
+struct PRINTF_ARG_LIST_S
+{
+   const PRINTF_ARG * pArgs; /* argument array */
+   size_t             Count; /* number of arguments */
+};
+
+/* ------------------------------------------------------------------------- *\
+   callback_printfa generates the same output like callback_printf but takes
+   the arguments from an array of typed arguments. A missing argument and
+   an argument of %n that isn't a non NULL PRINTF_ARG_PTR are reported as
+   error in the format string like an unknown format.
+\* ------------------------------------------------------------------------- */
+size_t callback_printfa (void * pUserData, PRINTF_CALLBACK * pCB, const char * pFmt, const PRINTF_ARG * pArgs, size_t Count);
+
+/* ------------------------------------------------------------------------- *\
+   callback_printfa_sink is the variant of callback_printf_sink for an
+   array of typed arguments.
+\* ------------------------------------------------------------------------- */
+size_t callback_printfa_sink (PRINTF_SINK * pSink, const char * pFmt, const PRINTF_ARG * pArgs, size_t Count);
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_sink_callback returns the callback that writes into a
+   PRINTF_SINK that is passed as user data to callback_printf,
+   callback_printfa or callback_printf_spec. This way the formatting of
+   parts of a format string still uses the reserve and commit callbacks.
+\* ------------------------------------------------------------------------- */
+PRINTF_CALLBACK * callback_printf_sink_callback (void);
+
+
+/* ========================================================================= *\
+   Conversions that were parsed in advance
+\* ========================================================================= */
+
+#define PRINTF_SPEC_LEFT      0x0001 /* '-' flag */
+#define PRINTF_SPEC_ALT       0x0002 /* '#' flag */
+#define PRINTF_SPEC_ZERO      0x0004 /* '0' flag */
+#define PRINTF_SPEC_PLUS      0x0008 /* '+' flag */
+#define PRINTF_SPEC_SPACE     0x0010 /* ' ' flag */
+#define PRINTF_SPEC_WIDTH_ARG 0x0020 /* width is an argument '*' */
+#define PRINTF_SPEC_PREC_ARG  0x0040 /* precision is an argument '.*' */
+#define PRINTF_SPEC_BASE      0x0080 /* numeric base is specified by %r */
+#define PRINTF_SPEC_BASE_ARG  0x0100 /* numeric base is an argument %r* */
+#define PRINTF_SPEC_JSON      0x0200 /* JSON string escaping %Js */
+#define PRINTF_SPEC_CSV       0x0400 /* CSV field quoting %Qs */
+#define PRINTF_SPEC_SHELL     0x0800 /* shell word quoting %qs */
+
+/* ------------------------------------------------------------------------- *\
+   PRINTF_SPEC describes a single conversion of a format string.
+\* ------------------------------------------------------------------------- */
+typedef struct PRINTF_SPEC_S PRINTF_SPEC;
+struct PRINTF_SPEC_S
+{
+   char     Conv;      /* conversion character s, c, p, P, an integer or a floating point format */
+   uint8_t  Size;      /* size of integers and characters in bytes, 16 for long double or 0 for int, char and double */
+   uint8_t  Base;      /* numeric base of %r */
+   uint16_t Flags;     /* PRINTF_SPEC_... flags */
+   size_t   Width;     /* minimum field width */
+   size_t   Precision; /* precision or ~(size_t) 0 if unspecified */
+};
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_spec prints a single conversion that was parsed in
+   advance (e.g. at compile time by callback_printf.hpp). The arguments for
+   '*' of width, precision and base precede the value. Other conversions
+   than s, c, p, the integer and the floating point formats are reported as
+   error.
+\* ------------------------------------------------------------------------- */
+size_t callback_printf_spec (void * pUserData, PRINTF_CALLBACK * pCB, const PRINTF_SPEC * pSpec, const PRINTF_ARG * pArgs, size_t Count);
+
+
+/* ========================================================================= *\
+   Profiling counters of the conversions
+
+   If callback_printf.c is compiled with CALLBACK_PRINTF_PROFILE defined then
+   every successful conversion increments thread local counters of its
+   conversion type. Without CALLBACK_PRINTF_PROFILE neither the counters nor
+   the following functions exist.
+\* ========================================================================= */
+
+#ifdef CALLBACK_PRINTF_PROFILE
+
+#define PRINTF_PROFILE_TEXT    0 /* literal text of the format and %% */
+#define PRINTF_PROFILE_D       1 /* %d %i */
+#define PRINTF_PROFILE_U       2 /* %u */
+#define PRINTF_PROFILE_O       3 /* %o */
+#define PRINTF_PROFILE_X       4 /* %x %X */
+#define PRINTF_PROFILE_B       5 /* %b %B */
+#define PRINTF_PROFILE_F       6 /* %f %F */
+#define PRINTF_PROFILE_E       7 /* %e %E */
+#define PRINTF_PROFILE_G       8 /* %g %G */
+#define PRINTF_PROFILE_A       9 /* %a %A */
+#define PRINTF_PROFILE_CHAR   10 /* %c */
+#define PRINTF_PROFILE_LCHAR  11 /* %lc %l1c %l2c %l4c %C */
+#define PRINTF_PROFILE_STR    12 /* %s */
+#define PRINTF_PROFILE_LSTR   13 /* %ls %l1s %l2s %l4s %S */
+#define PRINTF_PROFILE_ESC    14 /* %Js %Qs %qs */
+#define PRINTF_PROFILE_P      15 /* %p %P */
+#define PRINTF_PROFILE_N      16 /* %n */
+#define PRINTF_PROFILE_V      17 /* %v %V */
+#define PRINTF_PROFILE_NAMED  18 /* %{name} */
+#define PRINTF_PROFILE_NESTED 19 /* %@ */
+#define PRINTF_PROFILE_COUNT  20 /* number of conversion types */
+
+/* ------------------------------------------------------------------------- *\
+   PRINTF_PROFILE_COUNTER contains the counters of a conversion type. Ticks
+   are the sampled time stamp counter cycles on x86 and the nanoseconds
+   elsewhere. The conversions of a %@ or of a %v that calls callback_printf
+   are counted in addition to the outer conversion.
+\* ------------------------------------------------------------------------- */
+typedef struct PRINTF_PROFILE_COUNTER_S PRINTF_PROFILE_COUNTER;
+struct PRINTF_PROFILE_COUNTER_S
+{
+   uint64_t Calls;     /* number of conversions */
+   uint64_t Bytes;     /* number of output bytes */
+   uint64_t Callbacks; /* number of output fragments or commits of a reserve and commit sink */
+   uint64_t Samples;   /* number of conversions that were timed */
+   uint64_t Ticks;     /* sum of the ticks of the timed conversions */
+};
+
+typedef struct PRINTF_PROFILE_S PRINTF_PROFILE;
+struct PRINTF_PROFILE_S
+{
+   PRINTF_PROFILE_COUNTER Conv[PRINTF_PROFILE_COUNT]; /* counters indexed by PRINTF_PROFILE_... */
+};
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_profile_snapshot copies the counters of the calling
+   thread, callback_printf_profile_reset clears them and
+   callback_printf_profile_merge adds the counters of a snapshot to pTotal
+   for aggregating the snapshots of several threads.
+\* ------------------------------------------------------------------------- */
+void callback_printf_profile_snapshot (PRINTF_PROFILE * pProfile);
+void callback_printf_profile_reset    (void);
+void callback_printf_profile_merge    (PRINTF_PROFILE * pTotal, const PRINTF_PROFILE * pProfile);
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_profile_sampling times every Interval-th conversion of
+   each thread. The default Interval 0 disables the timing.
+\* ------------------------------------------------------------------------- */
+void callback_printf_profile_sampling (unsigned int Interval);
+
+/* ------------------------------------------------------------------------- *\
+   callback_printf_profile_name returns a short name of a conversion type
+   like "d" or "ls" or NULL for an invalid type.
+\* ------------------------------------------------------------------------- */
+const char * callback_printf_profile_name (int Conversion);
+
+#endif /* CALLBACK_PRINTF_PROFILE */
+
+
 #ifdef __cplusplus
 }/* extern "C" */
 #endif
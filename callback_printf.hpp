@@ -0,0 +1,1160 @@
+/*****************************************************************************\
+*                                                                             *
+*  FILE NAME:     callback_printf.hpp                                         *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  DESCRIPTION:   header only C++17 front end of callback_printf              *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  COPYRIGHT:     (c) 2026 Dipl.-Ing. Klaus Lux (Aachen, Germany)             *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  ORIGIN:        https://github.com/klux21/callback_printf                   *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+* Civil Usage Public License, Version 1.2, June 2026                          *
+*                                                                             *
+* Redistribution and use in source and binary forms, with or without          *
+* modification, are permitted provided that the following conditions are met: *
+*                                                                             *
+* 1. Redistributions of source code must retain the above copyright           *
+*    notice, this list of conditions, the explanation of terms                *
+*    and the following disclaimer.                                            *
+*                                                                             *
+* 2. Redistributions in binary form must reproduce the above copyright        *
+*    notice, this list of conditions and the following disclaimer in the      *
+*    documentation or other materials provided with the distribution.         *
+*                                                                             *
+* 3. All modified files must carry prominent notices stating that the         *
+*    files have been changed.                                                 *
+*                                                                             *
+* 4. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are designed or           *
+*    intended to harm, to kill or to forcibly immobilize people.              *
+*                                                                             *
+* 5. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are intended to           *
+*    monitor, to track, to change or to control the behavior, the             *
+*    constitution, the location or the communication of any people or         *
+*    their property without the explicit and prior agreement of those         *
+*    people except those devices and systems are solely designed for          *
+*    saving or protecting peoples life or health.                             *
+*                                                                             *
+* 6. The source code and binary forms and any derivative works are not        *
+*    stored or executed in any systems or devices that are intended           *
+*    for the production of any of the systems or devices that                 *
+*    have been stated before except the ones for saving or protecting         *
+*    peoples life or health only.                                             *
+*                                                                             *
+* The term 'systems' in all clauses shall include all types and combinations  *
+* of physical, virtualized or simulated hardware and software and any kind    *
+* of data storage.                                                            *
+*                                                                             *
+* The term 'devices' shall include any kind of local or non-local control     *
+* system of the stated devices as part of that device as well. Any assembly   *
+* of more than one device is one and the same device regarding this license.  *
+*                                                                             *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" *
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   *
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  *
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   *
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         *
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        *
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    *
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     *
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     *
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  *
+* POSSIBILITY OF SUCH DAMAGE.                                                 *
+*                                                                             *
+\*****************************************************************************/
+
+#ifndef CALLBACK_PRINTF_HPP
+#define CALLBACK_PRINTF_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <callback_printf.h>
+
+/* ========================================================================= *\
+   cbp::format_to, cbp::snprintf and cbp::sprintf pack their arguments into
+   a typed argument array on the stack and call callback_printfa. There is
+   no va_list and no default argument promotion and the printf extensions
+   like %v and %@ can be used without the unchecked _ssprintf variants.
+
+      char buf[64];
+      cbp::snprintf(buf, sizeof(buf), "%s=%d %-8.3f", "x", 42, 3.14159);
+      cbp::format_to([&](const char * ps, size_t n) { out.append(ps, n); }, "%#x", 255u);
+
+   A nested %@ format takes the result of cbp::nested(fmt, args...).
+\* ========================================================================= */
+
+namespace cbp
+{
+   /* ------------------------------------------------------------------------- *\
+      nested_args keeps the format string and the arguments of a %@ output.
+      The list gets pointed to the arguments when they are stored for a call
+      because the object may have been copied or moved since nested().
+   \* ------------------------------------------------------------------------- */
+   template<size_t N>
+   struct nested_args
+   {
+      const char *            fmt;
+      PRINTF_ARG              args[N ? N : 1];
+      mutable PRINTF_ARG_LIST list;
+   };
+
+   namespace detail
+   {
+      template<class T> struct dependent_false : std::false_type {};
+
+      template<class T> struct is_basic_string : std::false_type {};
+      template<class C, class Tr, class A> struct is_basic_string<std::basic_string<C, Tr, A>> : std::true_type {};
+
+      template<class T> struct is_nested : std::false_type {};
+      template<size_t N> struct is_nested<nested_args<N>> : std::true_type {};
+
+      /* number of array entries that an argument requires */
+      template<class T>
+      constexpr size_t arg_entries() { return is_nested<std::decay_t<T>>::value ? 2 : 1; }
+
+      /* ------------------------------------------------------------------------- *\
+         make_arg stores an argument as typed PRINTF_ARG.
+      \* ------------------------------------------------------------------------- */
+      template<class T>
+      inline void make_arg(PRINTF_ARG & a, const T & v)
+      {
+         using D = std::decay_t<T>;
+
+         if constexpr (std::is_enum_v<D>)
+         {
+            make_arg(a, static_cast<std::underlying_type_t<D>>(v));
+         }
+         else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>)
+         {
+            a.Type = PRINTF_ARG_INT;
+            a.v.i  = static_cast<int64_t>(v);
+         }
+         else if constexpr (std::is_integral_v<D>)
+         {
+            a.Type = PRINTF_ARG_UINT;
+            a.v.u  = static_cast<uint64_t>(v);
+         }
+         else if constexpr (std::is_same_v<D, long double>)
+         {
+            a.Type = PRINTF_ARG_LDOUBLE;
+            a.v.ld = v;
+         }
+         else if constexpr (std::is_floating_point_v<D>)
+         {
+            a.Type = PRINTF_ARG_DOUBLE;
+            a.v.d  = static_cast<double>(v);
+         }
+         else if constexpr (std::is_same_v<D, PRINTF_V_CALLBACK *>)
+         {
+            a.Type = PRINTF_ARG_FUNC;
+            a.v.f  = v;
+         }
+         else if constexpr (std::is_pointer_v<D> || std::is_null_pointer_v<D>)
+         {
+            a.Type = PRINTF_ARG_PTR;
+            a.v.p  = static_cast<const void *>(v);
+         }
+         else if constexpr (is_basic_string<D>::value)
+         {
+            a.Type = PRINTF_ARG_PTR;
+            a.v.p  = v.c_str();
+         }
+         else
+         {
+            static_assert(dependent_false<T>::value, "unsupported argument type of a cbp format function");
+         }
+      } /* make_arg(...) */
+
+      /* store writes the array entries of an argument */
+      template<class T>
+      inline void store(PRINTF_ARG *& pa, const T & v)
+      {
+         if constexpr (is_nested<std::decay_t<T>>::value)
+         {
+            pa->Type = PRINTF_ARG_PTR;
+            pa->v.p  = v.fmt;
+            ++pa;
+            v.list.pArgs = v.args;
+            pa->Type     = PRINTF_ARG_PTR;
+            pa->v.p      = &v.list;
+            ++pa;
+         }
+         else
+         {
+            make_arg(*pa++, v);
+         }
+      } /* store(...) */
+
+      /* sink_callback forwards the output to a callable sink */
+      template<class S>
+      inline void sink_callback(void * pUserData, const char * pSrc, size_t Length)
+      {
+         (*static_cast<S *>(pUserData))(pSrc, Length);
+      } /* sink_callback(...) */
+
+      /* ------------------------------------------------------------------------- *\
+         string_sink writes into a character buffer like ssnprintf.
+      \* ------------------------------------------------------------------------- */
+      struct string_sink
+      {
+         char * pDst;    /* position for the next data */
+         size_t DstSize; /* remaining buffer size without the string termination */
+
+         static void write(void * pUserData, const char * pSrc, size_t Length)
+         {
+            string_sink * pss = static_cast<string_sink *>(pUserData);
+
+            if(Length > pss->DstSize)
+               Length = pss->DstSize;
+
+            for(size_t i = 0; i < Length; ++i)
+               pss->pDst[i] = pSrc[i];
+
+            pss->pDst    += Length;
+            pss->DstSize -= Length;
+         }
+
+         static char * reserve(void * pUserData, size_t Length)
+         {
+            string_sink * pss = static_cast<string_sink *>(pUserData);
+            return ((Length <= pss->DstSize) ? pss->pDst : nullptr);
+         }
+
+         static void commit(void * pUserData, size_t Length)
+         {
+            string_sink * pss = static_cast<string_sink *>(pUserData);
+            pss->pDst    += Length;
+            pss->DstSize -= Length;
+         }
+      };
+   } /* namespace detail */
+
+
+   /* ------------------------------------------------------------------------- *\
+      nested returns the argument of a %@ nested format specification.
+   \* ------------------------------------------------------------------------- */
+   template<class... Args>
+   inline nested_args<(detail::arg_entries<Args>() + ... + 0)> nested(const char * fmt, const Args &... args)
+   {
+      nested_args<(detail::arg_entries<Args>() + ... + 0)> n;
+      PRINTF_ARG * pa = n.args;
+
+      (detail::store(pa, args), ...);
+
+      n.fmt        = fmt;
+      n.list.pArgs = nullptr; /* set by detail::store() */
+      n.list.Count = static_cast<size_t>(pa - n.args);
+      return (n);
+   } /* nested(...) */
+
+
+   /* ------------------------------------------------------------------------- *\
+      format_to calls sink(const char * pSrc, size_t Length) for every part of
+      the output and returns the length of the whole output. A zero length
+      indicates an error in the format string.
+   \* ------------------------------------------------------------------------- */
+   template<class Sink, class... Args>
+   inline size_t format_to(Sink && sink, const char * fmt, const Args &... args)
+   {
+      using S = std::remove_reference_t<Sink>;
+      PRINTF_ARG   a[(detail::arg_entries<Args>() + ... + 0) + 1];
+      PRINTF_ARG * pa = a;
+
+      (detail::store(pa, args), ...);
+
+      /* the list of a nested format points into the nested object that is alive until the end of the call */
+      return (callback_printfa(const_cast<void *>(static_cast<const void *>(&sink)), &detail::sink_callback<S>, fmt, a, static_cast<size_t>(pa - a)));
+   } /* format_to(...) */
+
+
+   /* ------------------------------------------------------------------------- *\
+      format_to_sink writes the output into a PRINTF_SINK.
+   \* ------------------------------------------------------------------------- */
+   template<class... Args>
+   inline size_t format_to_sink(PRINTF_SINK & sink, const char * fmt, const Args &... args)
+   {
+      PRINTF_ARG   a[(detail::arg_entries<Args>() + ... + 0) + 1];
+      PRINTF_ARG * pa = a;
+
+      (detail::store(pa, args), ...);
+
+      return (callback_printfa_sink(&sink, fmt, a, static_cast<size_t>(pa - a)));
+   } /* format_to_sink(...) */
+
+
+   /* ------------------------------------------------------------------------- *\
+      snprintf writes at most n - 1 characters and a string termination into
+      pDst like ssnprintf and returns the length of the whole output.
+   \* ------------------------------------------------------------------------- */
+   template<class... Args>
+   inline size_t snprintf(char * pDst, size_t n, const char * fmt, const Args &... args)
+   {
+      detail::string_sink ss   = { pDst, (pDst && n) ? n - 1 : 0 };
+      PRINTF_SINK         sink = { &ss, &detail::string_sink::write, &detail::string_sink::reserve, &detail::string_sink::commit };
+      size_t              zRet = format_to_sink(sink, fmt, args...);
+
+      if(pDst && n)
+         *ss.pDst = '\0';
+
+      return (zRet);
+   } /* snprintf(...) */
+
+
+   /* ------------------------------------------------------------------------- *\
+      sprintf writes the output into a character array of known size.
+   \* ------------------------------------------------------------------------- */
+   template<size_t N, class... Args>
+   inline size_t sprintf(char (&dst)[N], const char * fmt, const Args &... args)
+   {
+      return (snprintf(dst, N, fmt, args...));
+   } /* sprintf(...) */
+
+   /* ------------------------------------------------------------------------- *\
+      size_hint learns the output size of a call site. It keeps the largest
+      size and slowly decreases after shorter output. A static size_hint per
+      call site lets format_append allocate the memory once.
+   \* ------------------------------------------------------------------------- */
+   struct size_hint
+   {
+      std::atomic<size_t> Size{0};
+
+      size_t get() const { return (Size.load(std::memory_order_relaxed)); }
+
+      void learn(size_t Length)
+      {
+         size_t s = Size.load(std::memory_order_relaxed);
+
+         if(Length > s)
+            Size.store(Length, std::memory_order_relaxed);
+         else if(Length < s)
+            Size.store(s - ((s - Length + 15) >> 4), std::memory_order_relaxed);
+      }
+   };
+
+   namespace detail
+   {
+      /* ------------------------------------------------------------------------- *\
+         container_sink appends to a std::string, std::pmr::string or a
+         std::vector<char>. The container is resized in advance and cut to the
+         used size at the end so the output gets formatted in place. Output
+         that doesn't fit after a failed allocation is dropped.
+      \* ------------------------------------------------------------------------- */
+      template<class C>
+      struct container_sink
+      {
+         static_assert(sizeof(typename C::value_type) == 1, "the container of a cbp sink must hold characters");
+
+         C &    c;     /* container */
+         size_t Begin; /* size of the container before the call */
+         size_t Used;  /* size of the container with the output */
+
+         container_sink(C & Container, size_t Hint) : c(Container), Begin(Container.size()), Used(Container.size())
+         {
+            if(Hint)
+               c.resize(Used + Hint);
+         }
+
+         ~container_sink() { c.resize(Used); }
+
+         static char * reserve(void * pUserData, size_t Length) noexcept
+         {
+            container_sink * pcs = static_cast<container_sink *>(pUserData);
+
+            if(pcs->Used + Length > pcs->c.size())
+            { /* the appended part grows at least by a factor of two */
+               size_t grow = 2 * (pcs->Used - pcs->Begin);
+
+               if(grow < 64)
+                  grow = 64;
+
+               try
+               {
+                  pcs->c.resize(pcs->Used + ((Length > grow) ? Length : grow));
+               }
+               catch(...)
+               { /* no exceptions through the C code */
+                  return (nullptr);
+               }
+            }
+
+            return (reinterpret_cast<char *>(pcs->c.data()) + pcs->Used);
+         }
+
+         static void commit(void * pUserData, size_t Length) noexcept
+         {
+            static_cast<container_sink *>(pUserData)->Used += Length;
+         }
+
+         static void write(void * pUserData, const char * pSrc, size_t Length) noexcept
+         {
+            char * pd = Length ? reserve(pUserData, Length) : nullptr;
+
+            if(pd)
+            {
+               std::memcpy(pd, pSrc, Length);
+               commit(pUserData, Length);
+            }
+         }
+
+         PRINTF_SINK sink() { return (PRINTF_SINK{ this, &write, &reserve, &commit }); }
+      };
+   } /* namespace detail */
+
+
+   /* ------------------------------------------------------------------------- *\
+      format_append appends the output to a std::string, a std::pmr::string or
+      a std::vector<char> in a single pass and returns the length of the
+      output. The variant with a size_hint learns the usual output size.
+
+         static cbp::size_hint hint;
+         cbp::format_append(line, hint, "%s %d\n", name, value);
+   \* ------------------------------------------------------------------------- */
+   template<class C, class... Args>
+   inline size_t format_append(C & c, size_hint & hint, const char * fmt, const Args &... args)
+   {
+      detail::container_sink<C> cs(c, hint.get());
+      PRINTF_SINK               sink = cs.sink();
+      size_t                    zRet = format_to_sink(sink, fmt, args...);
+
+      hint.learn(zRet);
+      return (zRet);
+   } /* format_append(...) */
+
+   template<class C, class... Args>
+   inline size_t format_append(C & c, const char * fmt, const Args &... args)
+   {
+      detail::container_sink<C> cs(c, 0);
+      PRINTF_SINK               sink = cs.sink();
+      return (format_to_sink(sink, fmt, args...));
+   } /* format_append(...) */
+
+
+   /* ------------------------------------------------------------------------- *\
+      format returns the output as std::string.
+   \* ------------------------------------------------------------------------- */
+   template<class... Args>
+   inline std::string format(const char * fmt, const Args &... args)
+   {
+      std::string s;
+      format_append(s, fmt, args...);
+      return (s);
+   } /* format(...) */
+} /* namespace cbp */
+
+
+
+#if (__cplusplus >= 202002L) || (defined(_MSVC_LANG) && (_MSVC_LANG >= 202002L))
+
+#include <span>
+
+/* ========================================================================= *\
+   Since C++20 a format string literal can be parsed at compile time. The
+   format object cbp::fmt<"..."> splits the format string into literal text
+   and conversions, checks the types of the arguments and prints every part
+   by a direct call. Only the conversions themselves are dispatched at
+   runtime by callback_printf_spec, the format string isn't scanned again.
+
+      cbp::snprintf(buf, sizeof(buf), cbp::fmt<"%s=%-8.3f %r*lu">, "x", 3.14159, 36, 123456ul);
+
+   The conversions s, c, p and the integer and floating point formats are
+   printed by callback_printf_spec. The callback of a %{name} is looked up
+   once. The remaining conversions %v, %V and %@ get a NUL terminated copy
+   of their format specification for callback_printfa. Invalid format
+   strings and arguments of a type that doesn't match the conversion fail
+   to compile.
+\* ========================================================================= */
+
+namespace cbp
+{
+   /* ------------------------------------------------------------------------- *\
+      fixed_string keeps a string literal as template argument.
+   \* ------------------------------------------------------------------------- */
+   template<size_t N>
+   struct fixed_string
+   {
+      char s[N];
+
+      constexpr fixed_string(const char (&str)[N])
+      {
+         for(size_t i = 0; i < N; ++i)
+            s[i] = str[i];
+      }
+   };
+
+   namespace detail
+   {
+      enum { ITEM_LITERAL = 1, ITEM_SPEC, ITEM_RAW, ITEM_NAMED };                  /* kind of a format item */
+      enum { CLASS_INT = 1, CLASS_FLOAT, CLASS_PTR, CLASS_STRING, CLASS_FUNC, CLASS_NESTED }; /* class of an argument */
+
+      /* ------------------------------------------------------------------------- *\
+         format_item is a literal text or a conversion of a format string.
+      \* ------------------------------------------------------------------------- */
+      struct format_item
+      {
+         int         Kind;     /* ITEM_LITERAL, ITEM_SPEC, ITEM_RAW or ITEM_NAMED */
+         size_t      Begin;    /* offset of the text or name in the format string or of a raw conversion in Raw */
+         size_t      Length;   /* length of a literal text or name */
+         PRINTF_SPEC Spec;     /* conversion of ITEM_SPEC */
+         size_t      FirstArg; /* index of the first argument of the conversion */
+         size_t      ArgCount; /* number of arguments of the conversion */
+      };
+
+      /* ------------------------------------------------------------------------- *\
+         parsed_format is the result of parse_format.
+      \* ------------------------------------------------------------------------- */
+      template<size_t N>
+      struct parsed_format
+      {
+         format_item  Items[N];     /* literals and conversions */
+         size_t       Count;        /* number of items */
+         char         Raw[2 * N];   /* NUL terminated copies of conversions for callback_printfa */
+         size_t       RawLength;    /* used size of Raw */
+         int          ArgClass[N];  /* expected class of every argument */
+         size_t       ArgSize[N];   /* maximum size of an integer or the character size of a string */
+         size_t       ArgCount;     /* number of arguments */
+         const char * Error;        /* description of an error or nullptr */
+      };
+
+      constexpr bool is_digit(char c) { return ((c >= '0') && (c <= '9')); }
+
+      /* is_in checks whether c is one of the characters of ps */
+      constexpr bool is_in(char c, const char * ps)
+      {
+         while(*ps && (*ps != c))
+            ++ps;
+
+         return (c && *ps);
+      } /* is_in(...) */
+
+      /* the character classes of CharType of callback_printf.c */
+      constexpr bool is_fmt_end(char c) { return (!c || is_in(c, "%@AaBbCcdEeFfGgionPpSsuVvXx")); }
+      constexpr bool is_fmt_int(char c) { return (is_in(c, "BbdioXxu")); }
+      constexpr bool is_fmt_flt(char c) { return (is_in(c, "EeFfGg")); }
+
+      /* add_arg appends the expected class of the next argument */
+      template<size_t N>
+      constexpr void add_arg(parsed_format<N> & p, format_item & it, int cls, size_t size)
+      {
+         p.ArgClass[p.ArgCount] = cls;
+         p.ArgSize[p.ArgCount]  = size;
+         ++p.ArgCount;
+         ++it.ArgCount;
+      } /* add_arg(...) */
+
+      /* ------------------------------------------------------------------------- *\
+         modifier_size returns the size in bytes of an integer size modifier,
+         0 for a missing modifier or ~0 for an unknown one.
+      \* ------------------------------------------------------------------------- */
+      constexpr size_t modifier_size(const char * pm, size_t n)
+      {
+         char s0 = (n > 0) ? pm[0] : '\0';
+         char s1 = (n > 1) ? pm[1] : '\0';
+         char s2 = (n > 2) ? pm[2] : '\0';
+
+         if(!n)
+            return (0);
+
+         if(n == 1)
+         {
+            if(s0 == 'l')                                   return (sizeof(long));
+            if((s0 == 'z') || (s0 == 't') || (s0 == 'I'))   return (sizeof(size_t));
+            if(s0 == 'h')                                   return (sizeof(short));
+            if(s0 == 'j')                                   return (sizeof(intmax_t));
+         }
+         else if(n == 2)
+         {
+            if((s0 == 'l') && ((s1 == '1') || (s1 == '2') || (s1 == '4') || (s1 == '8')))
+               return ((size_t) (s1 - '0'));
+            if((s0 == 'l') && (s1 == 'l'))                  return (sizeof(long long));
+            if((s0 == 'h') && (s1 == 'h'))                  return (1);
+            if(((s0 == 'w') || (s0 == 'I')) && (s1 == '8')) return (1);
+         }
+         else if((n == 3) && ((s0 == 'w') || (s0 == 'I')))
+         {
+            if((s1 == '1') && (s2 == '6'))                  return (2);
+            if((s1 == '3') && (s2 == '2'))                  return (4);
+            if((s1 == '6') && (s2 == '4'))                  return (8);
+         }
+
+         return (~(size_t) 0);
+      } /* modifier_size(...) */
+
+      /* ------------------------------------------------------------------------- *\
+         parse_conversion parses a conversion after the '%' and returns the
+         position behind it. It reports errors in p.Error.
+      \* ------------------------------------------------------------------------- */
+      template<size_t N>
+      constexpr size_t parse_conversion(parsed_format<N> & p, format_item & it, const char (&f)[N], size_t i)
+      {
+         PRINTF_SPEC & sp = it.Spec;
+         size_t        k  = i;
+         size_t        ms;     /* begin of the modifiers */
+         size_t        n;      /* length of the modifiers */
+         char          fc;     /* conversion character */
+
+         sp.Precision = ~(size_t) 0;
+
+         while(is_digit(f[k]))
+            ++k;
+
+         if((k > i) && (f[k] == '$'))
+         {
+            p.Error = "positional arguments are not supported";
+            return (k);
+         }
+
+         for(;; ++i)
+         {
+            if(f[i] == '-')      sp.Flags |= PRINTF_SPEC_LEFT;
+            else if(f[i] == '#') sp.Flags |= PRINTF_SPEC_ALT;
+            else if(f[i] == '0') sp.Flags |= PRINTF_SPEC_ZERO;
+            else if(f[i] == '+') sp.Flags |= PRINTF_SPEC_PLUS;
+            else if(f[i] == ' ') sp.Flags |= PRINTF_SPEC_SPACE;
+            else break;
+         }
+
+         if(f[i] == '*')
+         {
+            sp.Flags |= PRINTF_SPEC_WIDTH_ARG;
+            add_arg(p, it, CLASS_INT, sizeof(int));
+            ++i;
+         }
+         else
+         {
+            while(is_digit(f[i]))
+               sp.Width = (sp.Width * 10) + (size_t) (f[i++] - '0');
+         }
+
+         if(f[i] == '.')
+         {
+            if(f[++i] == '*')
+            {
+               sp.Flags |= PRINTF_SPEC_PREC_ARG;
+               add_arg(p, it, CLASS_INT, sizeof(int));
+               ++i;
+            }
+            else if(is_digit(f[i]))
+            {
+               sp.Precision = 0;
+               while(is_digit(f[i]))
+                  sp.Precision = (sp.Precision * 10) + (size_t) (f[i++] - '0');
+            }
+         }
+
+         if(f[i] == '{')
+         { /* %{name} of a named formatter */
+            it.Begin = ++i;
+
+            while((f[i] == '_') || is_digit(f[i]) || ((f[i] >= 'a') && (f[i] <= 'z')) || ((f[i] >= 'A') && (f[i] <= 'Z')))
+               ++i;
+
+            it.Length = i - it.Begin;
+
+            if((f[i] != '}') || !it.Length || (it.Length > 32))
+               p.Error = "invalid name of a named formatter";
+
+            /* '*' arguments are left to callback_printfa */
+            it.Kind = (sp.Flags & (PRINTF_SPEC_WIDTH_ARG | PRINTF_SPEC_PREC_ARG)) ? ITEM_RAW : ITEM_NAMED;
+            add_arg(p, it, CLASS_PTR, 0);
+            return (p.Error ? i : i + 1);
+         }
+
+         if(is_digit(f[i]) || (f[i] == '*') || (f[i] == '$'))
+         {
+            p.Error = "invalid width or precision";
+            return (i);
+         }
+
+         ms = i;
+         while(!is_fmt_end(f[i]))
+            ++i;
+
+         fc = f[i];
+         n  = i - ms;
+
+         if(!fc)
+         {
+            p.Error = "incomplete conversion at the end of the format string";
+            return (i);
+         }
+
+         if((fc == 'v') || (fc == 'V') || (fc == '@'))
+         {
+            it.Kind = ITEM_RAW;
+
+            if(n)
+               p.Error = "conversions %v, %V and %@ don't take size modifiers";
+            else if(fc == 'v')
+            {
+               add_arg(p, it, CLASS_FUNC, 0);
+               add_arg(p, it, CLASS_PTR, 0);
+            }
+            else
+            {
+               add_arg(p, it, (fc == 'V') ? CLASS_PTR : CLASS_NESTED, 0);
+            }
+
+            return (i + 1);
+         }
+
+         it.Kind = ITEM_SPEC;
+         sp.Conv = fc;
+
+         if((n >= 2) && (f[ms] == 'r') && (is_fmt_int(fc) || is_fmt_flt(fc)))
+         { /* numeric base */
+            if(f[ms + 1] == '*')
+            {
+               sp.Flags |= PRINTF_SPEC_BASE_ARG;
+               add_arg(p, it, CLASS_INT, sizeof(int));
+            }
+            else if(is_digit(f[ms + 1]))
+            {
+               sp.Flags |= PRINTF_SPEC_BASE;
+               sp.Base   = (uint8_t) (f[ms + 1] - '0');
+            }
+            else
+            {
+               p.Error = "invalid numeric base of %r";
+               return (i);
+            }
+
+            ms += 2;
+            n  -= 2;
+         }
+
+         if(is_fmt_int(fc))
+         {
+            size_t size = modifier_size(f + ms, n);
+
+            if(size == ~(size_t) 0)
+               p.Error = "unknown size modifier of an integer conversion";
+
+            sp.Size = (uint8_t) ((size == sizeof(int)) ? 0 : size);
+            add_arg(p, it, CLASS_INT, (size > sizeof(int)) ? size : sizeof(int));
+         }
+         else if(is_fmt_flt(fc) || ((fc | 0x20) == 'a'))
+         {
+            if((n == 1) && (f[ms] == 'L'))
+               sp.Size = 16;
+            else if(n)
+               p.Error = "unknown size modifier of a floating point conversion";
+
+            add_arg(p, it, CLASS_FLOAT, 0);
+         }
+         else if((fc == 'p') || (fc == 'P'))
+         {
+            if(n)
+               p.Error = "conversion %p doesn't take size modifiers";
+
+            add_arg(p, it, CLASS_PTR, 0);
+         }
+         else if((fc == 's') || (fc == 'c') || (fc == 'S') || (fc == 'C'))
+         {
+            if(n && (fc == 's') && ((f[ms] == 'J') || (f[ms] == 'Q') || (f[ms] == 'q')))
+            { /* escaped string of JSON, CSV or shell */
+               sp.Flags |= (f[ms] == 'J') ? PRINTF_SPEC_JSON : ((f[ms] == 'Q') ? PRINTF_SPEC_CSV : PRINTF_SPEC_SHELL);
+               ++ms;
+               --n;
+            }
+
+            if((fc == 'S') || (fc == 'C'))
+            {
+               sp.Conv = (char) (fc | 0x20);
+               sp.Size = sizeof(wchar_t);
+            }
+
+            if(n && (sp.Size || (f[ms] != 'l') || (n > 2)))
+               p.Error = "unknown size modifier of a character or string conversion";
+            else if(n == 1)
+               sp.Size = sizeof(wchar_t);
+            else if((n == 2) && ((f[ms + 1] == '1') || (f[ms + 1] == '2') || (f[ms + 1] == '4')))
+               sp.Size = (uint8_t) (f[ms + 1] - '0');
+            else if(n == 2)
+               p.Error = "unknown size modifier of a character or string conversion";
+
+            if(sp.Conv == 'c')
+               add_arg(p, it, CLASS_INT, (sp.Size > sizeof(int)) ? sp.Size : sizeof(int));
+            else
+               add_arg(p, it, CLASS_STRING, sp.Size ? sp.Size : 1);
+         }
+         else
+         {
+            p.Error = (fc == 'n') ? "conversion %n is not supported" : "unknown conversion";
+         }
+
+         return (i + 1);
+      } /* parse_conversion(...) */
+
+      /* ------------------------------------------------------------------------- *\
+         parse_format splits a format string into literal text and conversions.
+      \* ------------------------------------------------------------------------- */
+      template<size_t N>
+      constexpr parsed_format<N> parse_format(const char (&f)[N])
+      {
+         parsed_format<N> p{};
+         size_t           i = 0;
+
+         while(f[i] && !p.Error)
+         {
+            size_t b       = i;
+            bool   percent = false;
+
+            while(f[i] && (f[i] != '%'))
+               ++i;
+
+            if(f[i] && (f[i + 1] == '%'))
+            { /* the literal text ends with the first character of "%%" */
+               percent = true;
+               ++i;
+            }
+
+            if(i > b)
+            {
+               format_item & lt = p.Items[p.Count++];
+               lt.Kind   = ITEM_LITERAL;
+               lt.Begin  = b;
+               lt.Length = i - b;
+            }
+
+            if(percent)
+            {
+               ++i;
+            }
+            else if(f[i])
+            {
+               format_item & it = p.Items[p.Count++];
+               size_t        s  = i;
+
+               it.FirstArg = p.ArgCount;
+               i = parse_conversion(p, it, f, i + 1);
+
+               if((it.Kind == ITEM_RAW) && !p.Error)
+               { /* callback_printfa gets a NUL terminated copy of the conversion */
+                  it.Begin = p.RawLength;
+
+                  while(s < i)
+                     p.Raw[p.RawLength++] = f[s++];
+
+                  p.Raw[p.RawLength++] = '\0';
+               }
+            }
+         }
+
+         return (p);
+      } /* parse_format(...) */
+
+      /* ------------------------------------------------------------------------- *\
+         arg_matches checks an argument type against the expected class.
+      \* ------------------------------------------------------------------------- */
+      template<class T>
+      constexpr bool arg_matches(int cls, size_t size)
+      {
+         using D = std::decay_t<T>;
+
+         if(cls == CLASS_INT)
+         {
+            if constexpr (std::is_integral_v<D> || std::is_enum_v<D>)
+               return (sizeof(D) <= size);
+            else
+               return (false);
+         }
+         else if(cls == CLASS_FLOAT)
+         {
+            return (std::is_floating_point_v<D>);
+         }
+         else if(cls == CLASS_PTR)
+         {
+            return (std::is_pointer_v<D> || std::is_null_pointer_v<D>);
+         }
+         else if(cls == CLASS_STRING)
+         {
+            if constexpr (std::is_pointer_v<D> && std::is_integral_v<std::remove_cv_t<std::remove_pointer_t<D>>>)
+               return (sizeof(std::remove_pointer_t<D>) == size);
+            else if constexpr (is_basic_string<D>::value)
+               return (sizeof(typename D::value_type) == size);
+            else
+               return (std::is_null_pointer_v<D>);
+         }
+         else if(cls == CLASS_FUNC)
+         {
+            return (std::is_same_v<D, PRINTF_V_CALLBACK *>);
+         }
+
+         return (is_nested<D>::value);
+      } /* arg_matches(...) */
+   } /* namespace detail */
+
+
+   /* ------------------------------------------------------------------------- *\
+      format_string is the compile time parsed format string F.
+   \* ------------------------------------------------------------------------- */
+   template<fixed_string F>
+   struct format_string
+   {
+      static constexpr auto parsed = detail::parse_format(F.s);
+
+      static_assert(!parsed.Error, "invalid cbp::fmt format string");
+
+      /* check_arg fails to compile if the type of argument I doesn't match the format string */
+      template<size_t I, class T>
+      static constexpr bool check_arg()
+      {
+         static_assert(detail::arg_matches<T>(parsed.ArgClass[I], parsed.ArgSize[I]), "argument type doesn't match the conversion of the cbp::fmt format string");
+         return (true);
+      } /* check_arg() */
+
+      template<class... Args, size_t... I>
+      static constexpr bool check_args(std::index_sequence<I...>)
+      {
+         return ((check_arg<I, Args>() && ...));
+      } /* check_args(...) */
+
+      /* write passes data to pCB and bypasses the trampoline if pUserData is a PRINTF_SINK */
+      template<bool Sink>
+      static void write(void * pUserData, PRINTF_CALLBACK * pCB, const char * pSrc, size_t Length)
+      {
+         if constexpr (Sink)
+         {
+            PRINTF_SINK * psk = static_cast<PRINTF_SINK *>(pUserData);
+            psk->pCB(psk->pUserData, pSrc, Length);
+         }
+         else
+         {
+            pCB(pUserData, pSrc, Length);
+         }
+      } /* write(...) */
+
+      /* plain_string checks whether T is a narrow C string or std::string */
+      template<class T>
+      static constexpr bool plain_string()
+      {
+         using D = std::decay_t<T>;
+         return (std::is_same_v<D, std::string> || std::is_same_v<D, const char *> || std::is_same_v<D, char *>);
+      } /* plain_string() */
+
+      /* store_args stores the arguments of a conversion */
+      template<size_t First, class Tuple, size_t... J>
+      static void store_args(PRINTF_ARG *& pa, const Tuple & t, std::index_sequence<J...>)
+      {
+         (detail::store(pa, std::get<First + J>(t)), ...);
+      } /* store_args(...) */
+
+      /* item prints the item I of the format string */
+      template<size_t I, bool Sink, class Tuple>
+      static size_t item(void * pUserData, PRINTF_CALLBACK * pCB, const Tuple & t)
+      {
+         constexpr detail::format_item it = parsed.Items[I];
+
+         if constexpr (it.Kind == detail::ITEM_LITERAL)
+         {
+            write<Sink>(pUserData, pCB, F.s + it.Begin, it.Length);
+            return (it.Length);
+         }
+         else if constexpr ((it.Kind == detail::ITEM_SPEC) && (it.Spec.Conv == 's') && !it.Spec.Size && !it.Spec.Flags && !it.Spec.Width &&
+                            (it.Spec.Precision == ~(size_t) 0) && plain_string<std::tuple_element_t<it.FirstArg, Tuple>>())
+         { /* a plain %s doesn't need any formatting */
+            const auto & v = std::get<it.FirstArg>(t);
+            const char * ps;
+            size_t       n;
+
+            if constexpr (detail::is_basic_string<std::decay_t<decltype(v)>>::value)
+            {
+               ps = v.data();
+               n  = v.size();
+            }
+            else
+            {
+               ps = v;
+
+               if constexpr (!std::is_array_v<std::remove_reference_t<decltype(v)>>)
+               {
+                  if(!ps)
+                     ps = "<NULL>";
+               }
+
+               n = std::char_traits<char>::length(ps);
+            }
+
+            write<Sink>(pUserData, pCB, ps, n);
+            return (n);
+         }
+         else if constexpr (it.Kind == detail::ITEM_NAMED)
+         { /* the callback of a name is looked up once */
+            static std::atomic<PRINTF_V_CALLBACK *> pcb{nullptr};
+            PRINTF_V_CALLBACK * pf = pcb.load(std::memory_order_relaxed);
+            const void *        pv = std::get<it.FirstArg>(t);
+
+            if(!pf)
+            {
+               pf = callback_printf_named(F.s + it.Begin, it.Length);
+
+               if(!pf)
+               { /* unknown name */
+                  pCB(pUserData, F.s + it.Begin, 0);
+                  return (0);
+               }
+
+               pcb.store(pf, std::memory_order_relaxed);
+            }
+
+            return (pf(pUserData, pCB, const_cast<void *>(pv), it.Spec.Precision, it.Spec.Width,
+                       (it.Spec.Flags & PRINTF_SPEC_LEFT) ? 1 : 0, (it.Spec.Flags & PRINTF_SPEC_ALT) ? 1 : 0));
+         }
+         else
+         {
+            PRINTF_ARG   a[2 * it.ArgCount];
+            PRINTF_ARG * pa = a;
+
+            store_args<it.FirstArg>(pa, t, std::make_index_sequence<it.ArgCount>{});
+
+            if constexpr (it.Kind == detail::ITEM_SPEC)
+               return (callback_printf_spec(pUserData, pCB, &parsed.Items[I].Spec, a, it.ArgCount));
+            else
+               return (callback_printfa(pUserData, pCB, parsed.Raw + it.Begin, a, static_cast<size_t>(pa - a)));
+         }
+      } /* item(...) */
+
+      template<bool Sink, class Tuple, size_t... I>
+      static size_t items(void * pUserData, PRINTF_CALLBACK * pCB, const Tuple & t, std::index_sequence<I...>)
+      {
+         size_t zRet = 0;
+         ((zRet += item<I, Sink>(pUserData, pCB, t)), ...);
+         return (zRet);
+      } /* items(...) */
+
+      /* ------------------------------------------------------------------------- *\
+         print writes the output by calls of pCB like callback_printfa. An error
+         at runtime (a base of %r* above 36 or a NULL callback of %v) is
+         reported to pCB but doesn't stop the output of the following parts.
+         Sink tells that pUserData is the PRINTF_SINK of callback_printf_sink_callback().
+      \* ------------------------------------------------------------------------- */
+      template<bool Sink, class... Args>
+      static size_t print(void * pUserData, PRINTF_CALLBACK * pCB, const Args &... args)
+      {
+         static_assert(sizeof...(Args) == parsed.ArgCount, "number of arguments doesn't match the cbp::fmt format string");
+         static_assert(check_args<Args...>(std::index_sequence_for<Args...>{}));
+
+         return (items<Sink>(pUserData, pCB, std::tuple<const Args &...>(args...), std::make_index_sequence<parsed.Count>{}));
+      } /* print(...) */
+   };
+
+   /* ------------------------------------------------------------------------- *\
+      fmt<"..."> is the compile time parsed format string argument.
+   \* ------------------------------------------------------------------------- */
+   template<fixed_string F>
+   inline constexpr format_string<F> fmt{};
+
+
+   /* ------------------------------------------------------------------------- *\
+      format_to, format_to_sink, snprintf and sprintf of a format string that
+      was parsed at compile time.
+   \* ------------------------------------------------------------------------- */
+   template<class Sink, fixed_string F, class... Args>
+   inline size_t format_to(Sink && sink, format_string<F>, const Args &... args)
+   {
+      using S = std::remove_reference_t<Sink>;
+      return (format_string<F>::template print<false>(const_cast<void *>(static_cast<const void *>(&sink)), &detail::sink_callback<S>, args...));
+   } /* format_to(...) */
+
+   template<fixed_string F, class... Args>
+   inline size_t format_to_sink(PRINTF_SINK & sink, format_string<F>, const Args &... args)
+   {
+      return (format_string<F>::template print<true>(&sink, callback_printf_sink_callback(), args...));
+   } /* format_to_sink(...) */
+
+   template<fixed_string F, class... Args>
+   inline size_t snprintf(char * pDst, size_t n, format_string<F> f, const Args &... args)
+   {
+      detail::string_sink ss   = { pDst, (pDst && n) ? n - 1 : 0 };
+      PRINTF_SINK         sink = { &ss, &detail::string_sink::write, &detail::string_sink::reserve, &detail::string_sink::commit };
+      size_t              zRet = format_to_sink(sink, f, args...);
+
+      if(pDst && n)
+         *ss.pDst = '\0';
+
+      return (zRet);
+   } /* snprintf(...) */
+
+   template<size_t N, fixed_string F, class... Args>
+   inline size_t sprintf(char (&dst)[N], format_string<F> f, const Args &... args)
+   {
+      return (snprintf(dst, N, f, args...));
+   } /* sprintf(...) */
+
+
+   /* ------------------------------------------------------------------------- *\
+      format_append and format of a compile time parsed format string learn
+      the output size in a size_hint per format string.
+   \* ------------------------------------------------------------------------- */
+   template<fixed_string F>
+   inline size_hint format_hint;
+
+   template<class C, fixed_string F, class... Args>
+   inline size_t format_append(C & c, format_string<F> f, const Args &... args)
+   {
+      size_t zRet;
+
+      {
+         detail::container_sink<C> cs(c, format_hint<F>.get());
+         PRINTF_SINK               sink = cs.sink();
+         zRet = format_to_sink(sink, f, args...);
+      }
+
+      format_hint<F>.learn(zRet);
+      return (zRet);
+   } /* format_append(...) */
+
+   template<fixed_string F, class... Args>
+   inline std::string format(format_string<F> f, const Args &... args)
+   {
+      std::string s;
+      format_append(s, f, args...);
+      return (s);
+   } /* format(...) */
+
+
+   /* ------------------------------------------------------------------------- *\
+      format_to_span writes at most dst.size() characters without a string
+      termination into a fixed buffer and returns the length of the whole
+      output like snprintf.
+   \* ------------------------------------------------------------------------- */
+   template<class... Args>
+   inline size_t format_to_span(std::span<char> dst, const char * fmt, const Args &... args)
+   {
+      detail::string_sink ss   = { dst.data(), dst.size() };
+      PRINTF_SINK         sink = { &ss, &detail::string_sink::write, &detail::string_sink::reserve, &detail::string_sink::commit };
+      return (format_to_sink(sink, fmt, args...));
+   } /* format_to_span(...) */
+
+   template<fixed_string F, class... Args>
+   inline size_t format_to_span(std::span<char> dst, format_string<F> f, const Args &... args)
+   {
+      detail::string_sink ss   = { dst.data(), dst.size() };
+      PRINTF_SINK         sink = { &ss, &detail::string_sink::write, &detail::string_sink::reserve, &detail::string_sink::commit };
+      return (format_to_sink(sink, f, args...));
+   } /* format_to_span(...) */
+} /* namespace cbp */
+
+#endif /* __cplusplus >= 202002L */
+
+#endif /* CALLBACK_PRINTF_HPP */
+
+/* ========================================================================= *\
+   E N D   O F   F I L E
+\* ========================================================================= */
@@ -0,0 +1,1065 @@
+/*****************************************************************************\
+*                                                                             *
+*  FILE NAME:     cbk_formats.c                                               *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  DESCRIPTION:   built-in named formatters of callback_printf                *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  COPYRIGHT:     (c) 2026 Dipl.-Ing. Klaus Lux (Aachen, Germany)             *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  ORIGIN:        https://github.com/klux21/callback_printf                   *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+* Civil Usage Public License, Version 1.2, June 2026                          *
+*                                                                             *
+* Redistribution and use in source and binary forms, with or without          *
+* modification, are permitted provided that the following conditions are met: *
+*                                                                             *
+* 1. Redistributions of source code must retain the above copyright           *
+*    notice, this list of conditions, the explanation of terms                *
+*    and the following disclaimer.                                            *
+*                                                                             *
+* 2. Redistributions in binary form must reproduce the above copyright        *
+*    notice, this list of conditions and the following disclaimer in the      *
+*    documentation or other materials provided with the distribution.         *
+*                                                                             *
+* 3. All modified files must carry prominent notices stating that the         *
+*    files have been changed.                                                 *
+*                                                                             *
+* 4. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are designed or           *
+*    intended to harm, to kill or to forcibly immobilize people.              *
+*                                                                             *
+* 5. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are intended to           *
+*    monitor, to track, to change or to control the behavior, the             *
+*    constitution, the location or the communication of any people or         *
+*    their property without the explicit and prior agreement of those         *
+*    people except those devices and systems are solely designed for          *
+*    saving or protecting peoples life or health.                             *
+*                                                                             *
+* 6. The source code and binary forms and any derivative works are not        *
+*    stored or executed in any systems or devices that are intended           *
+*    for the production of any of the systems or devices that                 *
+*    have been stated before except the ones for saving or protecting         *
+*    peoples life or health only.                                             *
+*                                                                             *
+* The term 'systems' in all clauses shall include all types and combinations  *
+* of physical, virtualized or simulated hardware and software and any kind    *
+* of data storage.                                                            *
+*                                                                             *
+* The term 'devices' shall include any kind of local or non-local control     *
+* system of the stated devices as part of that device as well. Any assembly   *
+* of more than one device is one and the same device regarding this license.  *
+*                                                                             *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" *
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   *
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  *
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   *
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         *
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        *
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    *
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     *
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     *
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  *
+* POSSIBILITY OF SUCH DAMAGE.                                                 *
+*                                                                             *
+\*****************************************************************************/
+
+
+#undef   _CRT_ERRNO_DEFINED
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma warning(disable : 4100 4127 4706 4710)
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
+
+#include <cbk_formats.h>
+
+#if defined(_MSC_VER) && (_MSC_VER < 1900)
+struct timespec
+{
+   time_t tv_sec;
+   long   tv_nsec;
+};
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define CBK_SSE2 1
+#endif
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define CBK_SSSE3 1
+#endif
+
+#if defined(_MSC_VER)
+#define CBK_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define CBK_THREAD_LOCAL __thread
+#else
+#define CBK_THREAD_LOCAL _Thread_local
+#endif
+
+/* ========================================================================= *\
+   Character tables
+\* ========================================================================= */
+
+static const char hex_lc[] = "0123456789abcdef";
+static const char hex_uc[] = "0123456789ABCDEF";
+
+/* two decimal digits of all values from 0 to 99 */
+static const char dec_2[] = "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+                            "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+/* decimal digits of all byte values with the number of digits in the last byte */
+static const char dec_u8[256][4] = {
+   {'0',0,0,1}, {'1',0,0,1}, {'2',0,0,1}, {'3',0,0,1}, {'4',0,0,1}, {'5',0,0,1}, {'6',0,0,1}, {'7',0,0,1},
+   {'8',0,0,1}, {'9',0,0,1}, {'1','0',0,2}, {'1','1',0,2}, {'1','2',0,2}, {'1','3',0,2}, {'1','4',0,2}, {'1','5',0,2},
+   {'1','6',0,2}, {'1','7',0,2}, {'1','8',0,2}, {'1','9',0,2}, {'2','0',0,2}, {'2','1',0,2}, {'2','2',0,2}, {'2','3',0,2},
+   {'2','4',0,2}, {'2','5',0,2}, {'2','6',0,2}, {'2','7',0,2}, {'2','8',0,2}, {'2','9',0,2}, {'3','0',0,2}, {'3','1',0,2},
+   {'3','2',0,2}, {'3','3',0,2}, {'3','4',0,2}, {'3','5',0,2}, {'3','6',0,2}, {'3','7',0,2}, {'3','8',0,2}, {'3','9',0,2},
+   {'4','0',0,2}, {'4','1',0,2}, {'4','2',0,2}, {'4','3',0,2}, {'4','4',0,2}, {'4','5',0,2}, {'4','6',0,2}, {'4','7',0,2},
+   {'4','8',0,2}, {'4','9',0,2}, {'5','0',0,2}, {'5','1',0,2}, {'5','2',0,2}, {'5','3',0,2}, {'5','4',0,2}, {'5','5',0,2},
+   {'5','6',0,2}, {'5','7',0,2}, {'5','8',0,2}, {'5','9',0,2}, {'6','0',0,2}, {'6','1',0,2}, {'6','2',0,2}, {'6','3',0,2},
+   {'6','4',0,2}, {'6','5',0,2}, {'6','6',0,2}, {'6','7',0,2}, {'6','8',0,2}, {'6','9',0,2}, {'7','0',0,2}, {'7','1',0,2},
+   {'7','2',0,2}, {'7','3',0,2}, {'7','4',0,2}, {'7','5',0,2}, {'7','6',0,2}, {'7','7',0,2}, {'7','8',0,2}, {'7','9',0,2},
+   {'8','0',0,2}, {'8','1',0,2}, {'8','2',0,2}, {'8','3',0,2}, {'8','4',0,2}, {'8','5',0,2}, {'8','6',0,2}, {'8','7',0,2},
+   {'8','8',0,2}, {'8','9',0,2}, {'9','0',0,2}, {'9','1',0,2}, {'9','2',0,2}, {'9','3',0,2}, {'9','4',0,2}, {'9','5',0,2},
+   {'9','6',0,2}, {'9','7',0,2}, {'9','8',0,2}, {'9','9',0,2}, {'1','0','0',3}, {'1','0','1',3}, {'1','0','2',3}, {'1','0','3',3},
+   {'1','0','4',3}, {'1','0','5',3}, {'1','0','6',3}, {'1','0','7',3}, {'1','0','8',3}, {'1','0','9',3}, {'1','1','0',3}, {'1','1','1',3},
+   {'1','1','2',3}, {'1','1','3',3}, {'1','1','4',3}, {'1','1','5',3}, {'1','1','6',3}, {'1','1','7',3}, {'1','1','8',3}, {'1','1','9',3},
+   {'1','2','0',3}, {'1','2','1',3}, {'1','2','2',3}, {'1','2','3',3}, {'1','2','4',3}, {'1','2','5',3}, {'1','2','6',3}, {'1','2','7',3},
+   {'1','2','8',3}, {'1','2','9',3}, {'1','3','0',3}, {'1','3','1',3}, {'1','3','2',3}, {'1','3','3',3}, {'1','3','4',3}, {'1','3','5',3},
+   {'1','3','6',3}, {'1','3','7',3}, {'1','3','8',3}, {'1','3','9',3}, {'1','4','0',3}, {'1','4','1',3}, {'1','4','2',3}, {'1','4','3',3},
+   {'1','4','4',3}, {'1','4','5',3}, {'1','4','6',3}, {'1','4','7',3}, {'1','4','8',3}, {'1','4','9',3}, {'1','5','0',3}, {'1','5','1',3},
+   {'1','5','2',3}, {'1','5','3',3}, {'1','5','4',3}, {'1','5','5',3}, {'1','5','6',3}, {'1','5','7',3}, {'1','5','8',3}, {'1','5','9',3},
+   {'1','6','0',3}, {'1','6','1',3}, {'1','6','2',3}, {'1','6','3',3}, {'1','6','4',3}, {'1','6','5',3}, {'1','6','6',3}, {'1','6','7',3},
+   {'1','6','8',3}, {'1','6','9',3}, {'1','7','0',3}, {'1','7','1',3}, {'1','7','2',3}, {'1','7','3',3}, {'1','7','4',3}, {'1','7','5',3},
+   {'1','7','6',3}, {'1','7','7',3}, {'1','7','8',3}, {'1','7','9',3}, {'1','8','0',3}, {'1','8','1',3}, {'1','8','2',3}, {'1','8','3',3},
+   {'1','8','4',3}, {'1','8','5',3}, {'1','8','6',3}, {'1','8','7',3}, {'1','8','8',3}, {'1','8','9',3}, {'1','9','0',3}, {'1','9','1',3},
+   {'1','9','2',3}, {'1','9','3',3}, {'1','9','4',3}, {'1','9','5',3}, {'1','9','6',3}, {'1','9','7',3}, {'1','9','8',3}, {'1','9','9',3},
+   {'2','0','0',3}, {'2','0','1',3}, {'2','0','2',3}, {'2','0','3',3}, {'2','0','4',3}, {'2','0','5',3}, {'2','0','6',3}, {'2','0','7',3},
+   {'2','0','8',3}, {'2','0','9',3}, {'2','1','0',3}, {'2','1','1',3}, {'2','1','2',3}, {'2','1','3',3}, {'2','1','4',3}, {'2','1','5',3},
+   {'2','1','6',3}, {'2','1','7',3}, {'2','1','8',3}, {'2','1','9',3}, {'2','2','0',3}, {'2','2','1',3}, {'2','2','2',3}, {'2','2','3',3},
+   {'2','2','4',3}, {'2','2','5',3}, {'2','2','6',3}, {'2','2','7',3}, {'2','2','8',3}, {'2','2','9',3}, {'2','3','0',3}, {'2','3','1',3},
+   {'2','3','2',3}, {'2','3','3',3}, {'2','3','4',3}, {'2','3','5',3}, {'2','3','6',3}, {'2','3','7',3}, {'2','3','8',3}, {'2','3','9',3},
+   {'2','4','0',3}, {'2','4','1',3}, {'2','4','2',3}, {'2','4','3',3}, {'2','4','4',3}, {'2','4','5',3}, {'2','4','6',3}, {'2','4','7',3},
+   {'2','4','8',3}, {'2','4','9',3}, {'2','5','0',3}, {'2','5','1',3}, {'2','5','2',3}, {'2','5','3',3}, {'2','5','4',3}, {'2','5','5',3}
+};
+
+
+/* ========================================================================= *\
+   Text generation
+\* ========================================================================= */
+
+/* put_u8 writes the decimal digits of a byte and returns the end position (pd needs 4 bytes of space) */
+static char * put_u8(char * pd, uint8_t v)
+{
+   memcpy(pd, dec_u8[v], 4);
+   return (pd + dec_u8[v][3]);
+} /* char * put_u8(char * pd, uint8_t v) */
+
+/* put_u32 writes the decimal digits of an unsigned integer */
+static char * put_u32(char * pd, uint32_t v)
+{
+   char   buf[10];
+   char * ps = buf + sizeof(buf);
+
+   do
+   {
+      *--ps = (char) ('0' + (v % 10));
+      v /= 10;
+   } while(v);
+
+   while(ps < buf + sizeof(buf))
+      *pd++ = *ps++;
+
+   return (pd);
+} /* char * put_u32(char * pd, uint32_t v) */
+
+/* put_2 writes two decimal digits of a value below 100 */
+static char * put_2(char * pd, unsigned v)
+{
+   memcpy(pd, dec_2 + 2 * v, 2);
+   return (pd + 2);
+} /* char * put_2(char * pd, unsigned v) */
+
+/* put_ipv4 writes a dotted quad (pd needs 16 bytes of space) */
+static char * put_ipv4(char * pd, const uint8_t * pa)
+{
+   pd = put_u8(pd, pa[0]);
+   *pd++ = '.';
+   pd = put_u8(pd, pa[1]);
+   *pd++ = '.';
+   pd = put_u8(pd, pa[2]);
+   *pd++ = '.';
+   return (put_u8(pd, pa[3]));
+} /* char * put_ipv4(char * pd, const uint8_t * pa) */
+
+/* put_hex16 writes a 16 bit group of an IPv6 address without leading zeros */
+static char * put_hex16(char * pd, unsigned v)
+{
+   size_t n = (size_t) 1 + (v > 0xf) + (v > 0xff) + (v > 0xfff);
+   char * pe = pd + n;
+
+   do
+   {
+      *--pe = hex_lc[v & 0xf];
+      v >>= 4;
+   } while(pe > pd);
+
+   return (pd + n);
+} /* char * put_hex16(char * pd, unsigned v) */
+
+/* put_hex writes Length bytes as pairs of hexadecimal digits */
+static char * put_hex(char * pd, const uint8_t * pa, size_t Length, const char * digits)
+{
+   while(Length--)
+   {
+      *pd++ = digits[*pa >> 4];
+      *pd++ = digits[*pa++ & 0xf];
+   }
+
+   return (pd);
+} /* char * put_hex(char * pd, const uint8_t * pa, size_t Length, const char * digits) */
+
+/* put_ipv6 writes an IPv6 address in the text form of RFC 5952 (pd needs 46 bytes of space) */
+static char * put_ipv6(char * pd, const uint8_t * pa, uint8_t full)
+{
+   unsigned g[8];
+   int      best_pos = -1; /* begin of the longest run of zero groups */
+   int      best_len = 1;  /* a single zero group isn't compressed */
+   int      i;
+
+   for(i = 0; i < 8; ++i)
+      g[i] = ((unsigned) pa[2 * i] << 8) | pa[2 * i + 1];
+
+   if(!full && !(g[0] | g[1] | g[2] | g[3] | g[4]) && (g[5] == 0xffff))
+   { /* IPv4 mapped address */
+      memcpy(pd, "::ffff:", 7);
+      return (put_ipv4(pd + 7, pa + 12));
+   }
+
+   for(i = 0; !full && (i < 8); ++i)
+   {
+      int n = 0;
+
+      while((i + n < 8) && !g[i + n])
+         ++n;
+
+      if(n > best_len)
+      {
+         best_pos = i;
+         best_len = n;
+      }
+
+      i += n;
+   }
+
+   for(i = 0; i < 8; ++i)
+   {
+      if(i == best_pos)
+      {
+         *pd++ = ':';
+         i += best_len - 1;
+
+         if(i == 7)
+            *pd++ = ':';
+
+         continue;
+      }
+
+      if(i)
+         *pd++ = ':';
+
+      pd = put_hex16(pd, g[i]);
+   }
+
+   return (pd);
+} /* char * put_ipv6(char * pd, const uint8_t * pa, uint8_t full) */
+
+
+/* ========================================================================= *\
+   Formatters
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_ipv4 prints an IPv4 address as dotted quad.
+\* ------------------------------------------------------------------------- */
+
+size_t cbk_format_ipv4(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   char buf[20];
+
+   if(!pvdata)
+      return (cbk_print_string(pUserData, pCB, "<NULL>", 6, minimum_width, left_justified));
+
+   return (cbk_print_string(pUserData, pCB, buf, (size_t) (put_ipv4(buf, (const uint8_t *) pvdata) - buf), minimum_width, left_justified));
+} /* size_t cbk_format_ipv4(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_ipv6 prints an IPv6 address in the text form of RFC 5952.
+\* ------------------------------------------------------------------------- */
+
+size_t cbk_format_ipv6(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   char buf[48];
+
+   if(!pvdata)
+      return (cbk_print_string(pUserData, pCB, "<NULL>", 6, minimum_width, left_justified));
+
+   return (cbk_print_string(pUserData, pCB, buf, (size_t) (put_ipv6(buf, (const uint8_t *) pvdata, prefixing) - buf), minimum_width, left_justified));
+} /* size_t cbk_format_ipv6(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_mac prints a MAC address.
+\* ------------------------------------------------------------------------- */
+
+size_t cbk_format_mac(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   char            buf[18];
+   const char *    digits = prefixing ? hex_uc : hex_lc;
+   const uint8_t * pa     = (const uint8_t *) pvdata;
+   char *          pd     = buf;
+   int             i;
+
+   if(!pa)
+      return (cbk_print_string(pUserData, pCB, "<NULL>", 6, minimum_width, left_justified));
+
+   for(i = 0; i < 6; ++i)
+   {
+      pd[0] = digits[pa[i] >> 4];
+      pd[1] = digits[pa[i] & 0xf];
+      pd[2] = ':';
+      pd += 3;
+   }
+
+   return (cbk_print_string(pUserData, pCB, buf, 17, minimum_width, left_justified));
+} /* size_t cbk_format_mac(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_uuid prints a UUID in the canonical form.
+\* ------------------------------------------------------------------------- */
+
+size_t cbk_format_uuid(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   char            buf[36];
+   const char *    digits = prefixing ? hex_uc : hex_lc;
+   const uint8_t * pa     = (const uint8_t *) pvdata;
+   char *          pd     = buf;
+
+   if(!pa)
+      return (cbk_print_string(pUserData, pCB, "<NULL>", 6, minimum_width, left_justified));
+
+   pd = put_hex(pd, pa, 4, digits);
+   *pd++ = '-';
+   pd = put_hex(pd, pa + 4, 2, digits);
+   *pd++ = '-';
+   pd = put_hex(pd, pa + 6, 2, digits);
+   *pd++ = '-';
+   pd = put_hex(pd, pa + 8, 2, digits);
+   *pd++ = '-';
+   put_hex(pd, pa + 10, 6, digits);
+
+   return (cbk_print_string(pUserData, pCB, buf, 36, minimum_width, left_justified));
+} /* size_t cbk_format_uuid(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_sockaddr prints an IPv4 or IPv6 socket address with its port.
+\* ------------------------------------------------------------------------- */
+
+size_t cbk_format_sockaddr(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   char                    buf[72];
+   char *                  pd   = buf;
+   const struct sockaddr * psa  = (const struct sockaddr *) pvdata;
+   const uint8_t *         port = NULL; /* port in network byte order */
+
+   if(!psa)
+      return (cbk_print_string(pUserData, pCB, "<NULL>", 6, minimum_width, left_justified));
+
+   if(psa->sa_family == AF_INET)
+   {
+      const struct sockaddr_in * psi = (const struct sockaddr_in *) pvdata;
+
+      pd   = put_ipv4(pd, (const uint8_t *) &psi->sin_addr);
+      port = (const uint8_t *) &psi->sin_port;
+   }
+   else if(psa->sa_family == AF_INET6)
+   {
+      const struct sockaddr_in6 * psi6 = (const struct sockaddr_in6 *) pvdata;
+
+      *pd++ = '[';
+      pd = put_ipv6(pd, (const uint8_t *) &psi6->sin6_addr, 0);
+
+      if(psi6->sin6_scope_id)
+      {
+         *pd++ = '%';
+         pd = put_u32(pd, (uint32_t) psi6->sin6_scope_id);
+      }
+
+      *pd++ = ']';
+      port = (const uint8_t *) &psi6->sin6_port;
+   }
+   else
+   { /* unsupported address family */
+      pCB(pUserData, NULL, 0);
+      return (0);
+   }
+
+   if(!prefixing && (port[0] | port[1]))
+   {
+      *pd++ = ':';
+      pd = put_u32(pd, ((uint32_t) port[0] << 8) | port[1]);
+   }
+
+   return (cbk_print_string(pUserData, pCB, buf, (size_t) (pd - buf), minimum_width, left_justified));
+} /* size_t cbk_format_sockaddr(...) */
+
+
+/* ========================================================================= *\
+   Timestamps
+\* ========================================================================= */
+
+#define TS_STYLE_ISO8601 0
+#define TS_STYLE_RFC3339 1
+#define TS_STYLE_COMPACT 2
+
+#define TS_SECOND_MIN    (-62167219200LL) /* 0000-01-01T00:00:00Z */
+#define TS_SECOND_MAX    (253402300799LL) /* 9999-12-31T23:59:59Z */
+
+typedef struct TS_STYLE_S TS_STYLE;
+struct TS_STYLE_S
+{
+   char         DateSep;    /* separator of year, month and day or 0 */
+   char         Separator;  /* separator of date and time */
+   char         TimeSep;    /* separator of hours, minutes and seconds or 0 */
+   uint8_t      ZoneLength; /* length of the time zone text */
+   const char * pZone;      /* time zone text */
+};
+
+static const TS_STYLE ts_styles[3] =
+{
+   { '-', 'T', ':', 1, "Z"      }, /* 2026-10-19T12:34:56.123456Z      */
+   { '-', ' ', ':', 6, "+00:00" }, /* 2026-10-19 12:34:56.123456+00:00 */
+   {  0,  'T',  0,  1, "Z"      }  /* 20261019T123456.123456Z          */
+};
+
+/* ------------------------------------------------------------------------- *\
+   The text of the date and the time up to the seconds is cached per thread
+   and style. Consecutive log records of the same second copy just the text
+   and write only the fraction and a change of the second within the same
+   day rewrites only the time.
+\* ------------------------------------------------------------------------- */
+typedef struct TS_CACHE_S TS_CACHE;
+struct TS_CACHE_S
+{
+   int64_t Second;     /* seconds since the epoch of Text */
+   int64_t Day;        /* days since the epoch of Text */
+   uint8_t Valid;      /* Text is valid */
+   uint8_t DateLength; /* length of the date part including the separator */
+   uint8_t Length;     /* length of Text */
+   char    Text[21];
+};
+
+static CBK_THREAD_LOCAL TS_CACHE ts_cache[3];
+
+/* ts_update writes the date and time of a second into the cache */
+static void ts_update(TS_CACHE * pc, const TS_STYLE * pst, int64_t sec)
+{
+   int64_t  day = sec / 86400;
+   int64_t  sod = sec % 86400; /* second of the day */
+   char *   pd;
+
+   if(sod < 0)
+   {
+      sod += 86400;
+      --day;
+   }
+
+   if(!pc->Valid || (pc->Day != day))
+   { /* civil date of the proleptic Gregorian calendar */
+      int64_t  z   = day + 719468;
+      int64_t  era = ((z >= 0) ? z : (z - 146096)) / 146097;
+      unsigned doe = (unsigned) (z - era * 146097);                                   /* day of the era */
+      unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;           /* year of the era */
+      unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);                         /* day of the year from March */
+      unsigned mp  = (5 * doy + 2) / 153;
+      unsigned d   = doy - (153 * mp + 2) / 5 + 1;
+      unsigned m   = (mp < 10) ? (mp + 3) : (mp - 9);
+      unsigned y   = (unsigned) (era * 400 + yoe) + (m <= 2);
+
+      pd = put_2(pc->Text, y / 100);
+      pd = put_2(pd, y % 100);
+
+      if(pst->DateSep)
+         *pd++ = pst->DateSep;
+
+      pd = put_2(pd, m);
+
+      if(pst->DateSep)
+         *pd++ = pst->DateSep;
+
+      pd = put_2(pd, d);
+      *pd++ = pst->Separator;
+
+      pc->DateLength = (uint8_t) (pd - pc->Text);
+      pc->Day        = day;
+   }
+
+   pd = put_2(pc->Text + pc->DateLength, (unsigned) (sod / 3600));
+
+   if(pst->TimeSep)
+      *pd++ = pst->TimeSep;
+
+   pd = put_2(pd, (unsigned) (sod / 60 % 60));
+
+   if(pst->TimeSep)
+      *pd++ = pst->TimeSep;
+
+   pd = put_2(pd, (unsigned) (sod % 60));
+
+   pc->Length = (uint8_t) (pd - pc->Text);
+   pc->Second = sec;
+   pc->Valid  = 1;
+} /* void ts_update(TS_CACHE * pc, const TS_STYLE * pst, int64_t sec) */
+
+
+/* format_timestamp prints a UTC timestamp with precision digits of the fraction of the second */
+static size_t format_timestamp(void * pUserData, PRINTF_CALLBACK * pCB, int64_t sec, uint32_t nsec, size_t precision, size_t minimum_width, uint8_t left_justified, int style)
+{
+   char             buf[48];
+   char *           pd;
+   TS_CACHE *       pc  = &ts_cache[style];
+   const TS_STYLE * pst = &ts_styles[style];
+
+   if((sec < TS_SECOND_MIN) || (sec > TS_SECOND_MAX) || (nsec >= 1000000000))
+   { /* not representable by four digits of the year */
+      pCB(pUserData, NULL, 0);
+      return (0);
+   }
+
+   if(!pc->Valid || (pc->Second != sec))
+      ts_update(pc, pst, sec);
+
+   memcpy(buf, pc->Text, sizeof(pc->Text));
+   pd = buf + pc->Length;
+
+   if(precision == ~(size_t) 0)
+      precision = 6;
+   else if(precision > 9)
+      precision = 9;
+
+   if(precision)
+   { /* the fraction is truncated and not rounded like the seconds */
+      char frac[10];
+
+      put_2(frac,     nsec / 10000000);
+      put_2(frac + 2, nsec / 100000 % 100);
+      put_2(frac + 4, nsec / 1000 % 100);
+      put_2(frac + 6, nsec / 10 % 100);
+      frac[8] = (char) ('0' + nsec % 10);
+
+      *pd++ = '.';
+      memcpy(pd, frac, precision);
+      pd += precision;
+   }
+
+   memcpy(pd, pst->pZone, pst->ZoneLength);
+   pd += pst->ZoneLength;
+
+   return (cbk_print_string(pUserData, pCB, buf, (size_t) (pd - buf), minimum_width, left_justified));
+} /* size_t format_timestamp(...) */
+
+
+/* format_timespec prints a struct timespec */
+static size_t format_timespec(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, int style)
+{
+   const struct timespec * pts = (const struct timespec *) pvdata;
+
+   if(!pts)
+      return (cbk_print_string(pUserData, pCB, "<NULL>", 6, minimum_width, left_justified));
+
+   if(pts->tv_nsec < 0)
+   {
+      pCB(pUserData, NULL, 0);
+      return (0);
+   }
+
+   return (format_timestamp(pUserData, pCB, (int64_t) pts->tv_sec, (uint32_t) pts->tv_nsec, precision, minimum_width, left_justified, style));
+} /* size_t format_timespec(...) */
+
+
+/* format_nanoseconds prints an int64_t of nanoseconds since the epoch */
+static size_t format_nanoseconds(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, int style)
+{
+   const int64_t * pns = (const int64_t *) pvdata;
+   int64_t         sec;
+   int64_t         nsec;
+
+   if(!pns)
+      return (cbk_print_string(pUserData, pCB, "<NULL>", 6, minimum_width, left_justified));
+
+   sec  = *pns / 1000000000;
+   nsec = *pns % 1000000000;
+
+   if(nsec < 0)
+   {
+      nsec += 1000000000;
+      --sec;
+   }
+
+   return (format_timestamp(pUserData, pCB, sec, (uint32_t) nsec, precision, minimum_width, left_justified, style));
+} /* size_t format_nanoseconds(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   ISO 8601, RFC 3339 and compact timestamps of a struct timespec or of
+   nanoseconds since the epoch.
+\* ------------------------------------------------------------------------- */
+
+size_t cbk_format_iso8601(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   return (format_timespec(pUserData, pCB, pvdata, precision, minimum_width, left_justified, TS_STYLE_ISO8601));
+} /* size_t cbk_format_iso8601(...) */
+
+size_t cbk_format_iso8601_ns(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   return (format_nanoseconds(pUserData, pCB, pvdata, precision, minimum_width, left_justified, TS_STYLE_ISO8601));
+} /* size_t cbk_format_iso8601_ns(...) */
+
+size_t cbk_format_rfc3339(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   return (format_timespec(pUserData, pCB, pvdata, precision, minimum_width, left_justified, TS_STYLE_RFC3339));
+} /* size_t cbk_format_rfc3339(...) */
+
+size_t cbk_format_rfc3339_ns(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   return (format_nanoseconds(pUserData, pCB, pvdata, precision, minimum_width, left_justified, TS_STYLE_RFC3339));
+} /* size_t cbk_format_rfc3339_ns(...) */
+
+size_t cbk_format_tscompact(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   return (format_timespec(pUserData, pCB, pvdata, precision, minimum_width, left_justified, TS_STYLE_COMPACT));
+} /* size_t cbk_format_tscompact(...) */
+
+size_t cbk_format_tscompact_ns(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   return (format_nanoseconds(pUserData, pCB, pvdata, precision, minimum_width, left_justified, TS_STYLE_COMPACT));
+} /* size_t cbk_format_tscompact_ns(...) */
+
+
+/* ========================================================================= *\
+   Binary data
+\* ========================================================================= */
+
+#define ENC_BLOCK 512 /* size of the output blocks on the stack */
+
+typedef char * (ENCODER) (char * pd, const uint8_t * ps, size_t Length, size_t Offset, uint8_t alt);
+
+typedef struct BYTE_CODEC_S BYTE_CODEC;
+struct BYTE_CODEC_S
+{
+   ENCODER * pEncode;                                 /* encodes a block of the input */
+   size_t    (*pLength) (size_t Length, uint8_t alt); /* length of the whole output */
+   size_t    Chunk;                                   /* input bytes of an output block of at most ENC_BLOCK bytes */
+};
+
+static const char b64_std[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char b64_url[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+static const char b32_std[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+
+#ifdef CBK_SSE2
+/* hex_sse2 converts the nibbles of 16 bytes to 16 hexadecimal digits */
+static __m128i hex_sse2(__m128i v, __m128i adjust)
+{
+   __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(9)), adjust);
+
+   return (_mm_add_epi8(_mm_add_epi8(v, _mm_set1_epi8('0')), letters));
+} /* __m128i hex_sse2(__m128i v, __m128i adjust) */
+#endif
+
+/* enc_hex writes two hexadecimal digits per byte */
+static char * enc_hex(char * pd, const uint8_t * ps, size_t Length, size_t Offset, uint8_t alt)
+{
+   const char * digits = alt ? hex_uc : hex_lc;
+
+#ifdef CBK_SSE2
+   __m128i      mask   = _mm_set1_epi8(0x0f);
+   __m128i      adjust = _mm_set1_epi8(alt ? 'A' - '0' - 10 : 'a' - '0' - 10);
+
+   for(; Length >= 16; Length -= 16, ps += 16, pd += 32)
+   {
+      __m128i v  = _mm_loadu_si128((const __m128i *) ps);
+      __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+      __m128i lo = _mm_and_si128(v, mask);
+
+      _mm_storeu_si128((__m128i *) pd,        hex_sse2(_mm_unpacklo_epi8(hi, lo), adjust));
+      _mm_storeu_si128((__m128i *) (pd + 16), hex_sse2(_mm_unpackhi_epi8(hi, lo), adjust));
+   }
+#endif
+
+   (void) Offset;
+   return (put_hex(pd, ps, Length, digits));
+} /* char * enc_hex(char * pd, const uint8_t * ps, size_t Length, size_t Offset, uint8_t alt) */
+
+static size_t len_hex(size_t Length, uint8_t alt)
+{
+   (void) alt;
+   return (2 * Length);
+} /* size_t len_hex(size_t Length, uint8_t alt) */
+
+
+/* enc_hex_sp writes the bytes as hexadecimal digits separated by a space */
+static char * enc_hex_sp(char * pd, const uint8_t * ps, size_t Length, size_t Offset, uint8_t alt)
+{
+   const char * digits = alt ? hex_uc : hex_lc;
+
+   while(Length--)
+   {
+      if(Offset++)
+         *pd++ = ' ';
+
+      *pd++ = digits[*ps >> 4];
+      *pd++ = digits[*ps++ & 0xf];
+   }
+
+   return (pd);
+} /* char * enc_hex_sp(char * pd, const uint8_t * ps, size_t Length, size_t Offset, uint8_t alt) */
+
+static size_t len_hex_sp(size_t Length, uint8_t alt)
+{
+   (void) alt;
+   return (Length ? 3 * Length - 1 : 0);
+} /* size_t len_hex_sp(size_t Length, uint8_t alt) */
+
+
+/* enc_hexdump writes lines of 16 bytes in the canonical format of hexdump -C */
+static char * enc_hexdump(char * pd, const uint8_t * ps, size_t Length, size_t Offset, uint8_t alt)
+{
+   const char * digits = alt ? hex_uc : hex_lc;
+
+   while(Length)
+   {
+      size_t n = (Length < 16) ? Length : 16;
+      size_t i;
+      int    shift;
+
+      for(shift = 28; shift >= 0; shift -= 4)
+         *pd++ = digits[(Offset >> shift) & 0xf];
+
+      *pd++ = ' ';
+
+      for(i = 0; i < 16; ++i)
+      {
+         if(!(i & 7))
+            *pd++ = ' ';
+
+         if(i < n)
+         {
+            pd[0] = digits[ps[i] >> 4];
+            pd[1] = digits[ps[i] & 0xf];
+         }
+         else
+            pd[0] = pd[1] = ' ';
+
+         pd[2] = ' ';
+         pd   += 3;
+      }
+
+      *pd++ = ' ';
+      *pd++ = '|';
+
+      for(i = 0; i < n; ++i)
+         *pd++ = ((ps[i] >= 0x20) && (ps[i] < 0x7f)) ? (char) ps[i] : '.';
+
+      *pd++ = '|';
+      *pd++ = '\n';
+
+      ps     += n;
+      Offset += n;
+      Length -= n;
+   }
+
+   return (pd);
+} /* char * enc_hexdump(char * pd, const uint8_t * ps, size_t Length, size_t Offset, uint8_t alt) */
+
+static size_t len_hexdump(size_t Length, uint8_t alt)
+{
+   (void) alt;
+   return ((Length / 16) * 79 + ((Length % 16) ? 63 + (Length % 16) : 0));
+} /* size_t len_hexdump(size_t Length, uint8_t alt) */
+
+
+#ifdef CBK_SSSE3
+/* b64_ssse3 encodes 12 of the 16 loaded bytes into 16 characters (W. Mula, D. Lemire) */
+static __m128i b64_ssse3(__m128i in, __m128i shift_lut)
+{
+   __m128i t0;
+   __m128i t1;
+   __m128i idx;
+   __m128i res;
+
+   in  = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+   t0  = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+   t1  = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+   idx = _mm_or_si128(t0, t1);
+
+   res = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+   res = _mm_or_si128(res, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), idx), _mm_set1_epi8(13)));
+   return (_mm_add_epi8(_mm_shuffle_epi8(shift_lut, res), idx));
+} /* __m128i b64_ssse3(__m128i in, __m128i shift_lut) */
+#endif
+
+/* enc_base64 encodes groups of 3 bytes into 4 characters of RFC 4648 or with alt of the URL safe alphabet without padding */
+static char * enc_base64(char * pd, const uint8_t * ps, size_t Length, size_t Offset, uint8_t alt)
+{
+   const char * pa = alt ? b64_url : b64_std;
+
+#ifdef CBK_SSSE3
+   __m128i      lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                    '0' - 52, '0' - 52, '0' - 52, (char) (pa[62] - 62), (char) (pa[63] - 63), 'A', 0, 0);
+
+   for(; Length >= 16; Length -= 12, ps += 12, pd += 16)
+      _mm_storeu_si128((__m128i *) pd, b64_ssse3(_mm_loadu_si128((const __m128i *) ps), lut));
+#endif
+
+   for(; Length >= 3; Length -= 3, ps += 3, pd += 4)
+   {
+      uint32_t v = ((uint32_t) ps[0] << 16) | ((uint32_t) ps[1] << 8) | ps[2];
+
+      pd[0] = pa[v >> 18];
+      pd[1] = pa[(v >> 12) & 0x3f];
+      pd[2] = pa[(v >> 6) & 0x3f];
+      pd[3] = pa[v & 0x3f];
+   }
+
+   if(Length)
+   { /* end of the data */
+      uint32_t v = ((uint32_t) ps[0] << 16) | ((Length > 1) ? ((uint32_t) ps[1] << 8) : 0);
+
+      *pd++ = pa[v >> 18];
+      *pd++ = pa[(v >> 12) & 0x3f];
+
+      if(Length > 1)
+         *pd++ = pa[(v >> 6) & 0x3f];
+      else if(!alt)
+         *pd++ = '=';
+
+      if(!alt)
+         *pd++ = '=';
+   }
+
+   (void) Offset;
+   return (pd);
+} /* char * enc_base64(char * pd, const uint8_t * ps, size_t Length, size_t Offset, uint8_t alt) */
+
+static size_t len_base64(size_t Length, uint8_t alt)
+{
+   return (alt ? (Length / 3) * 4 + ((Length % 3) ? (Length % 3) + 1 : 0) : ((Length + 2) / 3) * 4);
+} /* size_t len_base64(size_t Length, uint8_t alt) */
+
+
+/* enc_base32 encodes groups of 5 bytes into 8 characters of RFC 4648 and omits the padding with alt */
+static char * enc_base32(char * pd, const uint8_t * ps, size_t Length, size_t Offset, uint8_t alt)
+{
+   static const uint8_t chars[5] = { 2, 4, 5, 7, 8 }; /* characters of 1 to 5 bytes */
+
+   while(Length)
+   {
+      size_t   n = (Length < 5) ? Length : 5;
+      uint64_t v = 0;
+      size_t   i;
+
+      for(i = 0; i < 5; ++i)
+         v = (v << 8) | ((i < n) ? ps[i] : 0);
+
+      for(i = 0; i < chars[n - 1]; ++i)
+         *pd++ = b32_std[(v >> (35 - 5 * i)) & 0x1f];
+
+      for(; !alt && (i < 8); ++i)
+         *pd++ = '=';
+
+      ps     += n;
+      Length -= n;
+   }
+
+   (void) Offset;
+   return (pd);
+} /* char * enc_base32(char * pd, const uint8_t * ps, size_t Length, size_t Offset, uint8_t alt) */
+
+static size_t len_base32(size_t Length, uint8_t alt)
+{
+   static const uint8_t chars[5] = { 0, 2, 4, 5, 7 }; /* characters of the remaining bytes */
+
+   return (alt ? (Length / 5) * 8 + chars[Length % 5] : ((Length + 4) / 5) * 8);
+} /* size_t len_base32(size_t Length, uint8_t alt) */
+
+
+static const BYTE_CODEC codec_hex     = { &enc_hex,     &len_hex,     ENC_BLOCK / 2 };
+static const BYTE_CODEC codec_hex_sp  = { &enc_hex_sp,  &len_hex_sp,  ENC_BLOCK / 3 };
+static const BYTE_CODEC codec_hexdump = { &enc_hexdump, &len_hexdump, (ENC_BLOCK / 79) * 16 };
+static const BYTE_CODEC codec_base64  = { &enc_base64,  &len_base64,  (ENC_BLOCK / 4) * 3 };
+static const BYTE_CODEC codec_base32  = { &enc_base32,  &len_base32,  (ENC_BLOCK / 8) * 5 };
+
+
+/* ------------------------------------------------------------------------- *\
+   print_bytes encodes the bytes in blocks. The blocks are written directly
+   into the memory of a reserve and commit sink if possible or otherwise
+   into a buffer on the stack that is passed to the callback.
+\* ------------------------------------------------------------------------- */
+static size_t print_bytes(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t alt, const BYTE_CODEC * pc)
+{
+   char              buf[ENC_BLOCK];
+   const CBK_BYTES * pb   = (const CBK_BYTES *) pvdata;
+   PRINTF_SINK *     psk  = NULL;
+   const uint8_t *   ps;
+   size_t            Length;
+   size_t            Offset = 0;
+   size_t            zRet;
+
+   if(!pb || (!pb->pData && pb->Length))
+      return (cbk_print_string(pUserData, pCB, "<NULL>", 6, minimum_width, left_justified));
+
+   ps     = (const uint8_t *) pb->pData;
+   Length = (pb->Length < precision) ? pb->Length : precision;
+   zRet   = pc->pLength(Length, alt);
+
+   if((pCB == callback_printf_sink_callback()) && ((PRINTF_SINK *) pUserData)->pReserve)
+      psk = (PRINTF_SINK *) pUserData;
+
+   if(!left_justified && (minimum_width > zRet))
+      cbk_print_string(pUserData, pCB, "", 0, minimum_width - zRet, 0);
+
+   while(Length)
+   {
+      size_t n  = (Length < pc->Chunk) ? Length : pc->Chunk;
+      size_t nd = pc->pLength(Offset + n, alt) - pc->pLength(Offset, alt);
+      char * pd = psk ? psk->pReserve(psk->pUserData, nd) : NULL;
+
+      if(pd)
+      {
+         pc->pEncode(pd, ps, n, Offset, alt);
+         psk->pCommit(psk->pUserData, nd);
+      }
+      else
+      {
+         pc->pEncode(buf, ps, n, Offset, alt);
+         pCB(pUserData, buf, nd);
+      }
+
+      ps     += n;
+      Offset += n;
+      Length -= n;
+   }
+
+   if(left_justified && (minimum_width > zRet))
+      cbk_print_string(pUserData, pCB, "", 0, minimum_width - zRet, 1);
+
+   return ((minimum_width > zRet) ? minimum_width : zRet);
+} /* size_t print_bytes(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   Hexadecimal, hex dump, base64 and base32 output of a CBK_BYTES.
+\* ------------------------------------------------------------------------- */
+
+size_t cbk_format_hex(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   return (print_bytes(pUserData, pCB, pvdata, precision, minimum_width, left_justified, prefixing, &codec_hex));
+} /* size_t cbk_format_hex(...) */
+
+size_t cbk_format_hex_sp(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   return (print_bytes(pUserData, pCB, pvdata, precision, minimum_width, left_justified, prefixing, &codec_hex_sp));
+} /* size_t cbk_format_hex_sp(...) */
+
+size_t cbk_format_hexdump(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   const CBK_BYTES * pb     = (const CBK_BYTES *) pvdata;
+   const char *      digits = prefixing ? hex_uc : hex_lc;
+   char              line[9];
+   size_t            Offset;
+   size_t            zRet;
+   int               shift;
+
+   zRet = print_bytes(pUserData, pCB, pvdata, precision, 0, 0, prefixing, &codec_hexdump);
+
+   if(!pb || !pb->pData || !pb->Length || !precision)
+      return (zRet);
+
+   /* like hexdump -C the last line holds the offset behind the data */
+   Offset = (pb->Length < precision) ? pb->Length : precision;
+
+   for(shift = 28; shift >= 0; shift -= 4)
+      line[(28 - shift) / 4] = digits[(Offset >> shift) & 0xf];
+
+   line[8] = '\n';
+   pCB(pUserData, line, 9);
+
+   return (zRet + 9);
+} /* size_t cbk_format_hexdump(...) */
+
+size_t cbk_format_base64(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   return (print_bytes(pUserData, pCB, pvdata, precision, minimum_width, left_justified, prefixing, &codec_base64));
+} /* size_t cbk_format_base64(...) */
+
+size_t cbk_format_base32(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   return (print_bytes(pUserData, pCB, pvdata, precision, minimum_width, left_justified, prefixing, &codec_base32));
+} /* size_t cbk_format_base32(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   cbk_formats_register registers all built-in formatters.
+\* ------------------------------------------------------------------------- */
+
+int cbk_formats_register(void)
+{
+   static const PRINTF_NAMED_FORMATTER formats[] =
+   {
+      { "ipv4",         &cbk_format_ipv4         },
+      { "ipv6",         &cbk_format_ipv6         },
+      { "mac",          &cbk_format_mac          },
+      { "uuid",         &cbk_format_uuid         },
+      { "sockaddr",     &cbk_format_sockaddr     },
+      { "iso8601",      &cbk_format_iso8601      },
+      { "iso8601_ns",   &cbk_format_iso8601_ns   },
+      { "rfc3339",      &cbk_format_rfc3339      },
+      { "rfc3339_ns",   &cbk_format_rfc3339_ns   },
+      { "tscompact",    &cbk_format_tscompact    },
+      { "tscompact_ns", &cbk_format_tscompact_ns },
+      { "hex",          &cbk_format_hex          },
+      { "hex_sp",       &cbk_format_hex_sp       },
+      { "hexdump",      &cbk_format_hexdump      },
+      { "base64",       &cbk_format_base64       },
+      { "base32",       &cbk_format_base32       }
+   };
+
+   return (callback_printf_register(formats, sizeof(formats) / sizeof(formats[0])));
+} /* int cbk_formats_register(void) */
+
+
+/* ========================================================================= *\
+   E N D   O F   F I L E
+\* ========================================================================= */
@@ -0,0 +1,223 @@
+/*****************************************************************************\
+*                                                                             *
+*  FILE NAME:     cbk_formats.h                                               *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  DESCRIPTION:   built-in named formatters of callback_printf                *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  COPYRIGHT:     (c) 2026 Dipl.-Ing. Klaus Lux (Aachen, Germany)             *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  ORIGIN:        https://github.com/klux21/callback_printf                   *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+* Civil Usage Public License, Version 1.2, June 2026                          *
+*                                                                             *
+* Redistribution and use in source and binary forms, with or without          *
+* modification, are permitted provided that the following conditions are met: *
+*                                                                             *
+* 1. Redistributions of source code must retain the above copyright           *
+*    notice, this list of conditions, the explanation of terms                *
+*    and the following disclaimer.                                            *
+*                                                                             *
+* 2. Redistributions in binary form must reproduce the above copyright        *
+*    notice, this list of conditions and the following disclaimer in the      *
+*    documentation or other materials provided with the distribution.         *
+*                                                                             *
+* 3. All modified files must carry prominent notices stating that the         *
+*    files have been changed.                                                 *
+*                                                                             *
+* 4. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are designed or           *
+*    intended to harm, to kill or to forcibly immobilize people.              *
+*                                                                             *
+* 5. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are intended to           *
+*    monitor, to track, to change or to control the behavior, the             *
+*    constitution, the location or the communication of any people or         *
+*    their property without the explicit and prior agreement of those         *
+*    people except those devices and systems are solely designed for          *
+*    saving or protecting peoples life or health.                             *
+*                                                                             *
+* 6. The source code and binary forms and any derivative works are not        *
+*    stored or executed in any systems or devices that are intended           *
+*    for the production of any of the systems or devices that                 *
+*    have been stated before except the ones for saving or protecting         *
+*    peoples life or health only.                                             *
+*                                                                             *
+* The term 'systems' in all clauses shall include all types and combinations  *
+* of physical, virtualized or simulated hardware and software and any kind    *
+* of data storage.                                                            *
+*                                                                             *
+* The term 'devices' shall include any kind of local or non-local control     *
+* system of the stated devices as part of that device as well. Any assembly   *
+* of more than one device is one and the same device regarding this license.  *
+*                                                                             *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" *
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   *
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  *
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   *
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         *
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        *
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    *
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     *
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     *
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  *
+* POSSIBILITY OF SUCH DAMAGE.                                                 *
+*                                                                             *
+\*****************************************************************************/
+
+#ifndef CBK_FORMATS_H
+#define CBK_FORMATS_H
+
+#include <callback_printf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- *\
+   cbk_formats_register registers all built-in formatters of this file for
+   the use by %{name}. It returns 0 on success or the error code of
+   callback_printf_register.
+\* ------------------------------------------------------------------------- */
+int cbk_formats_register(void);
+
+
+/* ========================================================================= *\
+   Network addresses and identifiers
+   The formatters write the text into a small stack buffer and pass it at
+   once to the callback with the minimum width and the justification of the
+   conversion. A NULL pointer is printed as <NULL>.
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_ipv4 prints the 4 bytes of an IPv4 address in network byte
+   order (e.g. a struct in_addr) as dotted quad. %{ipv4}
+\* ------------------------------------------------------------------------- */
+size_t cbk_format_ipv4(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing);
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_ipv6 prints the 16 bytes of an IPv6 address (e.g. a struct
+   in6_addr) in the recommended text form of RFC 5952. The longest run of
+   two or more zero groups is compressed to "::" and IPv4 mapped addresses
+   are printed as ::ffff:a.b.c.d. The '#' flag prints the full form
+   without compression. %{ipv6}
+\* ------------------------------------------------------------------------- */
+size_t cbk_format_ipv6(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing);
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_mac prints the 6 bytes of a MAC address as 00:11:22:aa:bb:cc
+   or with the '#' flag in upper case letters. %{mac}
+\* ------------------------------------------------------------------------- */
+size_t cbk_format_mac(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing);
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_uuid prints the 16 bytes of a UUID in the canonical form
+   8-4-4-4-12 or with the '#' flag in upper case letters. %{uuid}
+\* ------------------------------------------------------------------------- */
+size_t cbk_format_uuid(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing);
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_sockaddr prints a struct sockaddr of the families AF_INET as
+   a.b.c.d:port and AF_INET6 as [ipv6]:port (with %scope for a scope ID).
+   The port is omitted if it is zero or if the '#' flag is specified. An
+   unsupported address family is reported as error. %{sockaddr}
+\* ------------------------------------------------------------------------- */
+size_t cbk_format_sockaddr(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing);
+
+
+/* ========================================================================= *\
+   Timestamps
+   The formatters print UTC timestamps of a struct timespec or of an int64_t
+   of nanoseconds since the epoch (the _ns versions). The precision is the
+   number of digits of the fraction of the second from 0 to 9 and defaults
+   to 6. The fraction is truncated. The text of the date and of the time up
+   to the seconds is cached per thread, so that records of the same second
+   write just the digits of the fraction. Years before 0 or after 9999 are
+   reported as error.
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_iso8601 prints the extended format of ISO 8601 like
+   2026-10-19T12:34:56.123456Z. %{iso8601} and %{iso8601_ns}
+\* ------------------------------------------------------------------------- */
+size_t cbk_format_iso8601(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing);
+size_t cbk_format_iso8601_ns(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing);
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_rfc3339 prints 2026-10-19 12:34:56.123456+00:00 with the
+   space separator and the numeric offset of RFC 3339. %{rfc3339} and
+   %{rfc3339_ns}
+\* ------------------------------------------------------------------------- */
+size_t cbk_format_rfc3339(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing);
+size_t cbk_format_rfc3339_ns(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing);
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_tscompact prints the basic format of ISO 8601 without
+   separators like 20261019T123456.123456Z. %{tscompact} and %{tscompact_ns}
+\* ------------------------------------------------------------------------- */
+size_t cbk_format_tscompact(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing);
+size_t cbk_format_tscompact_ns(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing);
+
+
+/* ========================================================================= *\
+   Binary data
+   The formatters take a pointer to a CBK_BYTES with the address and the
+   length of the data. The precision limits the number of bytes to encode.
+   The output is encoded in blocks of 512 bytes that are written directly
+   into the memory of a reserve and commit sink (see callback_printf_sink)
+   or passed to the callback otherwise.
+\* ========================================================================= */
+
+typedef struct CBK_BYTES_S CBK_BYTES;
+struct CBK_BYTES_S
+{
+   const void * pData;  /* address of the data */
+   size_t       Length; /* length of the data in bytes */
+};
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_hex prints two hexadecimal digits per byte like 00a1ff and
+   cbk_format_hex_sp separates the bytes by a space like 00 a1 ff. The '#'
+   flag selects upper case letters. %{hex} and %{hex_sp}
+\* ------------------------------------------------------------------------- */
+size_t cbk_format_hex(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing);
+size_t cbk_format_hex_sp(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing);
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_hexdump prints lines of 16 bytes with the offset, the
+   hexadecimal values and the printable characters in the canonical format
+   of hexdump -Cv, followed by a line with the offset behind the data. Every
+   line ends with a newline and the width is ignored. The '#' flag selects
+   upper case letters. %{hexdump}
+\* ------------------------------------------------------------------------- */
+size_t cbk_format_hexdump(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing);
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_base64 prints base64 of RFC 4648 with padding. The '#' flag
+   selects the URL safe alphabet without padding. %{base64}
+\* ------------------------------------------------------------------------- */
+size_t cbk_format_base64(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing);
+
+/* ------------------------------------------------------------------------- *\
+   cbk_format_base32 prints base32 of RFC 4648 with padding. The '#' flag
+   omits the padding. %{base32}
+\* ------------------------------------------------------------------------- */
+size_t cbk_format_base32(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing);
+
+
+#ifdef __cplusplus
+}/* extern "C" */
+#endif
+
+#endif /* CBK_FORMATS_H */
+
+/* ========================================================================= *\
+   E N D   O F   F I L E
+\* ========================================================================= */
@@ -0,0 +1,862 @@
+/*****************************************************************************\
+*                                                                             *
+*  FILE NAME:     cbk_record.c                                                *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  DESCRIPTION:   structured log records of callback_printf                   *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  COPYRIGHT:     (c) 2026 Dipl.-Ing. Klaus Lux (Aachen, Germany)             *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  ORIGIN:        https://github.com/klux21/callback_printf                   *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+* Civil Usage Public License, Version 1.2, June 2026                          *
+*                                                                             *
+* Redistribution and use in source and binary forms, with or without          *
+* modification, are permitted provided that the following conditions are met: *
+*                                                                             *
+* 1. Redistributions of source code must retain the above copyright           *
+*    notice, this list of conditions, the explanation of terms                *
+*    and the following disclaimer.                                            *
+*                                                                             *
+* 2. Redistributions in binary form must reproduce the above copyright        *
+*    notice, this list of conditions and the following disclaimer in the      *
+*    documentation or other materials provided with the distribution.         *
+*                                                                             *
+* 3. All modified files must carry prominent notices stating that the         *
+*    files have been changed.                                                 *
+*                                                                             *
+* 4. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are designed or           *
+*    intended to harm, to kill or to forcibly immobilize people.              *
+*                                                                             *
+* 5. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are intended to           *
+*    monitor, to track, to change or to control the behavior, the             *
+*    constitution, the location or the communication of any people or         *
+*    their property without the explicit and prior agreement of those         *
+*    people except those devices and systems are solely designed for          *
+*    saving or protecting peoples life or health.                             *
+*                                                                             *
+* 6. The source code and binary forms and any derivative works are not        *
+*    stored or executed in any systems or devices that are intended           *
+*    for the production of any of the systems or devices that                 *
+*    have been stated before except the ones for saving or protecting         *
+*    peoples life or health only.                                             *
+*                                                                             *
+* The term 'systems' in all clauses shall include all types and combinations  *
+* of physical, virtualized or simulated hardware and software and any kind    *
+* of data storage.                                                            *
+*                                                                             *
+* The term 'devices' shall include any kind of local or non-local control     *
+* system of the stated devices as part of that device as well. Any assembly   *
+* of more than one device is one and the same device regarding this license.  *
+*                                                                             *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" *
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   *
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  *
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   *
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         *
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        *
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    *
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     *
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     *
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  *
+* POSSIBILITY OF SUCH DAMAGE.                                                 *
+*                                                                             *
+\*****************************************************************************/
+
+
+#undef   _CRT_ERRNO_DEFINED
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <wchar.h>
+
+#ifdef _WIN32
+#pragma warning(disable : 4100 4127 4706 4710)
+#endif
+
+#include <cbk_record.h>
+
+/* ========================================================================= *\
+   Compiled schema
+\* ========================================================================= */
+
+#define FIELD_INT     1 /* signed integer */
+#define FIELD_UINT    2 /* unsigned integer */
+#define FIELD_DOUBLE  3 /* double */
+#define FIELD_LDOUBLE 4 /* long double */
+#define FIELD_CHAR    5 /* character */
+#define FIELD_STRING  6 /* string */
+#define FIELD_PTR     7 /* pointer */
+#define FIELD_NAMED   8 /* named formatter */
+
+#define RECORD_STYLES 3 /* number of output styles */
+
+typedef struct RECORD_FIELD_S RECORD_FIELD;
+struct RECORD_FIELD_S
+{
+   PRINTF_SPEC         Spec;                          /* conversion of the text style */
+   PRINTF_SPEC         Plain;                         /* conversion of logfmt and JSON without width, padding and sign flags */
+   PRINTF_V_CALLBACK * pNamed;                        /* callback of %{name} */
+   int                 Class;                         /* FIELD_... */
+   uint8_t             Number;                        /* the value is a JSON number */
+   size_t              Fragment[RECORD_STYLES];       /* offset of the constant text in front of the value */
+   size_t              FragmentLength[RECORD_STYLES]; /* length of the constant text in front of the value */
+};
+
+struct CBK_RECORD_S
+{
+   size_t         Count;                    /* number of fields */
+   RECORD_FIELD * pFields;                  /* fields */
+   char *         pText;                    /* constant text of all fragments */
+   size_t         End[RECORD_STYLES];       /* offset of the text at the end of a record */
+   size_t         EndLength[RECORD_STYLES]; /* length of the text at the end of a record */
+};
+
+
+/* record_key_char returns whether c is allowed within a key */
+static int record_key_char(char c)
+{
+   return (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9')) || (c == '_') || (c == '.') || (c == '-'));
+} /* int record_key_char(char c) */
+
+
+/* ------------------------------------------------------------------------- *\
+   record_parse parses the conversion of a field and returns the position
+   behind it or NULL for an invalid or unsupported conversion.
+\* ------------------------------------------------------------------------- */
+static const char * record_parse(const char * ps, RECORD_FIELD * pf)
+{
+   PRINTF_SPEC * sp      = &pf->Spec;
+   size_t        size    = 0;
+   size_t        skip    = 0;
+   int           plain_l = 0; /* just 'l' for wide characters and doubles */
+   char          fc;
+
+   sp->Precision = ~(size_t) 0;
+
+   if(*ps++ != '%')
+      return (NULL);
+
+   for(;; ++ps)
+   {
+      if(*ps == '-')
+         sp->Flags |= PRINTF_SPEC_LEFT;
+      else if(*ps == '+')
+         sp->Flags |= PRINTF_SPEC_PLUS;
+      else if(*ps == ' ')
+         sp->Flags |= PRINTF_SPEC_SPACE;
+      else if(*ps == '#')
+         sp->Flags |= PRINTF_SPEC_ALT;
+      else if(*ps == '0')
+         sp->Flags |= PRINTF_SPEC_ZERO;
+      else
+         break;
+   }
+
+   if(*ps == '*')
+   {
+      sp->Flags |= PRINTF_SPEC_WIDTH_ARG;
+      ++ps;
+   }
+   else
+   {
+      while((*ps >= '0') && (*ps <= '9'))
+         sp->Width = (sp->Width * 10) + (size_t) (*ps++ - '0');
+   }
+
+   if(*ps == '.')
+   {
+      if(*++ps == '*')
+      {
+         sp->Flags |= PRINTF_SPEC_PREC_ARG;
+         ++ps;
+      }
+      else
+      {
+         sp->Precision = 0;
+
+         while((*ps >= '0') && (*ps <= '9'))
+            sp->Precision = (sp->Precision * 10) + (size_t) (*ps++ - '0');
+      }
+   }
+
+   if(*ps == '{')
+   { /* named formatter */
+      const char * pn = ++ps;
+
+      while(*ps && (*ps != '}'))
+         ++ps;
+
+      if((*ps != '}') || !(pf->pNamed = callback_printf_named(pn, (size_t) (ps - pn))))
+         return (NULL);
+
+      pf->Class = FIELD_NAMED;
+      return (ps + 1);
+   }
+
+   if(*ps == 'r')
+   { /* numeric base */
+      if(ps[1] == '*')
+         sp->Flags |= PRINTF_SPEC_BASE_ARG;
+      else if((ps[1] >= '2') && (ps[1] <= '9'))
+      {
+         sp->Flags |= PRINTF_SPEC_BASE;
+         sp->Base   = (uint8_t) (ps[1] - '0');
+      }
+      else
+         return (NULL);
+
+      ps += 2;
+   }
+
+   /* size modifiers, skip is the number of their characters */
+   if((ps[0] == 'h') && (ps[1] == 'h'))
+   {
+      size = 1;
+      skip = 2;
+   }
+   else if(ps[0] == 'h')
+   {
+      size = 2;
+      skip = 1;
+   }
+   else if((ps[0] == 'l') && (ps[1] == 'l'))
+   {
+      size = 8;
+      skip = 2;
+   }
+   else if((ps[0] == 'l') && ((ps[1] == '1') || (ps[1] == '2') || (ps[1] == '4') || (ps[1] == '8')))
+   {
+      size = (size_t) (ps[1] - '0');
+      skip = 2;
+   }
+   else if(ps[0] == 'l')
+   {
+      size = sizeof(long);
+      skip = 1;
+      plain_l = 1;
+   }
+   else if(ps[0] == 'L')
+   {
+      size = 16;
+      skip = 1;
+   }
+   else if((ps[0] == 'I') && (ps[1] == '6') && (ps[2] == '4'))
+   {
+      size = 8;
+      skip = 3;
+   }
+   else if((ps[0] == 'I') && (ps[1] == '3') && (ps[2] == '2'))
+   {
+      size = 4;
+      skip = 3;
+   }
+   else if((ps[0] == 'z') || (ps[0] == 'I'))
+   {
+      size = sizeof(size_t);
+      skip = 1;
+   }
+   else if(ps[0] == 't')
+   {
+      size = sizeof(ptrdiff_t);
+      skip = 1;
+   }
+   else if(ps[0] == 'j')
+   {
+      size = sizeof(int64_t);
+      skip = 1;
+   }
+
+   ps += skip;
+   fc       = *ps++;
+   sp->Conv = fc;
+
+   if((fc == 'd') || (fc == 'i') || (fc == 'u') || (fc == 'x') || (fc == 'X') || (fc == 'o') || (fc == 'b') || (fc == 'B'))
+   {
+      if(size == 16)
+         return (NULL);
+
+      sp->Size   = (uint8_t) ((size == sizeof(int)) ? 0 : size);
+      pf->Class  = ((fc == 'd') || (fc == 'i')) ? FIELD_INT : FIELD_UINT;
+      pf->Number = (uint8_t) (((fc == 'd') || (fc == 'i') || (fc == 'u')) && !(sp->Flags & (PRINTF_SPEC_BASE | PRINTF_SPEC_BASE_ARG)));
+   }
+   else if((fc == 'e') || (fc == 'E') || (fc == 'f') || (fc == 'F') || (fc == 'g') || (fc == 'G') || (fc == 'a') || (fc == 'A'))
+   {
+      if(plain_l)
+         size = 0; /* %lf is a double */
+
+      if(size && (size != 16))
+         return (NULL);
+
+      sp->Size   = (uint8_t) size;
+      pf->Class  = size ? FIELD_LDOUBLE : FIELD_DOUBLE;
+      pf->Number = (uint8_t) (((fc | 0x20) != 'a') && !(sp->Flags & (PRINTF_SPEC_BASE | PRINTF_SPEC_BASE_ARG)));
+   }
+   else if((fc == 's') || (fc == 'c'))
+   {
+      if(plain_l)
+         size = sizeof(wchar_t);
+
+      if((size != 0) && (size != 1) && (size != 2) && (size != 4) && (size != sizeof(wchar_t)))
+         return (NULL);
+
+      if(sp->Flags & (PRINTF_SPEC_BASE | PRINTF_SPEC_BASE_ARG))
+         return (NULL);
+
+      sp->Size  = (uint8_t) size;
+      pf->Class = (fc == 's') ? FIELD_STRING : FIELD_CHAR;
+   }
+   else if((fc == 'p') || (fc == 'P'))
+   {
+      if(size || (sp->Flags & (PRINTF_SPEC_BASE | PRINTF_SPEC_BASE_ARG)))
+         return (NULL);
+
+      pf->Class = FIELD_PTR;
+   }
+   else
+      return (NULL);
+
+   return (ps);
+} /* const char * record_parse(const char * ps, RECORD_FIELD * pf) */
+
+
+/* ------------------------------------------------------------------------- *\
+   record_append appends text to the fragments and returns the new length.
+   Without pText it just counts.
+\* ------------------------------------------------------------------------- */
+static size_t record_append(char * pText, size_t Pos, const char * ps, size_t Length)
+{
+   if(pText)
+      memcpy(pText + Pos, ps, Length);
+
+   return (Pos + Length);
+} /* size_t record_append(char * pText, size_t Pos, const char * ps, size_t Length) */
+
+
+/* ------------------------------------------------------------------------- *\
+   record_fragments builds the constant text of all fields and styles and
+   returns its length. The fragment in front of a value contains the
+   closing quote of the previous value, the separator, the key and the
+   opening quote of the value.
+\* ------------------------------------------------------------------------- */
+static size_t record_fragments(CBK_RECORD * pRec, const char * pSchema, char * pText)
+{
+   size_t pos = 0;
+   int    style;
+
+   for(style = 0; style < RECORD_STYLES; ++style)
+   {
+      const char * ps     = pSchema;
+      int          quoted = 0; /* the previous value is quoted */
+      size_t       i;
+
+      for(i = 0; i < pRec->Count; ++i)
+      {
+         RECORD_FIELD * pf  = &pRec->pFields[i];
+         const char *   pk;
+         size_t         start = pos;
+         size_t         klen;
+
+         while(*ps == ' ')
+            ++ps;
+
+         pk = ps;
+         while(*ps != '=')
+            ++ps;
+
+         klen = (size_t) (ps - pk);
+
+         while(*ps && (*ps != ' '))
+            ++ps;
+
+         if(quoted)
+            pos = record_append(pText, pos, "\"", 1);
+
+         quoted = (style == CBK_RECORD_LOGFMT) ? (pf->Class == FIELD_NAMED) :
+                  (style == CBK_RECORD_JSON)   ? !pf->Number : 0;
+
+         if(style == CBK_RECORD_TEXT)
+         {
+            if(i)
+               pos = record_append(pText, pos, " ", 1);
+         }
+         else if(style == CBK_RECORD_LOGFMT)
+         {
+            if(i)
+               pos = record_append(pText, pos, " ", 1);
+
+            pos = record_append(pText, pos, pk, klen);
+            pos = record_append(pText, pos, "=", 1);
+         }
+         else
+         {
+            pos = record_append(pText, pos, i ? ",\"" : "{\"", 2);
+            pos = record_append(pText, pos, pk, klen);
+            pos = record_append(pText, pos, "\":", 2);
+         }
+
+         if(quoted)
+            pos = record_append(pText, pos, "\"", 1);
+
+         pf->Fragment[style]       = start;
+         pf->FragmentLength[style] = pos - start;
+      }
+
+      pRec->End[style] = pos;
+
+      if(quoted)
+         pos = record_append(pText, pos, "\"", 1);
+
+      if(style == CBK_RECORD_JSON)
+         pos = record_append(pText, pos, pRec->Count ? "}" : "{}", pRec->Count ? 1 : 2);
+
+      pos = record_append(pText, pos, "\n", 1);
+      pRec->EndLength[style] = pos - pRec->End[style];
+   }
+
+   return (pos);
+} /* size_t record_fragments(CBK_RECORD * pRec, const char * pSchema, char * pText) */
+
+
+/* ------------------------------------------------------------------------- *\
+   cbk_record_create compiles a schema.
+\* ------------------------------------------------------------------------- */
+CBK_RECORD * cbk_record_create(const char * pSchema)
+{
+   CBK_RECORD * pRec  = NULL;
+   const char * ps    = pSchema;
+   size_t       count = 0;
+   size_t       i;
+   int          err   = EINVAL;
+
+   if(!pSchema)
+      goto Exit;
+
+   while(*ps)
+   { /* count and check the fields */
+      while(*ps == ' ')
+         ++ps;
+
+      if(!*ps)
+         break;
+
+      if(!record_key_char(*ps))
+         goto Exit;
+
+      while(record_key_char(*ps))
+         ++ps;
+
+      if((*ps != '=') || (ps[1] != '%'))
+         goto Exit;
+
+      while(*ps && (*ps != ' '))
+         ++ps;
+
+      ++count;
+   }
+
+   err  = ENOMEM;
+   pRec = (CBK_RECORD *) calloc(1, sizeof(CBK_RECORD));
+   if(!pRec)
+      goto Exit;
+
+   pRec->Count   = count;
+   pRec->pFields = (RECORD_FIELD *) calloc(count ? count : 1, sizeof(RECORD_FIELD));
+   if(!pRec->pFields)
+      goto Exit;
+
+   err = EINVAL;
+   ps  = pSchema;
+
+   for(i = 0; i < count; ++i)
+   {
+      RECORD_FIELD * pf = &pRec->pFields[i];
+
+      while(*ps != '=')
+         ++ps;
+
+      ps = record_parse(ps + 1, pf);
+
+      if(!ps || (*ps && (*ps != ' ')))
+         goto Exit;
+
+      pf->Plain        = pf->Spec;
+      pf->Plain.Width  = 0;
+      pf->Plain.Flags &= (uint16_t) ~(PRINTF_SPEC_LEFT | PRINTF_SPEC_ZERO | PRINTF_SPEC_PLUS | PRINTF_SPEC_SPACE | PRINTF_SPEC_WIDTH_ARG);
+   }
+
+   err = ENOMEM;
+   pRec->pText = (char *) malloc(record_fragments(pRec, pSchema, NULL));
+   if(!pRec->pText)
+      goto Exit;
+
+   record_fragments(pRec, pSchema, pRec->pText);
+   err = 0;
+
+   Exit:;
+   if(err)
+   {
+      cbk_record_free(pRec);
+      pRec  = NULL;
+      errno = err;
+   }
+
+   return (pRec);
+} /* CBK_RECORD * cbk_record_create(const char * pSchema) */
+
+
+/* ------------------------------------------------------------------------- *\
+   cbk_record_free releases a compiled schema.
+\* ------------------------------------------------------------------------- */
+void cbk_record_free(CBK_RECORD * pRec)
+{
+   if(pRec)
+   {
+      free(pRec->pFields);
+      free(pRec->pText);
+      free(pRec);
+   }
+} /* void cbk_record_free(CBK_RECORD * pRec) */
+
+
+/* ========================================================================= *\
+   Output
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   RECORD_ESCAPE is the user data of record_escape_callback that escapes the
+   output of named formatters for quoted logfmt and JSON values.
+\* ------------------------------------------------------------------------- */
+typedef struct RECORD_ESCAPE_S RECORD_ESCAPE;
+struct RECORD_ESCAPE_S
+{
+   void *            pUserData; /* user data of the callback */
+   PRINTF_CALLBACK * pCB;       /* callback of the output */
+   size_t            Length;    /* length of the escaped output */
+};
+
+static void record_escape_callback(void * pUserData, const char * pSrc, size_t Length)
+{
+   RECORD_ESCAPE * pre = (RECORD_ESCAPE *) pUserData;
+
+   if(!Length)
+      pre->pCB(pre->pUserData, pSrc, 0);
+   else
+   {
+      PRINTF_SPEC spec;
+      PRINTF_ARG  arg;
+
+      memset(&spec, 0, sizeof(spec));
+      spec.Conv      = 's';
+      spec.Flags     = PRINTF_SPEC_JSON;
+      spec.Precision = Length;
+      arg.Type       = PRINTF_ARG_PTR;
+      arg.v.p        = pSrc;
+
+      pre->Length += callback_printf_spec(pre->pUserData, pre->pCB, &spec, &arg, 1);
+   }
+} /* void record_escape_callback(void * pUserData, const char * pSrc, size_t Length) */
+
+
+/* record_needs_quotes returns whether a string has to be quoted as logfmt value */
+static int record_needs_quotes(const char * ps, size_t precision)
+{
+   size_t i;
+
+   if(!ps || !*ps || !precision)
+      return (1);
+
+   for(i = 0; (i < precision) && ps[i]; ++i)
+   {
+      unsigned char c = (unsigned char) ps[i];
+
+      if((c <= ' ') || (c == '=') || (c == '"') || (c == '\\') || (c == 0x7f))
+         return (1);
+   }
+
+   return (0);
+} /* int record_needs_quotes(const char * ps, size_t precision) */
+
+
+/* ------------------------------------------------------------------------- *\
+   cbk_record_vprintf prints a record of the arguments in va_list.
+\* ------------------------------------------------------------------------- */
+size_t cbk_record_vprintf(void * pUserData, PRINTF_CALLBACK * pCB, const CBK_RECORD * pRec, int Style, va_list val)
+{
+   size_t zRet = 0;
+   size_t i;
+
+   if(!pCB)
+      goto Exit;
+
+   if(!pRec || (Style < 0) || (Style >= RECORD_STYLES))
+   {
+      pCB(pUserData, NULL, 0);
+      goto Exit;
+   }
+
+   for(i = 0; i < pRec->Count; ++i)
+   {
+      const RECORD_FIELD * pf    = &pRec->pFields[i];
+      const PRINTF_SPEC *  sp    = (Style == CBK_RECORD_TEXT) ? &pf->Spec : &pf->Plain;
+      PRINTF_SPEC          spec;
+      PRINTF_ARG           args[4];
+      union
+      {
+         uint8_t  c1[2];
+         uint16_t c2[2];
+         uint32_t c4[2];
+      }                    ch;
+      size_t               count = 0;
+      int                  width = 0;
+      int                  prec  = -1;
+
+      if(pf->FragmentLength[Style])
+      {
+         pCB(pUserData, pRec->pText + pf->Fragment[Style], pf->FragmentLength[Style]);
+         zRet += pf->FragmentLength[Style];
+      }
+
+      /* the arguments of '*' precede the value */
+      if(pf->Spec.Flags & PRINTF_SPEC_WIDTH_ARG)
+      {
+         width = va_arg(val, int);
+
+         if(sp->Flags & PRINTF_SPEC_WIDTH_ARG)
+         {
+            args[count].Type  = PRINTF_ARG_INT;
+            args[count++].v.i = width;
+         }
+      }
+
+      if(pf->Spec.Flags & PRINTF_SPEC_PREC_ARG)
+      {
+         prec              = va_arg(val, int);
+         args[count].Type  = PRINTF_ARG_INT;
+         args[count++].v.i = prec;
+      }
+
+      if(pf->Spec.Flags & PRINTF_SPEC_BASE_ARG)
+      {
+         args[count].Type  = PRINTF_ARG_INT;
+         args[count++].v.i = va_arg(val, int);
+      }
+
+      switch(pf->Class)
+      {
+         case FIELD_INT:
+            args[count].Type = PRINTF_ARG_INT;
+            args[count].v.i  = (pf->Spec.Size > sizeof(int)) ? (int64_t) va_arg(val, long long) : (int64_t) va_arg(val, int);
+            break;
+
+         case FIELD_UINT:
+            args[count].Type = PRINTF_ARG_UINT;
+            args[count].v.u  = (pf->Spec.Size > sizeof(int)) ? (uint64_t) va_arg(val, unsigned long long) : (uint64_t) va_arg(val, unsigned int);
+            break;
+
+         case FIELD_DOUBLE:
+            args[count].Type = PRINTF_ARG_DOUBLE;
+            args[count].v.d  = va_arg(val, double);
+
+            if((Style == CBK_RECORD_JSON) && ((args[count].v.d != args[count].v.d) || (args[count].v.d - args[count].v.d != 0)))
+            { /* NaN or infinite */
+               pCB(pUserData, "null", 4);
+               zRet += 4;
+               continue;
+            }
+            break;
+
+         case FIELD_LDOUBLE:
+            args[count].Type = PRINTF_ARG_LDOUBLE;
+            args[count].v.ld = va_arg(val, long double);
+
+            if((Style == CBK_RECORD_JSON) && ((args[count].v.ld != args[count].v.ld) || (args[count].v.ld - args[count].v.ld != 0)))
+            { /* NaN or infinite */
+               pCB(pUserData, "null", 4);
+               zRet += 4;
+               continue;
+            }
+            break;
+
+         case FIELD_CHAR:
+            args[count].Type = PRINTF_ARG_INT;
+            args[count].v.i  = va_arg(val, int);
+            break;
+
+         case FIELD_NAMED:
+         {
+            void *        pv        = va_arg(val, void *);
+            size_t        precision = (pf->Spec.Flags & PRINTF_SPEC_PREC_ARG) ? ((prec >= 0) ? (size_t) prec : ~(size_t) 0) : pf->Spec.Precision;
+            uint8_t       left      = (pf->Spec.Flags & PRINTF_SPEC_LEFT) ? 1 : 0;
+            uint8_t       alt       = (pf->Spec.Flags & PRINTF_SPEC_ALT)  ? 1 : 0;
+            RECORD_ESCAPE re;
+
+            if(Style == CBK_RECORD_TEXT)
+            {
+               size_t minimum_width = pf->Spec.Width;
+
+               if(pf->Spec.Flags & PRINTF_SPEC_WIDTH_ARG)
+               {
+                  left          = (uint8_t) (left | (width < 0));
+                  minimum_width = (size_t) ((width < 0) ? -width : width);
+               }
+
+               zRet += pf->pNamed(pUserData, pCB, pv, precision, minimum_width, left, alt);
+            }
+            else
+            {
+               re.pUserData = pUserData;
+               re.pCB       = pCB;
+               re.Length    = 0;
+               pf->pNamed(&re, &record_escape_callback, pv, precision, 0, 0, alt);
+               zRet += re.Length;
+            }
+
+            continue;
+         }
+
+         default:
+            args[count].Type = PRINTF_ARG_PTR;
+            args[count].v.p  = va_arg(val, const void *);
+            break;
+      }
+
+      ++count;
+
+      if(Style != CBK_RECORD_TEXT)
+      {
+         if((pf->Class == FIELD_STRING) || (pf->Class == FIELD_CHAR))
+         { /* escaped strings, logfmt values get their own quotes if required */
+            spec        = *sp;
+            spec.Flags |= PRINTF_SPEC_JSON;
+
+            if(pf->Class == FIELD_CHAR)
+            { /* a character is printed as string of a single character */
+               uint32_t c = (uint32_t) args[count - 1].v.i;
+
+               spec.Conv = 's';
+               if(!spec.Size)
+                  spec.Size = 1;
+
+               memset(&ch, 0, sizeof(ch));
+               if(spec.Size == 1)
+                  ch.c1[0] = (uint8_t) c;
+               else if(spec.Size == 2)
+                  ch.c2[0] = (uint16_t) c;
+               else
+                  ch.c4[0] = c;
+
+               args[count - 1].Type = PRINTF_ARG_PTR;
+               args[count - 1].v.p  = &ch;
+            }
+
+            if(Style == CBK_RECORD_JSON)
+               spec.Flags &= (uint16_t) ~PRINTF_SPEC_ALT;
+            else if((spec.Size > 1) || record_needs_quotes((const char *) args[count - 1].v.p, (spec.Flags & PRINTF_SPEC_PREC_ARG) ? ((prec >= 0) ? (size_t) prec : ~(size_t) 0) : spec.Precision))
+               spec.Flags |= PRINTF_SPEC_ALT;
+            else
+               spec.Flags &= (uint16_t) ~PRINTF_SPEC_ALT;
+
+            sp = &spec;
+         }
+      }
+
+      zRet += callback_printf_spec(pUserData, pCB, sp, args, count);
+   }
+
+   pCB(pUserData, pRec->pText + pRec->End[Style], pRec->EndLength[Style]);
+   zRet += pRec->EndLength[Style];
+
+   Exit:;
+   return (zRet);
+} /* size_t cbk_record_vprintf(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   cbk_record_printf prints a record of the variable arguments.
+\* ------------------------------------------------------------------------- */
+size_t cbk_record_printf(void * pUserData, PRINTF_CALLBACK * pCB, const CBK_RECORD * pRec, int Style, ...)
+{
+   size_t  zRet;
+   va_list val;
+
+   va_start(val, Style);
+   zRet = cbk_record_vprintf(pUserData, pCB, pRec, Style, val);
+   va_end(val);
+
+   return (zRet);
+} /* size_t cbk_record_printf(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   RECORD_BUFFER is the user data of record_buffer_callback that copies the
+   output into the buffer of cbk_record_snprintf.
+\* ------------------------------------------------------------------------- */
+typedef struct RECORD_BUFFER_S RECORD_BUFFER;
+struct RECORD_BUFFER_S
+{
+   char * pDst;    /* current write position */
+   size_t DstSize; /* remaining size of the buffer without the terminating zero */
+   int    Err;     /* error code */
+};
+
+static void record_buffer_callback(void * pUserData, const char * pSrc, size_t Length)
+{
+   RECORD_BUFFER * prb = (RECORD_BUFFER *) pUserData;
+
+   if(!Length)
+   {
+      if(!prb->Err)
+         prb->Err = EINVAL;
+      return;
+   }
+
+   if(Length > prb->DstSize)
+      Length = prb->DstSize;
+
+   memcpy(prb->pDst, pSrc, Length);
+   prb->pDst    += Length;
+   prb->DstSize -= Length;
+} /* void record_buffer_callback(void * pUserData, const char * pSrc, size_t Length) */
+
+
+/* ------------------------------------------------------------------------- *\
+   cbk_record_snprintf prints a record into a buffer.
+\* ------------------------------------------------------------------------- */
+size_t cbk_record_snprintf(char * pDst, size_t BufferSize, const CBK_RECORD * pRec, int Style, ...)
+{
+   RECORD_BUFFER rb;
+   size_t        zRet;
+   va_list       val;
+
+   rb.pDst    = pDst;
+   rb.DstSize = (pDst && BufferSize) ? BufferSize - 1 : 0;
+   rb.Err     = 0;
+
+   va_start(val, Style);
+   zRet = cbk_record_vprintf(&rb, &record_buffer_callback, pRec, Style, val);
+   va_end(val);
+
+   if(pDst && BufferSize)
+      *rb.pDst = '\0';
+
+   if(rb.Err)
+      errno = rb.Err;
+
+   return (zRet);
+} /* size_t cbk_record_snprintf(...) */
+
+
+/* ========================================================================= *\
+   E N D   O F   F I L E
+\* ========================================================================= */
@@ -0,0 +1,155 @@
+/*****************************************************************************\
+*                                                                             *
+*  FILE NAME:     cbk_record.h                                                *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  DESCRIPTION:   structured log records of callback_printf                   *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  COPYRIGHT:     (c) 2026 Dipl.-Ing. Klaus Lux (Aachen, Germany)             *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  ORIGIN:        https://github.com/klux21/callback_printf                   *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+* Civil Usage Public License, Version 1.2, June 2026                          *
+*                                                                             *
+* Redistribution and use in source and binary forms, with or without          *
+* modification, are permitted provided that the following conditions are met: *
+*                                                                             *
+* 1. Redistributions of source code must retain the above copyright           *
+*    notice, this list of conditions, the explanation of terms                *
+*    and the following disclaimer.                                            *
+*                                                                             *
+* 2. Redistributions in binary form must reproduce the above copyright        *
+*    notice, this list of conditions and the following disclaimer in the      *
+*    documentation or other materials provided with the distribution.         *
+*                                                                             *
+* 3. All modified files must carry prominent notices stating that the         *
+*    files have been changed.                                                 *
+*                                                                             *
+* 4. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are designed or           *
+*    intended to harm, to kill or to forcibly immobilize people.              *
+*                                                                             *
+* 5. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are intended to           *
+*    monitor, to track, to change or to control the behavior, the             *
+*    constitution, the location or the communication of any people or         *
+*    their property without the explicit and prior agreement of those         *
+*    people except those devices and systems are solely designed for          *
+*    saving or protecting peoples life or health.                             *
+*                                                                             *
+* 6. The source code and binary forms and any derivative works are not        *
+*    stored or executed in any systems or devices that are intended           *
+*    for the production of any of the systems or devices that                 *
+*    have been stated before except the ones for saving or protecting         *
+*    peoples life or health only.                                             *
+*                                                                             *
+* The term 'systems' in all clauses shall include all types and combinations  *
+* of physical, virtualized or simulated hardware and software and any kind    *
+* of data storage.                                                            *
+*                                                                             *
+* The term 'devices' shall include any kind of local or non-local control     *
+* system of the stated devices as part of that device as well. Any assembly   *
+* of more than one device is one and the same device regarding this license.  *
+*                                                                             *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" *
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   *
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  *
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   *
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         *
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        *
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    *
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     *
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     *
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  *
+* POSSIBILITY OF SUCH DAMAGE.                                                 *
+*                                                                             *
+\*****************************************************************************/
+
+#ifndef CBK_RECORD_H
+#define CBK_RECORD_H
+
+#include <callback_printf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- *\
+   CBK_RECORD is the opaque handle of a compiled record schema. A schema is
+   a list of fields separated by blanks like
+      "ts=%{iso8601} lvl=%s lat_us=%u msg=%s"
+   where every field consists of a key of letters, digits, '_', '.' and '-'
+   and a single conversion of callback_printf. %v, %V, %@ and %n are not
+   supported. The conversion of every field, the keys and the constant
+   fragments of every output style are prepared by cbk_record_create, so
+   that the output of a record just passes the fragments and the values to
+   the emitters of callback_printf_spec.
+   A compiled schema is immutable and may be shared by all threads.
+\* ------------------------------------------------------------------------- */
+typedef struct CBK_RECORD_S CBK_RECORD;
+
+/* ------------------------------------------------------------------------- *\
+   Output styles of a record. Every record ends with a newline.
+   CBK_RECORD_TEXT   prints the values separated by blanks as specified
+                     2026-10-19T12:34:56.123456Z info 17 started
+   CBK_RECORD_LOGFMT prints key=value pairs. Strings are escaped like JSON
+                     strings and quoted if they contain blanks, '=', quotes
+                     or control characters or are empty. Named formatters
+                     are always quoted.
+                     ts="2026-10-19T12:34:56.123456Z" lvl=info lat_us=17 msg=started
+   CBK_RECORD_JSON   prints a JSON object per line
+                     {"ts":"2026-10-19T12:34:56.123456Z","lvl":"info","lat_us":17,"msg":"started"}
+   The minimum width and the flags '0', '+' and ' ' of the conversions
+   are applied to the text style only. Integers of %d, %i and %u and the
+   floating point numbers of %e, %f and %g are JSON numbers while all the
+   other conversions are JSON strings. Infinite values and NaN are null.
+\* ------------------------------------------------------------------------- */
+#define CBK_RECORD_TEXT   0
+#define CBK_RECORD_LOGFMT 1
+#define CBK_RECORD_JSON   2
+
+/* ------------------------------------------------------------------------- *\
+   cbk_record_create compiles a schema. The named formatters of the schema
+   must be registered before. The function returns NULL and sets errno to
+   EINVAL for an invalid schema or to ENOMEM.
+\* ------------------------------------------------------------------------- */
+CBK_RECORD * cbk_record_create(const char * pSchema);
+
+/* ------------------------------------------------------------------------- *\
+   cbk_record_free releases a compiled schema.
+\* ------------------------------------------------------------------------- */
+void cbk_record_free(CBK_RECORD * pRec);
+
+/* ------------------------------------------------------------------------- *\
+   cbk_record_printf prints a record of the arguments of all fields in the
+   order of the schema in the specified style by the callback and returns
+   the length of the output. An invalid style is reported as error.
+   cbk_record_vprintf takes a va_list instead.
+\* ------------------------------------------------------------------------- */
+size_t cbk_record_printf(void * pUserData, PRINTF_CALLBACK * pCB, const CBK_RECORD * pRec, int Style, ...);
+size_t cbk_record_vprintf(void * pUserData, PRINTF_CALLBACK * pCB, const CBK_RECORD * pRec, int Style, va_list val);
+
+/* ------------------------------------------------------------------------- *\
+   cbk_record_snprintf prints a record into a buffer of BufferSize bytes
+   like ssnprintf. The output is always terminated and the function returns
+   the length of the whole record even if it got truncated.
+\* ------------------------------------------------------------------------- */
+size_t cbk_record_snprintf(char * pDst, size_t BufferSize, const CBK_RECORD * pRec, int Style, ...);
+
+
+#ifdef __cplusplus
+}/* extern "C" */
+#endif
+
+#endif /* CBK_RECORD_H */
+
+/* ========================================================================= *\
+   E N D   O F   F I L E
+\* ========================================================================= */
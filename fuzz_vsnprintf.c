@@ -0,0 +1,1302 @@
+/*****************************************************************************\
+*                                                                             *
+*  FILE NAME:     fuzz_vsnprintf.c                                            *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  DESCRIPTION:   differential fuzzing of svsnprintf against vsnprintf        *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  COPYRIGHT:     (c) 2026 Dipl.-Ing. Klaus Lux (Aachen, Germany)             *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  ORIGIN:        https://github.com/klux21/callback_printf                   *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+* Civil Usage Public License, Version 1.2, June 2026                          *
+*                                                                             *
+* Redistribution and use in source and binary forms, with or without          *
+* modification, are permitted provided that the following conditions are met: *
+*                                                                             *
+* 1. Redistributions of source code must retain the above copyright           *
+*    notice, this list of conditions, the explanation of terms                *
+*    and the following disclaimer.                                            *
+*                                                                             *
+* 2. Redistributions in binary form must reproduce the above copyright        *
+*    notice, this list of conditions and the following disclaimer in the      *
+*    documentation or other materials provided with the distribution.         *
+*                                                                             *
+* 3. All modified files must carry prominent notices stating that the         *
+*    files have been changed.                                                 *
+*                                                                             *
+* 4. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are designed or           *
+*    intended to harm, to kill or to forcibly immobilize people.              *
+*                                                                             *
+* 5. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are intended to           *
+*    monitor, to track, to change or to control the behavior, the             *
+*    constitution, the location or the communication of any people or         *
+*    their property without the explicit and prior agreement of those         *
+*    people except those devices and systems are solely designed for          *
+*    saving or protecting peoples life or health.                             *
+*                                                                             *
+* 6. The source code and binary forms and any derivative works are not        *
+*    stored or executed in any systems or devices that are intended           *
+*    for the production of any of the systems or devices that                 *
+*    have been stated before except the ones for saving or protecting         *
+*    peoples life or health only.                                             *
+*                                                                             *
+* The term 'systems' in all clauses shall include all types and combinations  *
+* of physical, virtualized or simulated hardware and software and any kind    *
+* of data storage.                                                            *
+*                                                                             *
+* The term 'devices' shall include any kind of local or non-local control     *
+* system of the stated devices as part of that device as well. Any assembly   *
+* of more than one device is one and the same device regarding this license.  *
+*                                                                             *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" *
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   *
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  *
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   *
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         *
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        *
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    *
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     *
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     *
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  *
+* POSSIBILITY OF SUCH DAMAGE.                                                 *
+*                                                                             *
+\*****************************************************************************/
+
+/* ========================================================================= *\
+   Differential fuzzing of svsnprintf against the vsnprintf of the C library
+
+   The input bytes are decoded into a format string with one or more
+   conversions of the standard subset (flags, width, precision, length
+   modifiers and the conversions d, i, o, u, x, X, c, s, f, F, e, E, g, G,
+   a, A and %%) and the matching arguments. The format gets printed by both
+   functions into buffers of the same random size and the return values and
+   the whole buffers including the bytes behind the output are compared.
+   A mismatch is reduced by dropping flags, widths, precisions, conversions
+   and so on as long as the outputs still differ and printed as a snprintf
+   call that reproduces it.
+
+   Known differences are not reported unless --strict is given: values
+   halfway between two outputs within the accuracy of callback_printf and
+   the leading hexadecimal digit 2 that the C library prints if %a rounds
+   up to the next power of two.
+
+   Build and run:
+
+      ./fuzz_vsnprintf.sh [--seed N] [--runs N] [--max-failures N] [--strict]
+      ./fuzz_vsnprintf.sh FILE...     replays inputs like crashes of AFL
+
+      clang -g -O1 -fsanitize=fuzzer,address -DFUZZ_LIBFUZZER -I . \
+            fuzz_vsnprintf.c callback_printf.c -o _fuzz_vsnprintf_lf
+      afl-cc -O2 -I . fuzz_vsnprintf.c callback_printf.c -o _fuzz_vsnprintf_afl
+      afl-fuzz -i seeds -o findings -- ./_fuzz_vsnprintf_afl @@
+
+   libFuzzer and AFL stop at a mismatch by abort().
+\* ========================================================================= */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <string.h>
+#include <inttypes.h>
+#include <float.h>
+#include <math.h>
+#include <wchar.h>
+
+#include <callback_printf.h>
+
+#define FUZZ_MAX_SPECS  5    /* maximum number of conversions of a format */
+#define FUZZ_MAX_STR    24   /* maximum length of a string argument */
+#define FUZZ_MAX_FMT    256  /* maximum length of a format */
+#define FUZZ_MAX_OUT    4096 /* size of the output buffers */
+#define FUZZ_MAX_INPUT  256  /* length of the random inputs of the standalone driver */
+#define FUZZ_CANARY     0xa5 /* fill byte of the output buffers */
+
+/* mode of a case */
+#define FUZZ_SINGLE  0 /* a conversion of any type */
+#define FUZZ_INTS    1 /* several conversions that take int arguments only */
+#define FUZZ_DOUBLES 2 /* several conversions that take double arguments only */
+
+/* argument types */
+#define FUZZ_NONE     0  /* %% */
+#define FUZZ_INT      1  /* int of d, i, hd, hhd and c */
+#define FUZZ_UINT     2  /* unsigned of o, u, x, X with or without h and hh */
+#define FUZZ_LONG     3
+#define FUZZ_ULONG    4
+#define FUZZ_LLONG    5
+#define FUZZ_ULLONG   6
+#define FUZZ_INTMAX   7
+#define FUZZ_UINTMAX  8
+#define FUZZ_PTRDIFF  9  /* signed of z and t */
+#define FUZZ_SIZE     10 /* unsigned of z and t */
+#define FUZZ_DOUBLE   11
+#define FUZZ_LDOUBLE  12
+#define FUZZ_STR      13
+#define FUZZ_WSTR     14
+#define FUZZ_WINT     15
+
+
+/* ------------------------------------------------------------------------- *\
+   FUZZ_SPEC is a conversion with the literal text in front of it and its
+   arguments.
+\* ------------------------------------------------------------------------- */
+typedef struct FUZZ_SPEC_S FUZZ_SPEC;
+struct FUZZ_SPEC_S
+{
+   char        Text[4];   /* literal text in front of the conversion */
+   char        Flags[6];  /* flags out of "-+ #0" */
+   int         Width;     /* width or -1 if not set */
+   int         Precision; /* precision or -1 if not set */
+   int         Star[2];   /* '*' of the width and of the precision */
+   int         StarValue[2]; /* arguments of the '*' */
+   char        Length[3]; /* length modifier */
+   char        Conv;      /* conversion */
+   uint64_t    Bits;      /* integer value */
+   long double Value;     /* floating point value */
+   char        Str[FUZZ_MAX_STR + 1]; /* string or character value */
+};
+
+typedef struct FUZZ_CASE_S FUZZ_CASE;
+struct FUZZ_CASE_S
+{
+   int       Mode;  /* FUZZ_SINGLE, FUZZ_INTS or FUZZ_DOUBLES */
+   size_t    Size;  /* buffer size passed to the functions */
+   size_t    Count; /* number of conversions */
+   FUZZ_SPEC Spec[FUZZ_MAX_SPECS];
+};
+
+typedef struct FUZZ_RESULT_S FUZZ_RESULT;
+struct FUZZ_RESULT_S
+{
+   char   Libc[FUZZ_MAX_OUT]; /* output of vsnprintf */
+   char   Out[FUZZ_MAX_OUT];  /* output of svsnprintf */
+   int    LibcRet;            /* return value of vsnprintf */
+   size_t Ret;                /* return value of svsnprintf */
+};
+
+typedef struct FUZZ_INPUT_S FUZZ_INPUT;
+struct FUZZ_INPUT_S
+{
+   const uint8_t * pData; /* remaining input */
+   size_t          Size;  /* remaining size */
+};
+
+
+static unsigned long fuzz_known_count = 0; /* number of known differences */
+static int           fuzz_strict      = 0; /* report known differences too */
+
+
+/* fuzz_byte returns the next byte of the input or 0 at its end */
+static unsigned fuzz_byte(FUZZ_INPUT * pi)
+{
+   if(!pi->Size)
+      return (0);
+
+   --pi->Size;
+   return (*pi->pData++);
+} /* unsigned fuzz_byte(FUZZ_INPUT * pi) */
+
+/* fuzz_bits returns the next 64 bits of the input */
+static uint64_t fuzz_bits(FUZZ_INPUT * pi)
+{
+   uint64_t u = 0;
+   int      i;
+
+   for(i = 0; i < 8; ++i)
+      u = (u << 8) | fuzz_byte(pi);
+
+   return (u);
+} /* uint64_t fuzz_bits(FUZZ_INPUT * pi) */
+
+
+/* ------------------------------------------------------------------------- *\
+   fuzz_type returns the argument type of a conversion
+\* ------------------------------------------------------------------------- */
+static int fuzz_type(const FUZZ_SPEC * ps)
+{
+   const char * pl     = ps->Length;
+   int          sign   = (ps->Conv == 'd') || (ps->Conv == 'i');
+
+   switch(ps->Conv)
+   {
+      case '%':
+         return (FUZZ_NONE);
+
+      case 'c':
+         return (pl[0] == 'l') ? FUZZ_WINT : FUZZ_INT;
+
+      case 's':
+         return (pl[0] == 'l') ? FUZZ_WSTR : FUZZ_STR;
+
+      case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+         return (pl[0] == 'L') ? FUZZ_LDOUBLE : FUZZ_DOUBLE;
+   }
+
+   if(!strcmp(pl, "l"))
+      return (sign ? FUZZ_LONG : FUZZ_ULONG);
+
+   if(!strcmp(pl, "ll"))
+      return (sign ? FUZZ_LLONG : FUZZ_ULLONG);
+
+   if(!strcmp(pl, "j"))
+      return (sign ? FUZZ_INTMAX : FUZZ_UINTMAX);
+
+   if(!strcmp(pl, "z") || !strcmp(pl, "t"))
+      return (sign ? FUZZ_PTRDIFF : FUZZ_SIZE);
+
+   return (sign ? FUZZ_INT : FUZZ_UINT);
+} /* int fuzz_type(const FUZZ_SPEC * ps) */
+
+
+/* ------------------------------------------------------------------------- *\
+   fuzz_double returns a floating point value of the input. Zero, infinity,
+   NaN and the limits are taken from a table with a sign of their own,
+   random bit patterns cover subnormal numbers, and the other values are
+   typical decimal numbers, halfway cases of the rounding and powers of ten.
+\* ------------------------------------------------------------------------- */
+static long double fuzz_double(FUZZ_INPUT * pi, int bLong)
+{
+   static const double special[] =
+   {
+      0.0, HUGE_VAL, 0.0 /* NaN */, DBL_MAX, DBL_MIN, DBL_MIN / 4503599627370496.0 /* smallest subnormal */,
+      DBL_EPSILON, 1.0, 0.5, 1e15, 1e16, 1e-5
+   };
+   unsigned    sel  = fuzz_byte(pi);
+   uint64_t    bits = fuzz_bits(pi);
+   long double v;
+   double      d;
+   int         e;
+
+   switch(sel & 7)
+   {
+      case 0:
+         memcpy(&d, &bits, sizeof(d));
+         v = d;
+         break;
+
+      case 1: /* special values */
+         e = (int) (bits % (sizeof(special) / sizeof(special[0])));
+         if(e == 2)
+            v = HUGE_VAL - HUGE_VAL;
+         else if(bLong && (e == 3))
+            v = LDBL_MAX;
+         else if(bLong && (e == 4))
+            v = LDBL_MIN;
+         else
+            v = special[e];
+
+         if(sel & 8)
+            v = -v;
+
+         return (bLong ? v : (long double) (double) v);
+
+      case 2: /* halfway cases like 2.5, 0.125 or 1.5e-3 */
+         v = (long double) (bits % 10000) + 0.5L;
+         for(e = (int) ((bits >> 32) % 8); e--;)
+            v /= 10;
+         break;
+
+      case 3: /* powers of ten */
+         v = 1;
+         for(e = (int) (bits % 40); e--;)
+            v = (bits & 0x100000000ull) ? v / 10 : v * 10;
+         break;
+
+      case 4: /* big and small magnitudes */
+         d = (double) (bits >> 11) / 9007199254740992.0;
+         for(e = (int) ((bits >> 4) % 300); e--;)
+            d = (bits & 8) ? d / 10 : d * 10;
+         v = d;
+         break;
+
+      default: /* decimal numbers with a few digits */
+         v = (long double) (int64_t) (bits % 2000001) - 1000000;
+         for(e = (int) ((bits >> 32) % 12); e--;)
+            v /= 10;
+         break;
+   }
+
+   if(sel & 8)
+      v = -v;
+
+   /* long double values mostly get an extended mantissa */
+   if(bLong && (sel & 0x30))
+      v += v * ((long double) (fuzz_byte(pi) + 1) / 1e18L);
+
+   return (bLong ? v : (long double) (double) v);
+} /* long double fuzz_double(FUZZ_INPUT * pi, int bLong) */
+
+
+/* fuzz_int returns an integer value of the input with a bias to limits */
+static uint64_t fuzz_int(FUZZ_INPUT * pi)
+{
+   static const uint64_t special[] =
+   {
+      0, 1, (uint64_t) -1, 0x7f, 0x80, 0xff, 0x7fff, 0x8000, 0xffff, 0x7fffffff, 0x80000000u,
+      0xffffffffu, 0x7fffffffffffffffull, 0x8000000000000000ull, 10, 100, 1000000000, 10000000000000000000ull
+   };
+   unsigned sel  = fuzz_byte(pi);
+   uint64_t bits = fuzz_bits(pi);
+
+   switch(sel & 3)
+   {
+      case 0:  return (special[bits % (sizeof(special) / sizeof(special[0]))]);
+      case 1:  return (bits % 1000) - 500;
+      default: return (bits);
+   }
+} /* uint64_t fuzz_int(FUZZ_INPUT * pi) */
+
+
+/* ------------------------------------------------------------------------- *\
+   Floating point numbers are printed by callback_printf with the precision
+   of long double arithmetic and not exactly like the C library does it with
+   big integers. So the decimal conversions are limited to DBL_DIG or LDBL_DIG
+   significant digits, %f to values that don't exceed them in front of the
+   decimal point and to the maximum precision of 64 or 128 digits and %a to
+   an explicit precision because callback_printf prints all digits of the
+   mantissa by default. %La isn't compared because the C library prints
+   another leading digit and neither are subnormal values of %a.
+\* ------------------------------------------------------------------------- */
+#define FUZZ_DBL_DIGITS  DBL_DIG
+#define FUZZ_LDBL_DIGITS LDBL_DIG
+#define FUZZ_DBL_PREC    64  /* maximum precision of double */
+#define FUZZ_LDBL_PREC   128 /* maximum precision of long double */
+
+/* fuzz_abs returns the absolute value */
+static long double fuzz_abs(long double v)
+{
+   return ((v < 0) ? -v : v);
+} /* long double fuzz_abs(long double v) */
+
+/* fuzz_exp10 returns the decimal exponent of a value */
+static int fuzz_exp10(long double v)
+{
+   char   buf[64];
+   char * pe;
+
+   snprintf(buf, sizeof(buf), "%.20Le", v);
+   pe = strchr(buf, 'e');
+   return (pe ? atoi(pe + 1) : 0); /* no exponent of inf and nan */
+} /* int fuzz_exp10(long double v) */
+
+/* fuzz_precision returns the precision of a floating point conversion */
+static int fuzz_precision(const FUZZ_SPEC * ps)
+{
+   if(ps->Star[1])
+      return ((ps->StarValue[1] < 0) ? 6 : ps->StarValue[1]);
+
+   return ((ps->Precision < 0) ? 6 : ps->Precision);
+} /* int fuzz_precision(const FUZZ_SPEC * ps) */
+
+/* fuzz_max_precision returns the maximum precision of a floating point conversion or -1 if there is none */
+static int fuzz_max_precision(const FUZZ_SPEC * ps)
+{
+   int digits = (ps->Length[0] == 'L') ? FUZZ_LDBL_DIGITS : FUZZ_DBL_DIGITS;
+   int max    = (ps->Length[0] == 'L') ? FUZZ_LDBL_PREC : FUZZ_DBL_PREC;
+
+   switch(ps->Conv | 0x20)
+   {
+      case 'a':
+         return ((ps->Length[0] == 'L') ? -1 : (DBL_MANT_DIG - 1) / 4);
+
+      case 'e':
+         return (digits - 1);
+
+      case 'g':
+         return (digits);
+   }
+
+   if((ps->Value == 0) || (ps->Value != ps->Value) || (ps->Value - ps->Value != 0))
+      return (max); /* 0, NaN and infinity */
+
+   digits -= 1 + fuzz_exp10(ps->Value);
+   return ((digits < max) ? digits : max);
+} /* int fuzz_max_precision(const FUZZ_SPEC * ps) */
+
+/* fuzz_valid returns 1 if a floating point conversion is within the limits */
+static int fuzz_valid(const FUZZ_SPEC * ps)
+{
+   int max = fuzz_max_precision(ps);
+
+   /* the C library prints subnormal values unnormalized */
+   if((ps->Conv | 0x20) == 'a')
+      return ((max >= 0) && (fuzz_abs(ps->Value) >= DBL_MIN) && (ps->Star[1] ? (ps->StarValue[1] >= 0) : (ps->Precision >= 0)) && (fuzz_precision(ps) <= max));
+
+   return (fuzz_precision(ps) <= max);
+} /* int fuzz_valid(const FUZZ_SPEC * ps) */
+
+/* fuzz_limit changes a floating point conversion to fit into the limits */
+static void fuzz_limit(FUZZ_SPEC * ps)
+{
+   int max;
+
+   if(fuzz_valid(ps))
+      return;
+
+   if(((ps->Conv | 0x20) == 'a') && (ps->Length[0] == 'L'))
+   {
+      ps->Length[0] = '\0';
+      ps->Value     = (double) ps->Value;
+   }
+
+   max = fuzz_max_precision(ps);
+   if(max < 0)
+   {
+      ps->Conv = (ps->Conv == 'F') ? 'E' : 'e'; /* too big for %f */
+      max      = fuzz_max_precision(ps);
+   }
+
+   if(ps->Star[1])
+      ps->StarValue[1] = (fuzz_precision(ps) < max) ? fuzz_precision(ps) : max;
+   else
+      ps->Precision = (fuzz_precision(ps) < max) ? fuzz_precision(ps) : max;
+} /* void fuzz_limit(FUZZ_SPEC * ps) */
+
+
+/* ------------------------------------------------------------------------- *\
+   fuzz_spec decodes a conversion. FUZZ_INTS limits it to conversions that
+   take int arguments and FUZZ_DOUBLES to floating point conversions of
+   double without '*'.
+\* ------------------------------------------------------------------------- */
+static void fuzz_spec(FUZZ_INPUT * pi, int Mode, FUZZ_SPEC * ps)
+{
+   static const char   convs[]    = "diouxXcsfFeEgGaA%";
+   static const char   ints[]     = "diouxXc%";
+   static const char   doubles[]  = "fFeEgGaA";
+   static const char * int_len[]  = { "", "", "", "hh", "h", "l", "ll", "j", "z", "t" };
+   static const char   flags[]    = "-+ #0";
+   static const char   text[]     = "ab |-=.x";
+   unsigned            b;
+   int                 i;
+   int                 n;
+
+   memset(ps, 0, sizeof(*ps));
+   ps->Width     = -1;
+   ps->Precision = -1;
+
+   b = fuzz_byte(pi);
+   n = 0;
+   for(i = 0; i < (int) (b & 3); ++i)
+      ps->Text[n++] = text[(b >> (2 + i * 3)) & 7];
+
+   b = fuzz_byte(pi);
+   if(Mode == FUZZ_INTS)
+      ps->Conv = ints[b % (sizeof(ints) - 1)];
+   else if(Mode == FUZZ_DOUBLES)
+      ps->Conv = doubles[b % (sizeof(doubles) - 1)];
+   else
+      ps->Conv = convs[b % (sizeof(convs) - 1)];
+
+   if(ps->Conv == '%')
+      return;
+
+   /* '#' is undefined for d, i, u, c and s and '0' for c and s */
+   b = fuzz_byte(pi);
+   n = 0;
+   for(i = 0; i < 5; ++i)
+   {
+      if((b & (1u << i)) && !((flags[i] == '#') && strchr("diucs", ps->Conv)) && !((flags[i] == '0') && strchr("cs", ps->Conv)))
+         ps->Flags[n++] = flags[i];
+   }
+
+   /* width: none, small, big or '*' */
+   b = fuzz_byte(pi);
+   switch(b & 3)
+   {
+      case 1: ps->Width = (int) (b >> 2) % 24;         break;
+      case 2: ps->Width = (b & 4) ? (int) (b >> 3) * 10 : (int) (b >> 2) % 48; break;
+      case 3:
+         if(Mode != FUZZ_DOUBLES)
+         {
+            ps->Star[0]      = 1;
+            ps->StarValue[0] = (int) (fuzz_byte(pi) % 80) - 20;
+         }
+         break;
+   }
+
+   /* precision: none, '.', small, big or '*' but none for c */
+   b = fuzz_byte(pi);
+   switch((ps->Conv == 'c') ? 0 : b & 7)
+   {
+      case 1: ps->Precision = 0;                        break;
+      case 2:
+      case 3: ps->Precision = (int) (b >> 3) % 20;      break;
+      case 4: ps->Precision = (int) (b >> 3) * 4;       break;
+      case 5:
+         if(Mode != FUZZ_DOUBLES)
+         {
+            ps->Star[1]      = 1;
+            ps->StarValue[1] = (int) (fuzz_byte(pi) % 80) - 20;
+         }
+         break;
+   }
+
+   b = fuzz_byte(pi);
+   switch(ps->Conv)
+   {
+      case 'c':
+         if((Mode == FUZZ_SINGLE) && (b & 1))
+            strcpy(ps->Length, "l");
+         ps->Str[0] = (char) (ps->Length[0] ? 1 + fuzz_byte(pi) % 127 : fuzz_byte(pi));
+         break;
+
+      case 's':
+         if(b & 1)
+            strcpy(ps->Length, "l");
+         n = (int) (fuzz_byte(pi) % (FUZZ_MAX_STR + 1));
+         for(i = 0; i < n; ++i)
+            ps->Str[i] = (char) (' ' + fuzz_byte(pi) % 95);
+         break;
+
+      case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+         if((Mode == FUZZ_SINGLE) && (b & 1))
+            strcpy(ps->Length, "L");
+         ps->Value = fuzz_double(pi, ps->Length[0] == 'L');
+         fuzz_limit(ps);
+         break;
+
+      default:
+         if(Mode == FUZZ_INTS)
+            strcpy(ps->Length, int_len[b % 5]);
+         else
+            strcpy(ps->Length, int_len[b % (sizeof(int_len) / sizeof(int_len[0]))]);
+         ps->Bits = fuzz_int(pi);
+         break;
+   }
+} /* void fuzz_spec(FUZZ_INPUT * pi, int Mode, FUZZ_SPEC * ps) */
+
+
+/* fuzz_decode decodes a case of the input */
+static void fuzz_decode(const uint8_t * pData, size_t Size, FUZZ_CASE * pc)
+{
+   FUZZ_INPUT in;
+   unsigned   b;
+   size_t     i;
+
+   in.pData = pData;
+   in.Size  = Size;
+
+   b = fuzz_byte(&in);
+   pc->Mode  = (b & 3) == 3 ? FUZZ_SINGLE : (int) (b & 3);
+   pc->Count = (pc->Mode == FUZZ_SINGLE) ? 1 : 1 + (b >> 2) % FUZZ_MAX_SPECS;
+
+   /* mostly a big buffer and sometimes a truncated output */
+   b = fuzz_byte(&in);
+   pc->Size = (b & 0xc0) ? FUZZ_MAX_OUT : b & 0x3f;
+
+   for(i = 0; i < pc->Count; ++i)
+      fuzz_spec(&in, pc->Mode, &pc->Spec[i]);
+} /* void fuzz_decode(const uint8_t * pData, size_t Size, FUZZ_CASE * pc) */
+
+
+/* ------------------------------------------------------------------------- *\
+   fuzz_format writes the format of a conversion and returns its end
+\* ------------------------------------------------------------------------- */
+static char * fuzz_format(char * pd, const FUZZ_SPEC * ps)
+{
+   pd += sprintf(pd, "%s%%", ps->Text);
+
+   if(ps->Conv != '%')
+   {
+      pd += sprintf(pd, "%s", ps->Flags);
+
+      if(ps->Star[0])
+         *pd++ = '*';
+      else if(ps->Width >= 0)
+         pd += sprintf(pd, "%d", ps->Width);
+
+      if(ps->Star[1])
+         pd += sprintf(pd, ".*");
+      else if(ps->Precision >= 0)
+         pd += sprintf(pd, ".%d", ps->Precision);
+
+      pd += sprintf(pd, "%s", ps->Length);
+   }
+
+   *pd++ = ps->Conv;
+   *pd   = '\0';
+   return (pd);
+} /* char * fuzz_format(char * pd, const FUZZ_SPEC * ps) */
+
+
+/* fuzz_pair prints the format by vsnprintf and svsnprintf */
+static void fuzz_pair(FUZZ_RESULT * pr, size_t size, const char * pFmt, ...)
+{
+   va_list val;
+
+   va_start(val, pFmt);
+   pr->LibcRet = vsnprintf(pr->Libc, size, pFmt, val);
+   va_end(val);
+
+   va_start(val, pFmt);
+   pr->Ret = svsnprintf(pr->Out, size, pFmt, val);
+   va_end(val);
+} /* void fuzz_pair(FUZZ_RESULT * pr, size_t size, const char * pFmt, ...) */
+
+
+/* FUZZ_PAIR passes the '*' arguments and the value of a conversion */
+#define FUZZ_PAIR(value)                                                          \
+   if(ps->Star[0] && ps->Star[1])                                                 \
+      fuzz_pair(pr, pc->Size, fmt, ps->StarValue[0], ps->StarValue[1], value);    \
+   else if(ps->Star[0] || ps->Star[1])                                            \
+      fuzz_pair(pr, pc->Size, fmt, ps->StarValue[ps->Star[1]], value);            \
+   else                                                                           \
+      fuzz_pair(pr, pc->Size, fmt, value)
+
+
+/* ------------------------------------------------------------------------- *\
+   fuzz_run prints a case by both functions and returns 1 if the return
+   values and the buffers are equal.
+\* ------------------------------------------------------------------------- */
+static int fuzz_run(const FUZZ_CASE * pc, FUZZ_RESULT * pr)
+{
+   char    fmt[FUZZ_MAX_FMT];
+   char *  pf = fmt;
+   size_t  i;
+
+   memset(pr->Libc, FUZZ_CANARY, sizeof(pr->Libc));
+   memset(pr->Out,  FUZZ_CANARY, sizeof(pr->Out));
+
+   for(i = 0; i < pc->Count; ++i)
+      pf = fuzz_format(pf, &pc->Spec[i]);
+
+   if(pc->Mode == FUZZ_INTS)
+   {
+      int    a[3 * FUZZ_MAX_SPECS + 1];
+      size_t n = 0;
+
+      for(i = 0; i < pc->Count; ++i)
+      {
+         const FUZZ_SPEC * ps = &pc->Spec[i];
+
+         if(ps->Star[0])
+            a[n++] = ps->StarValue[0];
+         if(ps->Star[1])
+            a[n++] = ps->StarValue[1];
+         if(ps->Conv == 'c')
+            a[n++] = (unsigned char) ps->Str[0];
+         else if(ps->Conv != '%')
+            a[n++] = (int) ps->Bits;
+      }
+
+      while(n < sizeof(a) / sizeof(a[0]))
+         a[n++] = 0;
+
+      fuzz_pair(pr, pc->Size, fmt, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7],
+                a[8], a[9], a[10], a[11], a[12], a[13], a[14], a[15]);
+   }
+   else if(pc->Mode == FUZZ_DOUBLES)
+   {
+      double a[FUZZ_MAX_SPECS];
+
+      for(i = 0; i < FUZZ_MAX_SPECS; ++i)
+         a[i] = (i < pc->Count) ? (double) pc->Spec[i].Value : 0;
+
+      fuzz_pair(pr, pc->Size, fmt, a[0], a[1], a[2], a[3], a[4]);
+   }
+   else
+   {
+      const FUZZ_SPEC * ps = &pc->Spec[0];
+      wchar_t           ws[FUZZ_MAX_STR + 1];
+
+      for(i = 0; (ws[i] = (wchar_t) (unsigned char) ps->Str[i]) != 0; ++i)
+         ;
+
+      switch(fuzz_type(ps))
+      {
+         case FUZZ_NONE:    FUZZ_PAIR(0);                                   break;
+         case FUZZ_INT:     FUZZ_PAIR((ps->Conv == 'c') ? (int) (unsigned char) ps->Str[0] : (int) ps->Bits); break;
+         case FUZZ_UINT:    FUZZ_PAIR((unsigned) ps->Bits);                 break;
+         case FUZZ_LONG:    FUZZ_PAIR((long) ps->Bits);                     break;
+         case FUZZ_ULONG:   FUZZ_PAIR((unsigned long) ps->Bits);            break;
+         case FUZZ_LLONG:   FUZZ_PAIR((long long) ps->Bits);                break;
+         case FUZZ_ULLONG:  FUZZ_PAIR((unsigned long long) ps->Bits);       break;
+         case FUZZ_INTMAX:  FUZZ_PAIR((intmax_t) ps->Bits);                 break;
+         case FUZZ_UINTMAX: FUZZ_PAIR((uintmax_t) ps->Bits);                break;
+         case FUZZ_PTRDIFF: FUZZ_PAIR((ptrdiff_t) ps->Bits);                break;
+         case FUZZ_SIZE:    FUZZ_PAIR((size_t) ps->Bits);                   break;
+         case FUZZ_DOUBLE:  FUZZ_PAIR((double) ps->Value);                  break;
+         case FUZZ_LDOUBLE: FUZZ_PAIR(ps->Value);                           break;
+         case FUZZ_STR:     FUZZ_PAIR(ps->Str);                             break;
+         case FUZZ_WSTR:    FUZZ_PAIR(ws);                                  break;
+         case FUZZ_WINT:    FUZZ_PAIR((wint_t) (unsigned char) ps->Str[0]); break;
+      }
+   }
+
+   return ((pr->LibcRet >= 0) && ((size_t) pr->LibcRet == pr->Ret) && !memcmp(pr->Libc, pr->Out, sizeof(pr->Out)));
+} /* int fuzz_run(const FUZZ_CASE * pc, FUZZ_RESULT * pr) */
+
+
+/* ------------------------------------------------------------------------- *\
+   fuzz_halfway returns 1 if the value of a floating point conversion is
+   halfway between two outputs within the accuracy of callback_printf.
+   callback_printf rounds exact halfway values away from zero while the C
+   library rounds them to even. Decimal digits are calculated with a
+   relative error of up to FUZZ_DBL_ERROR or FUZZ_LDBL_ERROR and values
+   closer to halfway than that may be rounded the other way. The digits
+   behind the precision are taken from the C library.
+\* ------------------------------------------------------------------------- */
+#define FUZZ_DBL_ERROR  5e-16 /* relative error of decimal digits of double */
+#define FUZZ_LDBL_ERROR 5e-19 /* relative error of decimal digits of long double */
+
+static int fuzz_halfway(const FUZZ_SPEC * ps)
+{
+   static char buf[8192];
+   char        conv   = (char) (ps->Conv | 0x20);
+   int         prec   = fuzz_precision(ps);
+   double      window = (ps->Length[0] == 'L') ? FUZZ_LDBL_ERROR : FUZZ_DBL_ERROR;
+   double      tail   = 0;
+   double      scale  = 1;
+   int         sig;
+   int         X;
+   char *      pd;
+   int         i;
+
+   if((ps->Value == 0) || (ps->Value != ps->Value) || (ps->Value - ps->Value != 0))
+      return (0);
+
+   if(conv == 'a')
+   {
+      /* hexadecimal digits are exact and only the halfway value 8 followed by zeros counts */
+      snprintf(buf, sizeof(buf), "%a", (double) ps->Value);
+      pd = strchr(buf, '.');
+      if(!pd || ((int) strcspn(pd + 1, "p") <= prec) || (pd[1 + prec] != '8'))
+         return (0);
+
+      for(pd += 2 + prec; *pd == '0'; ++pd)
+         ;
+
+      return (*pd == 'p');
+   }
+
+   /* the error in units of the last digit grows with the mantissa */
+   snprintf(buf, sizeof(buf), "%.20Le", fuzz_abs(ps->Value));
+   pd      = strchr(buf, 'e');
+   X       = atoi(pd + 1);
+   *pd     = '\0';
+   window *= atof(buf);
+
+   if(conv == 'g')
+   {
+      prec = prec ? prec : 1;
+      snprintf(buf, sizeof(buf), "%.*Le", prec - 1, ps->Value);
+      X = atoi(strchr(buf, 'e') + 1);
+
+      if((prec > X) && (X >= -4))
+      {
+         conv = 'f';
+         prec = prec - 1 - X;
+      }
+      else
+      {
+         conv = 'e';
+         prec = prec - 1;
+      }
+   }
+
+   if(conv == 'e')
+   {
+      sig = prec + 1;
+      snprintf(buf, sizeof(buf), "%.*Le", prec + 40, ps->Value);
+   }
+   else
+   {
+      sig = prec + 1 + X;
+      snprintf(buf, sizeof(buf), "%.*Lf", prec + 40, ps->Value);
+   }
+
+   for(i = 1; i < sig; ++i)
+      window *= 10;
+
+   for(i = sig; i < 1; ++i)
+      window /= 10;
+
+   if(window < 1e-12)
+      window = 1e-12;
+
+   /* the digits behind the precision as fraction of the last digit */
+   pd = strchr(buf, '.') + 1 + prec;
+   for(i = 0; (i < 15) && (*pd >= '0') && (*pd <= '9'); ++i)
+   {
+      scale /= 10;
+      tail  += (*pd++ - '0') * scale;
+   }
+
+   return ((tail - 0.5 <= window) && (0.5 - tail <= window));
+} /* int fuzz_halfway(const FUZZ_SPEC * ps) */
+
+
+/* ------------------------------------------------------------------------- *\
+   fuzz_known returns the reason if a mismatch is a known difference between
+   callback_printf and the C library or NULL.
+\* ------------------------------------------------------------------------- */
+static const char * fuzz_known(const FUZZ_CASE * pc)
+{
+   size_t i;
+
+   for(i = 0; (pc->Mode != FUZZ_INTS) && (i < pc->Count); ++i)
+   {
+      const FUZZ_SPEC * ps = &pc->Spec[i];
+
+      if(!strchr("fFeEgGaA", ps->Conv))
+         continue;
+
+      if(fuzz_halfway(ps))
+         return ("value halfway between two outputs");
+
+      /* the C library prints 0x2p+0 instead of 0x1p+1 if the rounding carries into the leading digit */
+      if((ps->Conv | 0x20) == 'a')
+      {
+         char buf[64];
+
+         snprintf(buf, sizeof(buf), "%.*a", fuzz_precision(ps), (double) ps->Value);
+         if(strstr(buf, "0x2"))
+            return ("leading hexadecimal digit 2 of the C library");
+      }
+   }
+
+   return (NULL);
+} /* const char * fuzz_known(const FUZZ_CASE * pc) */
+
+
+/* fuzz_differs returns 1 if a simplified case is within the limits and still differs */
+static int fuzz_differs(const FUZZ_CASE * pc, FUZZ_RESULT * pr)
+{
+   size_t i;
+
+   for(i = 0; i < pc->Count; ++i)
+   {
+      if(strchr("fFeEgGaA", pc->Spec[i].Conv) && !fuzz_valid(&pc->Spec[i]))
+         return (0);
+   }
+
+   return (!fuzz_run(pc, pr) && (fuzz_strict || !fuzz_known(pc)));
+} /* int fuzz_differs(const FUZZ_CASE * pc, FUZZ_RESULT * pr) */
+
+
+/* ------------------------------------------------------------------------- *\
+   fuzz_reduce simplifies a case as long as the outputs still differ
+\* ------------------------------------------------------------------------- */
+static void fuzz_reduce(FUZZ_CASE * pc, FUZZ_RESULT * pr)
+{
+   int bChanged = 1;
+
+   while(bChanged)
+   {
+      FUZZ_CASE t;
+      size_t    i;
+      size_t    j;
+
+      bChanged = 0;
+
+      /* drop a conversion */
+      for(i = 0; (pc->Count > 1) && (i < pc->Count); ++i)
+      {
+         t = *pc;
+         memmove(&t.Spec[i], &t.Spec[i + 1], (t.Count - i - 1) * sizeof(FUZZ_SPEC));
+         --t.Count;
+
+         if(fuzz_differs(&t, pr))
+         {
+            *pc      = t;
+            bChanged = 1;
+            --i;
+         }
+      }
+
+      if(pc->Size != FUZZ_MAX_OUT)
+      {
+         t      = *pc;
+         t.Size = FUZZ_MAX_OUT;
+         if(fuzz_differs(&t, pr))
+         {
+            *pc      = t;
+            bChanged = 1;
+         }
+      }
+
+      for(i = 0; i < pc->Count; ++i)
+      {
+         FUZZ_SPEC * ps = &t.Spec[i];
+
+         /* drop the text and the flags */
+         t = *pc;
+         if(ps->Text[0])
+         {
+            ps->Text[0] = '\0';
+            if(fuzz_differs(&t, pr))
+            {
+               *pc      = t;
+               bChanged = 1;
+            }
+         }
+
+         for(j = 0; pc->Spec[i].Flags[j]; ++j)
+         {
+            t = *pc;
+            memmove(&ps->Flags[j], &ps->Flags[j + 1], strlen(&ps->Flags[j]));
+            if(fuzz_differs(&t, pr))
+            {
+               *pc      = t;
+               bChanged = 1;
+               --j;
+            }
+         }
+
+         /* replace a '*' by the value, drop the width, the precision or the length modifier */
+         for(j = 0; j < 2; ++j)
+         {
+            t = *pc;
+            if(!ps->Star[j])
+               continue;
+
+            ps->Star[j] = 0;
+            if(j)
+               ps->Precision = (ps->StarValue[1] < 0) ? -1 : ps->StarValue[1];
+            else
+            {
+               ps->Width = (ps->StarValue[0] < 0) ? -ps->StarValue[0] : ps->StarValue[0];
+               if((ps->StarValue[0] < 0) && !strchr(ps->Flags, '-'))
+                  strcat(ps->Flags, "-");
+            }
+
+            if(fuzz_differs(&t, pr))
+            {
+               *pc      = t;
+               bChanged = 1;
+            }
+         }
+
+         t = *pc;
+         if(ps->Width >= 0)
+         {
+            ps->Width = -1;
+            if(fuzz_differs(&t, pr))
+            {
+               *pc      = t;
+               bChanged = 1;
+            }
+            else
+            {
+               t = *pc;
+               ps->Width /= 2;
+               if(ps->Width && fuzz_differs(&t, pr))
+               {
+                  *pc      = t;
+                  bChanged = 1;
+               }
+            }
+         }
+
+         t = *pc;
+         if(ps->Precision >= 0)
+         {
+            ps->Precision = -1;
+            if(fuzz_differs(&t, pr))
+            {
+               *pc      = t;
+               bChanged = 1;
+            }
+            else
+            {
+               t = *pc;
+               ps->Precision /= 2;
+               if(ps->Precision && fuzz_differs(&t, pr))
+               {
+                  *pc      = t;
+                  bChanged = 1;
+               }
+            }
+         }
+
+         t = *pc;
+         if(ps->Length[0] && (pc->Mode == FUZZ_SINGLE))
+         {
+            ps->Length[0] = '\0';
+            if(fuzz_differs(&t, pr))
+            {
+               *pc      = t;
+               bChanged = 1;
+            }
+         }
+
+         /* shorten the string */
+         t = *pc;
+         if((ps->Conv == 's') && ps->Str[0])
+         {
+            ps->Str[strlen(ps->Str) - 1] = '\0';
+            if(fuzz_differs(&t, pr))
+            {
+               *pc      = t;
+               bChanged = 1;
+            }
+         }
+      }
+   }
+
+   fuzz_run(pc, pr);
+} /* void fuzz_reduce(FUZZ_CASE * pc, FUZZ_RESULT * pr) */
+
+
+/* fuzz_put_string prints a string of the given length as C literal */
+static void fuzz_put_string(FILE * pf, const char * ps, size_t len)
+{
+   fputc('"', pf);
+
+   while(len--)
+   {
+      unsigned char c = (unsigned char) *ps++;
+
+      if((c == '"') || (c == '\\'))
+         fprintf(pf, "\\%c", c);
+      else if((c < ' ') || (c >= 0x7f))
+         fprintf(pf, "\\x%02x\"\"", c);
+      else
+         fputc(c, pf);
+   }
+
+   fputc('"', pf);
+} /* void fuzz_put_string(FILE * pf, const char * ps, size_t len) */
+
+
+/* fuzz_put_arg prints the value of a conversion as C expression */
+static void fuzz_put_arg(FILE * pf, int Mode, const FUZZ_SPEC * ps)
+{
+   int type = (Mode == FUZZ_SINGLE) ? fuzz_type(ps) : ((Mode == FUZZ_DOUBLES) ? FUZZ_DOUBLE : FUZZ_INT);
+
+   if((ps->Conv == 'c') && (type == FUZZ_INT))
+   {
+      fprintf(pf, ", (int) %u", (unsigned char) ps->Str[0]);
+      return;
+   }
+
+   if(((type == FUZZ_DOUBLE) || (type == FUZZ_LDOUBLE)) && ((ps->Value != ps->Value) || (ps->Value - ps->Value != 0)))
+   { /* NaN and infinity as C expressions */
+      fprintf(pf, ", (%s) %s", (type == FUZZ_DOUBLE) ? "double" : "long double",
+              (ps->Value != ps->Value) ? (signbit(ps->Value) ? "-NAN" : "NAN") : (signbit(ps->Value) ? "-HUGE_VAL" : "HUGE_VAL"));
+      return;
+   }
+
+   switch(type)
+   {
+      case FUZZ_NONE:    break;
+      case FUZZ_INT:     fprintf(pf, ", (int) %d", (int) ps->Bits);                      break;
+      case FUZZ_UINT:    fprintf(pf, ", (unsigned) %uu", (unsigned) ps->Bits);           break;
+      case FUZZ_LONG:    fprintf(pf, ", (long) %ldl", (long) ps->Bits);                  break;
+      case FUZZ_ULONG:   fprintf(pf, ", (unsigned long) %lulu", (unsigned long) ps->Bits); break;
+      case FUZZ_LLONG:   fprintf(pf, ", (long long) %lldll", (long long) ps->Bits);      break;
+      case FUZZ_ULLONG:  fprintf(pf, ", (unsigned long long) %llullu", (unsigned long long) ps->Bits); break;
+      case FUZZ_INTMAX:  fprintf(pf, ", (intmax_t) %lldll", (long long) ps->Bits);       break;
+      case FUZZ_UINTMAX: fprintf(pf, ", (uintmax_t) %llullu", (unsigned long long) ps->Bits); break;
+      case FUZZ_PTRDIFF: fprintf(pf, ", (ptrdiff_t) %lldll", (long long) (ptrdiff_t) ps->Bits); break;
+      case FUZZ_SIZE:    fprintf(pf, ", (size_t) %llullu", (unsigned long long) (size_t) ps->Bits); break;
+      case FUZZ_DOUBLE:  fprintf(pf, ", (double) %a", (double) ps->Value);                break;
+      case FUZZ_LDOUBLE: fprintf(pf, ", (long double) %LaL", ps->Value);                  break;
+      case FUZZ_WINT:    fprintf(pf, ", (wint_t) %u", (unsigned char) ps->Str[0]);        break;
+      case FUZZ_STR:
+      case FUZZ_WSTR:
+         fprintf(pf, (type == FUZZ_WSTR) ? ", L" : ", ");
+         fuzz_put_string(pf, ps->Str, strlen(ps->Str));
+         break;
+   }
+} /* void fuzz_put_arg(FILE * pf, int Mode, const FUZZ_SPEC * ps) */
+
+
+/* ------------------------------------------------------------------------- *\
+   fuzz_report prints a reduced mismatch as snprintf call with both outputs
+\* ------------------------------------------------------------------------- */
+static void fuzz_report(FILE * pf, const FUZZ_CASE * pc, const FUZZ_RESULT * pr)
+{
+   char   fmt[FUZZ_MAX_FMT];
+   char * pfmt = fmt;
+   size_t len;
+   size_t i;
+
+   for(i = 0; i < pc->Count; ++i)
+      pfmt = fuzz_format(pfmt, &pc->Spec[i]);
+
+   fprintf(pf, "mismatch: snprintf(buf, %zu, ", pc->Size);
+   fuzz_put_string(pf, fmt, strlen(fmt));
+
+   for(i = 0; i < pc->Count; ++i)
+   {
+      const FUZZ_SPEC * ps = &pc->Spec[i];
+
+      if(ps->Star[0])
+         fprintf(pf, ", %d", ps->StarValue[0]);
+      if(ps->Star[1])
+         fprintf(pf, ", %d", ps->StarValue[1]);
+
+      fuzz_put_arg(pf, pc->Mode, ps);
+   }
+
+   fprintf(pf, ")\n   vsnprintf  %5d ", pr->LibcRet);
+   len = (pr->LibcRet < 0) ? 0 : (size_t) pr->LibcRet;
+   len = pc->Size ? ((len < pc->Size) ? len : pc->Size - 1) : 0;
+   fuzz_put_string(pf, pr->Libc, len);
+
+   fprintf(pf, "\n   svsnprintf %5zu ", pr->Ret);
+   len = pc->Size ? ((pr->Ret < pc->Size) ? pr->Ret : pc->Size - 1) : 0;
+   fuzz_put_string(pf, pr->Out, len);
+
+   for(i = 0; i < sizeof(pr->Out); ++i)
+   {
+      if(pr->Libc[i] != pr->Out[i])
+      {
+         fprintf(pf, "\n   first difference at offset %zu%s", i, (i >= pc->Size) ? " behind the buffer size" : "");
+         break;
+      }
+   }
+
+   if(fuzz_known(pc))
+      fprintf(pf, "\n   known difference: %s", fuzz_known(pc));
+
+   fputs("\n", pf);
+} /* void fuzz_report(FILE * pf, const FUZZ_CASE * pc, const FUZZ_RESULT * pr) */
+
+
+/* ------------------------------------------------------------------------- *\
+   fuzz_one checks an input and returns 1 if both outputs are equal or the
+   difference is known. Mismatches get reduced and reported.
+\* ------------------------------------------------------------------------- */
+static int fuzz_one(const uint8_t * pData, size_t Size)
+{
+   static FUZZ_RESULT r;
+   FUZZ_CASE          c;
+
+   fuzz_decode(pData, Size, &c);
+
+   if(fuzz_run(&c, &r))
+      return (1);
+
+   if(!fuzz_differs(&c, &r))
+   {
+      ++fuzz_known_count;
+      return (1);
+   }
+
+   fuzz_reduce(&c, &r);
+   fuzz_report(stderr, &c, &r);
+   return (0);
+} /* int fuzz_one(const uint8_t * pData, size_t Size) */
+
+
+/* entry point of libFuzzer, also used by AFL++ in persistent mode */
+int LLVMFuzzerTestOneInput(const uint8_t * pData, size_t Size)
+{
+   if(!fuzz_one(pData, Size))
+      abort();
+
+   return (0);
+} /* int LLVMFuzzerTestOneInput(const uint8_t * pData, size_t Size) */
+
+
+#ifndef FUZZ_LIBFUZZER
+
+/* fuzz_random is the generator of the standalone driver */
+static uint32_t fuzz_random(uint32_t * pSeed)
+{
+   *pSeed = *pSeed * 1103515245u + 12345u;
+   return (*pSeed >> 8);
+} /* uint32_t fuzz_random(uint32_t * pSeed) */
+
+
+/* fuzz_file checks the input of a file like a crash of AFL or libFuzzer */
+static int fuzz_file(const char * pName)
+{
+   static uint8_t data[65536];
+   FILE *         pf = fopen(pName, "rb");
+   size_t         size;
+
+   if(!pf)
+   {
+      perror(pName);
+      return (0);
+   }
+
+   size = fread(data, 1, sizeof(data), pf);
+   fclose(pf);
+
+   return (fuzz_one(data, size));
+} /* int fuzz_file(const char * pName) */
+
+
+/* ------------------------------------------------------------------------- *\
+   main function of the standalone driver. Without file arguments it checks
+   random inputs, otherwise the inputs of the files.
+\* ------------------------------------------------------------------------- */
+int main(int argc, char * argv[])
+{
+   unsigned long seed     = 1;
+   unsigned long runs     = 200000;
+   unsigned long max_fail = 10;
+   unsigned long fails    = 0;
+   unsigned long files    = 0;
+   unsigned long n;
+   int           i;
+
+   for(i = 1; i < argc; ++i)
+   {
+      if(!strcmp(argv[i], "--seed") && (i + 1 < argc))
+         seed = strtoul(argv[++i], NULL, 0);
+      else if(!strcmp(argv[i], "--runs") && (i + 1 < argc))
+         runs = strtoul(argv[++i], NULL, 0);
+      else if(!strcmp(argv[i], "--max-failures") && (i + 1 < argc))
+         max_fail = strtoul(argv[++i], NULL, 0);
+      else if(!strcmp(argv[i], "--strict"))
+         fuzz_strict = 1;
+      else if(argv[i][0] == '-')
+      {
+         fprintf(stderr, "usage: %s [--seed N] [--runs N] [--max-failures N] [--strict] [FILE...]\n", argv[0]);
+         return (2);
+      }
+      else
+      {
+         ++files;
+         if(!fuzz_file(argv[i]))
+            ++fails;
+      }
+   }
+
+   if(files)
+   {
+      printf("%lu of %lu inputs passed, %lu known differences\n", files - fails, files, fuzz_known_count);
+      return (fails ? 1 : 0);
+   }
+
+   for(n = 0; (n < runs) && (!max_fail || (fails < max_fail)); ++n)
+   {
+      uint8_t  data[FUZZ_MAX_INPUT];
+      uint32_t s = (uint32_t) ((seed + n) * 2654435761ul);
+      size_t   k;
+
+      for(k = 0; k < sizeof(data); ++k)
+         data[k] = (uint8_t) fuzz_random(&s);
+
+      if(!fuzz_one(data, sizeof(data)))
+      {
+         fprintf(stderr, "   reproduce with --seed %lu --runs 1\n", seed + n);
+         ++fails;
+      }
+   }
+
+   printf("%lu of %lu random inputs passed (seed %lu), %lu known differences\n", n - fails, n, seed, fuzz_known_count);
+   return (fails ? 1 : 0);
+} /* main() */
+
+#endif /* FUZZ_LIBFUZZER */
+
+
+/* ========================================================================= *\
+   END OF FILE
+\* ========================================================================= */
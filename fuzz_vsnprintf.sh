@@ -0,0 +1,5 @@
+#!/bin/sh
+rm -f ./_fuzz_vsnprintf
+cc -Wall -O2 $CFLAGS -o _fuzz_vsnprintf -I . fuzz_vsnprintf.c callback_printf.c || exit $?
+./_fuzz_vsnprintf "$@"
+exit $?
@@ -1,5 +1,15 @@
 #!/bin/sh
-rm -f ./_test_callback_printf
-cc -Wall -ggdb -o _test_callback_printf -I . test_callback_printf.c callback_printf.c
-./_test_callback_printf
-exit $?
+rm -f ./_test_callback_printf ./_test_callback_printf_cpp
+cc -Wall -ggdb -o _test_callback_printf -I . test_callback_printf.c callback_printf.c sfprintf.c safdprintf.c cbk_formats.c cbk_record.c -lpthread
+./_test_callback_printf || exit $?
+cc -Wall -ggdb -DCALLBACK_PRINTF_PROFILE -o _test_callback_printf -I . test_callback_printf.c callback_printf.c sfprintf.c safdprintf.c cbk_formats.c cbk_record.c -lpthread
+./_test_callback_printf || exit $?
+if command -v c++ >/dev/null 2>&1; then
+   cc -Wall -ggdb -c -o _callback_printf.o -I . callback_printf.c
+   CXXSTD=c++20
+   echo 'int main() { return 0; }' | c++ -std=c++20 -x c++ -o /dev/null - 2>/dev/null || CXXSTD=c++17
+   c++ -std=$CXXSTD -Wall -ggdb -o _test_callback_printf_cpp -I . test_callback_printf.cpp _callback_printf.o
+   rm -f _callback_printf.o
+   ./_test_callback_printf_cpp || exit $?
+fi
+exit 0
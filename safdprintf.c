@@ -0,0 +1,1187 @@
+/*****************************************************************************\
+*                                                                             *
+*  FILE NAME:     safdprintf.c                                                *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  DESCRIPTION:   asynchronous file descriptor output of callback_printf      *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  COPYRIGHT:     (c) 2026 Dipl.-Ing. Klaus Lux (Aachen, Germany)             *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  ORIGIN:        https://github.com/klux21/callback_printf                   *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+* Civil Usage Public License, Version 1.2, June 2026                          *
+*                                                                             *
+* Redistribution and use in source and binary forms, with or without          *
+* modification, are permitted provided that the following conditions are met: *
+*                                                                             *
+* 1. Redistributions of source code must retain the above copyright           *
+*    notice, this list of conditions, the explanation of terms                *
+*    and the following disclaimer.                                            *
+*                                                                             *
+* 2. Redistributions in binary form must reproduce the above copyright        *
+*    notice, this list of conditions and the following disclaimer in the      *
+*    documentation or other materials provided with the distribution.         *
+*                                                                             *
+* 3. All modified files must carry prominent notices stating that the         *
+*    files have been changed.                                                 *
+*                                                                             *
+* 4. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are designed or           *
+*    intended to harm, to kill or to forcibly immobilize people.              *
+*                                                                             *
+* 5. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are intended to           *
+*    monitor, to track, to change or to control the behavior, the             *
+*    constitution, the location or the communication of any people or         *
+*    their property without the explicit and prior agreement of those         *
+*    people except those devices and systems are solely designed for          *
+*    saving or protecting peoples life or health.                             *
+*                                                                             *
+* 6. The source code and binary forms and any derivative works are not        *
+*    stored or executed in any systems or devices that are intended           *
+*    for the production of any of the systems or devices that                 *
+*    have been stated before except the ones for saving or protecting         *
+*    peoples life or health only.                                             *
+*                                                                             *
+* The term 'systems' in all clauses shall include all types and combinations  *
+* of physical, virtualized or simulated hardware and software and any kind    *
+* of data storage.                                                            *
+*                                                                             *
+* The term 'devices' shall include any kind of local or non-local control     *
+* system of the stated devices as part of that device as well. Any assembly   *
+* of more than one device is one and the same device regarding this license.  *
+*                                                                             *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" *
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   *
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  *
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   *
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         *
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        *
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    *
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     *
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     *
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  *
+* POSSIBILITY OF SUCH DAMAGE.                                                 *
+*                                                                             *
+\*****************************************************************************/
+
+#undef   _CRT_ERRNO_DEFINED
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>       /* write() */
+#include <Windows.h>  /* Sleep() */
+#pragma warning(disable : 4100 4127 4706 4710)
+#else
+#include <unistd.h>   /* write(), lseek(), usleep() */
+#include <fcntl.h>    /* fcntl() */
+#include <pthread.h>
+
+#if defined(__linux__) && defined(__has_include) && !defined(SAFD_NO_URING_SUPPORT)
+#if __has_include(<linux/io_uring.h>)
+#define SAFD_URING 1  /* io_uring support of the kernel headers is available */
+#endif
+#endif
+
+#endif
+
+#ifdef SAFD_URING
+#include <sys/mman.h>     /* mmap() */
+#include <sys/syscall.h>  /* syscall(), __NR_io_uring_setup, ... */
+#include <sys/uio.h>      /* struct iovec */
+#include <linux/io_uring.h>
+#endif
+
+#include <safdprintf.h>
+
+/* ========================================================================= *\
+   Internal data of the asynchronous output
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   SAFD_BUF describes a single output buffer.
+\* ------------------------------------------------------------------------- */
+typedef struct SAFD_BUF_S SAFD_BUF;
+struct SAFD_BUF_S
+{
+   char *   pData;  /* buffer memory */
+   size_t   Length; /* length of the data to write */
+   size_t   Done;   /* length of the data that are written already */
+   uint64_t Offset; /* file offset of the data in io_uring mode */
+   int      Busy;   /* the write is pending in io_uring mode */
+};
+
+#ifdef SAFD_URING
+/* ------------------------------------------------------------------------- *\
+   SAFD_RING contains the mapped submission and completion queues of an
+   io_uring instance.
+\* ------------------------------------------------------------------------- */
+typedef struct SAFD_RING_S SAFD_RING;
+struct SAFD_RING_S
+{
+   int                   fd;          /* file descriptor of the io_uring instance */
+   void *                pSqMem;      /* mapping of the submission queue ring */
+   size_t                SqMemSize;   /* size of the mapping of the submission queue ring */
+   void *                pCqMem;      /* mapping of the completion queue ring (may be the same as pSqMem) */
+   size_t                CqMemSize;   /* size of the mapping of the completion queue ring */
+   struct io_uring_sqe * pSqes;       /* array of submission queue entries */
+   size_t                SqesSize;    /* size of the mapping of the submission queue entries */
+   unsigned *            pSqHead;     /* head of submission queue (written by the kernel) */
+   unsigned *            pSqTail;     /* tail of submission queue (written by us) */
+   unsigned *            pSqMask;     /* index mask of submission queue */
+   unsigned *            pSqArray;    /* index array of submission queue */
+   unsigned *            pCqHead;     /* head of completion queue (written by us) */
+   unsigned *            pCqTail;     /* tail of completion queue (written by the kernel) */
+   unsigned *            pCqMask;     /* index mask of completion queue */
+   struct io_uring_cqe * pCqes;       /* array of completion queue entries */
+   unsigned              Unsubmitted; /* number of queued but not yet submitted entries */
+};
+#endif
+
+struct SAFD_S
+{
+   int              fd;            /* file descriptor for writing */
+   int              Mode;          /* SAFD_MODE_SYNC, SAFD_MODE_THREAD or SAFD_MODE_URING */
+   char *           pMem;          /* memory of all buffers */
+   size_t           BufSize;       /* size of a single buffer */
+   size_t           BufCount;      /* number of buffers */
+   SAFD_BUF *       pBuf;          /* array of buffer descriptions */
+   size_t *         pFree;         /* stack of indexes of unused buffers */
+   size_t           FreeCount;     /* number of unused buffers */
+   size_t *         pQueue;        /* FIFO of indexes of buffers to write by the writer thread */
+   size_t           QueueHead;     /* index of first entry of pQueue */
+   size_t           QueueCount;    /* number of entries in pQueue */
+   uint64_t         Queued;        /* number of bytes that have been queued for writing */
+   uint64_t         Written;       /* number of bytes that have been written successfully */
+   size_t           Pending;       /* number of buffers that are waiting for completion */
+   int              Err;           /* errno value of first failed write */
+#ifndef _WIN32
+   int              ThreadStarted; /* whether the writer thread has been started */
+   int              Stop;          /* request for the writer thread to terminate */
+   pthread_t        Thread;        /* writer thread */
+   pthread_mutex_t  Lock;          /* lock of the buffer lists and counters in thread mode */
+   pthread_cond_t   WorkCond;      /* signals new buffers in pQueue or a stop request */
+   pthread_cond_t   DoneCond;      /* signals completed buffers */
+#endif
+#ifdef SAFD_URING
+   uint64_t         Offset;        /* file offset for the next write in io_uring mode */
+   SAFD_RING        Ring;          /* io_uring instance */
+#endif
+};
+
+
+/* ------------------------------------------------------------------------- *\
+   safd_write_all writes a data buffer completely to a file descriptor and
+   retries interrupted or blocked writes. It returns the number of written
+   bytes and stores the errno value of a failed write in *pErr.
+\* ------------------------------------------------------------------------- */
+
+static size_t safd_write_all(int fd, const char * pSrc, size_t Length, int * pErr)
+{
+   size_t zRet = 0;
+
+   while(Length)
+   {
+      ptrdiff_t sz = write(fd, pSrc, Length > 0x20000 ? 0x20000 : (unsigned int) Length);
+
+      if(sz > 0)
+      {
+         zRet   += (size_t) sz;
+         Length -= (size_t) sz;
+         pSrc   += sz;
+      }
+      else if (sz < 0)
+      {
+         if (errno == EINTR)
+         { /* interrupted by a signal -> just try again */
+         }
+#ifdef _WIN32
+         else if (errno == EAGAIN)
+         {
+            Sleep(1);
+         }
+#else
+         else if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+         {
+            usleep(1000);
+         }
+#endif
+         else
+         {
+            *pErr = errno;
+            break;
+         }
+      }
+      else
+      {
+         *pErr = EIO; /* no progress at all */
+         break;
+      }
+   }
+
+   return (zRet);
+} /* size_t safd_write_all(int fd, const char * pSrc, size_t Length, int * pErr) */
+
+
+
+#ifdef SAFD_URING
+/* ========================================================================= *\
+   io_uring backend
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   safd_uring_enter submits the queued entries of the submission queue and
+   waits for min_complete completions. It returns 0 or an errno value.
+\* ------------------------------------------------------------------------- */
+
+static int safd_uring_enter(SAFD_RING * pr, unsigned min_complete)
+{
+   int iRet = 0;
+
+   while(pr->Unsubmitted || min_complete)
+   {
+      long r = syscall(__NR_io_uring_enter, pr->fd, pr->Unsubmitted, min_complete, min_complete ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+
+      if(r >= 0)
+      {
+         pr->Unsubmitted -= (unsigned) r;
+         if(min_complete)
+            break;
+      }
+      else if((errno != EINTR) && (errno != EAGAIN))
+      {
+         iRet = errno;
+         break;
+      }
+   }
+
+   return (iRet);
+} /* int safd_uring_enter(SAFD_RING * pr, unsigned min_complete) */
+
+
+/* ------------------------------------------------------------------------- *\
+   safd_uring_queue adds a write of the unwritten data of a buffer to the
+   submission queue. Every buffer is in the queue once at most and the
+   queue is big enough for all buffers.
+\* ------------------------------------------------------------------------- */
+
+static void safd_uring_queue(SAFD * pafd, size_t idx)
+{
+   SAFD_RING *           pr    = &pafd->Ring;
+   SAFD_BUF *            pb    = pafd->pBuf + idx;
+   unsigned              tail  = *pr->pSqTail;
+   unsigned              index = tail & *pr->pSqMask;
+   struct io_uring_sqe * sqe   = pr->pSqes + index;
+
+   memset(sqe, 0, sizeof(*sqe));
+   sqe->opcode    = IORING_OP_WRITE_FIXED;
+   sqe->fd        = pafd->fd;
+   sqe->addr      = (uint64_t) (uintptr_t) (pb->pData + pb->Done);
+   sqe->len       = (uint32_t) (pb->Length - pb->Done);
+   sqe->off       = pb->Offset + pb->Done;
+   sqe->buf_index = (uint16_t) idx;
+   sqe->user_data = (uint64_t) idx;
+
+   pr->pSqArray[index] = index;
+   __atomic_store_n(pr->pSqTail, tail + 1, __ATOMIC_RELEASE);
+   ++pr->Unsubmitted;
+} /* void safd_uring_queue(SAFD * pafd, size_t idx) */
+
+
+/* ------------------------------------------------------------------------- *\
+   safd_uring_reap collects the completions of the completion queue without
+   waiting. Incomplete writes are queued again.
+\* ------------------------------------------------------------------------- */
+
+static void safd_uring_reap(SAFD * pafd)
+{
+   SAFD_RING * pr   = &pafd->Ring;
+   unsigned    head = *pr->pCqHead;
+   unsigned    tail = __atomic_load_n(pr->pCqTail, __ATOMIC_ACQUIRE);
+
+   if(head == tail)
+      return;
+
+   while(head != tail)
+   {
+      struct io_uring_cqe * cqe = pr->pCqes + (head & *pr->pCqMask);
+      size_t                idx = (size_t) cqe->user_data;
+      SAFD_BUF *            pb  = pafd->pBuf + idx;
+      int                   res = cqe->res;
+      int                   done = 1;
+
+      if(!pb->Busy)
+      { /* late completion of a write that has been given up by safd_uring_fail */
+         done = 0;
+      }
+      else if(res > 0)
+      {
+         pb->Done      += (size_t) res;
+         pafd->Written += (uint64_t) res;
+
+         if((pb->Done < pb->Length) && !pafd->Err)
+         { /* partial write -> write the rest */
+            safd_uring_queue(pafd, idx);
+            done = 0;
+         }
+      }
+      else if((res == -EINTR) || (res == -EAGAIN))
+      {
+         if(!pafd->Err)
+         {
+            safd_uring_queue(pafd, idx);
+            done = 0;
+         }
+      }
+      else if(!pafd->Err)
+      {
+         pafd->Err = res ? -res : EIO;
+      }
+
+      if(done)
+      {
+         pb->Busy = 0;
+         pafd->pFree[pafd->FreeCount++] = idx;
+         --pafd->Pending;
+      }
+
+      ++head;
+   }
+
+   __atomic_store_n(pr->pCqHead, head, __ATOMIC_RELEASE);
+
+   if(pr->Unsubmitted)
+   {
+      int err = safd_uring_enter(pr, 0);
+      if(err && !pafd->Err)
+         pafd->Err = err;
+   }
+} /* void safd_uring_reap(SAFD * pafd) */
+
+
+/* ------------------------------------------------------------------------- *\
+   safd_uring_fail gives up all pending writes after io_uring_enter failed,
+   so that nobody waits for their completion anymore.
+\* ------------------------------------------------------------------------- */
+
+static void safd_uring_fail(SAFD * pafd)
+{
+   size_t idx;
+
+   for(idx = 0; idx < pafd->BufCount; ++idx)
+   {
+      if(pafd->pBuf[idx].Busy)
+      {
+         pafd->pBuf[idx].Busy = 0;
+         pafd->pFree[pafd->FreeCount++] = idx;
+         --pafd->Pending;
+      }
+   }
+
+   pafd->Ring.Unsubmitted = 0;
+} /* void safd_uring_fail(SAFD * pafd) */
+
+
+/* ------------------------------------------------------------------------- *\
+   safd_uring_wait waits for at least one completion and collects it. It
+   returns 0 or the errno value of io_uring_enter, which is stored in Err
+   and fails all pending writes. Interrupted calls are retried.
+\* ------------------------------------------------------------------------- */
+
+static int safd_uring_wait(SAFD * pafd)
+{
+   int iRet = safd_uring_enter(&pafd->Ring, 1);
+
+   safd_uring_reap(pafd);
+
+   if(iRet)
+   {
+      if(!pafd->Err)
+         pafd->Err = iRet;
+
+      safd_uring_fail(pafd);
+   }
+
+   return (iRet);
+} /* int safd_uring_wait(SAFD * pafd) */
+
+
+/* ------------------------------------------------------------------------- *\
+   safd_uring_exit releases the io_uring instance.
+\* ------------------------------------------------------------------------- */
+
+static void safd_uring_exit(SAFD_RING * pr)
+{
+   if(pr->pSqes && (pr->pSqes != MAP_FAILED))
+      munmap(pr->pSqes, pr->SqesSize);
+
+   if(pr->pCqMem && (pr->pCqMem != MAP_FAILED) && (pr->pCqMem != pr->pSqMem))
+      munmap(pr->pCqMem, pr->CqMemSize);
+
+   if(pr->pSqMem && (pr->pSqMem != MAP_FAILED))
+      munmap(pr->pSqMem, pr->SqMemSize);
+
+   if(pr->fd >= 0)
+      close(pr->fd);
+
+   memset(pr, 0, sizeof(*pr));
+   pr->fd = -1;
+} /* void safd_uring_exit(SAFD_RING * pr) */
+
+
+/* ------------------------------------------------------------------------- *\
+   safd_uring_init creates the io_uring instance and registers the buffers.
+   It returns 0 in success case and nonzero if io_uring is unsuitable for
+   the file descriptor or not supported by the system.
+\* ------------------------------------------------------------------------- */
+
+static int safd_uring_init(SAFD * pafd)
+{
+   int                     iRet    = -1;
+   SAFD_RING *             pr      = &pafd->Ring;
+   struct io_uring_params  p;
+   struct iovec *          piov    = NULL;
+   unsigned                entries = 1;
+   off_t                   offset;
+   int                     fl;
+   size_t                  i;
+
+   pr->fd = -1;
+
+   offset = lseek(pafd->fd, 0, SEEK_CUR);
+   if(offset < 0)
+      goto Exit; /* no seekable file -> the order of the writes is not ensured */
+
+   fl = fcntl(pafd->fd, F_GETFL);
+   if((fl == -1) || (fl & O_APPEND))
+      goto Exit; /* the kernel ignores the offsets in append mode */
+
+   if(pafd->BufCount > 4096)
+      goto Exit;
+
+   while(entries < pafd->BufCount)
+      entries <<= 1;
+
+   memset(&p, 0, sizeof(p));
+   pr->fd = (int) syscall(__NR_io_uring_setup, entries, &p);
+   if(pr->fd < 0)
+      goto Exit;
+
+   pr->SqMemSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+   pr->CqMemSize = p.cq_off.cqes  + p.cq_entries * sizeof(struct io_uring_cqe);
+
+   if(p.features & IORING_FEAT_SINGLE_MMAP)
+   {
+      if(pr->CqMemSize > pr->SqMemSize)
+         pr->SqMemSize = pr->CqMemSize;
+      pr->CqMemSize = pr->SqMemSize;
+   }
+
+   pr->pSqMem = mmap(NULL, pr->SqMemSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, pr->fd, IORING_OFF_SQ_RING);
+   if(pr->pSqMem == MAP_FAILED)
+      goto Exit;
+
+   if(p.features & IORING_FEAT_SINGLE_MMAP)
+      pr->pCqMem = pr->pSqMem;
+   else
+   {
+      pr->pCqMem = mmap(NULL, pr->CqMemSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, pr->fd, IORING_OFF_CQ_RING);
+      if(pr->pCqMem == MAP_FAILED)
+         goto Exit;
+   }
+
+   pr->SqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+   pr->pSqes    = (struct io_uring_sqe *) mmap(NULL, pr->SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, pr->fd, IORING_OFF_SQES);
+   if(pr->pSqes == MAP_FAILED)
+      goto Exit;
+
+   pr->pSqHead  = (unsigned *) ((char *) pr->pSqMem + p.sq_off.head);
+   pr->pSqTail  = (unsigned *) ((char *) pr->pSqMem + p.sq_off.tail);
+   pr->pSqMask  = (unsigned *) ((char *) pr->pSqMem + p.sq_off.ring_mask);
+   pr->pSqArray = (unsigned *) ((char *) pr->pSqMem + p.sq_off.array);
+   pr->pCqHead  = (unsigned *) ((char *) pr->pCqMem + p.cq_off.head);
+   pr->pCqTail  = (unsigned *) ((char *) pr->pCqMem + p.cq_off.tail);
+   pr->pCqMask  = (unsigned *) ((char *) pr->pCqMem + p.cq_off.ring_mask);
+   pr->pCqes    = (struct io_uring_cqe *) ((char *) pr->pCqMem + p.cq_off.cqes);
+
+   piov = (struct iovec *) malloc(pafd->BufCount * sizeof(struct iovec));
+   if(!piov)
+      goto Exit;
+
+   for(i = 0; i < pafd->BufCount; ++i)
+   {
+      piov[i].iov_base = pafd->pBuf[i].pData;
+      piov[i].iov_len  = pafd->BufSize;
+   }
+
+   if(syscall(__NR_io_uring_register, pr->fd, IORING_REGISTER_BUFFERS, piov, (unsigned) pafd->BufCount) < 0)
+      goto Exit; /* e.g. RLIMIT_MEMLOCK exceeded */
+
+   pafd->Offset = (uint64_t) offset;
+   iRet = 0;
+
+   Exit:;
+   if(piov)
+      free(piov);
+
+   if(iRet)
+      safd_uring_exit(pr);
+
+   return (iRet);
+} /* int safd_uring_init(SAFD * pafd) */
+
+#endif /* SAFD_URING */
+
+
+
+#ifndef _WIN32
+/* ========================================================================= *\
+   writer thread backend
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   safd_writer_thread writes the queued buffers in the order of the queue.
+   Buffers that are queued after a failed write are dropped.
+\* ------------------------------------------------------------------------- */
+
+static void * safd_writer_thread(void * pv)
+{
+   SAFD * pafd = (SAFD *) pv;
+
+   pthread_mutex_lock(&pafd->Lock);
+
+   for(;;)
+   {
+      size_t     idx;
+      SAFD_BUF * pb;
+      size_t     written = 0;
+      int        err     = 0;
+
+      while(!pafd->QueueCount && !pafd->Stop)
+         pthread_cond_wait(&pafd->WorkCond, &pafd->Lock);
+
+      if(!pafd->QueueCount)
+         break; /* stop request and nothing left to write */
+
+      idx = pafd->pQueue[pafd->QueueHead];
+      pafd->QueueHead = (pafd->QueueHead + 1) % pafd->BufCount;
+      --pafd->QueueCount;
+      pb = pafd->pBuf + idx;
+
+      if(!pafd->Err)
+      {
+         pthread_mutex_unlock(&pafd->Lock);
+         written = safd_write_all(pafd->fd, pb->pData, pb->Length, &err);
+         pthread_mutex_lock(&pafd->Lock);
+      }
+
+      pafd->Written += written;
+      if(err && !pafd->Err)
+         pafd->Err = err;
+
+      pafd->pFree[pafd->FreeCount++] = idx;
+      --pafd->Pending;
+      pthread_cond_broadcast(&pafd->DoneCond);
+   }
+
+   pthread_mutex_unlock(&pafd->Lock);
+   return (NULL);
+} /* void * safd_writer_thread(void * pv) */
+
+
+/* ------------------------------------------------------------------------- *\
+   safd_thread_init starts the writer thread and returns 0 in success case
+   or an errno value otherwise.
+\* ------------------------------------------------------------------------- */
+
+static int safd_thread_init(SAFD * pafd)
+{
+   int iRet = pthread_mutex_init(&pafd->Lock, NULL);
+
+   if(!iRet)
+   {
+      iRet = pthread_cond_init(&pafd->WorkCond, NULL);
+
+      if(!iRet)
+      {
+         iRet = pthread_cond_init(&pafd->DoneCond, NULL);
+
+         if(!iRet)
+         {
+            iRet = pthread_create(&pafd->Thread, NULL, &safd_writer_thread, pafd);
+
+            if(!iRet)
+            {
+               pafd->ThreadStarted = 1;
+               goto Exit;
+            }
+
+            pthread_cond_destroy(&pafd->DoneCond);
+         }
+         pthread_cond_destroy(&pafd->WorkCond);
+      }
+      pthread_mutex_destroy(&pafd->Lock);
+   }
+
+   Exit:;
+   return (iRet);
+} /* int safd_thread_init(SAFD * pafd) */
+
+#endif /* _WIN32 */
+
+
+
+/* ========================================================================= *\
+   buffer management
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   safd_acquire returns the index of an unused buffer and waits for the
+   completion of a write if all buffers are in use.
+\* ------------------------------------------------------------------------- */
+
+static size_t safd_acquire(SAFD * pafd)
+{
+   size_t idx;
+
+#ifndef _WIN32
+   if(pafd->Mode == SAFD_MODE_THREAD)
+   {
+      pthread_mutex_lock(&pafd->Lock);
+
+      while(!pafd->FreeCount)
+         pthread_cond_wait(&pafd->DoneCond, &pafd->Lock);
+
+      idx = pafd->pFree[--pafd->FreeCount];
+
+      pthread_mutex_unlock(&pafd->Lock);
+      goto Exit;
+   }
+#endif
+
+#ifdef SAFD_URING
+   if(pafd->Mode == SAFD_MODE_URING)
+   {
+      if(!pafd->FreeCount)
+         safd_uring_reap(pafd);
+
+      while(!pafd->FreeCount)
+         safd_uring_wait(pafd);
+   }
+#endif
+
+   idx = pafd->pFree[--pafd->FreeCount];
+
+#ifndef _WIN32
+   Exit:;
+#endif
+   pafd->pBuf[idx].Length = 0;
+   pafd->pBuf[idx].Done   = 0;
+   return (idx);
+} /* size_t safd_acquire(SAFD * pafd) */
+
+
+/* ------------------------------------------------------------------------- *\
+   safd_release gives an unused buffer back.
+\* ------------------------------------------------------------------------- */
+
+static void safd_release(SAFD * pafd, size_t idx)
+{
+#ifndef _WIN32
+   if(pafd->Mode == SAFD_MODE_THREAD)
+   {
+      pthread_mutex_lock(&pafd->Lock);
+      pafd->pFree[pafd->FreeCount++] = idx;
+      pthread_cond_broadcast(&pafd->DoneCond);
+      pthread_mutex_unlock(&pafd->Lock);
+      return;
+   }
+#endif
+   pafd->pFree[pafd->FreeCount++] = idx;
+} /* void safd_release(SAFD * pafd, size_t idx) */
+
+
+/* ------------------------------------------------------------------------- *\
+   safd_submit hands a filled buffer over for writing.
+\* ------------------------------------------------------------------------- */
+
+static void safd_submit(SAFD * pafd, size_t idx)
+{
+   SAFD_BUF * pb = pafd->pBuf + idx;
+
+#ifndef _WIN32
+   if(pafd->Mode == SAFD_MODE_THREAD)
+   {
+      pthread_mutex_lock(&pafd->Lock);
+      pafd->pQueue[(pafd->QueueHead + pafd->QueueCount) % pafd->BufCount] = idx;
+      ++pafd->QueueCount;
+      ++pafd->Pending;
+      pafd->Queued += pb->Length;
+      pthread_cond_signal(&pafd->WorkCond);
+      pthread_mutex_unlock(&pafd->Lock);
+      return;
+   }
+#endif
+
+   pafd->Queued += pb->Length;
+
+#ifdef SAFD_URING
+   if(pafd->Mode == SAFD_MODE_URING)
+   {
+      pb->Offset    = pafd->Offset;
+      pafd->Offset += pb->Length;
+
+      if(pafd->Err)
+      { /* drop the data after an error */
+         pafd->pFree[pafd->FreeCount++] = idx;
+      }
+      else
+      {
+         int err;
+
+         ++pafd->Pending;
+         pb->Busy = 1;
+         safd_uring_queue(pafd, idx);
+
+         err = safd_uring_enter(&pafd->Ring, 0);
+         if(err && !pafd->Err)
+            pafd->Err = err;
+
+         safd_uring_reap(pafd);
+      }
+      return;
+   }
+#endif
+
+   if(!pafd->Err)
+      pafd->Written += safd_write_all(pafd->fd, pb->pData, pb->Length, &pafd->Err);
+
+   pafd->pFree[pafd->FreeCount++] = idx;
+} /* void safd_submit(SAFD * pafd, size_t idx) */
+
+
+
+/* ========================================================================= *\
+   Implementation of the public functions
+\* ========================================================================= */
+
+/* ------------------------------------------------------------------------- *\
+   safd_open creates an asynchronous output channel for a file descriptor.
+\* ------------------------------------------------------------------------- */
+
+SAFD * safd_open(int fd, size_t buffer_size, size_t buffer_count, int flags)
+{
+   SAFD * pRet = NULL;
+   SAFD * pafd = NULL;
+   size_t i;
+   int    err  = ENOMEM;
+
+   if((fd < 0) || !buffer_size || !buffer_count || (buffer_size > 0x7fffffff) || (buffer_count > ((size_t) -1) / buffer_size))
+   {
+      err = EINVAL;
+      goto Exit;
+   }
+
+   pafd = (SAFD *) calloc(1, sizeof(SAFD));
+   if(!pafd)
+      goto Exit;
+
+   pafd->fd       = fd;
+   pafd->BufSize  = buffer_size;
+   pafd->BufCount = buffer_count;
+   pafd->Mode     = SAFD_MODE_SYNC;
+
+#ifdef _WIN32
+   pafd->pMem = (char *) malloc(buffer_size * buffer_count);
+   if(!pafd->pMem)
+      goto Exit;
+#else
+   if(posix_memalign((void **) &pafd->pMem, 4096, buffer_size * buffer_count))
+   {
+      pafd->pMem = NULL;
+      goto Exit;
+   }
+#endif
+
+   pafd->pBuf   = (SAFD_BUF *) calloc(buffer_count, sizeof(SAFD_BUF));
+   pafd->pFree  = (size_t *)   calloc(buffer_count, sizeof(size_t));
+   pafd->pQueue = (size_t *)   calloc(buffer_count, sizeof(size_t));
+
+   if(!pafd->pBuf || !pafd->pFree || !pafd->pQueue)
+      goto Exit;
+
+   for(i = 0; i < buffer_count; ++i)
+   {
+      pafd->pBuf[i].pData = pafd->pMem + i * buffer_size;
+      pafd->pFree[i]      = buffer_count - 1 - i;
+   }
+   pafd->FreeCount = buffer_count;
+
+#ifdef SAFD_URING
+   pafd->Ring.fd = -1;
+
+   if(!(flags & SAFD_NO_URING) && !safd_uring_init(pafd))
+      pafd->Mode = SAFD_MODE_URING;
+#endif
+
+#ifndef _WIN32
+   if(pafd->Mode == SAFD_MODE_SYNC)
+   {
+      err = safd_thread_init(pafd);
+      if(err)
+         goto Exit;
+
+      pafd->Mode = SAFD_MODE_THREAD;
+   }
+#endif
+
+   pRet = pafd;
+   pafd = NULL;
+
+   Exit:;
+   if(pafd)
+   {
+      free(pafd->pQueue);
+      free(pafd->pFree);
+      free(pafd->pBuf);
+      free(pafd->pMem);
+      free(pafd);
+   }
+
+   if(!pRet)
+      errno = err;
+
+   return (pRet);
+} /* SAFD * safd_open(int fd, size_t buffer_size, size_t buffer_count, int flags) */
+
+
+/* ------------------------------------------------------------------------- *\
+   safd_status returns the state of the output channel.
+\* ------------------------------------------------------------------------- */
+
+int safd_status(SAFD * pafd, SAFD_STATUS * pStatus)
+{
+   int iRet = EINVAL;
+
+   if(!pafd)
+      goto Exit;
+
+#ifndef _WIN32
+   if(pafd->Mode == SAFD_MODE_THREAD)
+      pthread_mutex_lock(&pafd->Lock);
+#endif
+
+#ifdef SAFD_URING
+   if(pafd->Mode == SAFD_MODE_URING)
+      safd_uring_reap(pafd);
+#endif
+
+   iRet = pafd->Err;
+
+   if(pStatus)
+   {
+      pStatus->Queued  = pafd->Queued;
+      pStatus->Written = pafd->Written;
+      pStatus->Pending = pafd->Pending;
+      pStatus->Err     = pafd->Err;
+      pStatus->Mode    = pafd->Mode;
+   }
+
+#ifndef _WIN32
+   if(pafd->Mode == SAFD_MODE_THREAD)
+      pthread_mutex_unlock(&pafd->Lock);
+#endif
+
+   Exit:;
+   return (iRet);
+} /* int safd_status(SAFD * pafd, SAFD_STATUS * pStatus) */
+
+
+/* ------------------------------------------------------------------------- *\
+   safd_flush waits until all queued data are written.
+\* ------------------------------------------------------------------------- */
+
+int safd_flush(SAFD * pafd)
+{
+   int iRet = EINVAL;
+
+   if(!pafd)
+      goto Exit;
+
+#ifndef _WIN32
+   if(pafd->Mode == SAFD_MODE_THREAD)
+   {
+      pthread_mutex_lock(&pafd->Lock);
+
+      while(pafd->Pending)
+         pthread_cond_wait(&pafd->DoneCond, &pafd->Lock);
+
+      iRet = pafd->Err;
+      pthread_mutex_unlock(&pafd->Lock);
+      goto Exit;
+   }
+#endif
+
+#ifdef SAFD_URING
+   if(pafd->Mode == SAFD_MODE_URING)
+   {
+      safd_uring_reap(pafd);
+
+      while(pafd->Pending)
+         safd_uring_wait(pafd); /* a failure gives up the pending writes */
+
+      lseek(pafd->fd, (off_t) pafd->Offset, SEEK_SET); /* keep the file position in sync for other writes */
+   }
+#endif
+
+   iRet = pafd->Err;
+
+   Exit:;
+   return (iRet);
+} /* int safd_flush(SAFD * pafd) */
+
+
+/* ------------------------------------------------------------------------- *\
+   safd_close flushes and releases the output channel.
+\* ------------------------------------------------------------------------- */
+
+int safd_close(SAFD * pafd)
+{
+   int iRet = safd_flush(pafd);
+
+   if(!pafd)
+      goto Exit;
+
+#ifndef _WIN32
+   if(pafd->ThreadStarted)
+   {
+      pthread_mutex_lock(&pafd->Lock);
+      pafd->Stop = 1;
+      pthread_cond_signal(&pafd->WorkCond);
+      pthread_mutex_unlock(&pafd->Lock);
+
+      pthread_join(pafd->Thread, NULL);
+
+      pthread_cond_destroy(&pafd->DoneCond);
+      pthread_cond_destroy(&pafd->WorkCond);
+      pthread_mutex_destroy(&pafd->Lock);
+   }
+#endif
+
+#ifdef SAFD_URING
+   if(pafd->Mode == SAFD_MODE_URING)
+      safd_uring_exit(&pafd->Ring);
+#endif
+
+   free(pafd->pQueue);
+   free(pafd->pFree);
+   free(pafd->pBuf);
+   free(pafd->pMem);
+   free(pafd);
+
+   Exit:;
+   return (iRet);
+} /* int safd_close(SAFD * pafd) */
+
+
+
+/* ========================================================================= *\
+   Implementation of safdprintf
+\* ========================================================================= */
+
+typedef struct SAFD_WRITE_DATA_S SAFD_WRITE_DATA;
+struct SAFD_WRITE_DATA_S
+{
+   SAFD * pafd;   /* output channel */
+   size_t Idx;    /* index of the current buffer or ~(size_t) 0 */
+   size_t Length; /* queued length */
+   int    Err;    /* error code, EINVAL */
+};
+
+
+/* ------------------------------------------------------------------------- *\
+   safdprintf_write_callback is our callback for callback_printf that is
+   used by the safdprintf function. It copies the data into the buffers and
+   hands over every filled buffer for writing.
+\* ------------------------------------------------------------------------- */
+
+static void safdprintf_write_callback(void * pUserData, const char * pSrc, size_t Length)
+{
+   SAFD_WRITE_DATA * pwd  = (SAFD_WRITE_DATA *) pUserData;
+   SAFD *            pafd = pwd->pafd;
+
+   if (!Length)
+   { /* callback_printf calls the callback a last time with zero length data in case of any errors within the format string */
+      if(!pwd->Err)
+         pwd->Err = EINVAL; /* invalid argument detected */
+      return;
+   }
+
+   pwd->Length += Length;
+
+   while(Length)
+   {
+      SAFD_BUF * pb;
+      size_t     sz;
+
+      if(pwd->Idx == ~(size_t) 0)
+         pwd->Idx = safd_acquire(pafd);
+
+      pb = pafd->pBuf + pwd->Idx;
+      sz = pafd->BufSize - pb->Length;
+      if(sz > Length)
+         sz = Length;
+
+      memcpy(pb->pData + pb->Length, pSrc, sz);
+      pb->Length += sz;
+      pSrc       += sz;
+      Length     -= sz;
+
+      if(pb->Length == pafd->BufSize)
+      {
+         safd_submit(pafd, pwd->Idx);
+         pwd->Idx = ~(size_t) 0;
+      }
+   }
+} /* void safdprintf_write_callback(void * pUserData, const char * pSrc, size_t Length) */
+
+
+/* ------------------------------------------------------------------------- *\
+   safdprintf_reserve and safdprintf_commit let callback_printf_sink write
+   directly into the current buffer as long as the data fit into it.
+\* ------------------------------------------------------------------------- */
+
+static char * safdprintf_reserve(void * pUserData, size_t Length)
+{
+   SAFD_WRITE_DATA * pwd  = (SAFD_WRITE_DATA *) pUserData;
+   SAFD *            pafd = pwd->pafd;
+   SAFD_BUF *        pb;
+
+   if(pwd->Idx == ~(size_t) 0)
+      pwd->Idx = safd_acquire(pafd);
+
+   pb = pafd->pBuf + pwd->Idx;
+   return ((Length <= pafd->BufSize - pb->Length) ? pb->pData + pb->Length : NULL);
+} /* char * safdprintf_reserve(void * pUserData, size_t Length) */
+
+static void safdprintf_commit(void * pUserData, size_t Length)
+{
+   SAFD_WRITE_DATA * pwd  = (SAFD_WRITE_DATA *) pUserData;
+   SAFD *            pafd = pwd->pafd;
+   SAFD_BUF *        pb   = pafd->pBuf + pwd->Idx;
+
+   pwd->Length += Length;
+   pb->Length  += Length;
+
+   if(pb->Length == pafd->BufSize)
+   {
+      safd_submit(pafd, pwd->Idx);
+      pwd->Idx = ~(size_t) 0;
+   }
+} /* void safdprintf_commit(void * pUserData, size_t Length) */
+
+
+/* ------------------------------------------------------------------------- *\
+   svafdprintf is a vfprintf like function that bases on callback_printf but
+   queues the data for an asynchronous write to a file desciptor. Numbers
+   are formatted directly into the buffers by callback_printf_sink.
+\* ------------------------------------------------------------------------- */
+
+size_t svafdprintf(SAFD * pafd, const char * pFmt, va_list val)
+{
+   size_t sz_ret = 0;
+
+   if(!pafd || !pFmt)
+   {
+      errno = EINVAL;
+   }
+   else
+   {
+      SAFD_WRITE_DATA wd =
+      {
+         pafd,
+         ~(size_t) 0,
+         0,
+         0
+      };
+
+      PRINTF_SINK sink =
+      {
+         &wd,
+         &safdprintf_write_callback,
+         &safdprintf_reserve,
+         &safdprintf_commit
+      };
+
+      callback_printf_sink(&sink, pFmt, val);
+
+      if(wd.Idx != ~(size_t) 0)
+      {
+         if(pafd->pBuf[wd.Idx].Length)
+            safd_submit(pafd, wd.Idx);
+         else
+            safd_release(pafd, wd.Idx);
+      }
+
+      sz_ret = wd.Length;
+
+      if(wd.Err)
+         errno = wd.Err;
+   }
+
+   return (sz_ret);
+} /* size_t svafdprintf(SAFD * pafd, const char * pFmt, va_list val) */
+
+
+/* ------------------------------------------------------------------------- *\
+   safdprintf is a fprintf like function that bases on callback_printf but
+   queues the data for an asynchronous write to a file desciptor.
+\* ------------------------------------------------------------------------- */
+
+size_t safdprintf(SAFD * pafd, const char * pFmt, ...)
+{
+   size_t sz_ret = 0;
+
+   va_list val;
+   va_start(val, pFmt);
+
+   sz_ret = svafdprintf(pafd, pFmt, val);
+
+   va_end(val);
+
+   return (sz_ret);
+} /* size_t safdprintf(SAFD * pafd, const char * pFmt, ...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   _safdprintf is a fprintf like function that bases on callback_printf but
+   queues the data for an asynchronous write to a file desciptor.
+\* ------------------------------------------------------------------------- */
+
+size_t _safdprintf(SAFD * pafd, const char * pFmt, ...)
+{
+   size_t sz_ret = 0;
+
+   va_list val;
+   va_start(val, pFmt);
+
+   sz_ret = svafdprintf(pafd, pFmt, val);
+
+   va_end(val);
+
+   return (sz_ret);
+} /* size_t _safdprintf(SAFD * pafd, const char * pFmt, ...) */
+
+
+/* ========================================================================= *\
+   E N D   O F   F I L E
+\* ========================================================================= */
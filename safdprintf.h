@@ -0,0 +1,169 @@
+/*****************************************************************************\
+*                                                                             *
+*  FILE NAME:     safdprintf.h                                                *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  DESCRIPTION:   asynchronous file descriptor output of callback_printf      *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  COPYRIGHT:     (c) 2026 Dipl.-Ing. Klaus Lux (Aachen, Germany)             *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  ORIGIN:        https://github.com/klux21/callback_printf                   *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+* Civil Usage Public License, Version 1.2, June 2026                          *
+*                                                                             *
+* Redistribution and use in source and binary forms, with or without          *
+* modification, are permitted provided that the following conditions are met: *
+*                                                                             *
+* 1. Redistributions of source code must retain the above copyright           *
+*    notice, this list of conditions, the explanation of terms                *
+*    and the following disclaimer.                                            *
+*                                                                             *
+* 2. Redistributions in binary form must reproduce the above copyright        *
+*    notice, this list of conditions and the following disclaimer in the      *
+*    documentation or other materials provided with the distribution.         *
+*                                                                             *
+* 3. All modified files must carry prominent notices stating that the         *
+*    files have been changed.                                                 *
+*                                                                             *
+* 4. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are designed or           *
+*    intended to harm, to kill or to forcibly immobilize people.              *
+*                                                                             *
+* 5. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are intended to           *
+*    monitor, to track, to change or to control the behavior, the             *
+*    constitution, the location or the communication of any people or         *
+*    their property without the explicit and prior agreement of those         *
+*    people except those devices and systems are solely designed for          *
+*    saving or protecting peoples life or health.                             *
+*                                                                             *
+* 6. The source code and binary forms and any derivative works are not        *
+*    stored or executed in any systems or devices that are intended           *
+*    for the production of any of the systems or devices that                 *
+*    have been stated before except the ones for saving or protecting         *
+*    peoples life or health only.                                             *
+*                                                                             *
+* The term 'systems' in all clauses shall include all types and combinations  *
+* of physical, virtualized or simulated hardware and software and any kind    *
+* of data storage.                                                            *
+*                                                                             *
+* The term 'devices' shall include any kind of local or non-local control     *
+* system of the stated devices as part of that device as well. Any assembly   *
+* of more than one device is one and the same device regarding this license.  *
+*                                                                             *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" *
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   *
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  *
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   *
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         *
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        *
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    *
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     *
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     *
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  *
+* POSSIBILITY OF SUCH DAMAGE.                                                 *
+*                                                                             *
+\*****************************************************************************/
+
+#ifndef SAFDPRINTF_H
+#define SAFDPRINTF_H
+
+#include <callback_printf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------- *\
+   SAFD is the opaque handle of an asynchronous output channel for a file
+   descriptor. The formatted data of every call is copied into one of a set
+   of preallocated buffers which are handed over to io_uring or to a writer
+   thread. The calling thread returns as soon as the data are queued and
+   does not have to wait for the storage.
+   A SAFD handle must not be used by more than one thread at the same time.
+\* ------------------------------------------------------------------------- */
+typedef struct SAFD_S SAFD;
+
+#define SAFD_NO_URING   0x01  /* flag for safd_open: do not use io_uring but a writer thread */
+
+#define SAFD_MODE_SYNC   0    /* data are written synchronously (systems without any asynchronous support) */
+#define SAFD_MODE_THREAD 1    /* data are written by a writer thread */
+#define SAFD_MODE_URING  2    /* data are written by io_uring using registered buffers */
+
+/* ------------------------------------------------------------------------- *\
+   SAFD_STATUS contains the state of the asynchronous output of a SAFD.
+\* ------------------------------------------------------------------------- */
+typedef struct SAFD_STATUS_S SAFD_STATUS;
+struct SAFD_STATUS_S
+{
+   uint64_t Queued;  /* number of bytes that have been queued for writing */
+   uint64_t Written; /* number of bytes that have been written successfully */
+   size_t   Pending; /* number of buffers that are waiting for the completion of a write */
+   int      Err;     /* errno value of the first failed write or 0 */
+   int      Mode;    /* SAFD_MODE_SYNC, SAFD_MODE_THREAD or SAFD_MODE_URING */
+};
+
+/* ------------------------------------------------------------------------- *\
+   safd_open creates an asynchronous output channel for the file descriptor
+   fd that uses buffer_count buffers of buffer_size bytes. All memory gets
+   allocated here. io_uring gets used for seekable file descriptors that are
+   not opened in append mode if the kernel supports it. The writer thread
+   is used in all other cases. The function returns NULL and sets errno in
+   case of an error. The file descriptor is not closed by safd_close.
+\* ------------------------------------------------------------------------- */
+SAFD * safd_open(int fd, size_t buffer_size, size_t buffer_count, int flags);
+
+/* ------------------------------------------------------------------------- *\
+   safd_status fills in the current state of the output channel if pStatus
+   is not NULL and returns the error code of the first failed write or 0.
+   Completed writes are collected by this call without waiting for any.
+\* ------------------------------------------------------------------------- */
+int safd_status(SAFD * pafd, SAFD_STATUS * pStatus);
+
+/* ------------------------------------------------------------------------- *\
+   safd_flush waits until all queued data are written and returns the error
+   code of the first failed write or 0. In io_uring mode the file position
+   of the file descriptor is moved behind the written data. If io_uring
+   fails itself then the pending writes are given up and its error returned.
+\* ------------------------------------------------------------------------- */
+int safd_flush(SAFD * pafd);
+
+/* ------------------------------------------------------------------------- *\
+   safd_close flushes and releases the output channel and returns the error
+   code of the first failed write or 0.
+\* ------------------------------------------------------------------------- */
+int safd_close(SAFD * pafd);
+
+/* ------------------------------------------------------------------------- *\
+   safdprintf is a fprintf like function that bases on callback_printf but
+   queues the output for an asynchronous write to the file descriptor of
+   pafd. It returns the length of the queued data. Errors of the format
+   string are returned in errno but write errors via safd_status only.
+   The caller has to wait only if all buffers are still in use.
+\* ------------------------------------------------------------------------- */
+size_t  safdprintf(SAFD * pafd, const char * pFmt, ...) PRINTF_LIKE_ARGS (2, 3); /* expects a printf like format string and arguments */
+size_t _safdprintf(SAFD * pafd, const char * pFmt, ...);                         /* same as safdprintf but without argument type check and possibly unsafe */
+
+/* ------------------------------------------------------------------------- *\
+   svafdprintf is a vfprintf like function that bases on callback_printf
+   but queues the output for an asynchronous write to the file descriptor.
+\* ------------------------------------------------------------------------- */
+size_t svafdprintf(SAFD * pafd, const char * pFmt, va_list val);
+
+
+#ifdef __cplusplus
+}/* extern "C" */
+#endif
+
+#endif /* SAFDPRINTF_H */
+
+/* ========================================================================= *\
+   E N D   O F   F I L E
+\* ========================================================================= */
@@ -73,8 +73,14 @@
 \*****************************************************************************/
 
 
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* fwrite_unlocked() of the GNU C library */
+#endif
+
 #undef   _CRT_ERRNO_DEFINED
 #include <errno.h>
+#include <string.h>
+#include <stdlib.h>
 
 #ifdef _WIN32
 #include <io.h>       /* write() */
@@ -82,10 +88,33 @@
 #pragma warning(disable : 4100 4127 4706 4710)
 #else
 #include <unistd.h>  /* usleep() */
+#include <pthread.h> /* pthread_key_create() */
+#include <sys/uio.h> /* writev() */
 #endif
 
 #include <sfprintf.h>
 
+/* ------------------------------------------------------------------------- *\
+   The stream gets locked once for the whole output of svfprintf. That makes
+   the output of a call atomic for other threads and allows the usage of
+   the faster unlocked stdio functions.
+\* ------------------------------------------------------------------------- */
+#if defined(_WIN32)
+#define SF_LOCK(pf)                    _lock_file(pf)
+#define SF_UNLOCK(pf)                  _unlock_file(pf)
+#define SF_FWRITE(ps, sz, n, pf)       _fwrite_nolock(ps, sz, n, pf)
+#elif defined(__GLIBC__)
+#define SF_LOCK(pf)                    flockfile(pf)
+#define SF_UNLOCK(pf)                  funlockfile(pf)
+#define SF_FWRITE(ps, sz, n, pf)       fwrite_unlocked(ps, sz, n, pf)
+#else
+#define SF_LOCK(pf)                    flockfile(pf)
+#define SF_UNLOCK(pf)                  funlockfile(pf)
+#define SF_FWRITE(ps, sz, n, pf)       fwrite(ps, sz, n, pf) /* the recursive lock of the stream is taken already */
+#endif
+
+#define SF_STAGING_SIZE 512 /* size of the stack buffer for collecting the small fragments of the output */
+
 /* ========================================================================= *\
    Implementation of our fprintf wrapper
 \* ========================================================================= */
@@ -99,15 +128,55 @@
 typedef struct WRITE_DATA_S WRITE_DATA;
 struct WRITE_DATA_S
 {
-   FILE * pf;     /* file pointer for writing */
-   size_t Length; /* successfully written length */
-   int    Err;    /* error code, EARG or ENOBUF */
+   FILE * pf;                    /* file pointer for writing */
+   size_t Length;                /* successfully written length */
+   int    Err;                   /* error code, EARG or ENOBUF */
+   size_t Used;                  /* length of the data in Buf */
+   char   Buf[SF_STAGING_SIZE];  /* staging buffer for small fragments */
 };
 
 
+/* ------------------------------------------------------------------------- *\
+   sfprintf_write writes a data buffer to the locked stream.
+\* ------------------------------------------------------------------------- */
+
+static void sfprintf_write(WRITE_DATA * pwd, const char * pSrc, size_t Length)
+{
+   size_t sz = SF_FWRITE(pSrc, 1, Length, pwd->pf);
+   pwd->Length += sz;
+
+   while(sz < Length)
+   {
+      if (errno == EINTR)
+      { /* interrupted by a signal -> just try again */
+      }
+      else if (errno == EAGAIN)
+      {
+#ifdef _WIN32
+         Sleep(1);
+#else
+         usleep(1000);
+#endif
+      }
+      else
+      { 
+         pwd->Err = errno;
+         break;
+      }
+
+      Length -= sz;
+      pSrc   += sz;
+
+      sz = SF_FWRITE(pSrc, 1, Length, pwd->pf);
+      pwd->Length += sz;
+   }
+} /* void sfprintf_write(WRITE_DATA * pwd, const char * pSrc, size_t Length) */
+
+
 /* ------------------------------------------------------------------------- *\
    sfprintf_write_callback is our callback for callback_printf that is used
-   by the sfprintf function
+   by the sfprintf function. Small fragments are collected in the staging
+   buffer and written at once.
 \* ------------------------------------------------------------------------- */
 
 static void sfprintf_write_callback(void * pUserData, const char * pSrc, size_t Length)
@@ -117,45 +186,81 @@ static void sfprintf_write_callback(void * pUserData, const char * pSrc, size_t
    if (!Length || pwd->Err)
    { /* callback_printf calls the callback a last time with zero length data in case of any errors within the format string */
       if(!pwd->Err)
-         pwd->Err = EINVAL; /* invalid argument detected */
+      {
+         if(pwd->Used)
+         { /* the output in front of the error gets written like without the staging buffer */
+            sfprintf_write(pwd, pwd->Buf, pwd->Used);
+            pwd->Used = 0;
+         }
+
+         if(!pwd->Err)
+            pwd->Err = EINVAL; /* invalid argument detected */
+      }
+   }
+   else if (Length <= sizeof(pwd->Buf) - pwd->Used)
+   {
+      memcpy(pwd->Buf + pwd->Used, pSrc, Length);
+      pwd->Used += Length;
    }
    else
    {
-      size_t sz = fwrite(pSrc, 1, Length, pwd->pf); 
-      pwd->Length += sz;
-
-      while(sz < Length)
+      if(pwd->Used)
       {
-         if (errno == EINTR)
-         { /* interrupted by a signal -> just try again */
-         }
-         else if (errno == EAGAIN)
-         {
-#ifdef _WIN32
-            Sleep(1);
-#else
-            usleep(1000);
-#endif
-         }
-         else
-         { 
-            pwd->Err = errno;
-            break;
-         }
+         sfprintf_write(pwd, pwd->Buf, pwd->Used);
+         pwd->Used = 0;
+      }
 
-         Length -= sz;
-         pSrc   += sz;
+      if(pwd->Err)
+         return; /* drop the output after a write error */
 
-         sz = fwrite(pSrc, 1, Length, pwd->pf); 
-         pwd->Length += sz;
+      if(Length < sizeof(pwd->Buf))
+      {
+         memcpy(pwd->Buf, pSrc, Length);
+         pwd->Used = Length;
+      }
+      else
+      {
+         sfprintf_write(pwd, pSrc, Length);
       }
    }
 } /* void  sfprintf_write_callback(void * pUserData, const char * pSrc, size_t Length) */
 
 
+/* ------------------------------------------------------------------------- *\
+   sfprintf_reserve and sfprintf_commit let callback_printf_sink write
+   directly into the staging buffer, so that the output isn't copied twice.
+\* ------------------------------------------------------------------------- */
+
+static char * sfprintf_reserve(void * pUserData, size_t Length)
+{
+   WRITE_DATA * pwd = (WRITE_DATA *) pUserData;
+
+   if(pwd->Err || (Length > sizeof(pwd->Buf)))
+      return (NULL);
+
+   if(Length > sizeof(pwd->Buf) - pwd->Used)
+   {
+      sfprintf_write(pwd, pwd->Buf, pwd->Used);
+      pwd->Used = 0;
+   }
+
+   return (pwd->Err ? NULL : pwd->Buf + pwd->Used);
+} /* char * sfprintf_reserve(void * pUserData, size_t Length) */
+
+static void sfprintf_commit(void * pUserData, size_t Length)
+{
+   WRITE_DATA * pwd = (WRITE_DATA *) pUserData;
+
+   pwd->Used += Length;
+} /* void sfprintf_commit(void * pUserData, size_t Length) */
+
+
 
 /* ------------------------------------------------------------------------- *\
    svfprintf is a wrapper for vfprintf that bases on callback_printf.
+   The output of a call is atomic regarding other threads that are writing
+   to the same stream. Numbers are formatted directly into the staging
+   buffer by callback_printf_sink.
 \* ------------------------------------------------------------------------- */
 
 size_t svfprintf(FILE * pf, const char * pFmt, va_list val)
@@ -168,14 +273,27 @@ size_t svfprintf(FILE * pf, const char * pFmt, va_list val)
    }
    else
    {
-      WRITE_DATA wd =
-      {
-         pf,
-         0,
-         0
-      };
+      WRITE_DATA  wd;
+      PRINTF_SINK sink;
+
+      wd.pf     = pf;
+      wd.Length = 0;
+      wd.Err    = 0;
+      wd.Used   = 0;
+
+      sink.pUserData = &wd;
+      sink.pCB       = &sfprintf_write_callback;
+      sink.pReserve  = &sfprintf_reserve;
+      sink.pCommit   = &sfprintf_commit;
+
+      SF_LOCK(pf);
 
-      callback_printf(&wd, &sfprintf_write_callback, pFmt, val);
+      callback_printf_sink(&sink, pFmt, val);
+
+      if(wd.Used && !wd.Err)
+         sfprintf_write(&wd, wd.Buf, wd.Used);
+
+      SF_UNLOCK(pf);
 
       sz_ret = wd.Length;
 
@@ -238,9 +356,134 @@ struct FD_WRITE_DATA_S
    int    fd;     /* file descriptor to write to */
    size_t Length; /* successfully written length */
    int    Err;    /* error code, EARG or ENOBUF */
+   size_t Used;   /* length of the data in the record buffer */
+   int    Direct; /* the record exceeded the limit and the data are written directly */
 };
 
 
+/* ------------------------------------------------------------------------- *\
+   Thread local record buffer of svfdprintf. The buffer grows up to the
+   limit that is set by sfdprintf_set_record_limit and is reused by all the
+   following calls of the same thread. On Posix systems it gets released at
+   the end of the thread.
+\* ------------------------------------------------------------------------- */
+
+#if defined(_MSC_VER)
+#define SF_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define SF_THREAD_LOCAL __thread
+#else
+#define SF_THREAD_LOCAL _Thread_local
+#endif
+
+typedef struct FD_RECORD_BUFFER_S FD_RECORD_BUFFER;
+struct FD_RECORD_BUFFER_S
+{
+   char * pData; /* buffer memory */
+   size_t Size;  /* size of the buffer */
+};
+
+static SF_THREAD_LOCAL FD_RECORD_BUFFER fd_record_buffer; /* record buffer of the current thread */
+static size_t                           fd_record_limit;  /* maximum size of the record buffers or 0 if disabled */
+
+/* the limit may be changed while other threads are printing */
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define FD_LIMIT_LOAD(p)        (*(volatile size_t *) (p))
+#define FD_LIMIT_EXCHANGE(p, v) ((size_t) _InterlockedExchangePointer((void * volatile *) (p), (void *) (v)))
+#else
+#define FD_LIMIT_LOAD(p)        __atomic_load_n((p), __ATOMIC_RELAXED)
+#define FD_LIMIT_EXCHANGE(p, v) __atomic_exchange_n((p), (v), __ATOMIC_RELAXED)
+#endif
+
+#ifndef _WIN32
+static pthread_once_t fd_record_once = PTHREAD_ONCE_INIT;
+static pthread_key_t  fd_record_key;
+
+static void fd_record_free(void * pv)
+{
+   free(pv);
+} /* void fd_record_free(void * pv) */
+
+static void fd_record_key_create(void)
+{
+   pthread_key_create(&fd_record_key, &fd_record_free);
+} /* void fd_record_key_create(void) */
+#endif
+
+
+/* ------------------------------------------------------------------------- *\
+   fd_record_grow grows the record buffer of the current thread for holding
+   at least the required number of bytes. It returns 0 if that would exceed
+   the limit or if there is not enough memory.
+\* ------------------------------------------------------------------------- */
+
+static int fd_record_grow(size_t required)
+{
+   FD_RECORD_BUFFER * prb   = &fd_record_buffer;
+   size_t             size  = prb->Size ? prb->Size * 2 : 256;
+   size_t             limit = FD_LIMIT_LOAD(&fd_record_limit);
+   char *             pData;
+
+   if(required > limit)
+      return (0);
+
+   if(size < required)
+      size = required;
+
+   if(size > limit)
+      size = limit;
+
+   pData = (char *) realloc(prb->pData, size);
+   if(!pData)
+      return (0);
+
+#ifndef _WIN32
+   if(pData != prb->pData)
+   {
+      pthread_once(&fd_record_once, &fd_record_key_create);
+      pthread_setspecific(fd_record_key, pData); /* frees the buffer at thread exit */
+   }
+#endif
+
+   prb->pData = pData;
+   prb->Size  = size;
+   return (1);
+} /* int fd_record_grow(size_t required) */
+
+
+/* ------------------------------------------------------------------------- *\
+   sfdprintf_set_record_limit sets the maximum size of the record buffers
+   and returns the previous one.
+\* ------------------------------------------------------------------------- */
+
+size_t sfdprintf_set_record_limit(size_t limit)
+{
+   return (FD_LIMIT_EXCHANGE(&fd_record_limit, limit));
+} /* size_t sfdprintf_set_record_limit(size_t limit) */
+
+
+/* ------------------------------------------------------------------------- *\
+   sfdprintf_release_record_buffer releases the record buffer of the
+   calling thread.
+\* ------------------------------------------------------------------------- */
+
+void sfdprintf_release_record_buffer(void)
+{
+   FD_RECORD_BUFFER * prb = &fd_record_buffer;
+
+   if(prb->pData)
+   {
+#ifndef _WIN32
+      pthread_setspecific(fd_record_key, NULL);
+#endif
+      free(prb->pData);
+      prb->pData = NULL;
+      prb->Size  = 0;
+   }
+} /* void sfdprintf_release_record_buffer(void) */
+
+
 /* ------------------------------------------------------------------------- *\
    sfdprintf_write_callback is our callback for callback_printf that is used
    by the sfdprintf function
@@ -303,9 +546,211 @@ static void sfdprintf_write_callback(void * pUserData, const char * pSrc, size_t
 } /* void  sfdprintf_write_callback(void * pUserData, const char * pSrc, size_t Length) */
 
 
+/* ------------------------------------------------------------------------- *\
+   sfdprintf_writev_callback is the vectored variant of
+   sfdprintf_write_callback for callback_printfv. On Posix systems all the
+   fragments of a call get written by writev().
+\* ------------------------------------------------------------------------- */
+
+static void sfdprintf_writev_callback(void * pUserData, const PRINTF_IOVEC * pVec, size_t Count)
+{
+#ifdef _WIN32
+   while(Count--)
+   {
+      sfdprintf_write_callback(pUserData, pVec->pSrc, pVec->Length);
+      ++pVec;
+   }
+#else
+   FD_WRITE_DATA * pwd = (FD_WRITE_DATA *) pUserData;
+   struct iovec    iov[16];
+   int             n   = 0;
+
+   while(Count && !pwd->Err)
+   {
+      int bInvalid = !pVec->Length; /* callback_printf reports errors in the format string with zero length data */
+
+      if(!bInvalid)
+      {
+         iov[n].iov_base = (void *) pVec->pSrc;
+         iov[n].iov_len  = pVec->Length;
+         ++n;
+      }
+
+      ++pVec;
+      --Count;
+
+      if(n && (bInvalid || !Count || (n == (int) (sizeof(iov) / sizeof(iov[0])))))
+      {
+         struct iovec * pv = iov;
+
+         while(n && !pwd->Err)
+         {
+            ssize_t sz = writev(pwd->fd, pv, n);
+
+            if(sz > 0)
+            {
+               pwd->Length += sz;
+
+               while(n && ((size_t) sz >= pv->iov_len))
+               {
+                  sz -= pv->iov_len;
+                  ++pv;
+                  --n;
+               }
+
+               if(n)
+               { /* partially written fragment */
+                  pv->iov_base = (char *) pv->iov_base + sz;
+                  pv->iov_len -= sz;
+               }
+            }
+            else if (errno == EINTR)
+            { /* interrupted by a signal -> just try again */
+            }
+            else if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            {
+               usleep(1000);
+            }
+            else
+            {
+               pwd->Err = sz ? errno : EIO;
+            }
+         }
+
+         n = 0;
+      }
+
+      if(bInvalid)
+         sfdprintf_write_callback(pUserData, NULL, 0);
+   }
+#endif
+} /* void sfdprintf_writev_callback(void * pUserData, const PRINTF_IOVEC * pVec, size_t Count) */
+
+
+/* ------------------------------------------------------------------------- *\
+   sfdprintf_write_record writes the collected data of the record buffer
+   using a single write() if the system allows it.
+\* ------------------------------------------------------------------------- */
+
+static void sfdprintf_write_record(FD_WRITE_DATA * pwd)
+{
+   const char * pSrc   = fd_record_buffer.pData;
+   size_t       Length = pwd->Used;
+
+   while(Length && !pwd->Err)
+   {
+#ifdef _WIN32
+      ptrdiff_t sz = write(pwd->fd, pSrc, (unsigned int) Length);
+#else
+      ptrdiff_t sz = write(pwd->fd, pSrc, Length);
+#endif
+      if(sz > 0)
+      {
+         pwd->Length += sz;
+         Length -= sz;
+         pSrc   += sz;
+      }
+      else if (errno == EINTR)
+      { /* interrupted by a signal -> just try again */
+      }
+#ifdef _WIN32
+      else if (errno == EAGAIN)
+      {
+         Sleep(1);
+      }
+#else
+      else if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+      {
+         usleep(1000);
+      }
+#endif
+      else
+      {
+         pwd->Err = sz ? errno : EIO;
+      }
+   }
+
+   pwd->Used = 0;
+} /* void sfdprintf_write_record(FD_WRITE_DATA * pwd) */
+
+
+/* ------------------------------------------------------------------------- *\
+   sfdprintf_record_callback is the callback for callback_printf that is
+   used by svfdprintf if record buffers are enabled. It collects the whole
+   output in the record buffer of the thread. If the output exceeds the
+   limit then the collected data and all the remaining output get written
+   by sfdprintf_write_callback.
+\* ------------------------------------------------------------------------- */
+
+static void sfdprintf_record_callback(void * pUserData, const char * pSrc, size_t Length)
+{
+   FD_WRITE_DATA *    pwd = (FD_WRITE_DATA *) pUserData;
+   FD_RECORD_BUFFER * prb = &fd_record_buffer;
+
+   if (!Length && pwd->Used && !pwd->Err)
+   { /* the record in front of an error in the format string gets written before the error is recorded */
+      sfdprintf_write_record(pwd);
+      sfdprintf_write_callback(pUserData, pSrc, Length);
+   }
+   else if (!Length || pwd->Err || pwd->Direct)
+   {
+      sfdprintf_write_callback(pUserData, pSrc, Length);
+   }
+   else if((Length <= prb->Size - pwd->Used) || fd_record_grow(pwd->Used + Length))
+   {
+      memcpy(prb->pData + pwd->Used, pSrc, Length);
+      pwd->Used += Length;
+   }
+   else
+   { /* continue with chunked writes */
+      pwd->Direct = 1;
+
+      if(pwd->Used)
+      {
+         sfdprintf_write_callback(pUserData, prb->pData, pwd->Used);
+         pwd->Used = 0;
+      }
+
+      sfdprintf_write_callback(pUserData, pSrc, Length);
+   }
+} /* void sfdprintf_record_callback(void * pUserData, const char * pSrc, size_t Length) */
+
+
+/* ------------------------------------------------------------------------- *\
+   sfdprintf_record_reserve and sfdprintf_record_commit let
+   callback_printf_sink write directly into the record buffer as long as
+   the output doesn't exceed the limit.
+\* ------------------------------------------------------------------------- */
+
+static char * sfdprintf_record_reserve(void * pUserData, size_t Length)
+{
+   FD_WRITE_DATA *    pwd = (FD_WRITE_DATA *) pUserData;
+   FD_RECORD_BUFFER * prb = &fd_record_buffer;
+
+   if(pwd->Err || pwd->Direct)
+      return (NULL);
+
+   if((Length <= prb->Size - pwd->Used) || fd_record_grow(pwd->Used + Length))
+      return (prb->pData + pwd->Used);
+
+   return (NULL);
+} /* char * sfdprintf_record_reserve(void * pUserData, size_t Length) */
+
+static void sfdprintf_record_commit(void * pUserData, size_t Length)
+{
+   FD_WRITE_DATA * pwd = (FD_WRITE_DATA *) pUserData;
+
+   pwd->Used += Length;
+} /* void sfdprintf_record_commit(void * pUserData, size_t Length) */
+
+
 /* ------------------------------------------------------------------------- *\
    svfdprintf is a vfprintf like function that bases on callback_printf but
-   writes to a file desciptor.
+   writes to a file desciptor. If a record limit is set then the whole
+   output of a call gets written by a single write() as long as it does not
+   exceed the limit. The record is formatted directly into the record buffer
+   by callback_printf_sink. Otherwise the fragments are collected by
+   callback_printfv and written by writev().
 \* ------------------------------------------------------------------------- */
 
 size_t svfdprintf(int fd, const char * pFmt, va_list val)
@@ -322,10 +767,30 @@ size_t svfdprintf(int fd, const char * pFmt, va_list val)
       {
          fd,
          0,
+         0,
+         0,
          0
       };
 
-      callback_printf(&wd, &sfdprintf_write_callback, pFmt, val);
+      if(FD_LIMIT_LOAD(&fd_record_limit))
+      {
+         PRINTF_SINK sink =
+         {
+            &wd,
+            &sfdprintf_record_callback,
+            &sfdprintf_record_reserve,
+            &sfdprintf_record_commit
+         };
+
+         callback_printf_sink(&sink, pFmt, val);
+
+         if(wd.Used)
+            sfdprintf_write_record(&wd);
+      }
+      else
+      {
+         callback_printfv(&wd, &sfdprintf_writev_callback, pFmt, val);
+      }
 
       sz_ret = wd.Length;
 
@@ -357,11 +822,11 @@ size_t sfdprintf(int fd, const char * pFmt, ...)
 } /* size_t sfdprintf(FILE * pf, const char * pFmt, ...) */
 
 /* ------------------------------------------------------------------------- *\
-   _fdprintf is a fprintf like function that bases on callback_printf but
+   _sfdprintf is a fprintf like function that bases on callback_printf but
    writes to a file desciptor.
 \* ------------------------------------------------------------------------- */
 
-size_t _fdprintf(int fd, const char * pFmt, ...)
+size_t _sfdprintf(int fd, const char * pFmt, ...)
 {
    size_t sz_ret = 0;
 
@@ -373,7 +838,7 @@ size_t _fdprintf(int fd, const char * pFmt, ...)
    va_end(val);
 
    return (sz_ret);
-} /* size_t _fdprintf(FILE * pf, const char * pFmt, ...) */
+} /* size_t _sfdprintf(FILE * pf, const char * pFmt, ...) */
 
 
 /* ========================================================================= *\
@@ -90,6 +90,8 @@ size_t _sfprintf(FILE * pf, const char * pFmt, ...);                         /*
 
 /* ------------------------------------------------------------------------- *\
    svfprintf is a wrapper for vfprintf that bases on callback_printf.
+   The stream stays locked during the whole call and the output of a call
+   can't be interrupted by the output of other threads.
 \* ------------------------------------------------------------------------- */
 size_t svfprintf(FILE * pf, const char * pFmt, va_list val);
 
@@ -106,6 +108,27 @@ size_t _sfdprintf(int fd, const char * pFmt, ...);                         /* sa
 \* ------------------------------------------------------------------------- */
 size_t svfdprintf(int fd, const char * pFmt, va_list val);
 
+/* ------------------------------------------------------------------------- *\
+   sfdprintf_set_record_limit enables thread local record buffers of
+   svfdprintf for all threads if limit is nonzero. The whole output of a
+   call gets collected in the buffer of the thread and is written by a
+   single write() then. That prevents the interleaving of the output of
+   several threads on regular files. The buffers grow up to limit bytes
+   and are reused by the following calls. The output of a call that exceeds
+   the limit gets written in chunks as without record buffers.
+   The limit may be changed while other threads are using sfdprintf, calls
+   in progress may still use the previous one. The function returns the
+   previous limit. A limit of 0 disables the buffers.
+\* ------------------------------------------------------------------------- */
+size_t sfdprintf_set_record_limit(size_t limit);
+
+/* ------------------------------------------------------------------------- *\
+   sfdprintf_release_record_buffer releases the record buffer of the
+   calling thread. That's done at the end of a thread on Posix systems
+   automatically but needs to be done by the thread itself on Windows.
+\* ------------------------------------------------------------------------- */
+void sfdprintf_release_record_buffer(void);
+
 
 #ifdef __cplusplus
 }/* extern "C" */
@@ -76,12 +76,63 @@
 #include <stddef.h>
 #include <signal.h>
 #include <float.h>
+#include <math.h>
 #include <string.h>
 #include <inttypes.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
+
 #include <callback_printf.h>
+#include <sfprintf.h>
+#include <safdprintf.h>
+#include <cbk_formats.h>
+#include <cbk_record.h>
 
 /* int test_svsprintf(const char * pout, const char * call, const char * pfmt, ...)  __PRINTF_LIKE_ARGS (3, 4); */
 
+/* ------------------------------------------------------------------------- *\
+   VECTOR_DATA is the user data of our vectored callback test_writev that
+   collects the output of callback_printfv.
+\* ------------------------------------------------------------------------- */
+
+typedef struct VECTOR_DATA_S VECTOR_DATA;
+struct VECTOR_DATA_S
+{
+   char * pDst;   /* current write position */
+   size_t Calls;  /* number of callback calls */
+   int    Err;    /* zero length fragment received */
+};
+
+static void test_writev(void * pUserData, const PRINTF_IOVEC * pVec, size_t Count)
+{
+   VECTOR_DATA * pvd = (VECTOR_DATA *) pUserData;
+
+   ++pvd->Calls;
+
+   while(Count--)
+   {
+      if(!pVec->Length)
+         pvd->Err = 1;
+
+      memcpy(pvd->pDst, pVec->pSrc, pVec->Length);
+      pvd->pDst += pVec->Length;
+      ++pVec;
+   }
+} /* void test_writev(void * pUserData, const PRINTF_IOVEC * pVec, size_t Count) */
+
+
 int test_svsprintf(int line, const char * pout, const char * call, const char * pfmt, ...)
 {
     int bRet = 0;
@@ -94,6 +145,9 @@ int test_svsprintf(int line, const char * pout, const char * call, const char *
     char bufn[2048];
     char bufu[2048];
     char bufnu[2048];
+    char bufv[2048];
+    size_t svRet;
+    VECTOR_DATA vd;
     size_t limit = 18; /* limit for snprint flike functions */
     memset(buf,   0xfefefefe, sizeof(buf));
     memset(bufn,  0xfefefefe, sizeof(bufn));
@@ -120,6 +174,14 @@ int test_svsprintf(int line, const char * pout, const char * call, const char *
     snuRet = svsnprintfu(bufnu, limit, pfmt, VarArgs);
     va_end(VarArgs);
 
+    vd.pDst  = bufv;
+    vd.Calls = 0;
+    vd.Err   = 0;
+    va_start(VarArgs, pfmt);
+    svRet = callback_printfv(&vd, &test_writev, pfmt, VarArgs);
+    va_end(VarArgs);
+    *vd.pDst = '\0';
+
     /********************************************************/
 
     if(sRet != snRet)
@@ -188,6 +250,12 @@ int test_svsprintf(int line, const char * pout, const char * call, const char *
        goto Exit;
     }
 
+    if((svRet != sRet) || (vd.pDst - bufv != (ptrdiff_t) sRet) || strcmp(buf, bufv) || (vd.Err && sRet))
+    {
+       printf("test_callback_printf.c:%d : callback_printfv returned %zd (%s) for '%s' but svsprintf returned %zd (%s)!\n", line, svRet, bufv, call, sRet, buf);
+       goto Exit;
+    }
+
     /********************************************************/
 
     if(sRet != suRet)
@@ -400,6 +468,8 @@ int test_ssprintf(const char * pfmt, ...)
     TEST_VSPRINTF( "%#08o",         "00000001",       (int) 1 );
     TEST_VSPRINTF( "%#o",           "01",             (int) 1 );
     TEST_VSPRINTF( "%#o",           "0",              (int) 0 );
+    TEST_VSPRINTF( "%#.0o",         "0",              (int) 0 );
+    TEST_VSPRINTF( "%#3.0o",        "  0",            (int) 0 );
     TEST_VSPRINTF( "%04s",          " foo",           (char *) "foo" );
     TEST_VSPRINTF( "%.1s",          "f",              (char *) "foo" );
     TEST_VSPRINTF( "%.0s",          "",               (char *) "foo" );
@@ -549,6 +619,7 @@ int test_ssprintf(const char * pfmt, ...)
     TEST_VSPRINTF( "%.3A",  "-0X1.A37P-10",  (double)       -1.6e-3 );
     TEST_VSPRINTF( "%.3La", "-0x1.a37p-10",  (long double)  -1.6e-3 );
     TEST_VSPRINTF( "%.3LA", "-0X1.A37P-10",  (long double)  -1.6e-3 );
+    TEST_VSPRINTF( "%.13a", "0x1.5555555555555p-2", (double) (1.0 / 3.0) );
 
     TEST_VSPRINTF( "%5.2e%.0f",  "  inf3",   (double) inf ARG(3.0));
     TEST_VSPRINTF( "%5.2e%.0f",  " -inf3",   (double) ninf ARG(3.0));
@@ -593,6 +664,19 @@ int test_ssprintf(const char * pfmt, ...)
     TEST_VSPRINTF( "%#Lg",        "0.00000", (long double) 0.0l);
     TEST_VSPRINTF( "%g",          "0",       (double) 0.0);
     TEST_VSPRINTF( "%Lg",         "0",       (long double) 0.0l);
+    TEST_VSPRINTF( "%g",          "-0",      (double) -0.0);
+    TEST_VSPRINTF( "%Lg",         "-0",      (long double) -0.0l);
+    TEST_VSPRINTF( "%.2f",        "-0.00",   (double) -0.0);
+    TEST_VSPRINTF( "%Le",         "-0.000000e+00", (long double) -0.0l);
+    TEST_VSPRINTF( "%+.1f",       "+0.0",    (double) 0.0);
+    TEST_VSPRINTF( "%06.1f",      "-000.0",  (double) -0.0);
+    TEST_VSPRINTF( "%.0a",        "-0x0p+0", (double) -0.0);
+    TEST_VSPRINTF( "%g",          "0.001",   (double) 0.001);
+    TEST_VSPRINTF( "%Lg",         "0.001",   (long double) 0.001l);
+    TEST_VSPRINTF( "%G",          "0.0015",  (double) 0.0015);
+    TEST_VSPRINTF( "%LG",         "0.0015",  (long double) 0.0015l);
+    TEST_VSPRINTF( "%.0g",        "1e-10",   (double) 1e-10);
+    TEST_VSPRINTF( "%.0Lg",       "1e-10",   (long double) 1e-10l);
     TEST_VSPRINTF( "%g",          "490000",  (double) 490000.0l);
     TEST_VSPRINTF( "%Lg",         "490000",  (long double) 490000.0l);
     TEST_VSPRINTF( "%G",          "4.9E+06", (double) 4900000.0l);
@@ -987,12 +1071,1162 @@ int test_ssprintf(const char * pfmt, ...)
        TEST_VSPRINTF("%#x%@ %d", "0x123 Hello world! 123", (unsigned int) 0x123 ARG(pfmt) ARG(val) ARG((int) 123));
        TEST_VSPRINTF("%#x%15@ %d", "0x123   Hello world! 123", (unsigned int) 0x123 ARG(pfmt) ARG(val) ARG((int) 123));
        TEST_VSPRINTF("%#x%-15@ %d", "0x123 Hello world!   123", (unsigned int) 0x123 ARG(pfmt) ARG(val) ARG((int) 123));
+       TEST_VSPRINTF("%#x%30@ %d", "0x123                  Hello world! 123", (unsigned int) 0x123 ARG(pfmt) ARG(val) ARG((int) 123));
+       TEST_VSPRINTF("%#x%3@ %d", "0x123 Hello world! 123", (unsigned int) 0x123 ARG(pfmt) ARG(val) ARG((int) 123));
        va_end(val);
     }
     return (bRet);
 } /* test_ssprintf() */
 
 
+/* ------------------------------------------------------------------------- *\
+   test_printfa_cb collects the output of callback_printfa in a string.
+\* ------------------------------------------------------------------------- */
+static void test_printfa_cb(void * pUserData, const char * pSrc, size_t Length)
+{
+   char ** ppd = (char **) pUserData;
+
+   if(!Length)
+   {
+      memcpy(*ppd, "<ERR>", 5);
+      *ppd += 5;
+   }
+
+   memcpy(*ppd, pSrc, Length);
+   *ppd += Length;
+} /* void test_printfa_cb(void * pUserData, const char * pSrc, size_t Length) */
+
+/* ------------------------------------------------------------------------- *\
+   test_printfa checks the output of callback_printfa for an argument array.
+\* ------------------------------------------------------------------------- */
+static int test_printfa(int line, const char * pout, const char * pfmt, const PRINTF_ARG * pArgs, size_t Count)
+{
+   char   buf[512];
+   char * pd   = buf;
+   size_t zRet = callback_printfa(&pd, &test_printfa_cb, pfmt, pArgs, Count);
+
+   *pd = '\0';
+
+   if(strcmp(buf, pout) || ((zRet != strlen(pout)) && !strstr(pout, "<ERR>")))
+   {
+      printf("test_callback_printf.c:%d : callback_printfa returned %zd (%s) for '%s' but expected was '%s'!\n", line, zRet, buf, pfmt, pout);
+      return (0);
+   }
+
+   return (1);
+} /* int test_printfa(...) */
+
+/* ------------------------------------------------------------------------- *\
+   test_callback_printfa tests the output of typed argument arrays.
+\* ------------------------------------------------------------------------- */
+int test_callback_printfa()
+{
+   int             bRet = 1;
+   PRINTF_ARG      a[6];
+   PRINTF_ARG      n[2];
+   PRINTF_ARG_LIST nl;
+
+   memset(a, 0, sizeof(a));
+   memset(n, 0, sizeof(n));
+
+   a[0].Type = PRINTF_ARG_PTR;    a[0].v.p  = "abc";
+   a[1].Type = PRINTF_ARG_INT;    a[1].v.i  = -42;
+   a[2].Type = PRINTF_ARG_UINT;   a[2].v.u  = 0xbeef;
+   a[3].Type = PRINTF_ARG_DOUBLE; a[3].v.d  = 2.5;
+   a[4].Type = PRINTF_ARG_INT;    a[4].v.i  = 7;
+   a[5].Type = PRINTF_ARG_INT;    a[5].v.i  = -42;
+
+   bRet &= test_printfa(__LINE__, "abc|-42|0xbeef|2.500", "%s|%d|%#x|%.3f", a, 4);
+   bRet &= test_printfa(__LINE__, "beef|2|7.00", "%x|%d|%.2f", a + 2, 3); /* %d of a double and %f of an integer */
+   bRet &= test_printfa(__LINE__, "[    -42]", "[%*d]", a + 4, 2);
+   bRet &= test_printfa(__LINE__, "abc-42<ERR>", "%s%d%d", a, 2);
+   bRet &= test_printfa(__LINE__, "no args 100%", "no args 100%%", NULL, 0);
+   bRet &= test_printfa(__LINE__, "x<ERR>", "x%n", a + 4, 1);   /* %n of an integer */
+   bRet &= test_printfa(__LINE__, "x<ERR>", "x%ln", a + 4, 1);
+   bRet &= test_printfa(__LINE__, "x<ERR>", "x%hn", NULL, 0);   /* %n without an argument */
+
+   {
+      int        count = 0;
+      PRINTF_ARG pn;
+
+      memset(&pn, 0, sizeof(pn));
+      pn.Type = PRINTF_ARG_PTR; pn.v.p = &count;
+
+      bRet &= test_printfa(__LINE__, "abc", "abc%n", &pn, 1);
+      if(count != 3)
+      {
+         printf("test_callback_printf.c:%d : %%n of callback_printfa stored %d but expected was 3!\n", __LINE__, count);
+         bRet = 0;
+      }
+   }
+
+   n[0].Type = PRINTF_ARG_INT;  n[0].v.i = 1;
+   n[1].Type = PRINTF_ARG_PTR;  n[1].v.p = "two";
+   nl.pArgs  = n;
+   nl.Count  = 2;
+   a[0].Type = PRINTF_ARG_PTR;  a[0].v.p = "%d-%s";
+   a[1].Type = PRINTF_ARG_PTR;  a[1].v.p = &nl;
+   a[2].Type = PRINTF_ARG_INT;  a[2].v.i = 3;
+
+   bRet &= test_printfa(__LINE__, "<   1-two> 3", "<%8@> %d", a, 3);
+   bRet &= test_printfa(__LINE__, "<1-two   > 3", "<%-8@> %d", a, 3);
+   a[0].v.p = "%d%y";
+   bRet &= test_printfa(__LINE__, "<   1<ERR>> 3", "<%4@> %d", a, 3); /* an invalid nested format doesn't stop the outer one */
+   a[0].v.p = "%d-%s%y";
+   bRet &= test_printfa(__LINE__, "[                         1-two<ERR>]", "[%30@]", a, 2);
+   bRet &= test_printfa(__LINE__, "[1-two<ERR>                         ]", "[%-30@]", a, 2);
+   a[0].v.p = "%d-%s";
+
+   /* nested output that doesn't fit into the staging buffer of %@ gets formatted twice */
+   {
+      char long_text[301];
+      char expected[320];
+
+      memset(long_text, 'x', 300);
+      long_text[300] = '\0';
+      n[1].v.p       = long_text;
+      ssprintf(expected, "< 1-%s> 3", long_text);
+
+      bRet &= test_printfa(__LINE__, expected, "<%303@> %d", a, 3);
+      bRet &= test_printfa(__LINE__, expected + 2, "%300@> %d", a, 3);
+   }
+
+   /* an invalid nested format with output that doesn't fit into the staging buffer */
+   {
+      char   long_text[401];
+      char   expected[520];
+      char   buf[520];
+      char * pd = buf;
+      size_t zRet;
+
+      memset(long_text, 'x', 400);
+      long_text[400] = '\0';
+      n[1].v.p       = long_text;
+      a[0].v.p       = "%d-%s%y";
+      ssprintf(expected, "[%98s1-%s<ERR>]", "", long_text);
+
+      zRet = callback_printfa(&pd, &test_printfa_cb, "[%500@]", a, 2);
+      *pd  = '\0';
+
+      if(strcmp(buf, expected) || (zRet != 502))
+      {
+         printf("test_callback_printf.c:%d : callback_printfa returned %zd (%s) but expected was 502 (%s)!\n", __LINE__, zRet, buf, expected);
+         bRet = 0;
+      }
+
+      a[0].v.p = "%d-%s";
+      n[1].v.p = "two";
+   }
+
+   return (bRet);
+} /* int test_callback_printfa() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_fragments checks the fragment statistics of callback_printf_fragments
+   and the coalescing of small fragments by callback_printfa.
+\* ------------------------------------------------------------------------- */
+int test_fragments()
+{
+   int              bRet = 1;
+   char             buf[512];
+   char *           pd   = buf;
+   PRINTF_FRAGMENTS fs;
+   PRINTF_ARG       a[2];
+   size_t           hist[PRINTF_FRAGMENT_BUCKETS] = { 0, 0, 0, 0, 1 }; /* "[   ab]xxx" */
+   char             text[101];
+
+   a[0].Type = PRINTF_ARG_PTR;
+   a[0].v.p  = "ab";
+   a[1].Type = PRINTF_ARG_INT;
+   a[1].v.i  = 'x';
+
+   callback_printf_fragments_init(&fs, &pd, &test_printfa_cb);
+   callback_printfa(&fs, &callback_printf_fragments, "[%5s]%.3c", a, 2);
+   *pd = '\0';
+
+   if(strcmp(buf, "[   ab]xxx") || (fs.Fragments != 1) || (fs.Bytes != 10) || fs.Errors || memcmp(fs.Histogram, hist, sizeof(hist)))
+   {
+      printf("test_callback_printf.c:%d : '%s' was counted as %zu fragments of %zu bytes and %zu errors!\n", __LINE__, buf, fs.Fragments, fs.Bytes, fs.Errors);
+      bRet = 0;
+   }
+
+   /* a long string is passed directly between the collected fragments */
+   memset(text, 'y', 100);
+   text[100] = '\0';
+   a[0].v.p  = text;
+   pd        = buf;
+
+   callback_printf_fragments_init(&fs, &pd, &test_printfa_cb);
+   callback_printfa(&fs, &callback_printf_fragments, "[%s]%.300c", a, 2);
+   *pd = '\0';
+
+   if((fs.Fragments != 4) || (fs.Bytes != 402) || (fs.Histogram[0] != 1) || (fs.Histogram[6] != 1) || (fs.Histogram[7] != 1) || (fs.Histogram[8] != 1) ||
+      strncmp(buf, "[yyyy", 5) || strncmp(buf + 100, "y]xx", 4) || (buf[401] != 'x'))
+   {
+      printf("test_callback_printf.c:%d : '%s' was counted as %zu fragments of %zu bytes!\n", __LINE__, buf, fs.Fragments, fs.Bytes);
+      bRet = 0;
+   }
+
+   a[0].v.p = "ab";
+
+   callback_printf_fragments_init(&fs, NULL, NULL);
+   callback_printfa(&fs, &callback_printf_fragments, "%y", a, 2);
+
+   if((fs.Errors != 1) || fs.Fragments)
+   {
+      printf("test_callback_printf.c:%d : an invalid format was counted as %zu errors!\n", __LINE__, fs.Errors);
+      bRet = 0;
+   }
+
+   if((callback_printf_fragment_bucket(0) != 1) || (callback_printf_fragment_bucket(8) != 256) || callback_printf_fragment_bucket(PRINTF_FRAGMENT_BUCKETS - 1))
+   {
+      printf("test_callback_printf.c:%d : invalid limits of the fragment sizes!\n", __LINE__);
+      bRet = 0;
+   }
+
+   return (bRet);
+} /* int test_fragments() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_named_upper prints a string in upper case letters for %{upper}.
+\* ------------------------------------------------------------------------- */
+static size_t test_named_upper(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   char         buf[64];
+   const char * ps = (const char *) pvdata;
+   size_t       n  = 0;
+
+   while(ps[n] && (n < precision) && (n < sizeof(buf)))
+   {
+      buf[n] = ((ps[n] >= 'a') && (ps[n] <= 'z')) ? (char) (ps[n] - 'a' + 'A') : ps[n];
+      ++n;
+   }
+
+   return (cbk_print_string(pUserData, pCB, buf, n, minimum_width, left_justified));
+} /* size_t test_named_upper(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_named registers some named formatters and checks the %{name} output.
+\* ------------------------------------------------------------------------- */
+int test_named()
+{
+   int                    bRet     = 1;
+   PRINTF_NAMED_FORMATTER fmts[]   = { { "upper", &test_named_upper }, { "v_data", &cbfunc } };
+   PRINTF_NAMED_FORMATTER dup[]    = { { "x1", &cbfunc }, { "upper", &cbfunc } };
+   PRINTF_NAMED_FORMATTER bad[]    = { { "bad-name", &cbfunc } };
+   PRINTF_NAMED_FORMATTER many[40];
+   char                   names[40][8];
+   PRINTF_V_DATA          cbdata   = { &cbfunc, 12, (void *) "Hello world!"};
+   PRINTF_ARG             a[2];
+   int                    i;
+
+   bRet &= test_svsprintf(__LINE__, "", "ssprintf(\"%{upper}\", \"abc\")", "%{upper}", "abc");
+
+   if((callback_printf_register(fmts, 2) != 0) ||
+      (callback_printf_register(dup, 2) != EEXIST) ||
+      (callback_printf_register(bad, 1) != EINVAL) ||
+      callback_printf_named("x1", 2) || (callback_printf_named("upper", 5) != &test_named_upper))
+   {
+      printf("test_callback_printf.c:%d : registering of named formatters failed!\n", __LINE__);
+      bRet = 0;
+   }
+
+   for(i = 0; i < 40; ++i)
+   {
+      ssprintf(names[i], "n%d", i);
+      many[i].pName = names[i];
+      many[i].pcb   = &test_named_upper;
+   }
+
+   if(callback_printf_register(many, 40) || (callback_printf_named("n39", 3) != &test_named_upper) || (callback_printf_named("v_data", 6) != &cbfunc))
+   {
+      printf("test_callback_printf.c:%d : registering of many named formatters failed!\n", __LINE__);
+      bRet = 0;
+   }
+
+   bRet &= test_svsprintf(__LINE__, "a ABC b", "ssprintf(\"a %{upper} b\", \"abc\")", "a %{upper} b", "abc");
+   bRet &= test_svsprintf(__LINE__, "[AB   ]|[  CD]|1", "ssprintf(\"[%-5.2{upper}]|[%*{n7}]|%d\", ...)", "[%-5.2{upper}]|[%*{n7}]|%d", "abc", 4, "cd", 1);
+   bRet &= test_svsprintf(__LINE__, "Hello world!", "ssprintf(\"%{v_data}\", &cbdata)", "%{v_data}", &cbdata);
+   bRet &= test_svsprintf(__LINE__, "", "ssprintf(\"%{nothing}\", \"abc\")", "%{nothing}", "abc");
+   bRet &= test_svsprintf(__LINE__, "", "ssprintf(\"%{upper\", \"abc\")", "%{upper", "abc");
+
+   memset(a, 0, sizeof(a));
+   a[0].Type = PRINTF_ARG_PTR; a[0].v.p = "array";
+   bRet &= test_printfa(__LINE__, "ARRAY!", "%{upper}!", a, 1);
+   bRet &= test_printfa(__LINE__, "x<ERR>", "x%{nothing}", a, 1);
+
+   return (bRet);
+} /* int test_named() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_formats checks the built-in formatters of cbk_formats.c.
+\* ------------------------------------------------------------------------- */
+int test_formats()
+{
+   int                 bRet     = 1;
+   uint8_t             ip4[4]   = { 192, 168, 0, 255 };
+   uint8_t             lo6[16]  = { 0,0, 0,0, 0,0, 0,0, 0,0, 0,0, 0,0, 0,1 };
+   uint8_t             doc6[16] = { 0x20,0x01, 0x0d,0xb8, 0,0, 0,0, 0,1, 0,0, 0,0, 0,1 };
+   uint8_t             one6[16] = { 0x20,0x01, 0x0d,0xb8, 0,0, 0,1, 0,1, 0,1, 0,1, 0,1 };
+   uint8_t             end6[16] = { 0xfe,0x80, 0,0, 0,0, 0,0, 0,0, 0,0, 0,0, 0,0 };
+   uint8_t             any6[16] = { 0 };
+   uint8_t             map6[16] = { 0,0, 0,0, 0,0, 0,0, 0,0, 0xff,0xff, 10,0,0,1 };
+   uint8_t             mac[6]   = { 0x00, 0x1a, 0x2b, 0x3c, 0x4d, 0xef };
+   uint8_t             uuid[16] = { 0x12,0x3e,0x45,0x67, 0xe8,0x9b, 0x12,0xd3, 0xa4,0x56, 0x42,0x66,0x14,0x17,0x40,0x00 };
+   struct sockaddr_in  sa4;
+   struct sockaddr_in6 sa6;
+
+   if(cbk_formats_register())
+   {
+      printf("test_callback_printf.c:%d : cbk_formats_register failed!\n", __LINE__);
+      return (0);
+   }
+
+   memset(&sa4, 0, sizeof(sa4));
+   sa4.sin_family = AF_INET;
+   sa4.sin_port   = htons(8080);
+   memcpy(&sa4.sin_addr, ip4, 4);
+
+   memset(&sa6, 0, sizeof(sa6));
+   sa6.sin6_family   = AF_INET6;
+   sa6.sin6_port     = htons(443);
+   sa6.sin6_scope_id = 2;
+   memcpy(&sa6.sin6_addr, end6, 16);
+
+   bRet &= test_svsprintf(__LINE__, "192.168.0.255|0.0.0.0", "ssprintf(\"%{ipv4}|%{ipv4}\", ...)", "%{ipv4}|%{ipv4}", ip4, lo6);
+   bRet &= test_svsprintf(__LINE__, "[    192.168.0.255]", "ssprintf(\"[%17{ipv4}]\", ...)", "[%17{ipv4}]", ip4);
+   bRet &= test_svsprintf(__LINE__, "::1|2001:db8::1:0:0:1|fe80::|::", "ssprintf(\"%{ipv6}|%{ipv6}|%{ipv6}|%{ipv6}\", ...)", "%{ipv6}|%{ipv6}|%{ipv6}|%{ipv6}", lo6, doc6, end6, any6);
+   bRet &= test_svsprintf(__LINE__, "2001:db8:0:1:1:1:1:1|::ffff:10.0.0.1", "ssprintf(\"%{ipv6}|%{ipv6}\", ...)", "%{ipv6}|%{ipv6}", one6, map6);
+   bRet &= test_svsprintf(__LINE__, "[0:0:0:0:0:0:0:1  ]", "ssprintf(\"[%#-17{ipv6}]\", ...)", "[%#-17{ipv6}]", lo6);
+   bRet &= test_svsprintf(__LINE__, "00:1a:2b:3c:4d:ef|00:1A:2B:3C:4D:EF", "ssprintf(\"%{mac}|%#{mac}\", ...)", "%{mac}|%#{mac}", mac, mac);
+   bRet &= test_svsprintf(__LINE__, "123e4567-e89b-12d3-a456-426614174000", "ssprintf(\"%{uuid}\", ...)", "%{uuid}", uuid);
+   bRet &= test_svsprintf(__LINE__, "192.168.0.255:8080|[fe80::%2]:443|192.168.0.255", "ssprintf(\"%{sockaddr}|%{sockaddr}|%#{sockaddr}\", ...)", "%{sockaddr}|%{sockaddr}|%#{sockaddr}", &sa4, &sa6, &sa4);
+   bRet &= test_svsprintf(__LINE__, "<NULL>", "ssprintf(\"%{uuid}\", NULL)", "%{uuid}", NULL);
+
+   return (bRet);
+} /* int test_formats() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_timestamps checks the timestamp formatters of cbk_formats.c and the
+   reuse of the cached text of the date and the time.
+\* ------------------------------------------------------------------------- */
+int test_timestamps()
+{
+   int             bRet = 1;
+   struct timespec ts;
+   int64_t         ns;
+
+   /* the formatters got registered by test_formats */
+   ts.tv_sec  = 1760877296;
+   ts.tv_nsec = 123456789;
+   bRet &= test_svsprintf(__LINE__, "2025-10-19T12:34:56.123456Z", "ssprintf(\"%{iso8601}\", &ts)", "%{iso8601}", &ts);
+   bRet &= test_svsprintf(__LINE__, "2025-10-19 12:34:56.123+00:00", "ssprintf(\"%.3{rfc3339}\", &ts)", "%.3{rfc3339}", &ts);
+   bRet &= test_svsprintf(__LINE__, "20251019T123456.123456789Z", "ssprintf(\"%.9{tscompact}\", &ts)", "%.9{tscompact}", &ts);
+   bRet &= test_svsprintf(__LINE__, "[2025-10-19T12:34:56Z  ]", "ssprintf(\"[%-22.0{iso8601}]\", &ts)", "[%-22.0{iso8601}]", &ts);
+
+   ts.tv_nsec = 5000; /* same second from the cache */
+   bRet &= test_svsprintf(__LINE__, "2025-10-19T12:34:56.000005Z", "ssprintf(\"%{iso8601}\", &ts)", "%{iso8601}", &ts);
+   ts.tv_sec  = 1760877297; /* next second of the same day */
+   bRet &= test_svsprintf(__LINE__, "2025-10-19T12:34:57.000005Z", "ssprintf(\"%{iso8601}\", &ts)", "%{iso8601}", &ts);
+   ts.tv_sec  = 1760918399;
+   bRet &= test_svsprintf(__LINE__, "2025-10-19T23:59:59.000005Z", "ssprintf(\"%{iso8601}\", &ts)", "%{iso8601}", &ts);
+   ts.tv_sec  = 1760918400; /* next day */
+   bRet &= test_svsprintf(__LINE__, "2025-10-20T00:00:00.000005Z", "ssprintf(\"%{iso8601}\", &ts)", "%{iso8601}", &ts);
+   ts.tv_sec  = 1709168461;
+   bRet &= test_svsprintf(__LINE__, "20240229T010101Z", "ssprintf(\"%.0{tscompact}\", &ts)", "%.0{tscompact}", &ts);
+
+   ns = 1760877296123456789LL;
+   bRet &= test_svsprintf(__LINE__, "2025-10-19T12:34:56.1234Z", "ssprintf(\"%.4{iso8601_ns}\", &ns)", "%.4{iso8601_ns}", &ns);
+   ns = -1;
+   bRet &= test_svsprintf(__LINE__, "1969-12-31 23:59:59.999999999+00:00", "ssprintf(\"%.9{rfc3339_ns}\", &ns)", "%.9{rfc3339_ns}", &ns);
+   ns = 0;
+   bRet &= test_svsprintf(__LINE__, "19700101T000000.000000Z", "ssprintf(\"%{tscompact_ns}\", &ns)", "%{tscompact_ns}", &ns);
+
+   ts.tv_sec  = (time_t) 253402300799LL;
+   ts.tv_nsec = 999999999;
+   if(sizeof(time_t) == 8)
+   {
+      bRet &= test_svsprintf(__LINE__, "9999-12-31T23:59:59.999Z", "ssprintf(\"%.3{iso8601}\", &ts)", "%.3{iso8601}", &ts);
+      ts.tv_sec += 1; /* year 10000 */
+      bRet &= test_svsprintf(__LINE__, "", "ssprintf(\"%{iso8601}\", &ts)", "%{iso8601}", &ts);
+   }
+
+   ts.tv_sec  = 0;
+   ts.tv_nsec = 1000000000; /* invalid */
+   bRet &= test_svsprintf(__LINE__, "", "ssprintf(\"%{iso8601}\", &ts)", "%{iso8601}", &ts);
+   bRet &= test_svsprintf(__LINE__, "<NULL>", "ssprintf(\"%{iso8601_ns}\", NULL)", "%{iso8601_ns}", NULL);
+
+   return (bRet);
+} /* int test_timestamps() */
+
+
+/* ------------------------------------------------------------------------- *\
+   BYTES_SINK is a reserve and commit sink of test_binary that reserves at
+   most 100 bytes at once.
+\* ------------------------------------------------------------------------- */
+typedef struct BYTES_SINK_S BYTES_SINK;
+struct BYTES_SINK_S
+{
+   char * pDst;    /* current write position */
+   size_t Commits; /* number of commits */
+};
+
+static char * bytes_reserve(void * pUserData, size_t Length)
+{
+   return ((Length <= 100) ? ((BYTES_SINK *) pUserData)->pDst : NULL);
+} /* char * bytes_reserve(void * pUserData, size_t Length) */
+
+static void bytes_commit(void * pUserData, size_t Length)
+{
+   ((BYTES_SINK *) pUserData)->pDst += Length;
+   ++((BYTES_SINK *) pUserData)->Commits;
+} /* void bytes_commit(void * pUserData, size_t Length) */
+
+static void bytes_write(void * pUserData, const char * pSrc, size_t Length)
+{
+   memcpy(((BYTES_SINK *) pUserData)->pDst, pSrc, Length);
+   ((BYTES_SINK *) pUserData)->pDst += Length;
+} /* void bytes_write(void * pUserData, const char * pSrc, size_t Length) */
+
+static size_t bytes_sink_printf(BYTES_SINK * pbs, const char * pFmt, ...)
+{
+   PRINTF_SINK sink;
+   size_t      zRet;
+   va_list     val;
+
+   sink.pUserData = pbs;
+   sink.pCB       = &bytes_write;
+   sink.pReserve  = &bytes_reserve;
+   sink.pCommit   = &bytes_commit;
+
+   va_start(val, pFmt);
+   zRet = callback_printf_sink(&sink, pFmt, val);
+   va_end(val);
+
+   *pbs->pDst = '\0';
+   return (zRet);
+} /* size_t bytes_sink_printf(BYTES_SINK * pbs, const char * pFmt, ...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_binary checks the hexadecimal, base64 and base32 formatters of
+   cbk_formats.c.
+\* ------------------------------------------------------------------------- */
+int test_binary()
+{
+   int        bRet = 1;
+   uint8_t    data[600];
+   char       expected[1300];
+   char       text[1300];
+   CBK_BYTES  foobar = { "foobar", 6 };
+   CBK_BYTES  empty  = { NULL, 0 };
+   CBK_BYTES  dump   = { "Hello world!\n\0\1\2\3\xff", 18 };
+   CBK_BYTES  big;
+   BYTES_SINK bs;
+   size_t     i;
+
+   /* the formatters got registered by test_formats */
+   for(i = 0; i < sizeof(data); ++i)
+   {
+      data[i] = (uint8_t) (i * 7 + 3);
+      ssprintf(expected + 2 * i, "%02x", data[i]);
+   }
+
+   big.pData  = data;
+   big.Length = sizeof(data);
+
+   bRet &= test_svsprintf(__LINE__, "666f6f626172|666F6F|", "ssprintf(\"%{hex}|%#.3{hex}|%{hex}\", ...)", "%{hex}|%#.3{hex}|%{hex}", &foobar, &foobar, &empty);
+   bRet &= test_svsprintf(__LINE__, "[66 6f 6f 62   ]", "ssprintf(\"[%-14.4{hex_sp}]\", ...)", "[%-14.4{hex_sp}]", &foobar);
+   bRet &= test_svsprintf(__LINE__, "|Zg==|Zm8=|Zm9v|Zm9vYg==|Zm9vYmE=|Zm9vYmFy", "ssprintf(\"%.0{base64}|%.1{base64}|...\", ...)", "%.0{base64}|%.1{base64}|%.2{base64}|%.3{base64}|%.4{base64}|%.5{base64}|%{base64}",
+                          &foobar, &foobar, &foobar, &foobar, &foobar, &foobar, &foobar);
+   bRet &= test_svsprintf(__LINE__, "MY======|MZXQ====|MZXW6===|MZXW6YQ=|MZXW6YTB|MZXW6YTBOI======", "ssprintf(\"%.1{base32}|%.2{base32}|...\", ...)", "%.1{base32}|%.2{base32}|%.3{base32}|%.4{base32}|%.5{base32}|%{base32}",
+                          &foobar, &foobar, &foobar, &foobar, &foobar, &foobar);
+   bRet &= test_svsprintf(__LINE__, "Zg|MZXQ|  Zm9vYmFy", "ssprintf(\"%#.1{base64}|%#.2{base32}|%10{base64}\", ...)", "%#.1{base64}|%#.2{base32}|%10{base64}", &foobar, &foobar, &foobar);
+   bRet &= test_svsprintf(__LINE__, "00000000  48 65 6c 6c 6f 20 77 6f  72 6c 64 21 0a 00 01 02  |Hello world!....|\n"
+                                    "00000010  03 ff                                             |..|\n"
+                                    "00000012\n", "ssprintf(\"%{hexdump}\", ...)", "%{hexdump}", &dump);
+   bRet &= test_svsprintf(__LINE__, "[]", "ssprintf(\"[%.0{hexdump}]\", ...)", "[%.0{hexdump}]", &dump);
+   bRet &= test_svsprintf(__LINE__, "<NULL>", "ssprintf(\"%{base64}\", NULL)", "%{base64}", NULL);
+
+   /* blocks of the output and SIMD code */
+   bRet &= test_svsprintf(__LINE__, expected, "ssprintf(\"%{hex}\", &big)", "%{hex}", &big);
+
+   /* base64 of the whole data must match the concatenated base64 of 12 byte pieces */
+   for(i = 0; i < sizeof(data); i += 12)
+   {
+      CBK_BYTES piece;
+
+      piece.pData  = data + i;
+      piece.Length = 12;
+      _ssprintf(expected + i / 12 * 16, "%{base64}", &piece);
+   }
+
+   bRet &= test_svsprintf(__LINE__, expected, "ssprintf(\"%{base64}\", &big)", "%{base64}", &big);
+
+   /* direct output into the memory of a reserve and commit sink or by the callback for too large blocks */
+   bs.pDst    = text;
+   bs.Commits = 0;
+   if((bytes_sink_printf(&bs, "%.36{base64}", &big) != 48) || strncmp(text, expected, 48) || (bs.Commits != 1))
+   {
+      printf("test_callback_printf.c:%d : %%{base64} wrote '%s' with %zu commits into the sink!\n", __LINE__, text, bs.Commits);
+      bRet = 0;
+   }
+
+   bs.pDst = text;
+   if((bytes_sink_printf(&bs, "%{base64}", &big) != 800) || strcmp(text, expected))
+   {
+      printf("test_callback_printf.c:%d : %%{base64} wrote '%s' into the sink!\n", __LINE__, text);
+      bRet = 0;
+   }
+
+   /* the last line of %{hexdump} holds the offset behind the data like hexdump -C */
+   if((_ssprintf(text, "%.20{hexdump}", &big) != 155) || strcmp(text + 146, "00000014\n"))
+   {
+      printf("test_callback_printf.c:%d : %%{hexdump} of 20 bytes ended with '%s'!\n", __LINE__, text + 146);
+      bRet = 0;
+   }
+
+   if((_ssprintf(text, "%#.26{hexdump}", &big) != 161) || strcmp(text + 152, "0000001A\n"))
+   {
+      printf("test_callback_printf.c:%d : %%#{hexdump} of 26 bytes ended with '%s'!\n", __LINE__, text + 152);
+      bRet = 0;
+   }
+
+   return (bRet);
+} /* int test_binary() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_escaped checks the JSON, CSV and shell escaping of %Js, %Qs and %qs.
+\* ------------------------------------------------------------------------- */
+int test_escaped()
+{
+   int            bRet   = 1;
+   const uint16_t u16[]  = { 'a', '\n', 0xe9, '"', 0 };
+   const uint32_t u32[]  = { 'x', ',', 0x20ac, 0 };
+
+   bRet &= test_svsprintf(__LINE__, "a\\\"b\\\\c\\n\\t\\u0001\\u001f\xc3\xa9", "ssprintf(\"%Js\", ...)", "%Js", "a\"b\\c\n\t\x01\x1f\xc3\xa9");
+   bRet &= test_svsprintf(__LINE__, "\"line\\r\\n\"|\"\"", "ssprintf(\"%#Js|%#Js\", ...)", "%#Js|%#Js", "line\r\n", "");
+   bRet &= test_svsprintf(__LINE__, "0123456789abcdefghij\\\"xyz0123456789abcdefghij", "ssprintf(\"%Js\", ...)", "%Js", "0123456789abcdefghij\"xyz0123456789abcdefghij");
+   bRet &= test_svsprintf(__LINE__, "a\\\"b|[a\\nb    ]|[    a\\nb]", "ssprintf(\"%.3Js|[%-8Js]|[%8Js]\", ...)", "%.3Js|[%-8Js]|[%8Js]", "a\"bcd", "a\nb", "a\nb");
+   bRet &= test_svsprintf(__LINE__, "plain|\"a,b\"|\"he said \"\"hi\"\"\"|\"x\"", "ssprintf(\"%Qs|%Qs|%Qs|%#Qs\", ...)", "%Qs|%Qs|%Qs|%#Qs", "plain", "a,b", "he said \"hi\"", "x");
+   bRet &= test_svsprintf(__LINE__, "abc-1.txt|'it'\\''s here'|''|'x'|[   'a b']", "ssprintf(\"%qs|%qs|%qs|%#qs|[%8qs]\", ...)", "%qs|%qs|%qs|%#qs|[%8qs]", "abc-1.txt", "it's here", "", "x", "a b");
+   bRet &= test_svsprintf(__LINE__, "a\\n\xc3\xa9\\\"|\"x,\xe2\x82\xac\"|[\"x,\"     ]", "ssprintf(\"%Jl2s|%Ql4s|[%-9.2Ql4s]\", ...)", "%Jl2s|%Ql4s|[%-9.2Ql4s]", u16, u32, u32);
+   bRet &= test_svsprintf(__LINE__, "\"x,\xc3\xa9\"", "ssprintf(\"%Qls\", L\"x,\\u00e9\")", "%Qls", L"x,é");
+   bRet &= test_svsprintf(__LINE__, "<NULL>|'<NULL>'", "ssprintf(\"%Js|%qs\", NULL, NULL)", "%Js|%qs", NULL, NULL);
+   bRet &= test_svsprintf(__LINE__, "", "ssprintf(\"%Jl3s\", ...)", "%Jl3s", "x");
+
+   return (bRet);
+} /* int test_escaped() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_record_check compares the output of cbk_record_snprintf.
+\* ------------------------------------------------------------------------- */
+static int test_record_check(int Line, const char * pExpected, const char * pText, size_t Length)
+{
+   if((Length != strlen(pExpected)) || strcmp(pText, pExpected))
+   {
+      printf("test_callback_printf.c:%d : record '%s' (%zu) instead of '%s'!\n", Line, pText, Length, pExpected);
+      return (0);
+   }
+
+   return (1);
+} /* int test_record_check(int Line, const char * pExpected, const char * pText, size_t Length) */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_record checks the text, logfmt and JSON output of cbk_record.
+\* ------------------------------------------------------------------------- */
+int test_record()
+{
+   int             bRet = 1;
+   CBK_RECORD *    pRec;
+   char            text[256];
+   size_t          len;
+   struct timespec ts;
+
+   /* the formatters got registered by test_formats */
+   ts.tv_sec  = 1792400096; /* 2026-10-19T08:54:56Z */
+   ts.tv_nsec = 123456789;
+
+   pRec = cbk_record_create("ts=%.3{iso8601} lvl=%-5s lat_us=%4u ratio=%.2f msg=%s c=%c");
+   if(!pRec)
+   {
+      printf("test_callback_printf.c:%d : cbk_record_create failed with %d!\n", __LINE__, errno);
+      return (0);
+   }
+
+   len   = cbk_record_snprintf(text, sizeof(text), pRec, CBK_RECORD_TEXT, &ts, "info", 42u, 0.5, "hello world", 'x');
+   bRet &= test_record_check(__LINE__, "2026-10-19T08:54:56.123Z info    42 0.50 hello world x\n", text, len);
+   len   = cbk_record_snprintf(text, sizeof(text), pRec, CBK_RECORD_LOGFMT, &ts, "info", 42u, 0.5, "hello world", 'x');
+   bRet &= test_record_check(__LINE__, "ts=\"2026-10-19T08:54:56.123Z\" lvl=info lat_us=42 ratio=0.50 msg=\"hello world\" c=x\n", text, len);
+   len   = cbk_record_snprintf(text, sizeof(text), pRec, CBK_RECORD_JSON, &ts, "warn", 7u, -HUGE_VAL, "a\"b\n", '"');
+   bRet &= test_record_check(__LINE__, "{\"ts\":\"2026-10-19T08:54:56.123Z\",\"lvl\":\"warn\",\"lat_us\":7,\"ratio\":null,\"msg\":\"a\\\"b\\n\",\"c\":\"\\\"\"}\n", text, len);
+
+   /* truncation keeps the returned length */
+   len   = cbk_record_snprintf(text, 10, pRec, CBK_RECORD_JSON, &ts, "info", 1u, 2.0, "", ' ');
+   if((len != 88) || strcmp(text, "{\"ts\":\"20"))
+   {
+      printf("test_callback_printf.c:%d : truncated record '%s' (%zu)!\n", __LINE__, text, len);
+      bRet = 0;
+   }
+   cbk_record_free(pRec);
+
+   /* '*' arguments, sizes and bases, the width only applies to the text */
+   pRec = cbk_record_create("  id=%08llx n=%+*d name=%.*s v=%Lg  ");
+   if(!pRec)
+   {
+      printf("test_callback_printf.c:%d : cbk_record_create failed with %d!\n", __LINE__, errno);
+      return (0);
+   }
+
+   len   = cbk_record_snprintf(text, sizeof(text), pRec, CBK_RECORD_TEXT, 0xabcULL, 5, -3, 3, "abcdef", (long double) 2.5);
+   bRet &= test_record_check(__LINE__, "00000abc    -3 abc 2.5\n", text, len);
+   len   = cbk_record_snprintf(text, sizeof(text), pRec, CBK_RECORD_LOGFMT, 0xabcULL, 5, 3, 3, "a=bcdef", (long double) 2.5);
+   bRet &= test_record_check(__LINE__, "id=abc n=3 name=\"a=b\" v=2.5\n", text, len);
+   len   = cbk_record_snprintf(text, sizeof(text), pRec, CBK_RECORD_JSON, 0xabcULL, 5, 3, 3, "abcdef", (long double) 2.5);
+   bRet &= test_record_check(__LINE__, "{\"id\":\"abc\",\"n\":3,\"name\":\"abc\",\"v\":2.5}\n", text, len);
+   cbk_record_free(pRec);
+
+   /* long, size_t and wide character sizes */
+   pRec = cbk_record_create("l=%ld z=%zu j=%jd s=%ls c=%lc f=%lf");
+   if(!pRec)
+   {
+      printf("test_callback_printf.c:%d : cbk_record_create failed with %d!\n", __LINE__, errno);
+      return (0);
+   }
+
+   len   = cbk_record_snprintf(text, sizeof(text), pRec, CBK_RECORD_TEXT, -5L, (size_t) 42, (intmax_t) -7, L"ab", (int) 0xe9, 1.5);
+   bRet &= test_record_check(__LINE__, "-5 42 -7 ab \xc3\xa9 1.500000\n", text, len);
+   len   = cbk_record_snprintf(text, sizeof(text), pRec, CBK_RECORD_JSON, -5L, (size_t) 42, (intmax_t) -7, L"a\"b", (int) 0xe9, 1.5);
+   bRet &= test_record_check(__LINE__, "{\"l\":-5,\"z\":42,\"j\":-7,\"s\":\"a\\\"b\",\"c\":\"\xc3\xa9\",\"f\":1.500000}\n", text, len);
+   cbk_record_free(pRec);
+
+   /* an empty schema and invalid ones */
+   pRec = cbk_record_create("");
+   if(pRec)
+   {
+      len   = cbk_record_snprintf(text, sizeof(text), pRec, CBK_RECORD_JSON);
+      bRet &= test_record_check(__LINE__, "{}\n", text, len);
+      cbk_record_free(pRec);
+   }
+   else
+      bRet = 0;
+
+   if(cbk_record_create("a=%d b") || (errno != EINVAL) || cbk_record_create("a=%n") || cbk_record_create("a=%{unknown}") ||
+      cbk_record_create("a b=%d") || cbk_record_create("a=%dx"))
+   {
+      printf("test_callback_printf.c:%d : cbk_record_create accepted an invalid schema!\n", __LINE__);
+      bRet = 0;
+   }
+
+   return (bRet);
+} /* int test_record() */
+
+
+#ifdef CALLBACK_PRINTF_PROFILE
+/* ------------------------------------------------------------------------- *\
+   test_profile_check compares a counter of the profile with the expected
+   calls and bytes.
+\* ------------------------------------------------------------------------- */
+static int test_profile_check(int Line, const PRINTF_PROFILE * pProfile, int Conversion, uint64_t Calls, uint64_t Bytes)
+{
+   const PRINTF_PROFILE_COUNTER * pc = &pProfile->Conv[Conversion];
+
+   if((pc->Calls != Calls) || (pc->Bytes != Bytes) || (Calls && !pc->Callbacks))
+   {
+      printf("test_callback_printf.c:%d : %%%s counted %" PRIu64 " calls, %" PRIu64 " bytes and %" PRIu64 " callbacks instead of %" PRIu64 " calls and %" PRIu64 " bytes!\n",
+             Line, callback_printf_profile_name(Conversion), pc->Calls, pc->Bytes, pc->Callbacks, Calls, Bytes);
+      return (0);
+   }
+
+   return (1);
+} /* int test_profile_check(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_profile checks the profiling counters of the conversions.
+\* ------------------------------------------------------------------------- */
+int test_profile()
+{
+   int            bRet = 1;
+   char           buf[128];
+   char *         pd   = buf;
+   PRINTF_PROFILE p;
+   PRINTF_PROFILE total;
+   PRINTF_ARG     a[2];
+
+   callback_printf_profile_reset();
+   ssnprintf(buf, sizeof(buf), "x=%d %s|%5.2f %%", -42, "abc", 3.14159);
+   callback_printf_profile_snapshot(&p);
+
+   bRet &= test_profile_check(__LINE__, &p, PRINTF_PROFILE_TEXT, 5, 6);
+   bRet &= test_profile_check(__LINE__, &p, PRINTF_PROFILE_D,    1, 3);
+   bRet &= test_profile_check(__LINE__, &p, PRINTF_PROFILE_STR,  1, 3);
+   bRet &= test_profile_check(__LINE__, &p, PRINTF_PROFILE_F,    1, 5);
+   bRet &= test_profile_check(__LINE__, &p, PRINTF_PROFILE_X,    0, 0);
+
+   a[0].Type = PRINTF_ARG_UINT;
+   a[0].v.u  = 0xff;
+   a[1].Type = PRINTF_ARG_PTR;
+   a[1].v.p  = L"wide";
+
+   callback_printf_profile_reset();
+   callback_printfa(&pd, &test_printfa_cb, "%x%ls%Js", a, 2);
+   callback_printf_profile_snapshot(&p);
+
+   bRet &= test_profile_check(__LINE__, &p, PRINTF_PROFILE_X,    1, 2);
+   bRet &= test_profile_check(__LINE__, &p, PRINTF_PROFILE_LSTR, 1, 4);
+   bRet &= test_profile_check(__LINE__, &p, PRINTF_PROFILE_ESC,  0, 0);
+
+   if(p.Conv[PRINTF_PROFILE_X].Callbacks != 1)
+   {
+      printf("test_callback_printf.c:%d : %%x counted %" PRIu64 " callbacks instead of 1!\n", __LINE__, p.Conv[PRINTF_PROFILE_X].Callbacks);
+      bRet = 0;
+   }
+
+   memset(&total, 0, sizeof(total));
+   callback_printf_profile_merge(&total, &p);
+   callback_printf_profile_merge(&total, &p);
+   bRet &= test_profile_check(__LINE__, &total, PRINTF_PROFILE_LSTR, 2, 8);
+
+   callback_printf_profile_sampling(1);
+   callback_printf_profile_reset();
+   ssnprintf(buf, sizeof(buf), "%d%d", 1, 2);
+   callback_printf_profile_sampling(0);
+   callback_printf_profile_snapshot(&p);
+
+   if((p.Conv[PRINTF_PROFILE_D].Samples != 2) || p.Conv[PRINTF_PROFILE_TEXT].Samples)
+   {
+      printf("test_callback_printf.c:%d : %" PRIu64 " timed conversions instead of 2!\n", __LINE__, p.Conv[PRINTF_PROFILE_D].Samples);
+      bRet = 0;
+   }
+
+   if(strcmp(callback_printf_profile_name(PRINTF_PROFILE_NESTED), "@") || callback_printf_profile_name(PRINTF_PROFILE_COUNT))
+   {
+      printf("test_callback_printf.c:%d : invalid names of the conversion types!\n", __LINE__);
+      bRet = 0;
+   }
+
+   return (bRet);
+} /* int test_profile() */
+#endif
+
+
+/* ------------------------------------------------------------------------- *\
+   test_sfprintf_error checks that sfprintf writes the output in front of an
+   error in the format string like ssnprintf returns it.
+\* ------------------------------------------------------------------------- */
+int test_sfprintf_error()
+{
+   int          bRet = 0;
+   const char * pfmt = "hello %d %y world\n";
+   char         text[601];
+   char         content[1024];
+   size_t       sz;
+   size_t       len;
+   FILE *       pf = tmpfile();
+
+   if(!pf)
+   {
+      printf("test_callback_printf.c:%d : tmpfile failed!\n", __LINE__);
+      goto Exit;
+   }
+
+   errno = 0;
+   sz    = sfprintf(pf, pfmt, 5);
+   if((sz != 8) || (errno != EINVAL))
+   {
+      printf("test_callback_printf.c:%d : sfprintf returned %zu with error %d instead of 8 with EINVAL!\n", __LINE__, sz, errno);
+      goto Exit;
+   }
+
+   /* output in front of the error that doesn't fit into the staging buffer */
+   memset(text, 'x', 600);
+   text[600] = '\0';
+   pfmt      = "%s%y";
+   sz        = sfprintf(pf, pfmt, text);
+
+   rewind(pf);
+   len = fread(content, 1, sizeof(content), pf);
+
+   if((sz != 600) || (len != 608) || memcmp(content, "hello 5 ", 8) || memcmp(content + 8, text, 600))
+   {
+      printf("test_callback_printf.c:%d : sfprintf wrote %zu bytes and returned %zu in front of format errors!\n", __LINE__, len, sz);
+      goto Exit;
+   }
+
+   bRet = 1;
+
+   Exit:;
+   if(pf)
+      fclose(pf);
+
+   return (bRet);
+} /* int test_sfprintf_error() */
+
+
+#ifndef _WIN32
+/* ------------------------------------------------------------------------- *\
+   test_safdprintf writes some lines using small buffers asynchronously to a
+   temporary file and compares the file content with the expected data.
+\* ------------------------------------------------------------------------- */
+int test_safdprintf(int flags)
+{
+   int          bRet = 0;
+   char         path[] = "/tmp/test_safdprintf_XXXXXX";
+   char         expected[8192];
+   char         content[8192];
+   size_t       exp_len = 0;
+   ptrdiff_t    len;
+   SAFD *       pafd = NULL;
+   SAFD_STATUS  st;
+   int          fd = mkstemp(path);
+   int          i;
+
+   if(fd < 0)
+   {
+      printf("test_callback_printf.c:%d : mkstemp failed!\n", __LINE__);
+      goto Exit;
+   }
+
+   pafd = safd_open(fd, 64, 4, flags);
+   if(!pafd)
+   {
+      printf("test_callback_printf.c:%d : safd_open failed with error %d!\n", __LINE__, errno);
+      goto Exit;
+   }
+
+   for(i = 0; i < 100; ++i)
+   {
+      const char * pfmt = "%03d: %-*s|%#x\n";
+      size_t sz  = safdprintf(pafd, pfmt, i, i % 80, "Hello world!", (unsigned int) i);
+      size_t sz2 = ssprintf(expected + exp_len, pfmt, i, i % 80, "Hello world!", (unsigned int) i);
+
+      if(sz != sz2)
+      {
+         printf("test_callback_printf.c:%d : safdprintf returned %zu instead of %zu!\n", __LINE__, sz, sz2);
+         goto Exit;
+      }
+      exp_len += sz2;
+   }
+
+   if(safd_flush(pafd) || safd_status(pafd, &st) || (st.Written != exp_len) || (st.Queued != exp_len) || st.Pending)
+   {
+      printf("test_callback_printf.c:%d : safdprintf in mode %d wrote %zu of %zu bytes with error %d!\n", __LINE__, st.Mode, (size_t) st.Written, exp_len, st.Err);
+      goto Exit;
+   }
+
+   len = pread(fd, content, sizeof(content), 0);
+   if((len != (ptrdiff_t) exp_len) || memcmp(content, expected, exp_len))
+   {
+      printf("test_callback_printf.c:%d : file content of safdprintf in mode %d doesn't match expected data!\n", __LINE__, st.Mode);
+      goto Exit;
+   }
+
+   bRet = 1;
+
+   Exit:;
+   if(pafd && safd_close(pafd))
+      bRet = 0;
+
+   if(fd >= 0)
+   {
+      close(fd);
+      unlink(path);
+   }
+
+   return (bRet);
+} /* int test_safdprintf(int flags) */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_safdprintf_uring_error replaces the io_uring instance by a regular
+   file, so that io_uring_enter fails. safd_flush and safd_close must return
+   the error instead of waiting for the pending writes forever.
+\* ------------------------------------------------------------------------- */
+int test_safdprintf_uring_error()
+{
+   int          bRet = 0;
+   char         path[] = "/tmp/test_safdprintf_XXXXXX";
+   SAFD *       pafd = NULL;
+   SAFD_STATUS  st;
+   int          fd = mkstemp(path);
+   int          ring = -1;
+   int          err;
+   int          i;
+
+   if(fd < 0)
+   {
+      printf("test_callback_printf.c:%d : mkstemp failed!\n", __LINE__);
+      goto Exit;
+   }
+
+   pafd = safd_open(fd, 64, 4, 0);
+   if(!pafd)
+   {
+      printf("test_callback_printf.c:%d : safd_open failed with error %d!\n", __LINE__, errno);
+      goto Exit;
+   }
+
+   if(safd_status(pafd, &st) || (st.Mode != SAFD_MODE_URING))
+   { /* io_uring isn't available */
+      bRet = 1;
+      goto Exit;
+   }
+
+   for(i = 3; (i < 1024) && (ring < 0); ++i)
+   {
+      char      name[32];
+      char      link[64];
+      ptrdiff_t len;
+
+      ssprintf(name, "/proc/self/fd/%d", i);
+      len = readlink(name, link, sizeof(link) - 1);
+      if(len > 0)
+      {
+         link[len] = '\0';
+         if(strstr(link, "io_uring"))
+            ring = i;
+      }
+   }
+
+   if((ring < 0) || (dup2(fd, ring) != ring))
+   {
+      printf("test_callback_printf.c:%d : the io_uring instance of safd_open wasn't found!\n", __LINE__);
+      goto Exit;
+   }
+
+   for(i = 0; i < 20; ++i)
+      safdprintf(pafd, "%03d: %s\n", i, "Hello world! Hello world! Hello world!");
+
+   err = safd_flush(pafd);
+   if(!err || (safd_status(pafd, &st) != err) || st.Pending)
+   {
+      printf("test_callback_printf.c:%d : safd_flush returned %d with %zu pending writes after io_uring failed!\n", __LINE__, err, st.Pending);
+      goto Exit;
+   }
+
+   i    = safd_close(pafd);
+   pafd = NULL;
+   if(i != err)
+   {
+      printf("test_callback_printf.c:%d : safd_close returned %d instead of %d!\n", __LINE__, i, err);
+      goto Exit;
+   }
+
+   bRet = 1;
+
+   Exit:;
+   if(pafd && safd_close(pafd))
+      bRet = 0;
+
+   if(fd >= 0)
+   {
+      close(fd);
+      unlink(path);
+   }
+
+   return (bRet);
+} /* int test_safdprintf_uring_error() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_sfdprintf_record_modes checks the record buffer of sfdprintf in
+   front of an error in the format string and the switch to chunked writes
+   if the output exceeds the record limit.
+\* ------------------------------------------------------------------------- */
+int test_sfdprintf_record_modes()
+{
+   int          bRet = 0;
+   char         path[] = "/tmp/test_sfdprintf_XXXXXX";
+   const char * pfmt   = "hello %d %y world\n";
+   char         text[1001];
+   char         content[2048];
+   size_t       old_limit = sfdprintf_set_record_limit(256);
+   size_t       sz;
+   ptrdiff_t    len;
+   int          fd = mkstemp(path);
+
+   if(fd < 0)
+   {
+      printf("test_callback_printf.c:%d : mkstemp failed!\n", __LINE__);
+      goto Exit;
+   }
+
+   errno = 0;
+   sz    = sfdprintf(fd, pfmt, 5);
+   if((sz != 8) || (errno != EINVAL))
+   {
+      printf("test_callback_printf.c:%d : sfdprintf returned %zu with error %d instead of 8 with EINVAL!\n", __LINE__, sz, errno);
+      goto Exit;
+   }
+
+   /* output beyond the record limit */
+   memset(text, 'x', 1000);
+   text[1000] = '\0';
+   sz         = sfdprintf(fd, "<%s|%d>\n", text, 42);
+   if(sz != 1006)
+   {
+      printf("test_callback_printf.c:%d : sfdprintf returned %zu instead of 1006 beyond the record limit!\n", __LINE__, sz);
+      goto Exit;
+   }
+
+   len = pread(fd, content, sizeof(content), 0);
+   if((len != 1014) || memcmp(content, "hello 5 <", 9) || memcmp(content + 9, text, 1000) || memcmp(content + 1009, "|42>\n", 5))
+   {
+      printf("test_callback_printf.c:%d : file content of sfdprintf with record buffer doesn't match expected data!\n", __LINE__);
+      goto Exit;
+   }
+
+   bRet = 1;
+
+   Exit:;
+   sfdprintf_release_record_buffer();
+   sfdprintf_set_record_limit(old_limit);
+
+   if(fd >= 0)
+   {
+      close(fd);
+      unlink(path);
+   }
+
+   return (bRet);
+} /* int test_sfdprintf_record_modes() */
+
+
+#define RECORD_THREADS  4     /* number of threads writing records */
+#define RECORD_COUNT    100   /* number of records per thread */
+#define RECORD_PART     3000  /* size of the parts of a record */
+
+/* ------------------------------------------------------------------------- *\
+   record_thread writes records that are much bigger than PIPE_BUF and
+   consist of a lot of fragments by sfdprintf.
+\* ------------------------------------------------------------------------- */
+static void * record_thread(void * pv)
+{
+   int *  parg = (int *) pv;
+   char   part[RECORD_PART + 1];
+   int    i;
+
+   memset(part, 'a' + parg[1], RECORD_PART);
+   part[RECORD_PART] = '\0';
+
+   for(i = 0; i < RECORD_COUNT; ++i)
+      sfdprintf(parg[0], "<%d:%04d:%s%s%s%s>\n", parg[1], i, part, part, part, part);
+
+   sfdprintf_release_record_buffer();
+   return (NULL);
+} /* void * record_thread(void * pv) */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_sfdprintf_records checks that the records of several threads that
+   are written by sfdprintf using record buffers do not interleave.
+\* ------------------------------------------------------------------------- */
+int test_sfdprintf_records()
+{
+   int          bRet = 0;
+   char         path[] = "/tmp/test_sfdprintf_XXXXXX";
+   size_t       rec_len = 2 + 1 + 1 + 4 + 1 + 4 * RECORD_PART + 1;
+   size_t       size = rec_len * RECORD_THREADS * RECORD_COUNT;
+   int          count[RECORD_THREADS];
+   int          args[RECORD_THREADS][2];
+   pthread_t    threads[RECORD_THREADS];
+   char *       pdata = NULL;
+   char *       pd;
+   size_t       old_limit = sfdprintf_set_record_limit(0x10000);
+   int          fd = mkstemp(path);
+   int          i;
+
+   if(fd < 0)
+   {
+      printf("test_callback_printf.c:%d : mkstemp failed!\n", __LINE__);
+      goto Exit;
+   }
+
+   fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_APPEND);
+
+   for(i = 0; i < RECORD_THREADS; ++i)
+   {
+      count[i]   = 0;
+      args[i][0] = fd;
+      args[i][1] = i;
+      pthread_create(&threads[i], NULL, &record_thread, args[i]);
+   }
+
+   /* changing the limit while the threads are writing keeps the records whole */
+   for(i = 0; i < 1000; ++i)
+      sfdprintf_set_record_limit((i & 1) ? 0x10000 : 0x20000);
+
+   for(i = 0; i < RECORD_THREADS; ++i)
+      pthread_join(threads[i], NULL);
+
+   pdata = (char *) malloc(size + 1);
+   if(!pdata || (pread(fd, pdata, size + 1, 0) != (ptrdiff_t) size))
+   {
+      printf("test_callback_printf.c:%d : unexpected file size of the records of sfdprintf!\n", __LINE__);
+      goto Exit;
+   }
+
+   for(pd = pdata; pd < pdata + size; pd += rec_len)
+   {
+      int    id = pd[1] - '0';
+      size_t j;
+
+      if((pd[0] != '<') || (id < 0) || (id >= RECORD_THREADS) || (pd[rec_len - 2] != '>') || (pd[rec_len - 1] != '\n'))
+         break;
+
+      for(j = 9; j < rec_len - 2; ++j)
+         if(pd[j] != 'a' + id)
+            break;
+
+      if(j != rec_len - 2)
+         break;
+
+      ++count[id];
+   }
+
+   if(pd != pdata + size)
+   {
+      printf("test_callback_printf.c:%d : records of sfdprintf are interleaved at offset %zu!\n", __LINE__, (size_t) (pd - pdata));
+      goto Exit;
+   }
+
+   for(i = 0; i < RECORD_THREADS; ++i)
+   {
+      if(count[i] != RECORD_COUNT)
+      {
+         printf("test_callback_printf.c:%d : found %d instead of %d records of thread %d!\n", __LINE__, count[i], RECORD_COUNT, i);
+         goto Exit;
+      }
+   }
+
+   bRet = 1;
+
+   Exit:;
+   sfdprintf_set_record_limit(old_limit);
+
+   if(pdata)
+      free(pdata);
+
+   if(fd >= 0)
+   {
+      close(fd);
+      unlink(path);
+   }
+
+   return (bRet);
+} /* int test_sfdprintf_records() */
+#endif
+
+
 /* ------------------------------------------------------------------------- *\
    main function
 \* ------------------------------------------------------------------------- */
@@ -1002,6 +2236,52 @@ int main(int argc, char * argv[])
     if(!test_ssprintf("%*s%c", 12, "Hello world", '!'))
          goto Exit;
 
+    if(!test_callback_printfa())
+         goto Exit;
+
+    if(!test_fragments())
+         goto Exit;
+
+    if(!test_named())
+         goto Exit;
+
+    if(!test_formats())
+         goto Exit;
+
+    if(!test_timestamps())
+         goto Exit;
+
+    if(!test_binary())
+         goto Exit;
+
+    if(!test_escaped())
+         goto Exit;
+
+    if(!test_record())
+         goto Exit;
+
+    if(!test_sfprintf_error())
+         goto Exit;
+
+#ifdef CALLBACK_PRINTF_PROFILE
+    if(!test_profile())
+         goto Exit;
+#endif
+
+#ifndef _WIN32
+    if(!test_safdprintf(0) || !test_safdprintf(SAFD_NO_URING))
+         goto Exit;
+
+    if(!test_safdprintf_uring_error())
+         goto Exit;
+
+    if(!test_sfdprintf_records())
+         goto Exit;
+
+    if(!test_sfdprintf_record_modes())
+         goto Exit;
+#endif
+
     iRet = 0;
 
     Exit:;
@@ -0,0 +1,287 @@
+/*****************************************************************************\
+*                                                                             *
+*  FILE NAME:     test_callback_printf.cpp                                    *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  DESCRIPTION:   tests of the C++ front end callback_printf.hpp              *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  COPYRIGHT:     (c) 2026 Dipl.-Ing. Klaus Lux (Aachen, Germany)             *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  ORIGIN:        https://github.com/klux21/callback_printf                   *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+* Civil Usage Public License, Version 1.2, June 2026                          *
+*                                                                             *
+* Redistribution and use in source and binary forms, with or without          *
+* modification, are permitted provided that the following conditions are met: *
+*                                                                             *
+* 1. Redistributions of source code must retain the above copyright           *
+*    notice, this list of conditions, the explanation of terms                *
+*    and the following disclaimer.                                            *
+*                                                                             *
+* 2. Redistributions in binary form must reproduce the above copyright        *
+*    notice, this list of conditions and the following disclaimer in the      *
+*    documentation or other materials provided with the distribution.         *
+*                                                                             *
+* 3. All modified files must carry prominent notices stating that the         *
+*    files have been changed.                                                 *
+*                                                                             *
+* 4. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are designed or           *
+*    intended to harm, to kill or to forcibly immobilize people.              *
+*                                                                             *
+* 5. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are intended to           *
+*    monitor, to track, to change or to control the behavior, the             *
+*    constitution, the location or the communication of any people or         *
+*    their property without the explicit and prior agreement of those         *
+*    people except those devices and systems are solely designed for          *
+*    saving or protecting peoples life or health.                             *
+*                                                                             *
+* 6. The source code and binary forms and any derivative works are not        *
+*    stored or executed in any systems or devices that are intended           *
+*    for the production of any of the systems or devices that                 *
+*    have been stated before except the ones for saving or protecting         *
+*    peoples life or health only.                                             *
+*                                                                             *
+* The term 'systems' in all clauses shall include all types and combinations  *
+* of physical, virtualized or simulated hardware and software and any kind    *
+* of data storage.                                                            *
+*                                                                             *
+* The term 'devices' shall include any kind of local or non-local control     *
+* system of the stated devices as part of that device as well. Any assembly   *
+* of more than one device is one and the same device regarding this license.  *
+*                                                                             *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" *
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   *
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  *
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   *
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         *
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        *
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    *
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     *
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     *
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  *
+* POSSIBILITY OF SUCH DAMAGE.                                                 *
+*                                                                             *
+\*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#if defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+#endif
+
+#include <callback_printf.hpp>
+
+/* ------------------------------------------------------------------------- *\
+   check compares the output of a test with the expected data
+\* ------------------------------------------------------------------------- */
+static int check(int line, const char * pout, const char * pres, size_t ret)
+{
+   if(strcmp(pout, pres) || (ret != strlen(pout)))
+   {
+      printf("test_callback_printf.cpp:%d : output '%s' (%zd) doesn't match expected '%s' !\n", line, pres, ret, pout);
+      return (0);
+   }
+
+   return (1);
+} /* int check(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   Write function for our own %v argument data.
+\* ------------------------------------------------------------------------- */
+static size_t vfunc(void * pUserData, PRINTF_CALLBACK * pCB, void * pvdata, size_t precision, size_t minimum_width, uint8_t left_justified, uint8_t prefixing)
+{
+   const char * ps = (const char *) pvdata;
+   return (cbk_print_string(pUserData, pCB, ps, strlen(ps), minimum_width, left_justified));
+} /* size_t vfunc(...) */
+
+
+enum color { red, green, blue };
+
+#if (__cplusplus >= 202002L)
+/* format strings that must be rejected at compile time */
+static_assert(!cbp::detail::parse_format("%d|%r*lu|%l2s|%w32d|%I64u|%v|%@").Error);
+static_assert(cbp::detail::parse_format("%n").Error);
+static_assert(cbp::detail::parse_format("%1$d").Error);
+static_assert(cbp::detail::parse_format("%ld%").Error);
+static_assert(cbp::detail::parse_format("%Lp").Error);
+static_assert(cbp::detail::parse_format("%w12d").Error);
+static_assert(cbp::detail::parse_format("%l3s").Error);
+static_assert(cbp::detail::parse_format("%rxd").Error);
+static_assert(cbp::detail::parse_format("%{name").Error);
+static_assert(cbp::detail::parse_format("%{}").Error);
+static_assert(cbp::detail::parse_format("%{a-b}").Error);
+static_assert(!cbp::detail::parse_format("%Js|%#Qs|%qls|%Jl2s").Error);
+static_assert(cbp::detail::parse_format("%Jd").Error);
+static_assert(cbp::detail::parse_format("%JS").Error);
+
+/* argument types that must be rejected at compile time */
+static_assert(cbp::detail::arg_matches<long long>(cbp::detail::CLASS_INT, 8));
+static_assert(!cbp::detail::arg_matches<long long>(cbp::detail::CLASS_INT, 4));
+static_assert(!cbp::detail::arg_matches<double>(cbp::detail::CLASS_INT, 4));
+static_assert(!cbp::detail::arg_matches<int>(cbp::detail::CLASS_FLOAT, 0));
+static_assert(!cbp::detail::arg_matches<const wchar_t *>(cbp::detail::CLASS_STRING, 1));
+static_assert(cbp::detail::arg_matches<std::u16string>(cbp::detail::CLASS_STRING, 2));
+#endif
+
+/* ------------------------------------------------------------------------- *\
+   main function
+\* ------------------------------------------------------------------------- */
+int main()
+{
+   int         bRet = 1;
+   char        buf[256];
+   std::string s("string");
+   std::string out;
+   size_t      ret;
+
+   ret = cbp::sprintf(buf, "%d|%u|%hhd|%lld|%#x|%c", -1, 7u, 300, -9000000000LL, 255u, 'c');
+   bRet &= check(__LINE__, "-1|7|44|-9000000000|0xff|c", buf, ret);
+
+   ret = cbp::sprintf(buf, "%.3f|%e|%g|%Lf|%d|%.1f", 3.14159, 1e-5, 0.5f, 1.5L, 2.9, 7);
+   bRet &= check(__LINE__, "3.142|1.000000e-05|0.5|1.500000|2|7.0", buf, ret);
+
+   ret = cbp::sprintf(buf, "%s|%-8s|%ls|%*d|%d", s, "ab", L"wide", 5, 42, blue);
+   bRet &= check(__LINE__, "string|ab      |wide|   42|2", buf, ret);
+
+   ret = cbp::sprintf(buf, "<%10@>|%v", cbp::nested("%s-%d", "n", 1), &vfunc, (void *) "user");
+   bRet &= check(__LINE__, "<       n-1>|user", buf, ret);
+
+   {  /* a copied nested format keeps its own arguments */
+      auto n1 = cbp::nested("%d-%s", 42, "abc");
+      auto n2 = n1;
+
+      n1  = cbp::nested("%d-%s", 7, "xyz");
+      ret = cbp::snprintf(buf, sizeof(buf), "[%16@]", n2);
+      bRet &= check(__LINE__, "[          42-abc]", buf, ret);
+   }
+
+   ret = cbp::snprintf(buf, 6, "%s", "truncated");
+   bRet &= (ret == 9) && check(__LINE__, "trunc", buf, 5);
+
+   ret = cbp::format_to([&](const char * ps, size_t n) { out.append(ps, n); }, "%s=%08.2f", "pi", 3.14159);
+   bRet &= check(__LINE__, "pi=00003.14", out.c_str(), ret);
+
+   /* appending to containers */
+   {
+      static cbp::size_hint hint;
+      std::vector<char>     v(2, '>');
+      std::string           big(1000, 'x');
+      std::string           line("log: ");
+
+      ret = cbp::format_append(line, "%s=%-5d|", "a", 1);
+      ret += cbp::format_append(line, hint, "%s|%.2f", big, 0.5);
+      bRet &= (ret == 1013) && (line.size() == 1018) && !line.compare(0, 14, "log: a=1    |x") && !line.compare(1010, 8, "xxx|0.50");
+
+      ret = cbp::format_append(line, hint, "%d", 7);
+      bRet &= (ret == 1) && (line.size() == 1019) && (line.back() == '7') && (hint.get() > 900);
+
+      ret = cbp::format_append(v, "%08.3f", 3.14159);
+      bRet &= (ret == 8) && check(__LINE__, ">>0003.142", std::string(v.begin(), v.end()).c_str(), v.size());
+
+      out = cbp::format("%s-%#x", "id", 255u);
+      bRet &= check(__LINE__, "id-0xff", out.c_str(), out.size());
+   }
+
+#if defined(__cpp_lib_memory_resource)
+   {
+      char                                buffer[512];
+      std::pmr::monotonic_buffer_resource mr(buffer, sizeof(buffer));
+      std::pmr::string                    ps(&mr);
+
+      ret = cbp::format_append(ps, "%s %5.1e", "pmr", 12345.0);
+      bRet &= check(__LINE__, "pmr 1.2e+04", ps.c_str(), ret);
+   }
+#endif
+
+#if (__cplusplus >= 202002L)
+   {
+      char span[8];
+
+      ret = cbp::format_to_span(span, "%s", "0123456789");
+      bRet &= (ret == 10) && !memcmp(span, "01234567", 8);
+
+      ret = cbp::format_to_span(std::span<char>(span, 4), cbp::fmt<"%d">, 42);
+      bRet &= (ret == 2) && !memcmp(span, "4223", 4);
+
+      for(int i = 0; i < 3; ++i)
+      {
+         out.clear();
+         ret = cbp::format_append(out, cbp::fmt<"%s:%d">, "line", i);
+         bRet &= check(__LINE__, (i == 2) ? "line:2" : (i == 1) ? "line:1" : "line:0", out.c_str(), ret);
+      }
+
+      bRet &= (cbp::format_hint<"%s:%d">.get() == 6);
+      bRet &= (cbp::format(cbp::fmt<"%s|%5s">, std::string("a"), "b") == "a|    b");
+   }
+
+   ret = cbp::sprintf(buf, cbp::fmt<"%d|%u|%hhd|%lld|%#x|%c|%%|%05.1f%%">, -1, 7u, 300, -9000000000LL, 255u, 'c', 99.44);
+   bRet &= check(__LINE__, "-1|7|44|-9000000000|0xff|c|%|099.4%", buf, ret);
+
+   ret = cbp::sprintf(buf, cbp::fmt<"%r*lu|%r2hhu|%-*.*e|%La|%+i|% d">, 36, 123456789ul, 255, -12, 3, 1234.5, 1.0L, 5, 5);
+   bRet &= check(__LINE__, "21i3v9|11111111|1.235e+03   |0x1.0000000000000000p+0|+5| 5", buf, ret);
+
+   ret = cbp::sprintf(buf, cbp::fmt<"%s|%-8s|%ls|%l2s|%.3s|%5c|%*d|%d|%p">, s, "ab", L"wide", u"u16", "abcdef", 'x', 5, 42, blue, (void *) 0);
+   bRet &= check(__LINE__, "string|ab      |wide|u16|abc|    x|   42|2|0000000000000000", buf, ret);
+
+   ret = cbp::sprintf(buf, cbp::fmt<"<%10@>|%v|%w32d|%I64u">, cbp::nested("%s-%d", "n", 1), &vfunc, (void *) "user", -7, 18446744073709551615ull);
+   bRet &= check(__LINE__, "<       n-1>|user|-7|18446744073709551615", buf, ret);
+
+   ret = cbp::snprintf(buf, 6, cbp::fmt<"%s%s">, "trun", "cated");
+   bRet &= (ret == 9) && check(__LINE__, "trunc", buf, 5);
+
+   out.clear();
+   ret = cbp::format_to([&](const char * ps, size_t n) { out.append(ps, n); }, cbp::fmt<"%s=%08.2f">, "pi", 3.14159);
+   bRet &= check(__LINE__, "pi=00003.14", out.c_str(), ret);
+
+   /* named formatters */
+   {
+      static const PRINTF_NAMED_FORMATTER nf[] = { { "cpp_str", &vfunc } };
+
+      callback_printf_register(nf, 1);
+      ret = cbp::sprintf(buf, cbp::fmt<"[%-6{cpp_str}]|[%*{cpp_str}]|%s">, (void *) "ab", 4, (void *) "cd", "x");
+      bRet &= check(__LINE__, "[ab    ]|[  cd]|x", buf, ret);
+      ret = cbp::sprintf(buf, "[%6{cpp_str}]", (void *) "ab");
+      bRet &= check(__LINE__, "[    ab]", buf, ret);
+      ret = cbp::sprintf(buf, cbp::fmt<"%{cpp_none}">, (void *) "ab");
+      bRet &= (ret == 0);
+   }
+
+   /* both front ends must agree */
+   {
+      char buf2[256];
+      size_t ret2 = cbp::sprintf(buf2, "%-+12.3e|%#o|%#X|%g|%10.4s|%lc", -0.000123, 8u, 48879u, 1e20, "truncate", L'w');
+      ret = cbp::sprintf(buf, cbp::fmt<"%-+12.3e|%#o|%#X|%g|%10.4s|%lc">, -0.000123, 8u, 48879u, 1e20, "truncate", L'w');
+      bRet &= check(__LINE__, buf2, buf, ret) && (ret == ret2);
+   }
+
+   /* escaped strings */
+   ret = cbp::sprintf(buf, cbp::fmt<"{\"k\":%#Js}|%Qs|[%-8qs]|%Jls">, std::string("a\"b\n"), "x,y", "a b", L"\t");
+   bRet &= check(__LINE__, "{\"k\":\"a\\\"b\\n\"}|\"x,y\"|['a b'   ]|\\t", buf, ret);
+#endif
+
+   if(bRet)
+      printf("All C++ tests passed!\n");
+   else
+      printf("C++ tests failed!\n");
+
+   return (bRet ? 0 : 1);
+} /* int main() */
+
+
+/* ========================================================================= *\
+   END OF FILE
+\* ========================================================================= */
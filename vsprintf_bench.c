@@ -72,21 +72,43 @@
 *                                                                             *
 \*****************************************************************************/
 
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* sched_setaffinity() of the GNU C library */
+#endif
+
 #include <stdio.h>
+#include <stdlib.h>
 #include <stddef.h>
 #include <signal.h>
 #include <float.h>
 #include <string.h>
 #include <inttypes.h>
+#include <errno.h>
+#include <time.h>
 
 #if defined (_WIN32) || defined (__CYGWIN__)
+#include <winsock2.h>
+#include <ws2tcpip.h>
 #include <windows.h>
 #else
 #include <sys/time.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <pthread.h>
+#endif
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <unistd.h>
+#include <arpa/inet.h>
 #endif
 
 #include <callback_printf.h>
 #include <sfprintf.h>
+#include <cbk_formats.h>
+#include <cbk_record.h>
 
 #if defined (_WIN32) || defined (__CYGWIN__)
 
@@ -149,326 +171,1034 @@ int64_t unix_time()
 #endif
 
 
-/* int test_vsprintf(const char * pout, const char * call, const char * pfmt, ...)  __PRINTF_LIKE_ARGS (3, 4); */
+/* ========================================================================= *\
+   Benchmark harness of test_vsprintf
+\* ========================================================================= */
 
-int test_vsprintf(const char * pout, const char * call, const char * pfmt, ...)
+#define BENCH_OUT_TEXT 0 /* readable text */
+#define BENCH_OUT_JSON 1 /* a JSON object per line */
+#define BENCH_OUT_CSV  2 /* comma separated values with a header line */
+
+#define BENCH_MAX_SAMPLES 1000 /* maximum number of samples of --repeat */
+
+typedef struct BENCH_OPTIONS_S BENCH_OPTIONS;
+struct BENCH_OPTIONS_S
 {
-    int bRet = 1;
-    size_t outlen = strlen(pout);
-    va_list VarArgs;
+   const char * pFilter; /* substring of the calls to run or NULL */
+   size_t       Samples; /* number of timed samples per function */
+   size_t       Batch;   /* calls per sample */
+   size_t       Warmup;  /* untimed calls in front of the samples */
+   int          Cpu;     /* CPU to run on or -1 */
+   int          Output;  /* BENCH_OUT_... */
+   int          Header;  /* the CSV header got printed */
+   int          Perf;    /* read the hardware performance counters */
+   long         Threads; /* maximum number of threads of --threads or 0 for the number of CPUs */
+};
 
-    char buf[0x8000];
-    char * pb = buf;
+static BENCH_OPTIONS bench_options = { NULL, 21, 1000, 2000, -1, BENCH_OUT_TEXT, 0, 0, 0 };
 
-    struct _result
-    {
-       const char * name; /* function name */
-       int64_t      ts;   /* start time */
-       int64_t      te;   /* end time */
-       char *       pb;   /* pointer to output buffer */
-       size_t       ret;  /* returned size */
-    } results[8];
-    struct _result * pr = results;
 
+/* ------------------------------------------------------------------------- *\
+   bench_clock returns a monotonic time in nanoseconds that isn't adjusted
+   by NTP and has the best resolution the system provides.
+\* ------------------------------------------------------------------------- */
 #if defined (_WIN32) || defined (__CYGWIN__)
-    size_t loops = vGetSystemTimePreciseAsFileTime ? 20000 : 200000;
-    size_t div   = vGetSystemTimePreciseAsFileTime ? 2 : 20;
+static int64_t bench_clock()
+{
+   static LARGE_INTEGER freq;
+   LARGE_INTEGER        now;
+
+   if(!freq.QuadPart)
+      QueryPerformanceFrequency(&freq);
+
+   QueryPerformanceCounter(&now);
+   return ((int64_t) ((double) now.QuadPart * 1e9 / (double) freq.QuadPart));
+} /* int64_t bench_clock() */
 #else
-    size_t loops = 20000;
-    size_t div   = 2;
+static int64_t bench_clock()
+{
+   struct timespec ts;
+
+#ifdef CLOCK_MONOTONIC_RAW
+   clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+   clock_gettime(CLOCK_MONOTONIC, &ts);
 #endif
 
-    size_t count = 0;
+   return ((int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec);
+} /* int64_t bench_clock() */
+#endif
 
-    memset(results, 0, sizeof(results));
-    memset(buf, 0xfefefefe,  sizeof(buf));
 
-    /* --------------------------------------------------------------------------- */
-    count = loops;
-    pr->name = "vsprintf";
-    pr->pb   = pb;
-    pr->ts   = unix_time();
-    while(count--)
-    {
-       va_start(VarArgs, pfmt);
-       pr->ret = vsprintf(pb, pfmt, VarArgs);
-       va_end(VarArgs);
-    }
-    pr->te   = unix_time();
-    pb += 1024;
-    pr++;
-
-    /* --------------------------------------------------------------------------- */
-    count = loops;
-    pr->name = "vsnprintf";
-    pr->pb   = pb;
-    pr->ts   = unix_time();
-    while(count--)
-    {
-       va_start(VarArgs, pfmt);
-       pr->ret = vsnprintf(pb, 1024, pfmt, VarArgs);
-       va_end(VarArgs);
-    }
-    pr->te   = unix_time();
-    pb += 1024;
-    pr++;
-
-    /* --------------------------------------------------------------------------- */
-    count = loops;
-    pr->name = "svsprintf";
-    pr->pb   = pb;
-    pr->ts   = unix_time();
-    while(count--)
-    {
-       va_start(VarArgs, pfmt);
-       pr->ret = svsprintf(pb, pfmt, VarArgs);
-       va_end(VarArgs);
-    }
-    pr->te   = unix_time();
-    pb += 1024;
-    pr++;
-
-    /* --------------------------------------------------------------------------- */
-    count = loops;
-    pr->name = "svsnprintf";
-    pr->pb   = pb;
-    pr->ts   = unix_time();
-    while(count--)
-    {
-       va_start(VarArgs, pfmt);
-       pr->ret = svsnprintf(pb, 1024, pfmt, VarArgs);
-       va_end(VarArgs);
-    }
-    pr->te   = unix_time();
-    pb += 1024;
-    pr++;
+/* ------------------------------------------------------------------------- *\
+   bench_pin_cpu binds the calling thread to a CPU for stable timings.
+\* ------------------------------------------------------------------------- */
+static int bench_pin_cpu(int Cpu)
+{
+#if defined (_WIN32) || defined (__CYGWIN__)
+   return ((Cpu >= 0) && (Cpu < 64) && SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) 1 << Cpu));
+#elif defined (__linux__)
+   cpu_set_t set;
 
-    /* --------------------------------------------------------------------------- */
+   CPU_ZERO(&set);
+   CPU_SET(Cpu, &set);
+   return (!sched_setaffinity(0, sizeof(set), &set));
+#else
+   return (0);
+#endif
+} /* int bench_pin_cpu(int Cpu) */
 
-    printf("Call : %s\n", call);
 
-    pr = results;
-    while(pr->name)
-    {
-       int64_t tm   = pr->te - pr->ts;
-       int     failed = (outlen != pr->ret) || strcmp(pout, pr->pb);
-       sfprintf(stdout, "%10s:  %3ld.%.4ldus %s \"%s\"\n", pr->name, (long) (tm / loops), (long) ((tm % loops + (div / 2)) / div), failed ? "!NOK!" : "  OK ", pr->pb);
-       if(failed)
-          bRet = 0;
-       ++pr;
-    }
+/* ------------------------------------------------------------------------- *\
+   Hardware performance counters of --perf. Every counter is opened on its
+   own for the calling thread and user space only, so a counter that the
+   CPU or a container doesn't provide is just reported as not available.
+\* ------------------------------------------------------------------------- */
+#define BENCH_COUNTERS 4 /* cycles, instructions, branch misses, L1d misses */
 
-    printf("\n");
-    return (bRet);
-} /* int test_vsprintf(...) */
+static const char * bench_counter_names[BENCH_COUNTERS] = { "cycles", "instructions", "branch_misses", "l1d_misses" };
 
+#ifdef __linux__
+static int bench_perf_fd[BENCH_COUNTERS] = { -1, -1, -1, -1 };
 
-int run_tests()
+static int bench_perf_open()
 {
-   int bRet = 1;
+   static const uint64_t config[BENCH_COUNTERS] =
+   {
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_BRANCH_MISSES,
+      PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+   };
+   int opened = 0;
+   int err    = 0;
+   int i;
 
-   uint32_t u_inf  = 0x7f800000;
-   uint32_t u_ninf = 0xff800000;
-   uint32_t u_nan  = 0x7fc00000;
-   uint32_t u_nnan = 0xffc00000;
+   for(i = 0; i < BENCH_COUNTERS; ++i)
+   {
+      struct perf_event_attr pea;
 
-   float inf;
-   float ninf;
-   float nan;
-   float nnan;
+      memset(&pea, 0, sizeof(pea));
+      pea.size           = sizeof(pea);
+      pea.type           = (i == 3) ? PERF_TYPE_HW_CACHE : PERF_TYPE_HARDWARE;
+      pea.config         = config[i];
+      pea.disabled       = 1;
+      pea.exclude_kernel = 1;
+      pea.exclude_hv     = 1;
+      pea.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
 
-   memcpy(&inf,  &u_inf,  4);
-   memcpy(&ninf, &u_ninf, 4);
-   memcpy(&nan,  &u_nan,  4);
-   memcpy(&nnan, &u_nnan, 4);
+      bench_perf_fd[i] = (int) syscall(SYS_perf_event_open, &pea, 0, -1, -1, 0);
+      if(bench_perf_fd[i] >= 0)
+         ++opened;
+      else if(!err)
+         err = errno;
+   }
 
+   if(!opened)
+      fprintf(stderr, "--perf: hardware counters are not available (%s), only the time gets measured\n", strerror(err));
 
-#define ARG(x)    ,x
+   return (opened);
+} /* int bench_perf_open() */
 
-#define TEST_VSPRINTF(pfmt, pout, val) bRet &= test_vsprintf(pout, #pfmt ", " #val " : " #pout , pfmt, val);
+static void bench_perf_start()
+{
+   int i;
 
-    TEST_VSPRINTF( "Hallo Welt!",   "Hallo Welt!",               0);
-    TEST_VSPRINTF( "%s",            "Hallo Welt!",              "Hallo Welt!");
-    TEST_VSPRINTF( "%.10s!",        "Hallo Welt!",               "Hallo Welt");
-    TEST_VSPRINTF( "%.*s!",         "Hallo Welt!",               (int) 10 ARG("Hallo Welt"));
-    TEST_VSPRINTF( "%.5s %.5s",     "Hallo Welt!",               "Hallo" ARG("Welt!"));
-    TEST_VSPRINTF( "%-6.5s%4.5s!",  "Hallo Welt!",               "Hallo" ARG("Welt"));
-    TEST_VSPRINTF( "%c%c%c%c%c %c%c%c%c!", "Hallo Welt!", 'H' ARG('a') ARG('l') ARG('l') ARG('o') ARG('W') ARG('e') ARG('l') ARG('t'));
-    TEST_VSPRINTF( "%02d/%02d/%04d %02d:%02d:%02d", "01/01/1970 23:59:59", 1 ARG(1) ARG(1970) ARG(23) ARG(59) ARG(59));
-    TEST_VSPRINTF( "%.2d/%.2d/%.4d %.2d:%.2d:%.2d", "01/01/1970 23:59:59", 1 ARG(1) ARG(1970) ARG(23) ARG(59) ARG(59));
-    TEST_VSPRINTF( "%+#23.15e",     " +1.000000000000000e-01",   (double) 1.0e-1 );
-    TEST_VSPRINTF( "%+#23.15e",     " +3.900000000000000e+00",   (double) 3.9 );
-    TEST_VSPRINTF( "%+#23.14e",     " +7.89456123000000e-307",   (double) 7.89456123e-307 );
-    TEST_VSPRINTF( "%+#23.14e",     " +7.89456123000000e+307",   (double) 7.89456123e+307 );
-    TEST_VSPRINTF( "%+#23.15e",     " +7.894561230000000e+08",   (double) 789456123.0 );
-    TEST_VSPRINTF( "%-#23.15e",     "7.894561230000000e+08  ",   (double) 789456123.0 );
-    TEST_VSPRINTF( "%#23.15e",      "  7.894561230000000e+08",   (double)789456123.0 );
-    TEST_VSPRINTF( "%#1.1g",        "8.e+08",                    (double) 789456123.0 );
-    TEST_VSPRINTF( "%+#23.15Le",    " +1.000000000000000e-01",   (long double) 1.0e-1l );
-    TEST_VSPRINTF( "%+#23.15Le",    " +3.900000000000000e+00",   (long double) 3.9l );
-    TEST_VSPRINTF( "%+#27.6e",    "             +1.594561e-317", (double) 1.59456123e-317 );
-    TEST_VSPRINTF( "%+#27.16e",    "   +1.5945612300000000e+308", (double) 1.59456123e+308 );
-#ifdef _WIN32
-    TEST_VSPRINTF( "%+#27.15Le",    "    +9.894561230000000e-307",(long double) 9.89456123e-307l );
-    TEST_VSPRINTF( "%+#27.15Le",    "    +9.894561230000000e+307",(long double) 9.89456123e+307l );
+   for(i = 0; i < BENCH_COUNTERS; ++i)
+   {
+      if(bench_perf_fd[i] >= 0)
+      {
+         ioctl(bench_perf_fd[i], PERF_EVENT_IOC_RESET, 0);
+         ioctl(bench_perf_fd[i], PERF_EVENT_IOC_ENABLE, 0);
+      }
+   }
+} /* void bench_perf_start() */
+
+/* bench_perf_stop stores the counters per call and -1 for unavailable ones */
+static void bench_perf_stop(double * pValues, size_t Calls)
+{
+   int i;
+
+   for(i = 0; i < BENCH_COUNTERS; ++i)
+   {
+      uint64_t v[3]; /* value, time enabled, time running */
+
+      pValues[i] = -1;
+
+      if(bench_perf_fd[i] < 0)
+         continue;
+
+      ioctl(bench_perf_fd[i], PERF_EVENT_IOC_DISABLE, 0);
+
+      if((read(bench_perf_fd[i], v, sizeof(v)) == (ssize_t) sizeof(v)) && v[2])
+         pValues[i] = (double) v[0] * ((double) v[1] / (double) v[2]) / (double) Calls; /* scaled if the counter got multiplexed */
+   }
+} /* void bench_perf_stop(double * pValues, size_t Calls) */
 #else
-    TEST_VSPRINTF( "%+#27.17Le",    " +7.89456123000000000e-4307",(long double) 7.89456123e-4307l );
-    TEST_VSPRINTF( "%+#27.17Le",    " +7.89456123000000000e+4307",(long double) 7.89456123e+4307l );
+static int bench_perf_open()
+{
+   fprintf(stderr, "--perf: hardware counters are only supported on Linux, only the time gets measured\n");
+   return (0);
+} /* int bench_perf_open() */
+
+static void bench_perf_start()
+{
+} /* void bench_perf_start() */
+
+static void bench_perf_stop(double * pValues, size_t Calls)
+{
+   int i;
+
+   for(i = 0; i < BENCH_COUNTERS; ++i)
+      pValues[i] = -1;
+} /* void bench_perf_stop(double * pValues, size_t Calls) */
 #endif
-    TEST_VSPRINTF( "%+#23.15Le",    " +7.894561230000000e+08",   (long double) 789456123.0l );
-    TEST_VSPRINTF( "%-#23.15Le",    "7.894561230000000e+08  ",   (long double) 789456123.0l );
-    TEST_VSPRINTF( "%#23.15Le",     "  7.894561230000000e+08",   (long double) 789456123.0l );
-    TEST_VSPRINTF( "%#1.1Lg",       "8.e+08",                    (long double) 789456123.0l );
-    TEST_VSPRINTF( "%lld",          "-8589934591",               (unsigned long long) ((unsigned long long)0xffffffff)*0xffffffff );
-    TEST_VSPRINTF( "%+8lld",        "    +100",                  (unsigned long long) 100 );
-    TEST_VSPRINTF( "%+.8lld",       "+00000100",                 (unsigned long long) 100 );
-    TEST_VSPRINTF( "%+10.8lld",     " +00000100",                (unsigned long long) 100 );
-    TEST_VSPRINTF( "%-1.5lld",      "-00100",                    (unsigned long long) -100 );
-    TEST_VSPRINTF( "%5lld",         "  100",                     (unsigned long long) 100 );
-    TEST_VSPRINTF( "%5lld",         " -100",                     (unsigned long long) -100 );
-    TEST_VSPRINTF( "%-5lld",        "100  ",                     (unsigned long long) 100 );
-    TEST_VSPRINTF( "%-5lld",        "-100 ",                     (unsigned long long) -100 );
-    TEST_VSPRINTF( "%-.5lld",       "00100",                     (unsigned long long) 100 );
-    TEST_VSPRINTF( "%-.5lld",       "-00100",                    (unsigned long long) -100 );
-    TEST_VSPRINTF( "%-8.5lld",      "00100   ",                  (unsigned long long) 100 );
-    TEST_VSPRINTF( "%-8.5lld",      "-00100  ",                  (unsigned long long) -100 );
-    TEST_VSPRINTF( "%05lld",        "00100",                     (unsigned long long) 100 );
-    TEST_VSPRINTF( "%05lld",        "-0100",                     (unsigned long long) -100 );
-    TEST_VSPRINTF( "% lld",         " 100",                      (unsigned long long) 100 );
-    TEST_VSPRINTF( "% lld",         "-100",                      (unsigned long long) -100 );
-    TEST_VSPRINTF( "% 5lld",        "  100",                     (unsigned long long)  100 );
-    TEST_VSPRINTF( "% 5lld",        " -100",                     (unsigned long long)  -100 );
-    TEST_VSPRINTF( "% .5lld",       " 00100",                    (unsigned long long) 100 );
-    TEST_VSPRINTF( "% .5lld",       "-00100",                    (unsigned long long) -100 );
-    TEST_VSPRINTF( "% 8.5lld",      "   00100",                  (unsigned long long) 100 );
-    TEST_VSPRINTF( "% 8.5lld",      "  -00100",                  (unsigned long long) -100 );
-    TEST_VSPRINTF( "%.0lld",        "",                          (unsigned long long) 0 );
-    TEST_VSPRINTF( "%8.0lld",       "        ",                  (unsigned long long) 0 );
-    TEST_VSPRINTF( "%08.0lld",      "        ",                  (unsigned long long) 0 );
-    TEST_VSPRINTF( "%#+21.18llx",   " 0x00ffffffffffffff9c",     (unsigned long long) -100 );
-    TEST_VSPRINTF( "%#.25llo",      "0001777777777777777777634", (unsigned long long) -100 );
-    TEST_VSPRINTF( "%#+24.20llo",   " 01777777777777777777634",  (unsigned long long) -100 );
-    TEST_VSPRINTF( "%#+18.21llX",   "0X00000FFFFFFFFFFFFFF9C",   (unsigned long long) -100 );
-    TEST_VSPRINTF( "%#+20.24llo",   "001777777777777777777634",  (unsigned long long) -100 );
-    TEST_VSPRINTF( "%#+25.22llu",   "   0018446744073709551615", (unsigned long long) -1 );
-    TEST_VSPRINTF( "%#+25.22llu",   "   0018446744073709551615", (unsigned long long) -1 );
-    TEST_VSPRINTF( "%#+30.25llu",   "     0000018446744073709551615", (unsigned long long) -1 );
-    TEST_VSPRINTF( "%+#25.22lld",   "  -0000000000000000000001", (unsigned long long) -1 );
-    TEST_VSPRINTF( "%#-8.5llo",     "00144   ",                  (unsigned long long) 100 );
-    TEST_VSPRINTF( "%#-+ 08.5lld",  "+00100  ",                  (unsigned long long) 100 );
-    TEST_VSPRINTF( "%.80lld",       "00000000000000000000000000000000000000000000000000000000000000000000000000000001",  (unsigned long long) 1 );
-    TEST_VSPRINTF( "% .80lld",      " 00000000000000000000000000000000000000000000000000000000000000000000000000000001", (unsigned long long) 1 );
-    TEST_VSPRINTF( "% .80d",        " 00000000000000000000000000000000000000000000000000000000000000000000000000000001", (int) 1 );
-    TEST_VSPRINTF( "%zx",           "1",              (size_t) 1 );
-    TEST_VSPRINTF( "%zx",           sizeof(size_t) > 4 ? "ffffffffffffffff" : "ffffffff", (size_t) -1 );
-    TEST_VSPRINTF( "%tx",           "1",              (ptrdiff_t) 1 );
-    TEST_VSPRINTF( "%tx",           sizeof(size_t) > 4 ? "8000000000000000" : "80000000", (ptrdiff_t) 1 << (sizeof(ptrdiff_t) * 8 - 1));
-    TEST_VSPRINTF( "% d",           " 1",             (int) 1 );
-    TEST_VSPRINTF( "%+ d",          "+1",             (int) 1 );
-    TEST_VSPRINTF( "%S",            "wide",           (wchar_t *) L"wide" );
-    TEST_VSPRINTF( "%04c",          "   1",           (int) '1' );
-    TEST_VSPRINTF( "%-04c",         "1   ",           (int) '1' );
-    TEST_VSPRINTF( "%#012x",        "0x0000000001",   (int) 1 );
-    TEST_VSPRINTF( "%#012x",        "000000000000",   (int) 0 );
-    TEST_VSPRINTF( "%#04.8x",       "0x00000001",     (int) 1 );
-    TEST_VSPRINTF( "%#04.8x",       "00000000",       (int) 0 );
-    TEST_VSPRINTF( "%#-08.2x",      "0x01    ",       (int) 1 );
-    TEST_VSPRINTF( "%#-08.2x",      "00      ",       (int) 0 );
-    TEST_VSPRINTF( "%#.0x",         "0x1",            (int) 1 );
-    TEST_VSPRINTF( "%#.0x",         "",               (int) 0 );
-    TEST_VSPRINTF( "%#08o",         "00000001",       (int) 1 );
-    TEST_VSPRINTF( "%#o",           "01",             (int) 1 );
-    TEST_VSPRINTF( "%#o",           "0",              (int) 0 );
-    TEST_VSPRINTF( "%04s",          " foo",           (char *) "foo" );
-    TEST_VSPRINTF( "%.1s",          "f",              (char *) "foo" );
-    TEST_VSPRINTF( "%.0s",          "",               (char *) "foo" );
-    TEST_VSPRINTF( "hello",         "hello",          0 );
-    TEST_VSPRINTF( "%b",            "101010",         (int) 42 );
-    TEST_VSPRINTF( "%#b",           "0b101010",       (int) 42 );
-    TEST_VSPRINTF( "%#B",           "0B101010",       (int) 42 );
-    TEST_VSPRINTF( "%3c",           "  a",            (int) 'a' );
-    TEST_VSPRINTF( "%-3c",          "a  ",            (int) 'a' );
-    TEST_VSPRINTF( "%3d",           "1234",           (int) 1234 );
-    TEST_VSPRINTF( "%-1d",          "2",              (int) 2 );
-    TEST_VSPRINTF( "%2.4f",         "8.6000",         (double) 8.6 );
-    TEST_VSPRINTF( "%0f",           "0.600000",       (double) 0.6 );
-    TEST_VSPRINTF( "%.0f",          "1",              (double) 0.6 );
-    TEST_VSPRINTF( "%2.4e",         "8.6000e+00",     (double) 8.6 );
-    TEST_VSPRINTF( "% 2.4e",        " 8.6000e+00",    (double) 8.6 );
-    TEST_VSPRINTF( "% 014.4e",      " 0008.6000e+00", (double) 8.6 );
-    TEST_VSPRINTF( "% 2.4e",        "-8.6000e+00",    (double)  -8.6 );
-    TEST_VSPRINTF( "%+2.4e",        "+8.6000e+00",    (double) 8.6 );
-    TEST_VSPRINTF( "%2.4g",         "8.6",            (double) 8.6 );
-    TEST_VSPRINTF( "%2.4Lf",        "8.6000",         (long double) 8.6 );
-    TEST_VSPRINTF( "%0Lf",          "0.600000",       (long double) 0.6 );
-    TEST_VSPRINTF( "%.0Lf",         "1",              (long double) 0.6 );
-    TEST_VSPRINTF( "%2.4Le",        "8.6000e+00",     (long double) 8.6 );
-    TEST_VSPRINTF( "% 2.4Le",       " 8.6000e+00",    (long double) 8.6 );
-    TEST_VSPRINTF( "% 014.4Le",     " 0008.6000e+00", (long double) 8.6 );
-    TEST_VSPRINTF( "% 2.4Le",       "-8.6000e+00",    (long double)  -8.6 );
-    TEST_VSPRINTF( "%+2.4Le",       "+8.6000e+00",    (long double) 8.6 );
-    TEST_VSPRINTF( "%2.4Lg",        "8.6",            (long double) 8.6 );
-    TEST_VSPRINTF( "%-i",           "-1",             (int) -1 );
-    TEST_VSPRINTF( "%-i",           "1",              (int) 1 );
-    TEST_VSPRINTF( "%+i",           "+1",             (int) 1 );
-    TEST_VSPRINTF( "%o",            "12",             (int) 10 );
- //   TEST_VSPRINTF( "%s",            "<NULL>",         (char *) NULL );
-    TEST_VSPRINTF( "%s",            "%%%%",           (char *) "%%%%" );
-    TEST_VSPRINTF( "%u",            "4294967295",     (int) -1 );
-    TEST_VSPRINTF( "%u",            "2147483648",     (unsigned int) 0x80000000 );
-    TEST_VSPRINTF( "%d",            "-2147483648",    (int) 0x80000000 );
-    TEST_VSPRINTF( "%jd",           "-1",             (intmax_t) -1 );
-    TEST_VSPRINTF( "%F",            "0.000000",       (double) 0 );
-    TEST_VSPRINTF( "x%cx",          "xXx",            (int) 0x100+'X' );
-    TEST_VSPRINTF( "%%0",           "%0",             0 );
-    TEST_VSPRINTF( "%%%%%%%%",      "%%%%",           0 );
-    TEST_VSPRINTF( "%%%%%d%%%%",    "%%42%%",         (int) 42 );
-    TEST_VSPRINTF( "%hx",           "2345",           (int) 0x12345 );
-    TEST_VSPRINTF( "%hhx",          "23",             (int) 0x123 );
-    TEST_VSPRINTF( "%hhx",          "45",             (int) 0x12345 );
-    TEST_VSPRINTF( "%c",            "a",              (int) 'a' );
-    TEST_VSPRINTF( "%c",            "\x82",           (int) 0xa082 );
-//    TEST_VSPRINTF( "%C",            "a",              (int) 'a' );
-//    TEST_VSPRINTF( "%C",            "\xe3\x81\x82" /*""*/, (int) 0x3042 );
-//    TEST_VSPRINTF( "%l4c",          "\xe3\x81\x82" /*""*/, (int) 0x3042 );
-//    TEST_VSPRINTF( "%l2c",          "\xe3\x81\x82" /*""*/, (int) 0x3042 );
-    TEST_VSPRINTF( "a%Cb",          "a\xe3\x81\x82" "b",   (int) 0x3042 );
-    TEST_VSPRINTF( "%lld",          "-8589934591",   (unsigned long long) ((unsigned long long)0xffffffff)*0xffffffff );
-    TEST_VSPRINTF( "%llu",          "18446744065119617025", (unsigned long long) ((unsigned long long)0xffffffff)*0xffffffff );
-    TEST_VSPRINTF( "%d",            "1",             (int) 1 );
-    TEST_VSPRINTF( "%.0f",          "-2",            (double) -1.5 );
-    TEST_VSPRINTF( "%.0f",          "-1",            (double) -0.5 );
-    TEST_VSPRINTF( "%.0f",          "1",             (double) 0.5 );
-    TEST_VSPRINTF( "%.0f",          "2",             (double) 1.5 );
 
-    TEST_VSPRINTF( "%.3e", "0.000e+00",    (double) 0.0 );
-    TEST_VSPRINTF( "%.3e", "5.000e+00",    (double) 5e-0 );
-    TEST_VSPRINTF( "%.3e", "5.000e+00",    (double) 5e+0 );
-    TEST_VSPRINTF( "%.3e", "5.000e-01",    (double) 5e-1 );
-    TEST_VSPRINTF( "%.3e", "5.000e+01",    (double) 5e+1 );
-    TEST_VSPRINTF( "%.3e", "5.000e-02",    (double) 5e-2 );
-    TEST_VSPRINTF( "%.3e", "5.000e+02",    (double) 5e+2 );
-    TEST_VSPRINTF( "%.3e", "5.000e-03",    (double) 5e-3 );
-    TEST_VSPRINTF( "%.3e", "5.000e+03",    (double) 5e+3 );
-    TEST_VSPRINTF( "%.3e", "9.995e+00",    (double) 9.995e-0 );
-    TEST_VSPRINTF( "%.3e", "9.995e+00",    (double) 9.995e+0 );
-    TEST_VSPRINTF( "%.3e", "9.995e-01",    (double) 9.995e-1 );
-    TEST_VSPRINTF( "%.3e", "9.995e+01",    (double) 9.995e+1 );
-    TEST_VSPRINTF( "%.3e", "9.995e-02",    (double) 9.995e-2 );
-    TEST_VSPRINTF( "%.3e", "9.995e+02",    (double) 9.995e+2 );
-    TEST_VSPRINTF( "%.3e", "1.000e+00",    (double)  1.0 );
-    TEST_VSPRINTF( "%.3e", "-1.000e+00",   (double) -1.0 );
-    TEST_VSPRINTF( "%.3e", "1.000e+01",    (double)  1e+1 );
-    TEST_VSPRINTF( "%.3e", "-1.000e-01",   (double) -1e-1 );
-    TEST_VSPRINTF( "%.3e", "-1.000e+01",   (double) -1e+1 );
-    TEST_VSPRINTF( "%.3e", "1.000e-01",    (double)  1e-1 );
-    TEST_VSPRINTF( "%.3e", "-1.000e-01",   (double) -1e-1 );
-    TEST_VSPRINTF( "%.3e", "1.000e+02",    (double)  1e+2 );
-    TEST_VSPRINTF( "%.3e", "1.000e-02",    (double)  1e-2 );
-    TEST_VSPRINTF( "%.3e", "1.000e+03",    (double)  1e+3 );
-    TEST_VSPRINTF( "%.3e", "1.000e-03",    (double)  1e-3 );
 
-    TEST_VSPRINTF( "%.3Le", "0.000e+00",   (long double) 0.0 );
+/* bench_compare_samples sorts samples ascending for qsort */
+static int bench_compare_samples(const void * pv1, const void * pv2)
+{
+   double d1 = *(const double *) pv1;
+   double d2 = *(const double *) pv2;
+
+   return ((d1 > d2) - (d1 < d2));
+} /* int bench_compare_samples(const void * pv1, const void * pv2) */
+
+
+/* ------------------------------------------------------------------------- *\
+   BENCH_STATS are the statistics of the samples of a function in ns per call
+\* ------------------------------------------------------------------------- */
+typedef struct BENCH_STATS_S BENCH_STATS;
+struct BENCH_STATS_S
+{
+   double Min;    /* fastest sample */
+   double Median; /* median of the samples */
+   double P99;    /* 99th percentile of the samples */
+   double Mean;   /* mean of the samples */
+   double Counter[BENCH_COUNTERS]; /* performance counters per call or -1 */
+};
+
+static void bench_stats(double * pSamples, size_t Count, BENCH_STATS * pStats)
+{
+   double sum = 0;
+   size_t i;
+
+   qsort(pSamples, Count, sizeof(double), &bench_compare_samples);
+
+   for(i = 0; i < Count; ++i)
+      sum += pSamples[i];
+
+   pStats->Min    = pSamples[0];
+   pStats->Median = (Count & 1) ? pSamples[Count / 2] : (pSamples[Count / 2 - 1] + pSamples[Count / 2]) / 2;
+   pStats->P99    = pSamples[(Count * 99 + 99) / 100 - 1];
+   pStats->Mean   = sum / (double) Count;
+} /* void bench_stats(double * pSamples, size_t Count, BENCH_STATS * pStats) */
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_report prints the result of a function in the selected format.
+\* ------------------------------------------------------------------------- */
+static void bench_report(const char * call, const char * name, const BENCH_STATS * pst, int ok, const char * pOut)
+{
+   char   buf[1024];
+   char * pb = buf;
+   int    i;
+
+   if(bench_options.Output == BENCH_OUT_JSON)
+   {
+      pb += _ssnprintf(pb, sizeof(buf) - 64, "{\"call\":%#Js,\"func\":\"%s\",\"samples\":%zu,\"batch\":%zu,\"min_ns\":%.2f,\"median_ns\":%.2f,\"p99_ns\":%.2f,\"mean_ns\":%.2f,\"ok\":%s",
+                       call, name, bench_options.Samples, bench_options.Batch, pst->Min, pst->Median, pst->P99, pst->Mean, ok ? "true" : "false");
+
+      for(i = 0; bench_options.Perf && (i < BENCH_COUNTERS); ++i)
+      {
+         if(pst->Counter[i] < 0)
+            pb += ssprintf(pb, ",\"%s\":null", bench_counter_names[i]);
+         else
+            pb += ssprintf(pb, ",\"%s\":%.2f", bench_counter_names[i], pst->Counter[i]);
+      }
+
+      ssprintf(pb, "}\n");
+      fputs(buf, stdout);
+   }
+   else if(bench_options.Output == BENCH_OUT_CSV)
+   {
+      if(!bench_options.Header)
+      {
+         fputs("call,func,samples,batch,min_ns,median_ns,p99_ns,mean_ns,ok", stdout);
+
+         for(i = 0; bench_options.Perf && (i < BENCH_COUNTERS); ++i)
+            printf(",%s", bench_counter_names[i]);
+
+         fputs("\n", stdout);
+         bench_options.Header = 1;
+      }
+
+      pb += _ssnprintf(pb, sizeof(buf) - 64, "%Qs,%s,%zu,%zu,%.2f,%.2f,%.2f,%.2f,%d",
+                       call, name, bench_options.Samples, bench_options.Batch, pst->Min, pst->Median, pst->P99, pst->Mean, ok);
+
+      for(i = 0; bench_options.Perf && (i < BENCH_COUNTERS); ++i)
+      {
+         if(pst->Counter[i] < 0)
+            pb += ssprintf(pb, ",");
+         else
+            pb += ssprintf(pb, ",%.2f", pst->Counter[i]);
+      }
+
+      ssprintf(pb, "\n");
+      fputs(buf, stdout);
+   }
+   else
+   {
+      sfprintf(stdout, "%10s: median %8.1fns  p99 %8.1fns  min %8.1fns %s \"%s\"\n", name, pst->Median, pst->P99, pst->Min, ok ? "  OK " : "!NOK!", pOut);
+
+      if(bench_options.Perf)
+      {
+         pb += ssprintf(pb, "%11s", "");
+
+         for(i = 0; i < BENCH_COUNTERS; ++i)
+         {
+            if(pst->Counter[i] < 0)
+               pb += ssprintf(pb, " %s n/a", bench_counter_names[i]);
+            else
+               pb += ssprintf(pb, " %s %.2f", bench_counter_names[i], pst->Counter[i]);
+         }
+
+         puts(buf);
+      }
+   }
+} /* void bench_report(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   the compared functions with the same signature
+\* ------------------------------------------------------------------------- */
+typedef size_t BENCH_VSPRINTF(char * pDst, size_t n, const char * pFmt, va_list val);
+
+static size_t bench_libc_vsprintf(char * pDst, size_t n, const char * pFmt, va_list val)
+{
+   return ((size_t) vsprintf(pDst, pFmt, val));
+} /* size_t bench_libc_vsprintf(char * pDst, size_t n, const char * pFmt, va_list val) */
+
+static size_t bench_libc_vsnprintf(char * pDst, size_t n, const char * pFmt, va_list val)
+{
+   return ((size_t) vsnprintf(pDst, n, pFmt, val));
+} /* size_t bench_libc_vsnprintf(char * pDst, size_t n, const char * pFmt, va_list val) */
+
+static size_t bench_svsprintf(char * pDst, size_t n, const char * pFmt, va_list val)
+{
+   return (svsprintf(pDst, pFmt, val));
+} /* size_t bench_svsprintf(char * pDst, size_t n, const char * pFmt, va_list val) */
+
+static const struct
+{
+   const char *     name;  /* function name */
+   BENCH_VSPRINTF * pfn;   /* function */
+   int              check; /* compared with a baseline relative to the reference function */
+} bench_functions[] =
+{
+   { "vsprintf",   &bench_libc_vsprintf,  0 },
+   { "vsnprintf",  &bench_libc_vsnprintf, 0 },
+   { "svsprintf",  &bench_svsprintf,      1 },
+   { "svsnprintf", &svsnprintf,           1 }
+};
+
+#define BENCH_REFERENCE 1 /* index of vsnprintf in bench_functions */
+
+
+/* ========================================================================= *\
+   Regression check against a baseline
+
+   A baseline is a file with a JSON object per line and function of a call:
+
+      {"call":"\"%d\", 5 : \"5\"","func":"svsprintf","ratio":0.5512,"median_ns":18.40}
+
+   ratio is the median of the function divided by the median of vsnprintf of
+   the same call. The ratio changes much less between machines, compilers and
+   CPU frequencies than the time itself, so a baseline that is checked in can
+   be compared on other machines too. An optional "tolerance":PCT overrides
+   the default tolerance of --tolerance for a noisy call. --write-baseline
+   writes the baseline of the run and keeps these tolerances of the loaded
+   baseline, regressions don't fail the run then. Calls that appear several
+   times are matched in the order of their occurrence. Only the wrong outputs
+   of svsprintf and svsnprintf fail a run with a baseline because the output
+   of the C library differs between its versions.
+\* ========================================================================= */
+
+#define BENCH_BASELINE_LINE      4096 /* maximum length of a line of a baseline */
+#define BENCH_BASELINE_TOLERANCE 30.0 /* default tolerance in percent */
+#define BENCH_BASELINE_SLACK_NS  2.0  /* smaller differences are ignored as timer noise */
+#define BENCH_BASELINE_RETRIES   3    /* measurements of a ratio that looks slower */
+
+#define BENCH_CASE_SAME   0 /* within the tolerance */
+#define BENCH_CASE_SLOWER 1 /* regression beyond the tolerance */
+#define BENCH_CASE_FASTER 2 /* improvement beyond the tolerance */
+#define BENCH_CASE_NEW    3 /* not in the baseline */
+#define BENCH_CASE_WRONG  4 /* wrong output */
+
+typedef struct BENCH_CASE_S BENCH_CASE;
+struct BENCH_CASE_S
+{
+   char *       pCall;     /* JSON string of the call including the quotes */
+   const char * pRun;      /* call of the run or NULL if it didn't run */
+   char         Func[16];  /* function name */
+   double       Ratio;     /* median relative to vsnprintf in the baseline */
+   double       Median;    /* median in ns in the baseline */
+   double       Tolerance; /* tolerance in percent or a negative value for the default */
+   double       Current;   /* median relative to vsnprintf in the run */
+   int          Result;    /* BENCH_CASE_... */
+};
+
+typedef struct BENCH_BASELINE_S BENCH_BASELINE;
+struct BENCH_BASELINE_S
+{
+   const char * pName;     /* file name of --baseline or NULL */
+   const char * pOutName;  /* file name of --write-baseline or NULL */
+   FILE *       pfOut;     /* file of --write-baseline */
+   double       Tolerance; /* default tolerance in percent */
+   BENCH_CASE * pCases;    /* cases of the baseline followed by the new ones */
+   size_t       Count;     /* number of cases */
+   size_t       Size;      /* allocated number of cases */
+};
+
+static BENCH_BASELINE bench_baseline = { NULL, NULL, NULL, BENCH_BASELINE_TOLERANCE, NULL, 0, 0 };
+
+
+/* bench_json_string returns the end of the JSON string at ps or NULL */
+static const char * bench_json_string(const char * ps)
+{
+   if(*ps++ != '"')
+      return (NULL);
+
+   while(*ps && (*ps != '"'))
+   {
+      if((*ps == '\\') && ps[1])
+         ++ps;
+      ++ps;
+   }
+
+   return (*ps ? ps + 1 : NULL);
+} /* const char * bench_json_string(const char * ps) */
+
+
+/* bench_json_number reads the number of a field behind pStart or returns 0 */
+static int bench_json_number(const char * pStart, const char * pField, double * pValue)
+{
+   const char * ps = strstr(pStart, pField);
+   char *       pe;
+
+   if(!ps)
+      return (0);
+
+   ps += strlen(pField);
+   *pValue = strtod(ps, &pe);
+   return (pe != ps);
+} /* int bench_json_number(const char * pStart, const char * pField, double * pValue) */
+
+
+/* bench_baseline_add appends a case and returns it or NULL */
+static BENCH_CASE * bench_baseline_add(const char * pCall, size_t len, const char * pFunc, size_t flen)
+{
+   BENCH_BASELINE * pb = &bench_baseline;
+   BENCH_CASE *     pc;
+
+   if(pb->Count == pb->Size)
+   {
+      size_t       size = pb->Size ? 2 * pb->Size : 1024;
+      BENCH_CASE * pn   = (BENCH_CASE *) realloc(pb->pCases, size * sizeof(BENCH_CASE));
+
+      if(!pn)
+         return (NULL);
+
+      pb->pCases = pn;
+      pb->Size   = size;
+   }
+
+   pc = &pb->pCases[pb->Count];
+   memset(pc, 0, sizeof(*pc));
+
+   if((flen >= sizeof(pc->Func)) || !(pc->pCall = (char *) malloc(len + 1)))
+      return (NULL);
+
+   memcpy(pc->pCall, pCall, len);
+   pc->pCall[len] = '\0';
+   memcpy(pc->Func, pFunc, flen);
+   pc->Tolerance = -1;
+   ++pb->Count;
+
+   return (pc);
+} /* BENCH_CASE * bench_baseline_add(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_baseline_load reads the baseline of --baseline. Lines that are
+   empty or don't start with {"call": are ignored.
+\* ------------------------------------------------------------------------- */
+static int bench_baseline_load(const char * pName)
+{
+   FILE * pf    = fopen(pName, "r");
+   char * pLine = (char *) malloc(BENCH_BASELINE_LINE);
+   size_t line  = 0;
+   int    bRet  = 0;
+
+   if(!pf || !pLine)
+   {
+      fprintf(stderr, "%s: %s\n", pName, strerror(errno));
+      goto Exit;
+   }
+
+   while(fgets(pLine, BENCH_BASELINE_LINE, pf))
+   {
+      const char * pCall = pLine + 8;
+      const char * pce;
+      const char * pFunc;
+      const char * pfe;
+      BENCH_CASE * pc;
+
+      ++line;
+
+      if(strncmp(pLine, "{\"call\":", 8))
+         continue;
+
+      pce = bench_json_string(pCall);
+      if(!pce || strncmp(pce, ",\"func\":", 8) || !(pfe = bench_json_string(pFunc = pce + 8)))
+      {
+         fprintf(stderr, "%s:%zu: invalid call or func\n", pName, line);
+         goto Exit;
+      }
+
+      pc = bench_baseline_add(pCall, (size_t) (pce - pCall), pFunc + 1, (size_t) (pfe - pFunc - 2));
+      if(!pc)
+      {
+         fprintf(stderr, "%s:%zu: invalid func or out of memory\n", pName, line);
+         goto Exit;
+      }
+
+      if(!bench_json_number(pfe, "\"ratio\":", &pc->Ratio) || (pc->Ratio <= 0))
+      {
+         fprintf(stderr, "%s:%zu: invalid ratio\n", pName, line);
+         goto Exit;
+      }
+
+      bench_json_number(pfe, "\"median_ns\":", &pc->Median);
+      bench_json_number(pfe, "\"tolerance\":", &pc->Tolerance);
+   }
+
+   bRet = 1;
+
+   Exit:;
+   if(pf)
+      fclose(pf);
+
+   free(pLine);
+   return (bRet);
+} /* int bench_baseline_load(const char * pName) */
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_baseline_case returns the case of a call and a function in the
+   baseline or a new case if the baseline doesn't have it.
+\* ------------------------------------------------------------------------- */
+static BENCH_CASE * bench_baseline_case(const char * call, const char * name)
+{
+   BENCH_BASELINE * pb = &bench_baseline;
+   BENCH_CASE *     pc;
+   char             buf[1024];
+   size_t           len;
+   size_t           i;
+
+   len = _ssnprintf(buf, sizeof(buf), "%#Js", call);
+
+   for(i = 0; i < pb->Count; ++i)
+   {
+      pc = &pb->pCases[i];
+      if(!pc->pRun && !strcmp(pc->Func, name) && !strcmp(pc->pCall, buf))
+         return (pc);
+   }
+
+   pc = bench_baseline_add(buf, len, name, strlen(name));
+   if(pc)
+      pc->Result = BENCH_CASE_NEW;
+
+   return (pc);
+} /* BENCH_CASE * bench_baseline_case(const char * call, const char * name) */
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_baseline_compare compares the ratio of a run with the baseline and
+   returns BENCH_CASE_SAME, _SLOWER, _FASTER or _NEW. A ratio is only slower
+   or faster if it differs by more than the tolerance and the difference is
+   more than BENCH_BASELINE_SLACK_NS at the speed of the run.
+\* ------------------------------------------------------------------------- */
+static int bench_baseline_compare(const BENCH_CASE * pc, double Ratio, double Median)
+{
+   double tol;
+   double delta;
+
+   if(pc->Result == BENCH_CASE_NEW)
+      return (BENCH_CASE_NEW);
+
+   tol   = 1 + ((pc->Tolerance >= 0) ? pc->Tolerance : bench_baseline.Tolerance) / 100;
+   delta = Median - Median * pc->Ratio / Ratio;
+
+   if((Ratio > pc->Ratio * tol) && (delta > BENCH_BASELINE_SLACK_NS))
+      return (BENCH_CASE_SLOWER);
+
+   if((Ratio < pc->Ratio / tol) && (-delta > BENCH_BASELINE_SLACK_NS))
+      return (BENCH_CASE_FASTER);
+
+   return (BENCH_CASE_SAME);
+} /* int bench_baseline_compare(const BENCH_CASE * pc, double Ratio, double Median) */
+
+
+/* bench_baseline_write writes a line of a baseline */
+static void bench_baseline_write(FILE * pf, const BENCH_CASE * pc, double Ratio, double Median)
+{
+   fprintf(pf, "{\"call\":%s,\"func\":\"%s\",\"ratio\":%.4f,\"median_ns\":%.2f", pc->pCall, pc->Func, Ratio, Median);
+
+   if(pc->Tolerance >= 0)
+      fprintf(pf, ",\"tolerance\":%g", pc->Tolerance);
+
+   fputs("}\n", pf);
+} /* void bench_baseline_write(FILE * pf, const BENCH_CASE * pc, double Ratio, double Median) */
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_baseline_result stores the result of a case and writes it to the
+   new baseline of --write-baseline.
+\* ------------------------------------------------------------------------- */
+static void bench_baseline_result(BENCH_CASE * pc, const char * call, double Ratio, double Median, int ok)
+{
+   BENCH_BASELINE * pb = &bench_baseline;
+
+   pc->pRun    = call;
+   pc->Current = Ratio;
+   pc->Result  = ok ? bench_baseline_compare(pc, Ratio, Median) : BENCH_CASE_WRONG;
+
+   if(ok && pb->pfOut)
+      bench_baseline_write(pb->pfOut, pc, Ratio, Median);
+} /* void bench_baseline_result(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_baseline_report prints the calls that are slower or faster than the
+   tolerance allows, the new ones and the ones with a wrong output to stderr
+   and returns 0 on wrong outputs or on regressions unless a new baseline
+   gets written. It completes and closes the file of --write-baseline.
+\* ------------------------------------------------------------------------- */
+static int bench_baseline_report()
+{
+   BENCH_BASELINE * pb      = &bench_baseline;
+   size_t           count[5] = { 0, 0, 0, 0, 0 };
+   size_t           missing  = 0;
+   int              r;
+   size_t           i;
+
+   for(i = 0; i < pb->Count; ++i)
+   {
+      if(pb->pCases[i].pRun)
+         ++count[pb->pCases[i].Result];
+      else if(pb->pName)
+         ++missing;
+   }
+
+   for(r = BENCH_CASE_SLOWER; r <= BENCH_CASE_WRONG; ++r)
+   {
+      if(!count[r] || ((r == BENCH_CASE_NEW) && !pb->pName))
+         continue;
+
+      if(r == BENCH_CASE_SLOWER)
+         fprintf(stderr, "\nslower than %s (median relative to vsnprintf):\n", pb->pName);
+      else if(r == BENCH_CASE_FASTER)
+         fprintf(stderr, "\nfaster than %s, consider updating the baseline:\n", pb->pName);
+      else if(r == BENCH_CASE_NEW)
+         fprintf(stderr, "\nnot in %s:\n", pb->pName);
+      else
+         fprintf(stderr, "\nwrong output:\n");
+
+      fprintf(stderr, "   %-10s %9s %9s %8s %6s  %s\n", "func", "baseline", "current", "change", "limit", "call");
+
+      for(i = 0; i < pb->Count; ++i)
+      {
+         const BENCH_CASE * pc = &pb->pCases[i];
+
+         if(!pc->pRun || (pc->Result != r))
+            continue;
+
+         if((r == BENCH_CASE_NEW) || (r == BENCH_CASE_WRONG))
+            fprintf(stderr, "   %-10s %9s %9.4f %8s %6s  %s\n", pc->Func, "-", pc->Current, "-", "-", pc->pRun);
+         else
+            fprintf(stderr, "   %-10s %9.4f %9.4f %+7.1f%% %5.0f%%  %s\n", pc->Func, pc->Ratio, pc->Current,
+                    100.0 * (pc->Current - pc->Ratio) / pc->Ratio, (pc->Tolerance >= 0) ? pc->Tolerance : pb->Tolerance, pc->pRun);
+      }
+   }
+
+   if(pb->pName)
+      fprintf(stderr, "\n%zu cases compared with %s: %zu within %.0f%%, %zu slower, %zu faster, %zu new, %zu wrong, %zu not run\n",
+              count[0] + count[1] + count[2], pb->pName, count[0], pb->Tolerance, count[1], count[2], count[3], count[4], missing);
+
+   for(i = 0; i < pb->Count; ++i)
+   {
+      const BENCH_CASE * pc = &pb->pCases[i];
+
+      /* cases that didn't run because of --filter are kept */
+      if(pb->pfOut && !pc->pRun)
+         bench_baseline_write(pb->pfOut, pc, pc->Ratio, pc->Median);
+
+      free(pc->pCall);
+   }
+
+   if(pb->pfOut)
+      fclose(pb->pfOut);
+
+   free(pb->pCases);
+   pb->pCases = NULL;
+   pb->pfOut  = NULL;
+   pb->Count  = pb->Size = 0;
+
+   return (!count[BENCH_CASE_WRONG] && (pb->pOutName || !count[BENCH_CASE_SLOWER]));
+} /* int bench_baseline_report() */
+
+
+/* ------------------------------------------------------------------------- *\
+   test_vsprintf times a format with vsprintf, vsnprintf, svsprintf and
+   svsnprintf. Every function gets warmed up first and is then timed by
+   samples of a batch of calls. The median, the 99th percentile and the
+   minimum of the samples are reported because a mean of a single loop is
+   too noisy for detecting small regressions.
+\* ------------------------------------------------------------------------- */
+
+/* int test_vsprintf(const char * pout, const char * call, const char * pfmt, ...)  __PRINTF_LIKE_ARGS (3, 4); */
+
+int test_vsprintf(const char * pout, const char * call, const char * pfmt, ...)
+{
+    int         bRet   = 1;
+    size_t      outlen = strlen(pout);
+    va_list     VarArgs;
+    char        buf[1024];
+    double      samples[BENCH_MAX_SAMPLES];
+    BENCH_STATS st;
+    BENCH_STATS rs;
+    size_t      f;
+
+    if(bench_options.pFilter && !strstr(call, bench_options.pFilter))
+       return (1);
+
+    if(bench_options.Output == BENCH_OUT_TEXT)
+       printf("Call : %s\n", call);
+
+    for(f = 0; f < sizeof(bench_functions) / sizeof(bench_functions[0]); ++f)
+    {
+       BENCH_VSPRINTF * pfn = bench_functions[f].pfn;
+       size_t           ret = 0;
+       size_t           count;
+       size_t           s;
+       int              ok;
+
+       memset(buf, 0xfe, sizeof(buf));
+
+       count = bench_options.Warmup;
+       while(count--)
+       {
+          va_start(VarArgs, pfmt);
+          pfn(buf, sizeof(buf), pfmt, VarArgs);
+          va_end(VarArgs);
+       }
+
+       if(bench_options.Perf)
+          bench_perf_start();
+
+       for(s = 0; s < bench_options.Samples; ++s)
+       {
+          int64_t ts, te;
+
+          count = bench_options.Batch;
+          ts    = bench_clock();
+          while(count--)
+          {
+             va_start(VarArgs, pfmt);
+             ret = pfn(buf, sizeof(buf), pfmt, VarArgs);
+             va_end(VarArgs);
+          }
+          te    = bench_clock();
+
+          samples[s] = (double) (te - ts) / (double) bench_options.Batch;
+       }
+
+       bench_perf_stop(st.Counter, bench_options.Samples * bench_options.Batch);
+       bench_stats(samples, bench_options.Samples, &st);
+
+       ok = (outlen == ret) && !strcmp(pout, buf);
+       if(!ok)
+          bRet = 0;
+
+       bench_report(call, bench_functions[f].name, &st, ok, buf);
+
+       if(bench_functions[f].check && (bench_baseline.pName || bench_baseline.pfOut))
+       {
+          BENCH_CASE * pc    = bench_baseline_case(call, bench_functions[f].name);
+          double       ratio = 0;
+          int          retry;
+
+          /* the reference and the function are timed alternately and a slower
+             ratio is measured again for telling a regression from noise */
+          for(retry = 0; pc && (retry < BENCH_BASELINE_RETRIES); ++retry)
+          {
+             for(s = 0; s < bench_options.Samples; ++s)
+             {
+                BENCH_VSPRINTF * pfr = bench_functions[BENCH_REFERENCE].pfn;
+                double           tr;
+                int64_t          ts, te;
+
+                count = bench_options.Batch;
+                ts    = bench_clock();
+                while(count--)
+                {
+                   va_start(VarArgs, pfmt);
+                   pfr(buf, sizeof(buf), pfmt, VarArgs);
+                   va_end(VarArgs);
+                }
+                te    = bench_clock();
+                tr    = (double) (te - ts);
+
+                count = bench_options.Batch;
+                ts    = bench_clock();
+                while(count--)
+                {
+                   va_start(VarArgs, pfmt);
+                   pfn(buf, sizeof(buf), pfmt, VarArgs);
+                   va_end(VarArgs);
+                }
+                te    = bench_clock();
+
+                samples[s] = (tr > 0) ? (double) (te - ts) / tr : 1;
+             }
+
+             bench_stats(samples, bench_options.Samples, &rs);
+             if(!retry || (rs.Median < ratio))
+                ratio = rs.Median;
+
+             if(bench_baseline_compare(pc, ratio, st.Median) != BENCH_CASE_SLOWER)
+                break;
+          }
+
+          if(pc)
+             bench_baseline_result(pc, call, ratio, st.Median, ok);
+       }
+    }
+
+    if(bench_options.Output == BENCH_OUT_TEXT)
+       printf("\n");
+
+    return (bRet);
+} /* int test_vsprintf(...) */
+
+
+int run_tests()
+{
+   int bRet = 1;
+
+   uint32_t u_inf  = 0x7f800000;
+   uint32_t u_ninf = 0xff800000;
+   uint32_t u_nan  = 0x7fc00000;
+   uint32_t u_nnan = 0xffc00000;
+
+   float inf;
+   float ninf;
+   float nan;
+   float nnan;
+
+   memcpy(&inf,  &u_inf,  4);
+   memcpy(&ninf, &u_ninf, 4);
+   memcpy(&nan,  &u_nan,  4);
+   memcpy(&nnan, &u_nnan, 4);
+
+
+#define ARG(x)    ,x
+
+#define TEST_VSPRINTF(pfmt, pout, val) bRet &= test_vsprintf(pout, #pfmt ", " #val " : " #pout , pfmt, val);
+
+    TEST_VSPRINTF( "Hallo Welt!",   "Hallo Welt!",               0);
+    TEST_VSPRINTF( "%s",            "Hallo Welt!",              "Hallo Welt!");
+    TEST_VSPRINTF( "%.10s!",        "Hallo Welt!",               "Hallo Welt");
+    TEST_VSPRINTF( "%.*s!",         "Hallo Welt!",               (int) 10 ARG("Hallo Welt"));
+    TEST_VSPRINTF( "%.5s %.5s",     "Hallo Welt!",               "Hallo" ARG("Welt!"));
+    TEST_VSPRINTF( "%-6.5s%4.5s!",  "Hallo Welt!",               "Hallo" ARG("Welt"));
+    TEST_VSPRINTF( "%c%c%c%c%c %c%c%c%c!", "Hallo Welt!", 'H' ARG('a') ARG('l') ARG('l') ARG('o') ARG('W') ARG('e') ARG('l') ARG('t'));
+    TEST_VSPRINTF( "%02d/%02d/%04d %02d:%02d:%02d", "01/01/1970 23:59:59", 1 ARG(1) ARG(1970) ARG(23) ARG(59) ARG(59));
+    TEST_VSPRINTF( "%.2d/%.2d/%.4d %.2d:%.2d:%.2d", "01/01/1970 23:59:59", 1 ARG(1) ARG(1970) ARG(23) ARG(59) ARG(59));
+    TEST_VSPRINTF( "%+#23.15e",     " +1.000000000000000e-01",   (double) 1.0e-1 );
+    TEST_VSPRINTF( "%+#23.15e",     " +3.900000000000000e+00",   (double) 3.9 );
+    TEST_VSPRINTF( "%+#23.14e",     " +7.89456123000000e-307",   (double) 7.89456123e-307 );
+    TEST_VSPRINTF( "%+#23.14e",     " +7.89456123000000e+307",   (double) 7.89456123e+307 );
+    TEST_VSPRINTF( "%+#23.15e",     " +7.894561230000000e+08",   (double) 789456123.0 );
+    TEST_VSPRINTF( "%-#23.15e",     "7.894561230000000e+08  ",   (double) 789456123.0 );
+    TEST_VSPRINTF( "%#23.15e",      "  7.894561230000000e+08",   (double)789456123.0 );
+    TEST_VSPRINTF( "%#1.1g",        "8.e+08",                    (double) 789456123.0 );
+    TEST_VSPRINTF( "%+#23.15Le",    " +1.000000000000000e-01",   (long double) 1.0e-1l );
+    TEST_VSPRINTF( "%+#23.15Le",    " +3.900000000000000e+00",   (long double) 3.9l );
+    TEST_VSPRINTF( "%+#27.6e",    "             +1.594561e-317", (double) 1.59456123e-317 );
+    TEST_VSPRINTF( "%+#27.16e",    "   +1.5945612300000000e+308", (double) 1.59456123e+308 );
+#ifdef _WIN32
+    TEST_VSPRINTF( "%+#27.15Le",    "    +9.894561230000000e-307",(long double) 9.89456123e-307l );
+    TEST_VSPRINTF( "%+#27.15Le",    "    +9.894561230000000e+307",(long double) 9.89456123e+307l );
+#else
+    TEST_VSPRINTF( "%+#27.17Le",    " +7.89456123000000000e-4307",(long double) 7.89456123e-4307l );
+    TEST_VSPRINTF( "%+#27.17Le",    " +7.89456123000000000e+4307",(long double) 7.89456123e+4307l );
+#endif
+    TEST_VSPRINTF( "%+#23.15Le",    " +7.894561230000000e+08",   (long double) 789456123.0l );
+    TEST_VSPRINTF( "%-#23.15Le",    "7.894561230000000e+08  ",   (long double) 789456123.0l );
+    TEST_VSPRINTF( "%#23.15Le",     "  7.894561230000000e+08",   (long double) 789456123.0l );
+    TEST_VSPRINTF( "%#1.1Lg",       "8.e+08",                    (long double) 789456123.0l );
+    TEST_VSPRINTF( "%lld",          "-8589934591",               (unsigned long long) ((unsigned long long)0xffffffff)*0xffffffff );
+    TEST_VSPRINTF( "%+8lld",        "    +100",                  (unsigned long long) 100 );
+    TEST_VSPRINTF( "%+.8lld",       "+00000100",                 (unsigned long long) 100 );
+    TEST_VSPRINTF( "%+10.8lld",     " +00000100",                (unsigned long long) 100 );
+    TEST_VSPRINTF( "%-1.5lld",      "-00100",                    (unsigned long long) -100 );
+    TEST_VSPRINTF( "%5lld",         "  100",                     (unsigned long long) 100 );
+    TEST_VSPRINTF( "%5lld",         " -100",                     (unsigned long long) -100 );
+    TEST_VSPRINTF( "%-5lld",        "100  ",                     (unsigned long long) 100 );
+    TEST_VSPRINTF( "%-5lld",        "-100 ",                     (unsigned long long) -100 );
+    TEST_VSPRINTF( "%-.5lld",       "00100",                     (unsigned long long) 100 );
+    TEST_VSPRINTF( "%-.5lld",       "-00100",                    (unsigned long long) -100 );
+    TEST_VSPRINTF( "%-8.5lld",      "00100   ",                  (unsigned long long) 100 );
+    TEST_VSPRINTF( "%-8.5lld",      "-00100  ",                  (unsigned long long) -100 );
+    TEST_VSPRINTF( "%05lld",        "00100",                     (unsigned long long) 100 );
+    TEST_VSPRINTF( "%05lld",        "-0100",                     (unsigned long long) -100 );
+    TEST_VSPRINTF( "% lld",         " 100",                      (unsigned long long) 100 );
+    TEST_VSPRINTF( "% lld",         "-100",                      (unsigned long long) -100 );
+    TEST_VSPRINTF( "% 5lld",        "  100",                     (unsigned long long)  100 );
+    TEST_VSPRINTF( "% 5lld",        " -100",                     (unsigned long long)  -100 );
+    TEST_VSPRINTF( "% .5lld",       " 00100",                    (unsigned long long) 100 );
+    TEST_VSPRINTF( "% .5lld",       "-00100",                    (unsigned long long) -100 );
+    TEST_VSPRINTF( "% 8.5lld",      "   00100",                  (unsigned long long) 100 );
+    TEST_VSPRINTF( "% 8.5lld",      "  -00100",                  (unsigned long long) -100 );
+    TEST_VSPRINTF( "%.0lld",        "",                          (unsigned long long) 0 );
+    TEST_VSPRINTF( "%8.0lld",       "        ",                  (unsigned long long) 0 );
+    TEST_VSPRINTF( "%08.0lld",      "        ",                  (unsigned long long) 0 );
+    TEST_VSPRINTF( "%#+21.18llx",   " 0x00ffffffffffffff9c",     (unsigned long long) -100 );
+    TEST_VSPRINTF( "%#.25llo",      "0001777777777777777777634", (unsigned long long) -100 );
+    TEST_VSPRINTF( "%#+24.20llo",   " 01777777777777777777634",  (unsigned long long) -100 );
+    TEST_VSPRINTF( "%#+18.21llX",   "0X00000FFFFFFFFFFFFFF9C",   (unsigned long long) -100 );
+    TEST_VSPRINTF( "%#+20.24llo",   "001777777777777777777634",  (unsigned long long) -100 );
+    TEST_VSPRINTF( "%#+25.22llu",   "   0018446744073709551615", (unsigned long long) -1 );
+    TEST_VSPRINTF( "%#+25.22llu",   "   0018446744073709551615", (unsigned long long) -1 );
+    TEST_VSPRINTF( "%#+30.25llu",   "     0000018446744073709551615", (unsigned long long) -1 );
+    TEST_VSPRINTF( "%+#25.22lld",   "  -0000000000000000000001", (unsigned long long) -1 );
+    TEST_VSPRINTF( "%#-8.5llo",     "00144   ",                  (unsigned long long) 100 );
+    TEST_VSPRINTF( "%#-+ 08.5lld",  "+00100  ",                  (unsigned long long) 100 );
+    TEST_VSPRINTF( "%.80lld",       "00000000000000000000000000000000000000000000000000000000000000000000000000000001",  (unsigned long long) 1 );
+    TEST_VSPRINTF( "% .80lld",      " 00000000000000000000000000000000000000000000000000000000000000000000000000000001", (unsigned long long) 1 );
+    TEST_VSPRINTF( "% .80d",        " 00000000000000000000000000000000000000000000000000000000000000000000000000000001", (int) 1 );
+    TEST_VSPRINTF( "%zx",           "1",              (size_t) 1 );
+    TEST_VSPRINTF( "%zx",           sizeof(size_t) > 4 ? "ffffffffffffffff" : "ffffffff", (size_t) -1 );
+    TEST_VSPRINTF( "%tx",           "1",              (ptrdiff_t) 1 );
+    TEST_VSPRINTF( "%tx",           sizeof(size_t) > 4 ? "8000000000000000" : "80000000", (ptrdiff_t) 1 << (sizeof(ptrdiff_t) * 8 - 1));
+    TEST_VSPRINTF( "% d",           " 1",             (int) 1 );
+    TEST_VSPRINTF( "%+ d",          "+1",             (int) 1 );
+    TEST_VSPRINTF( "%S",            "wide",           (wchar_t *) L"wide" );
+    TEST_VSPRINTF( "%04c",          "   1",           (int) '1' );
+    TEST_VSPRINTF( "%-04c",         "1   ",           (int) '1' );
+    TEST_VSPRINTF( "%#012x",        "0x0000000001",   (int) 1 );
+    TEST_VSPRINTF( "%#012x",        "000000000000",   (int) 0 );
+    TEST_VSPRINTF( "%#04.8x",       "0x00000001",     (int) 1 );
+    TEST_VSPRINTF( "%#04.8x",       "00000000",       (int) 0 );
+    TEST_VSPRINTF( "%#-08.2x",      "0x01    ",       (int) 1 );
+    TEST_VSPRINTF( "%#-08.2x",      "00      ",       (int) 0 );
+    TEST_VSPRINTF( "%#.0x",         "0x1",            (int) 1 );
+    TEST_VSPRINTF( "%#.0x",         "",               (int) 0 );
+    TEST_VSPRINTF( "%#08o",         "00000001",       (int) 1 );
+    TEST_VSPRINTF( "%#o",           "01",             (int) 1 );
+    TEST_VSPRINTF( "%#o",           "0",              (int) 0 );
+    TEST_VSPRINTF( "%04s",          " foo",           (char *) "foo" );
+    TEST_VSPRINTF( "%.1s",          "f",              (char *) "foo" );
+    TEST_VSPRINTF( "%.0s",          "",               (char *) "foo" );
+    TEST_VSPRINTF( "hello",         "hello",          0 );
+    TEST_VSPRINTF( "%b",            "101010",         (int) 42 );
+    TEST_VSPRINTF( "%#b",           "0b101010",       (int) 42 );
+    TEST_VSPRINTF( "%#B",           "0B101010",       (int) 42 );
+    TEST_VSPRINTF( "%3c",           "  a",            (int) 'a' );
+    TEST_VSPRINTF( "%-3c",          "a  ",            (int) 'a' );
+    TEST_VSPRINTF( "%3d",           "1234",           (int) 1234 );
+    TEST_VSPRINTF( "%-1d",          "2",              (int) 2 );
+    TEST_VSPRINTF( "%2.4f",         "8.6000",         (double) 8.6 );
+    TEST_VSPRINTF( "%0f",           "0.600000",       (double) 0.6 );
+    TEST_VSPRINTF( "%.0f",          "1",              (double) 0.6 );
+    TEST_VSPRINTF( "%2.4e",         "8.6000e+00",     (double) 8.6 );
+    TEST_VSPRINTF( "% 2.4e",        " 8.6000e+00",    (double) 8.6 );
+    TEST_VSPRINTF( "% 014.4e",      " 0008.6000e+00", (double) 8.6 );
+    TEST_VSPRINTF( "% 2.4e",        "-8.6000e+00",    (double)  -8.6 );
+    TEST_VSPRINTF( "%+2.4e",        "+8.6000e+00",    (double) 8.6 );
+    TEST_VSPRINTF( "%2.4g",         "8.6",            (double) 8.6 );
+    TEST_VSPRINTF( "%2.4Lf",        "8.6000",         (long double) 8.6 );
+    TEST_VSPRINTF( "%0Lf",          "0.600000",       (long double) 0.6 );
+    TEST_VSPRINTF( "%.0Lf",         "1",              (long double) 0.6 );
+    TEST_VSPRINTF( "%2.4Le",        "8.6000e+00",     (long double) 8.6 );
+    TEST_VSPRINTF( "% 2.4Le",       " 8.6000e+00",    (long double) 8.6 );
+    TEST_VSPRINTF( "% 014.4Le",     " 0008.6000e+00", (long double) 8.6 );
+    TEST_VSPRINTF( "% 2.4Le",       "-8.6000e+00",    (long double)  -8.6 );
+    TEST_VSPRINTF( "%+2.4Le",       "+8.6000e+00",    (long double) 8.6 );
+    TEST_VSPRINTF( "%2.4Lg",        "8.6",            (long double) 8.6 );
+    TEST_VSPRINTF( "%-i",           "-1",             (int) -1 );
+    TEST_VSPRINTF( "%-i",           "1",              (int) 1 );
+    TEST_VSPRINTF( "%+i",           "+1",             (int) 1 );
+    TEST_VSPRINTF( "%o",            "12",             (int) 10 );
+ //   TEST_VSPRINTF( "%s",            "<NULL>",         (char *) NULL );
+    TEST_VSPRINTF( "%s",            "%%%%",           (char *) "%%%%" );
+    TEST_VSPRINTF( "%u",            "4294967295",     (int) -1 );
+    TEST_VSPRINTF( "%u",            "2147483648",     (unsigned int) 0x80000000 );
+    TEST_VSPRINTF( "%d",            "-2147483648",    (int) 0x80000000 );
+    TEST_VSPRINTF( "%jd",           "-1",             (intmax_t) -1 );
+    TEST_VSPRINTF( "%F",            "0.000000",       (double) 0 );
+    TEST_VSPRINTF( "x%cx",          "xXx",            (int) 0x100+'X' );
+    TEST_VSPRINTF( "%%0",           "%0",             0 );
+    TEST_VSPRINTF( "%%%%%%%%",      "%%%%",           0 );
+    TEST_VSPRINTF( "%%%%%d%%%%",    "%%42%%",         (int) 42 );
+    TEST_VSPRINTF( "%hx",           "2345",           (int) 0x12345 );
+    TEST_VSPRINTF( "%hhx",          "23",             (int) 0x123 );
+    TEST_VSPRINTF( "%hhx",          "45",             (int) 0x12345 );
+    TEST_VSPRINTF( "%c",            "a",              (int) 'a' );
+    TEST_VSPRINTF( "%c",            "\x82",           (int) 0xa082 );
+//    TEST_VSPRINTF( "%C",            "a",              (int) 'a' );
+//    TEST_VSPRINTF( "%C",            "\xe3\x81\x82" /*""*/, (int) 0x3042 );
+//    TEST_VSPRINTF( "%l4c",          "\xe3\x81\x82" /*""*/, (int) 0x3042 );
+//    TEST_VSPRINTF( "%l2c",          "\xe3\x81\x82" /*""*/, (int) 0x3042 );
+    TEST_VSPRINTF( "a%Cb",          "a\xe3\x81\x82" "b",   (int) 0x3042 );
+    TEST_VSPRINTF( "%lld",          "-8589934591",   (unsigned long long) ((unsigned long long)0xffffffff)*0xffffffff );
+    TEST_VSPRINTF( "%llu",          "18446744065119617025", (unsigned long long) ((unsigned long long)0xffffffff)*0xffffffff );
+    TEST_VSPRINTF( "%d",            "1",             (int) 1 );
+    TEST_VSPRINTF( "%.0f",          "-2",            (double) -1.5 );
+    TEST_VSPRINTF( "%.0f",          "-1",            (double) -0.5 );
+    TEST_VSPRINTF( "%.0f",          "1",             (double) 0.5 );
+    TEST_VSPRINTF( "%.0f",          "2",             (double) 1.5 );
+
+    TEST_VSPRINTF( "%.3e", "0.000e+00",    (double) 0.0 );
+    TEST_VSPRINTF( "%.3e", "5.000e+00",    (double) 5e-0 );
+    TEST_VSPRINTF( "%.3e", "5.000e+00",    (double) 5e+0 );
+    TEST_VSPRINTF( "%.3e", "5.000e-01",    (double) 5e-1 );
+    TEST_VSPRINTF( "%.3e", "5.000e+01",    (double) 5e+1 );
+    TEST_VSPRINTF( "%.3e", "5.000e-02",    (double) 5e-2 );
+    TEST_VSPRINTF( "%.3e", "5.000e+02",    (double) 5e+2 );
+    TEST_VSPRINTF( "%.3e", "5.000e-03",    (double) 5e-3 );
+    TEST_VSPRINTF( "%.3e", "5.000e+03",    (double) 5e+3 );
+    TEST_VSPRINTF( "%.3e", "9.995e+00",    (double) 9.995e-0 );
+    TEST_VSPRINTF( "%.3e", "9.995e+00",    (double) 9.995e+0 );
+    TEST_VSPRINTF( "%.3e", "9.995e-01",    (double) 9.995e-1 );
+    TEST_VSPRINTF( "%.3e", "9.995e+01",    (double) 9.995e+1 );
+    TEST_VSPRINTF( "%.3e", "9.995e-02",    (double) 9.995e-2 );
+    TEST_VSPRINTF( "%.3e", "9.995e+02",    (double) 9.995e+2 );
+    TEST_VSPRINTF( "%.3e", "1.000e+00",    (double)  1.0 );
+    TEST_VSPRINTF( "%.3e", "-1.000e+00",   (double) -1.0 );
+    TEST_VSPRINTF( "%.3e", "1.000e+01",    (double)  1e+1 );
+    TEST_VSPRINTF( "%.3e", "-1.000e-01",   (double) -1e-1 );
+    TEST_VSPRINTF( "%.3e", "-1.000e+01",   (double) -1e+1 );
+    TEST_VSPRINTF( "%.3e", "1.000e-01",    (double)  1e-1 );
+    TEST_VSPRINTF( "%.3e", "-1.000e-01",   (double) -1e-1 );
+    TEST_VSPRINTF( "%.3e", "1.000e+02",    (double)  1e+2 );
+    TEST_VSPRINTF( "%.3e", "1.000e-02",    (double)  1e-2 );
+    TEST_VSPRINTF( "%.3e", "1.000e+03",    (double)  1e+3 );
+    TEST_VSPRINTF( "%.3e", "1.000e-03",    (double)  1e-3 );
+
+    TEST_VSPRINTF( "%.3Le", "0.000e+00",   (long double) 0.0 );
     TEST_VSPRINTF( "%.3Le", "5.000e+00",   (long double) 5e-0 );
     TEST_VSPRINTF( "%.3Le", "5.000e+00",   (long double) 5e+0 );
     TEST_VSPRINTF( "%.3Le", "5.000e-01",   (long double) 5e-1 );
@@ -495,69 +1225,1754 @@ int run_tests()
     TEST_VSPRINTF( "%.3Le", "1.000e+03",   (long double)  1e+3 );
     TEST_VSPRINTF( "%.3Le", "1.000e-03",   (long double)  1e-3 );
 
-    TEST_VSPRINTF( "%.3a",  "-0x1.a37p-10",  (double)       -1.6e-3 );
-    TEST_VSPRINTF( "%.3A",  "-0X1.A37P-10",  (double)       -1.6e-3 );
-    TEST_VSPRINTF( "%.3La", "-0x1.a37p-10",  (long double)  -1.6e-3 );
-    TEST_VSPRINTF( "%.3LA", "-0X1.A37P-10",  (long double)  -1.6e-3 );
+    TEST_VSPRINTF( "%.3a",  "-0x1.a37p-10",  (double)       -1.6e-3 );
+    TEST_VSPRINTF( "%.3A",  "-0X1.A37P-10",  (double)       -1.6e-3 );
+    TEST_VSPRINTF( "%.3La", "-0x1.a37p-10",  (long double)  -1.6e-3 );
+    TEST_VSPRINTF( "%.3LA", "-0X1.A37P-10",  (long double)  -1.6e-3 );
+
+    TEST_VSPRINTF( "%5.2e%.0f",  "  inf3",   (double) inf ARG(3.0));
+    TEST_VSPRINTF( "%5.2e%.0f",  " -inf3",   (double) ninf ARG(3.0));
+    TEST_VSPRINTF( "%5.2e%.0f",  "  nan3",   (double) nan ARG(3.0));
+    TEST_VSPRINTF( "%5.2e%.0f",  " -nan3",   (double) nnan ARG(3.0));
+    TEST_VSPRINTF( "%5.2E%.0f",  "  INF-3",  (double) inf ARG(-3.0));
+    TEST_VSPRINTF( "%5.2E%.0f",  " -INF-3",  (double) ninf ARG(-3.0));
+    TEST_VSPRINTF( "%5.2E%.0f",  "  NAN-3",  (double) nan ARG(-3.0));
+    TEST_VSPRINTF( "%5.2E%.0f",  " -NAN-3",  (double) nnan ARG(-3.0));
+
+    TEST_VSPRINTF( "%5.2f%.0f",  "  inf3",   (double) inf ARG(3.0));
+    TEST_VSPRINTF( "%5.2f%.0f",  " -inf3",   (double) ninf ARG(3.0));
+    TEST_VSPRINTF( "%5.2f%.0f",  "  nan3",   (double) nan ARG(3.0));
+    TEST_VSPRINTF( "%5.2f%.0f",  " -nan3",   (double) nnan ARG(3.0));
+    TEST_VSPRINTF( "%5.2F%.0f",  "  INF-3",  (double) inf ARG(-3.0));
+    TEST_VSPRINTF( "%5.2F%.0f",  " -INF-3",  (double) ninf ARG(-3.0));
+    TEST_VSPRINTF( "%5.2F%.0f",  "  NAN-3",  (double) nan ARG(-3.0));
+    TEST_VSPRINTF( "%5.2F%.0f",  " -NAN-3",  (double) nnan ARG(-3.0));
+
+    TEST_VSPRINTF( "%5.2Le%.0Lf", "  inf3",  (long double) inf ARG((long double) 3.0));
+    TEST_VSPRINTF( "%5.2Le%.0Lf", " -inf3",  (long double) ninf ARG((long double) 3.0));
+    TEST_VSPRINTF( "%5.2Le%.0Lf", "  nan3",  (long double) nan ARG((long double) 3.0));
+    TEST_VSPRINTF( "%5.2Le%.0Lf", " -nan3",  (long double) nnan ARG((long double) 3.0));
+    TEST_VSPRINTF( "%5.2LE%.0Lf", "  INF-3", (long double) inf ARG((long double) -3.0));
+    TEST_VSPRINTF( "%5.2LE%.0Lf", " -INF-3", (long double) ninf ARG((long double) -3.0));
+    TEST_VSPRINTF( "%5.2LE%.0Lf", "  NAN-3", (long double) nan ARG((long double) -3.0));
+    TEST_VSPRINTF( "%5.2LE%.0Lf", " -NAN-3", (long double) nnan ARG((long double) -3.0));
+
+    TEST_VSPRINTF( "%# 01.1g",    " 1.e+01", (double) 9.8);
+    TEST_VSPRINTF( "%# 01.1Lg",   " 1.e+01", (long double) 9.8l);
+
+    TEST_VSPRINTF( "%010.3g",  "0000003.33", (double) (10.0/3.0));
+    TEST_VSPRINTF( "%010.3Lg", "0000003.33", (long double) (10.0/3.0));
+    TEST_VSPRINTF( "%10.6g",   "   3.33333", (double) (10.0/3.0));
+    TEST_VSPRINTF( "%10.6Lg",  "   3.33333", (long double) (10.0/3.0));
+    TEST_VSPRINTF( "%10.6g",   " 0.0333333", (double) (0.1/3.0));
+    TEST_VSPRINTF( "%10.6Lg",  " 0.0333333", (long double) (0.1/3.0));
+
+    TEST_VSPRINTF( "%#.1g",       "-4.e+04", (double) -40661.5);
+    TEST_VSPRINTF( "%#.1Lg",      "-4.e+04", (long double) -40661.5l);
+    TEST_VSPRINTF( "%#g",         "0.00000", (double) 0.0);
+    TEST_VSPRINTF( "%#Lg",        "0.00000", (long double) 0.0l);
+    TEST_VSPRINTF( "%g",          "0",       (double) 0.0);
+    TEST_VSPRINTF( "%Lg",         "0",       (long double) 0.0l);
+    TEST_VSPRINTF( "%g",          "490000",  (double) 490000.0l);
+    TEST_VSPRINTF( "%Lg",         "490000",  (long double) 490000.0l);
+    TEST_VSPRINTF( "%G",          "4.9E+06", (double) 4900000.0l);
+    TEST_VSPRINTF( "%LG",         "4.9E+06", (long double) 4900000.0l);
+    TEST_VSPRINTF( "%.7G",        "4900000", (double) 4900000.0l);
+    TEST_VSPRINTF( "%.7LG",       "4900000", (long double) 4900000.0l);
+
+//    TEST_VSPRINTF("%+5.10r2E %+10.10r2e %+10.10r7e %+10.10r4e %+10.0r0e %+10.0r0e ", "+1.1111001101E+01 +1.0001101111e-1111111001 +1.6250223006e+1030 +2.3300320211e+32     +8e-01    +2e-308 ",
+//                    (double) 3.9 ARG(7.89456123e-307) ARG(7.89456123e+307) ARG(789456123.0) ARG(0.789456123) ARG(DBL_MIN));
+
+//    TEST_VSPRINTF("%+5.10r2LE %+10.10r2Le %+10.10r7Le %+10.10r4Le %+10.0r0Le %+10.0r0Le ", "+1.1111001101E+01 +1.0001101111e-1111111001 +1.6250223006e+1030 +2.3300320211e+32     +8e-01    +2e-308 ",
+//                    (long double) 3.9 ARG((long double) 7.89456123e-307) ARG((long double) 7.89456123e+307) ARG((long double) 789456123.0) ARG((long double) 0.789456123) ARG((long double) DBL_MIN));
+
+    return (bRet);
+} /* run_tests() */
+
+
+/* ------------------------------------------------------------------------- *\
+   BENCH_SINK is the user data of the counting memory sinks that are used
+   for comparing callback_printf with callback_printfv.
+\* ------------------------------------------------------------------------- */
+
+typedef struct BENCH_SINK_S BENCH_SINK;
+struct BENCH_SINK_S
+{
+   char * pDst;  /* current write position */
+   size_t Calls; /* number of callback calls */
+};
+
+static void bench_write(void * pUserData, const char * pSrc, size_t Length)
+{
+   BENCH_SINK * pbs = (BENCH_SINK *) pUserData;
+
+   ++pbs->Calls;
+   memcpy(pbs->pDst, pSrc, Length);
+   pbs->pDst += Length;
+} /* void bench_write(void * pUserData, const char * pSrc, size_t Length) */
+
+static void bench_writev(void * pUserData, const PRINTF_IOVEC * pVec, size_t Count)
+{
+   BENCH_SINK * pbs = (BENCH_SINK *) pUserData;
+
+   ++pbs->Calls;
+   while(Count--)
+   {
+      memcpy(pbs->pDst, pVec->pSrc, pVec->Length);
+      pbs->pDst += pVec->Length;
+      ++pVec;
+   }
+} /* void bench_writev(void * pUserData, const PRINTF_IOVEC * pVec, size_t Count) */
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_vectored runs a format with callback_printf and callback_printfv
+   and prints the number of callback calls and the time per format.
+\* ------------------------------------------------------------------------- */
+
+static void bench_vectored(const char * pfmt, ...)
+{
+   char       buf[1024];
+   size_t     loops = 200000;
+   int        v;
+
+   printf("Call : %s\n", pfmt);
+
+   for(v = 0; v < 2; ++v)
+   {
+      BENCH_SINK bs;
+      size_t     count = loops;
+      int64_t    ts, te;
+      va_list    VarArgs;
+
+      ts = unix_time();
+      while(count--)
+      {
+         bs.pDst  = buf;
+         bs.Calls = 0;
+         va_start(VarArgs, pfmt);
+         if(v)
+            callback_printfv(&bs, &bench_writev, pfmt, VarArgs);
+         else
+            callback_printf(&bs, &bench_write, pfmt, VarArgs);
+         va_end(VarArgs);
+      }
+      te = unix_time();
+
+      *bs.pDst = '\0';
+      printf("%16s: %3d calls %8.1fns \"%s\"\n", v ? "callback_printfv" : "callback_printf", (int) bs.Calls, (double) (te - ts) * 1000.0 / loops, buf);
+   }
+
+   printf("\n");
+} /* void bench_vectored(const char * pfmt, ...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_fragments prints the number of fragments that callback_printf
+   passes to its callback and a histogram of their sizes. The fragments are
+   counted by the diagnostic callback callback_printf_fragments.
+\* ------------------------------------------------------------------------- */
+
+static void bench_fragments(const char * pfmt, ...)
+{
+   char             buf[1024];
+   char *           pb = buf;
+   BENCH_SINK       bs;
+   PRINTF_FRAGMENTS fs;
+   va_list          VarArgs;
+   int              i;
+
+   if(bench_options.pFilter && !strstr(pfmt, bench_options.pFilter))
+      return;
+
+   bs.pDst  = buf;
+   bs.Calls = 0;
+   callback_printf_fragments_init(&fs, &bs, &bench_write);
+
+   va_start(VarArgs, pfmt);
+   callback_printf(&fs, &callback_printf_fragments, pfmt, VarArgs);
+   va_end(VarArgs);
+   *bs.pDst = '\0';
+
+   if(bench_options.Output == BENCH_OUT_JSON)
+   {
+      pb += _ssnprintf(pb, sizeof(buf) - 64, "{\"call\":%#Js,\"bytes\":%zu,\"fragments\":%zu,\"histogram\":[", pfmt, fs.Bytes, fs.Fragments);
+
+      for(i = 0; i < PRINTF_FRAGMENT_BUCKETS; ++i)
+         pb += ssprintf(pb, "%s%zu", i ? "," : "", fs.Histogram[i]);
+
+      ssprintf(pb, "]}\n");
+      fputs(buf, stdout);
+   }
+   else if(bench_options.Output == BENCH_OUT_CSV)
+   {
+      if(!bench_options.Header)
+      {
+         fputs("call,bytes,fragments", stdout);
+
+         for(i = 0; i < PRINTF_FRAGMENT_BUCKETS; ++i)
+         {
+            if(callback_printf_fragment_bucket(i))
+               printf(",le%zu", callback_printf_fragment_bucket(i));
+            else
+               printf(",gt%zu", callback_printf_fragment_bucket(i - 1));
+         }
+
+         fputs("\n", stdout);
+         bench_options.Header = 1;
+      }
+
+      pb += _ssnprintf(pb, sizeof(buf) - 64, "%Qs,%zu,%zu", pfmt, fs.Bytes, fs.Fragments);
+
+      for(i = 0; i < PRINTF_FRAGMENT_BUCKETS; ++i)
+         pb += ssprintf(pb, ",%zu", fs.Histogram[i]);
+
+      ssprintf(pb, "\n");
+      fputs(buf, stdout);
+   }
+   else
+   {
+      char hist[256];
+      char * ph = hist;
+
+      for(i = 0; i < PRINTF_FRAGMENT_BUCKETS; ++i)
+      {
+         if(!fs.Histogram[i])
+            continue;
+
+         if(callback_printf_fragment_bucket(i))
+            ph += ssprintf(ph, " <=%zu:%zu", callback_printf_fragment_bucket(i), fs.Histogram[i]);
+         else
+            ph += ssprintf(ph, " >%zu:%zu", callback_printf_fragment_bucket(i - 1), fs.Histogram[i]);
+      }
+
+      *ph = '\0';
+      printf("Call : %s\n", pfmt);
+      printf("%10s: %3zu fragments %5zu bytes %6.1f bytes per fragment  sizes%s\n", "fragments", fs.Fragments, fs.Bytes,
+             fs.Fragments ? (double) fs.Bytes / (double) fs.Fragments : 0.0, hist);
+      printf("%10s: \"%s\"\n\n", "output", buf);
+   }
+} /* void bench_fragments(const char * pfmt, ...) */
+
+
+#if !defined (_WIN32) && !defined (__CYGWIN__)
+/* ------------------------------------------------------------------------- *\
+   bench_sfdprintf compares the throughput of sfdprintf writing fragment by
+   fragment with the output using the thread local record buffers.
+\* ------------------------------------------------------------------------- */
+int bench_sfdprintf()
+{
+   static char part[3001];
+   const char * mode[2] = { "chunked", "record" };
+   size_t       loops   = 20000;
+   int          fd      = open("/dev/null", O_WRONLY);
+   int          m;
+
+   if(fd < 0)
+      return (0);
+
+   memset(part, 'x', sizeof(part) - 1);
+
+   for(m = 0; m < 2; ++m)
+   {
+      int64_t ts, te;
+      size_t  count;
+      size_t  bytes;
+
+      sfdprintf_set_record_limit(m ? 0x10000 : 0);
+
+      count = loops;
+      bytes = 0;
+      ts    = unix_time();
+      while(count--)
+         bytes += sfdprintf(fd, "%04d-%02d-%02d %02d:%02d:%02d [%5s] %s: %d %#x\n", 2026, 10, 19, 12, 0, (int) (count % 60), "info", "request done", (int) count, (unsigned int) count);
+      te    = unix_time();
+
+      printf("sfdprintf %-7s log line : %8.1fns/call %8.1fMB/s\n", mode[m], (double) (te - ts) * 1000.0 / loops, (double) bytes / (double) (te - ts + 1));
+
+      count = loops;
+      bytes = 0;
+      ts    = unix_time();
+      while(count--)
+         bytes += sfdprintf(fd, "<%d:%04d:%s|%s|%s>\n", 1, (int) count, part, part, part);
+      te    = unix_time();
+
+      printf("sfdprintf %-7s 9kB rec  : %8.1fns/call %8.1fMB/s\n", mode[m], (double) (te - ts) * 1000.0 / loops, (double) bytes / (double) (te - ts + 1));
+   }
+
+   sfdprintf_set_record_limit(0);
+   sfdprintf_release_record_buffer();
+   close(fd);
+   printf("\n");
+   return (1);
+} /* int bench_sfdprintf() */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_formats compares the built-in formatters of addresses and UUIDs
+   with the usual conversion by inet_ntop or %02x into temporary buffers.
+\* ------------------------------------------------------------------------- */
+int bench_formats()
+{
+   uint8_t ip4[4]   = { 192, 168, 100, 254 };
+   uint8_t ip6[16]  = { 0x20,0x01, 0x0d,0xb8, 0x85,0xa3, 0,0, 0,0, 0x8a,0x2e, 0x03,0x70, 0x73,0x34 };
+   uint8_t uuid[16] = { 0x12,0x3e,0x45,0x67, 0xe8,0x9b, 0x12,0xd3, 0xa4,0x56, 0x42,0x66,0x14,0x17,0x40,0x00 };
+   char    buf[256];
+   char    ref[256];
+   size_t  loops    = 200000;
+   size_t  count;
+   int64_t ts, te;
+
+   if(cbk_formats_register())
+      return (0);
+
+   count = loops;
+   ts    = unix_time();
+   while(count--)
+   {
+      char s4[INET_ADDRSTRLEN];
+      char s6[INET6_ADDRSTRLEN];
+      char su[40];
+
+      inet_ntop(AF_INET,  ip4, s4, sizeof(s4));
+      inet_ntop(AF_INET6, ip6, s6, sizeof(s6));
+      ssnprintf(su, sizeof(su), "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+                uuid[0], uuid[1], uuid[2], uuid[3], uuid[4], uuid[5], uuid[6], uuid[7],
+                uuid[8], uuid[9], uuid[10], uuid[11], uuid[12], uuid[13], uuid[14], uuid[15]);
+      ssnprintf(ref, sizeof(ref), "%-15s %s %s", s4, s6, su);
+   }
+   te    = unix_time();
+   printf("inet_ntop + %%02x      : %8.1fns \"%s\"\n", (double) (te - ts) * 1000.0 / loops, ref);
+
+   count = loops;
+   ts    = unix_time();
+   while(count--)
+      _ssnprintf(buf, sizeof(buf), "%-15{ipv4} %{ipv6} %{uuid}", ip4, ip6, uuid);
+   te    = unix_time();
+   printf("%%{ipv4} %%{ipv6} %%{uuid} : %8.1fns \"%s\" %s\n", (double) (te - ts) * 1000.0 / loops, buf, strcmp(buf, ref) ? "!NOK!" : "OK");
+
+   printf("\n");
+   return (!strcmp(buf, ref));
+} /* int bench_formats() */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_timestamps compares the timestamp formatters with gmtime and seven
+   integer conversions for log prefixes of a microsecond clock and of a
+   clock that changes the second at every record.
+\* ------------------------------------------------------------------------- */
+static void gmtime_prefix(char * buf, size_t size, const struct timespec * pts)
+{
+   struct tm tm;
+   time_t    t = pts->tv_sec;
+
+#ifdef _WIN32
+   gmtime_s(&tm, &t);
+#else
+   gmtime_r(&t, &tm);
+#endif
+   ssnprintf(buf, size, "%04d-%02d-%02dT%02d:%02d:%02d.%06dZ %s", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+             tm.tm_hour, tm.tm_min, tm.tm_sec, (int) (pts->tv_nsec / 1000), "record");
+} /* void gmtime_prefix(char * buf, size_t size, const struct timespec * pts) */
+
+int bench_timestamps()
+{
+   static const long steps[2] = { 1000, 1000001000 }; /* one microsecond or one second per record */
+   char            buf[128];
+   char            ref[128];
+   size_t          loops = 1000000;
+   size_t          count;
+   int64_t         ts, te;
+   struct timespec tsp;
+   int             bRet  = 1;
+   int             i;
+
+   if(cbk_formats_register())
+      return (0);
+
+   for(i = 0; i < 2; ++i)
+   {
+      printf("%s per record:\n", i ? "1 second" : "1 microsecond");
+
+      tsp.tv_sec  = 1760877296;
+      tsp.tv_nsec = 0;
+      count       = loops;
+      ts          = unix_time();
+      while(count--)
+      {
+         gmtime_prefix(ref, sizeof(ref), &tsp);
+         tsp.tv_sec  += (tsp.tv_nsec + steps[i]) / 1000000000;
+         tsp.tv_nsec  = (tsp.tv_nsec + steps[i]) % 1000000000;
+      }
+      te          = unix_time();
+      printf("gmtime_r + %%02d  : %8.1fns \"%s\"\n", (double) (te - ts) * 1000.0 / loops, ref);
+
+      tsp.tv_sec  = 1760877296;
+      tsp.tv_nsec = 0;
+      count       = loops;
+      ts          = unix_time();
+      while(count--)
+      {
+         _ssnprintf(buf, sizeof(buf), "%{iso8601} %s", &tsp, "record");
+         tsp.tv_sec  += (tsp.tv_nsec + steps[i]) / 1000000000;
+         tsp.tv_nsec  = (tsp.tv_nsec + steps[i]) % 1000000000;
+      }
+      te          = unix_time();
+      printf("%%{iso8601}       : %8.1fns \"%s\" %s\n\n", (double) (te - ts) * 1000.0 / loops, buf, strcmp(buf, ref) ? "!NOK!" : "OK");
+
+      bRet &= !strcmp(buf, ref);
+   }
+
+   return (bRet);
+} /* int bench_timestamps() */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_binary compares the hexadecimal and base64 output of a payload of
+   1 KiB with a loop of %02x conversions.
+\* ------------------------------------------------------------------------- */
+int bench_binary()
+{
+   static char buf[8192];
+   static char ref[4096];
+   uint8_t     data[1024];
+   int         bRet;
+   CBK_BYTES   payload;
+   size_t      loops = 20000;
+   size_t      count;
+   size_t      i;
+   int64_t     ts, te;
+
+   if(cbk_formats_register())
+      return (0);
+
+   for(i = 0; i < sizeof(data); ++i)
+      data[i] = (uint8_t) (i * 7 + 3);
+
+   payload.pData  = data;
+   payload.Length = sizeof(data);
+
+   count = loops;
+   ts    = unix_time();
+   while(count--)
+   {
+      for(i = 0; i < sizeof(data); ++i)
+         ssnprintf(ref + 2 * i, 3, "%02x", data[i]);
+   }
+   te    = unix_time();
+   printf("%%02x per byte : %8.1fns %8.3fGB/s\n", (double) (te - ts) * 1000.0 / loops, (double) sizeof(data) * loops / (te - ts) / 1000.0);
+
+   count = loops;
+   ts    = unix_time();
+   while(count--)
+      _ssnprintf(buf, sizeof(buf), "%{hex}", &payload);
+   te    = unix_time();
+   bRet  = !strcmp(buf, ref);
+   printf("%%{hex}        : %8.1fns %8.3fGB/s %s\n", (double) (te - ts) * 1000.0 / loops, (double) sizeof(data) * loops / (te - ts) / 1000.0, bRet ? "OK" : "!NOK!");
+
+   count = loops;
+   ts    = unix_time();
+   while(count--)
+      _ssnprintf(buf, sizeof(buf), "%{hex_sp}", &payload);
+   te    = unix_time();
+   printf("%%{hex_sp}     : %8.1fns %8.3fGB/s\n", (double) (te - ts) * 1000.0 / loops, (double) sizeof(data) * loops / (te - ts) / 1000.0);
+
+   count = loops;
+   ts    = unix_time();
+   while(count--)
+      _ssnprintf(buf, sizeof(buf), "%{base64}", &payload);
+   te    = unix_time();
+   printf("%%{base64}     : %8.1fns %8.3fGB/s\n", (double) (te - ts) * 1000.0 / loops, (double) sizeof(data) * loops / (te - ts) / 1000.0);
+
+   count = loops;
+   ts    = unix_time();
+   while(count--)
+      _ssnprintf(buf, sizeof(buf), "%{base32}", &payload);
+   te    = unix_time();
+   printf("%%{base32}     : %8.1fns %8.3fGB/s\n", (double) (te - ts) * 1000.0 / loops, (double) sizeof(data) * loops / (te - ts) / 1000.0);
+
+   count = loops;
+   ts    = unix_time();
+   while(count--)
+      _ssnprintf(buf, sizeof(buf), "%{hexdump}", &payload);
+   te    = unix_time();
+   printf("%%{hexdump}    : %8.1fns %8.3fGB/s\n\n", (double) (te - ts) * 1000.0 / loops, (double) sizeof(data) * loops / (te - ts) / 1000.0);
+
+   return (bRet);
+} /* int bench_binary() */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_escape compares %Js with the escaping of a JSON string into a
+   temporary buffer before printing it by %s.
+\* ------------------------------------------------------------------------- */
+static size_t json_escape(char * pd, const char * ps)
+{
+   char * pb = pd;
+
+   for(; *ps; ++ps)
+   {
+      unsigned char c = (unsigned char) *ps;
+
+      if((c == '"') || (c == '\\'))
+      {
+         *pd++ = '\\';
+         *pd++ = (char) c;
+      }
+      else if(c == '\n')
+      {
+         *pd++ = '\\';
+         *pd++ = 'n';
+      }
+      else if(c == '\t')
+      {
+         *pd++ = '\\';
+         *pd++ = 't';
+      }
+      else if(c < 0x20)
+         pd += ssprintf(pd, "\\u%04x", c);
+      else
+         *pd++ = (char) c;
+   }
+
+   *pd = '\0';
+   return ((size_t) (pd - pb));
+} /* size_t json_escape(char * pd, const char * ps) */
+
+int bench_escape()
+{
+   static const char * values[3] = { "GET /api/v1/items?limit=100&offset=200 HTTP/1.1",
+                                     "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 Safari/537.36",
+                                     "error: \"disk full\"\n\tat write()" };
+   char        buf[1024];
+   char        ref[1024];
+   char        tmp[3][512];
+   size_t      loops = 500000;
+   size_t      count;
+   int64_t     ts, te;
+
+   count = loops;
+   ts    = unix_time();
+   while(count--)
+   {
+      json_escape(tmp[0], values[0]);
+      json_escape(tmp[1], values[1]);
+      json_escape(tmp[2], values[2]);
+      ssnprintf(ref, sizeof(ref), "{\"req\":\"%s\",\"agent\":\"%s\",\"msg\":\"%s\"}", tmp[0], tmp[1], tmp[2]);
+   }
+   te    = unix_time();
+   printf("escape + %%s : %8.1fns\n", (double) (te - ts) * 1000.0 / loops);
+
+   count = loops;
+   ts    = unix_time();
+   while(count--)
+      _ssnprintf(buf, sizeof(buf), "{\"req\":%#Js,\"agent\":%#Js,\"msg\":%#Js}", values[0], values[1], values[2]);
+   te    = unix_time();
+   printf("%%#Js        : %8.1fns %s\n", (double) (te - ts) * 1000.0 / loops, strcmp(buf, ref) ? "!NOK!" : "OK");
+   printf("%s\n\n", buf);
+
+   return (!strcmp(buf, ref));
+} /* int bench_escape() */
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_record compares a JSON record of cbk_record with formatting every
+   value into a temporary buffer and serializing the escaped text.
+\* ------------------------------------------------------------------------- */
+int bench_record()
+{
+   static const char * msg = "GET /api/v1/items?limit=100 \"slow\"";
+   CBK_RECORD *        pRec;
+   struct timespec     now;
+   char                buf[1024];
+   char                ref[1024];
+   char                val[5][256];
+   char                esc[2][512];
+   size_t              loops = 500000;
+   size_t              count;
+   int64_t             ts, te;
+   int                 bRet;
+
+   cbk_formats_register(); /* EEXIST doesn't matter */
+   pRec = cbk_record_create("ts=%{iso8601} lvl=%s lat_us=%u ratio=%.3f msg=%s");
+   if(!pRec)
+      return (0);
+
+   now.tv_sec  = 1792400096;
+   now.tv_nsec = 123456789;
+
+   count = loops;
+   ts    = unix_time();
+   while(count--)
+   {
+      _ssnprintf(val[0], sizeof(val[0]), "%{iso8601}", &now);
+      ssnprintf(val[1], sizeof(val[1]), "%s", "info");
+      ssnprintf(val[2], sizeof(val[2]), "%u", 1234u);
+      ssnprintf(val[3], sizeof(val[3]), "%.3f", 0.875);
+      ssnprintf(val[4], sizeof(val[4]), "%s", msg);
+      json_escape(esc[0], val[1]);
+      json_escape(esc[1], val[4]);
+      ssnprintf(ref, sizeof(ref), "{\"ts\":\"%s\",\"lvl\":\"%s\",\"lat_us\":%s,\"ratio\":%s,\"msg\":\"%s\"}\n", val[0], esc[0], val[2], val[3], esc[1]);
+   }
+   te    = unix_time();
+   printf("format + JSON : %8.1fns\n", (double) (te - ts) * 1000.0 / loops);
+
+   count = loops;
+   ts    = unix_time();
+   while(count--)
+      cbk_record_snprintf(buf, sizeof(buf), pRec, CBK_RECORD_JSON, &now, "info", 1234u, 0.875, msg);
+   te    = unix_time();
+   bRet  = !strcmp(buf, ref);
+   printf("cbk_record    : %8.1fns %s\n", (double) (te - ts) * 1000.0 / loops, bRet ? "OK" : "!NOK!");
+   printf("%s\n", buf);
+
+   cbk_record_free(pRec);
+   return (bRet);
+} /* int bench_record() */
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_nested compares a right justified %30@ prefix of a logging wrapper
+   with measuring the nested output before formatting it.
+\* ------------------------------------------------------------------------- */
+static size_t nested_two_pass(char * pd, size_t size, const char * pfmt, ...)
+{
+   size_t  len;
+   size_t  pad = 0;
+   va_list val;
+
+   va_start(val, pfmt);
+   len = svsnprintf(NULL, 0, pfmt, val);
+   va_end(val);
+
+   if(len < 30)
+   {
+      pad = 30 - len;
+      memset(pd, ' ', pad);
+   }
+
+   va_start(val, pfmt);
+   len = svsnprintf(pd + pad, size - pad, pfmt, val);
+   va_end(val);
+
+   return (ssnprintf(pd + pad + len, size - pad - len, " %s", "message text") + pad + len);
+} /* size_t nested_two_pass(char * pd, size_t size, const char * pfmt, ...) */
+
+static size_t nested_prefix(char * pd, size_t size, const char * pfmt, ...)
+{
+   size_t  len;
+   va_list val;
+
+   va_start(val, pfmt);
+   len = _ssnprintf(pd, size, "%30@ %s", pfmt, val, "message text");
+   va_end(val);
+
+   return (len);
+} /* size_t nested_prefix(char * pd, size_t size, const char * pfmt, ...) */
+
+int bench_nested()
+{
+   char    buf[256];
+   char    ref[256];
+   size_t  loops = 1000000;
+   size_t  count;
+   int64_t ts, te;
+
+   count = loops;
+   ts    = unix_time();
+   while(count--)
+      nested_two_pass(ref, sizeof(ref), "%s:%d %s()", "callback_printf.c", 4711, "printf_core");
+   te    = unix_time();
+   printf("measure + format : %8.1fns\n", (double) (te - ts) * 1000.0 / loops);
+
+   count = loops;
+   ts    = unix_time();
+   while(count--)
+      nested_prefix(buf, sizeof(buf), "%s:%d %s()", "callback_printf.c", 4711, "printf_core");
+   te    = unix_time();
+   printf("%%30@             : %8.1fns %s\n", (double) (te - ts) * 1000.0 / loops, strcmp(buf, ref) ? "!NOK!" : "OK");
+   printf("%s\n\n", buf);
+
+   return (!strcmp(buf, ref));
+} /* int bench_nested() */
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_threads measures the scaling of a mix of log lines over 1 to nproc
+   threads into per thread buffers, into a shared FILE and into a shared
+   file descriptor by sfdprintf. Every thread formats the same number of
+   lines, so the throughput of a perfect scaling grows with the threads.
+\* ------------------------------------------------------------------------- */
+#define BENCH_MAX_THREADS 64     /* maximum number of threads */
+#define BENCH_THREAD_LINES 100000 /* log lines per thread */
+
+#define BENCH_TARGET_BUFFER 0 /* ssnprintf into a buffer of the thread */
+#define BENCH_TARGET_FILE   1 /* sfprintf into a shared FILE */
+#define BENCH_TARGET_FD     2 /* sfdprintf into a shared file descriptor */
+
+typedef struct BENCH_THREAD_S BENCH_THREAD;
+struct BENCH_THREAD_S
+{
+   pthread_t Thread; /* thread handle */
+   int       Target; /* BENCH_TARGET_... */
+   int       Id;     /* thread number */
+   FILE *    pf;     /* shared stream */
+   int       fd;     /* shared file descriptor */
+   size_t    Bytes;  /* formatted bytes */
+};
+
+static void * bench_thread(void * pv)
+{
+   BENCH_THREAD * pt = (BENCH_THREAD *) pv;
+   char           buf[256];
+   size_t         bytes = 0;
+   int            i;
+
+   for(i = 0; i < BENCH_THREAD_LINES; ++i)
+   {
+      switch(pt->Target * 4 + (i & 3))
+      {
+         case 0:  bytes += ssnprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d.%06d [%5s] %s: %d %#x\n", 2026, 10, 19, 12, i / 60 % 60, i % 60, i, "info", "request done", pt->Id, (unsigned int) i); break;
+         case 1:  bytes += ssnprintf(buf, sizeof(buf), "%s %s %d %.3f ms\n", "GET", "/api/v1/items?limit=100", 200, i * 0.001); break;
+         case 2:  bytes += ssnprintf(buf, sizeof(buf), "user=%s id=%llu ok=%d\n", "alice", (unsigned long long) i * 7919u, i & 1); break;
+         case 3:  bytes += ssnprintf(buf, sizeof(buf), "error: %s (errno %d) at %s:%d\n", "disk full", 28, "writer.c", 4711); break;
+         case 4:  bytes += sfprintf(pt->pf, "%04d-%02d-%02d %02d:%02d:%02d.%06d [%5s] %s: %d %#x\n", 2026, 10, 19, 12, i / 60 % 60, i % 60, i, "info", "request done", pt->Id, (unsigned int) i); break;
+         case 5:  bytes += sfprintf(pt->pf, "%s %s %d %.3f ms\n", "GET", "/api/v1/items?limit=100", 200, i * 0.001); break;
+         case 6:  bytes += sfprintf(pt->pf, "user=%s id=%llu ok=%d\n", "alice", (unsigned long long) i * 7919u, i & 1); break;
+         case 7:  bytes += sfprintf(pt->pf, "error: %s (errno %d) at %s:%d\n", "disk full", 28, "writer.c", 4711); break;
+         case 8:  bytes += sfdprintf(pt->fd, "%04d-%02d-%02d %02d:%02d:%02d.%06d [%5s] %s: %d %#x\n", 2026, 10, 19, 12, i / 60 % 60, i % 60, i, "info", "request done", pt->Id, (unsigned int) i); break;
+         case 9:  bytes += sfdprintf(pt->fd, "%s %s %d %.3f ms\n", "GET", "/api/v1/items?limit=100", 200, i * 0.001); break;
+         case 10: bytes += sfdprintf(pt->fd, "user=%s id=%llu ok=%d\n", "alice", (unsigned long long) i * 7919u, i & 1); break;
+         default: bytes += sfdprintf(pt->fd, "error: %s (errno %d) at %s:%d\n", "disk full", 28, "writer.c", 4711); break;
+      }
+   }
+
+   if(pt->Target == BENCH_TARGET_FD)
+      sfdprintf_release_record_buffer();
+
+   pt->Bytes = bytes;
+   return (NULL);
+} /* void * bench_thread(void * pv) */
+
+int bench_threads()
+{
+   static const char * target[3] = { "buffer", "FILE", "sfdprintf" };
+   BENCH_THREAD        threads[BENCH_MAX_THREADS];
+   long                nproc = bench_options.Threads ? bench_options.Threads : sysconf(_SC_NPROCESSORS_ONLN);
+   int                 fd    = open("/dev/null", O_WRONLY);
+   FILE *              pf    = fopen("/dev/null", "w");
+   int                 bRet  = 1;
+   int                 t;
+
+   if((fd < 0) || !pf)
+   {
+      bRet = 0;
+      goto Exit;
+   }
+
+   if(nproc < 1)
+      nproc = 1;
+   else if(nproc > BENCH_MAX_THREADS)
+      nproc = BENCH_MAX_THREADS;
+
+   sfdprintf_set_record_limit(0x1000); /* a log line gets written by a single write() */
+
+   printf("target     threads    Mlines/s     MB/s  efficiency\n");
+
+   for(t = 0; t < 3; ++t)
+   {
+      double single = 0;
+      long   n;
+
+      for(n = 1; n <= nproc; n = ((n * 2 > nproc) && (n < nproc)) ? nproc : n * 2)
+      {
+         int64_t ts, te;
+         size_t  bytes = 0;
+         double  rate;
+         long    i;
+
+         ts = bench_clock();
+         for(i = 0; i < n; ++i)
+         {
+            threads[i].Target = t;
+            threads[i].Id     = (int) i;
+            threads[i].pf     = pf;
+            threads[i].fd     = fd;
+            threads[i].Bytes  = 0;
+
+            if(pthread_create(&threads[i].Thread, NULL, &bench_thread, &threads[i]))
+            {
+               n    = i;
+               bRet = 0;
+               break;
+            }
+         }
+
+         for(i = 0; i < n; ++i)
+         {
+            pthread_join(threads[i].Thread, NULL);
+            bytes += threads[i].Bytes;
+         }
+         te = bench_clock();
+
+         if(!bRet)
+            break;
+
+         rate = (double) n * BENCH_THREAD_LINES * 1000.0 / (double) (te - ts); /* million lines per second */
+         if(n == 1)
+            single = rate;
+
+         printf("%-10s %7ld %11.2f %8.1f %10.0f%%\n", target[t], n, rate, (double) bytes * 1000.0 / (double) (te - ts), rate * 100.0 / (single * (double) n));
+      }
+   }
+
+   printf("\n");
+
+   Exit:;
+   sfdprintf_set_record_limit(0);
+
+   if(pf)
+      fclose(pf);
+
+   if(fd >= 0)
+      close(fd);
+
+   return (bRet);
+} /* int bench_threads() */
+#endif
+
+
+/* ========================================================================= *\
+   Replay of recorded format and argument traces
+
+   A trace is a text file with a record per line. A record consists of the
+   format string and its arguments separated by tabs. Every argument has a
+   type prefix:
+
+      i:-42          signed integer
+      u:42           unsigned integer
+      f:2.5          floating point number
+      s:text         string
+      x:0a1bff       bytes as CBK_BYTES pointer for %{hex} and the like
+
+   Backslashes, tabs, line breaks and other control characters are written
+   as \\, \t, \n, \r and \xNN within formats and strings. Empty lines and
+   lines starting with '#' are ignored. Records whose conversions don't
+   match the types of their arguments are rejected.
+\* ========================================================================= */
+
+#define TRACE_MAX_ARGS  32   /* maximum number of arguments of a record */
+#define TRACE_MAX_LINE  4096 /* maximum length of a line of the trace file */
+#define TRACE_MAX_OUT   4096 /* maximum length of the output of a record */
+
+#define TRACE_INT  1 /* argument of a chunk is passed as long long */
+#define TRACE_CHAR 2 /* argument of a chunk is passed as int */
+#define TRACE_DBL  3 /* argument of a chunk is passed as double */
+#define TRACE_PTR  4 /* argument of a chunk is passed as pointer */
+
+/* ------------------------------------------------------------------------- *\
+   TRACE_CHUNK is a part of a format with a single conversion for the
+   replay by snprintf. The size modifier of integers is replaced by ll and
+   the value gets truncated to the original size while loading the trace,
+   so snprintf can be called with a fixed type for every chunk.
+\* ------------------------------------------------------------------------- */
+typedef struct TRACE_CHUNK_S TRACE_CHUNK;
+struct TRACE_CHUNK_S
+{
+   char *    pFmt;    /* format of the chunk */
+   int       Class;   /* TRACE_... of the value or 0 for text only */
+   int       Stars;   /* number of '*' arguments in front of the value */
+   int       Star[2]; /* values of the '*' arguments */
+   union
+   {
+      long long    ll;
+      double       d;
+      const void * p;
+   } v;              /* value */
+};
+
+typedef struct TRACE_RECORD_S TRACE_RECORD;
+struct TRACE_RECORD_S
+{
+   char *        pFmt;    /* format */
+   PRINTF_ARG *  pArgs;   /* arguments for callback_printfa */
+   size_t        Count;   /* number of arguments */
+   TRACE_CHUNK * pChunks; /* chunks for snprintf or NULL if it has no equivalent of the format */
+   size_t        Chunks;  /* number of chunks */
+};
+
+typedef struct TRACE_S TRACE;
+struct TRACE_S
+{
+   TRACE_RECORD * pRecords; /* records */
+   size_t         Count;    /* number of records */
+   size_t         Size;     /* allocated number of records */
+   size_t         Libc;     /* number of records with a snprintf equivalent */
+};
+
+
+/* trace_unescape decodes the escape sequences of a field in place */
+static char * trace_unescape(char * ps)
+{
+   char * pd = ps;
+   char * pRet = ps;
+
+   while(*ps)
+   {
+      if((*ps == '\\') && ps[1])
+      {
+         ++ps;
+         if(*ps == 't')
+            *pd++ = '\t';
+         else if(*ps == 'n')
+            *pd++ = '\n';
+         else if(*ps == 'r')
+            *pd++ = '\r';
+         else if((*ps == 'x') && ps[1] && ps[2])
+         {
+            char hex[3];
+
+            hex[0] = ps[1];
+            hex[1] = ps[2];
+            hex[2] = '\0';
+            *pd++  = (char) strtoul(hex, NULL, 16);
+            ps    += 2;
+         }
+         else
+            *pd++ = *ps;
+
+         ++ps;
+      }
+      else
+         *pd++ = *ps++;
+   }
+
+   *pd = '\0';
+   return (pRet);
+} /* char * trace_unescape(char * ps) */
+
+
+/* trace_put_escaped writes a field with escape sequences */
+static void trace_put_escaped(FILE * pf, const char * ps)
+{
+   for(; *ps; ++ps)
+   {
+      unsigned char c = (unsigned char) *ps;
+
+      if(c == '\\')
+         fputs("\\\\", pf);
+      else if(c == '\t')
+         fputs("\\t", pf);
+      else if(c == '\n')
+         fputs("\\n", pf);
+      else if(c == '\r')
+         fputs("\\r", pf);
+      else if(c < 0x20)
+         fprintf(pf, "\\x%02x", c);
+      else
+         fputc(c, pf);
+   }
+} /* void trace_put_escaped(FILE * pf, const char * ps) */
+
+
+/* trace_copy_text copies text up to the next conversion into a chunk */
+static const char * trace_copy_text(const char * pf, char ** ppd)
+{
+   char * pd = *ppd;
+
+   while(*pf && ((pf[0] != '%') || (pf[1] == '%')))
+   {
+      if(*pf == '%')
+         *pd++ = *pf++;
+      *pd++ = *pf++;
+   }
+
+   *ppd = pd;
+   return (pf);
+} /* const char * trace_copy_text(const char * pf, char ** ppd) */
+
+
+/* ------------------------------------------------------------------------- *\
+   trace_chunk parses the conversion at pf into a chunk and returns the
+   position behind the following text or NULL if the conversion has no
+   snprintf equivalent.
+\* ------------------------------------------------------------------------- */
+static const char * trace_chunk(const char * pf, TRACE_CHUNK * pc, const TRACE_RECORD * pr, size_t * pArg, char * pd)
+{
+   const PRINTF_ARG * pa;
+   size_t             bytes = 0; /* size of the integer or 0 for int */
+   char               fc;
+
+   pf = trace_copy_text(pf, &pd);
+
+   if(!*pf)
+   {
+      *pd = '\0';
+      return (pf);
+   }
+
+   *pd++ = *pf++; /* '%' */
+
+   while(*pf && strchr("-+ #0", *pf))
+      *pd++ = *pf++;
+
+   if(*pf == '*')
+   {
+      *pd++ = *pf++;
+      pc->Stars++;
+   }
+
+   while((*pf >= '0') && (*pf <= '9'))
+      *pd++ = *pf++;
+
+   if(*pf == '.')
+   {
+      *pd++ = *pf++;
+
+      if(*pf == '*')
+      {
+         *pd++ = *pf++;
+         pc->Stars++;
+      }
+
+      while((*pf >= '0') && (*pf <= '9'))
+         *pd++ = *pf++;
+   }
+
+   /* size modifiers are dropped and the sizes remembered */
+   if((pf[0] == 'h') && (pf[1] == 'h'))
+   {
+      bytes = 1;
+      pf   += 2;
+   }
+   else if(pf[0] == 'h')
+   {
+      bytes = 2;
+      pf   += 1;
+   }
+   else if((pf[0] == 'l') && (pf[1] == 'l'))
+   {
+      bytes = 8;
+      pf   += 2;
+   }
+   else if(pf[0] == 'l')
+   {
+      bytes = sizeof(long);
+      pf   += 1;
+   }
+   else if((pf[0] == 'z') || (pf[0] == 't'))
+   {
+      bytes = sizeof(size_t);
+      pf   += 1;
+   }
+   else if(pf[0] == 'j')
+   {
+      bytes = 8;
+      pf   += 1;
+   }
+   else if(pf[0] == 'L')
+   {
+      pf += 1;
+   }
+
+   fc = *pf++;
+
+   if(fc && strchr("diouxX", fc))
+   {
+      pc->Class = TRACE_INT;
+      *pd++     = 'l';
+      *pd++     = 'l';
+   }
+   else if(fc == 'c')
+      pc->Class = TRACE_CHAR;
+   else if(fc && strchr("eEfFgGaA", fc))
+      pc->Class = TRACE_DBL;
+   else if(((fc == 's') || (fc == 'p')) && !bytes)
+      pc->Class = TRACE_PTR;
+   else
+      return (NULL); /* %{name}, %v, %V, %@, %b, %r, %Js, wide strings and the like */
+
+   *pd++ = fc;
+   pf    = trace_copy_text(pf, &pd);
+   *pd   = '\0';
+
+   if(*pArg + (size_t) pc->Stars + 1 > pr->Count)
+      return (NULL);
+
+   if(pc->Stars > 0)
+      pc->Star[0] = (int) pr->pArgs[(*pArg)++].v.i;
+
+   if(pc->Stars > 1)
+      pc->Star[1] = (int) pr->pArgs[(*pArg)++].v.i;
+
+   pa = &pr->pArgs[(*pArg)++];
+
+   if(pc->Class == TRACE_DBL)
+   {
+      if(pa->Type != PRINTF_ARG_DOUBLE)
+         return (NULL);
+
+      pc->v.d = pa->v.d;
+   }
+   else if(pc->Class == TRACE_PTR)
+   {
+      if(pa->Type != PRINTF_ARG_PTR)
+         return (NULL);
+
+      pc->v.p = pa->v.p;
+   }
+   else
+   {
+      uint64_t u    = (uint64_t) pa->v.i;
+      uint64_t mask;
+
+      if((pa->Type != PRINTF_ARG_INT) && (pa->Type != PRINTF_ARG_UINT))
+         return (NULL);
+
+      if(!bytes)
+         bytes = sizeof(int);
+
+      if(bytes < 8)
+      { /* the truncation to the original size */
+         mask = ((uint64_t) 1 << (bytes * 8)) - 1;
+         u   &= mask;
+
+         if(((fc == 'd') || (fc == 'i')) && (u >> (bytes * 8 - 1)))
+            u |= ~mask;
+      }
+
+      pc->v.ll = (long long) u;
+   }
+
+   return (pf);
+} /* const char * trace_chunk(...) */
+
+
+/* trace_free_record releases the memory of a record */
+static void trace_free_record(TRACE_RECORD * pr)
+{
+   size_t i;
+
+   for(i = 0; pr->pChunks && (i < pr->Chunks); ++i)
+      free(pr->pChunks[i].pFmt);
+
+   for(i = 0; i < pr->Count; ++i)
+   { /* strings and bytes are allocated by trace_parse_record */
+      if(pr->pArgs[i].Type == PRINTF_ARG_PTR)
+         free((void *) pr->pArgs[i].v.p);
+   }
+
+   free(pr->pChunks);
+   free(pr->pFmt);
+   free(pr->pArgs);
+   memset(pr, 0, sizeof(*pr));
+} /* void trace_free_record(TRACE_RECORD * pr) */
+
+
+/* ------------------------------------------------------------------------- *\
+   trace_chunks splits the format of a record into chunks for snprintf.
+   It returns 0 if the format uses any extension of callback_printf.
+\* ------------------------------------------------------------------------- */
+static int trace_chunks(TRACE_RECORD * pr)
+{
+   const char * pf  = pr->pFmt;
+   size_t       arg = 0;
+   char         fmt[TRACE_MAX_LINE * 2];
+
+   pr->pChunks = (TRACE_CHUNK *) calloc(TRACE_MAX_ARGS + 1, sizeof(TRACE_CHUNK));
+   pr->Chunks  = 0;
+
+   while(pr->pChunks && *pf && (pr->Chunks <= TRACE_MAX_ARGS))
+   {
+      TRACE_CHUNK * pc = &pr->pChunks[pr->Chunks];
+
+      pf = trace_chunk(pf, pc, pr, &arg, fmt);
+      if(!pf)
+         break;
+
+      pc->pFmt = (char *) malloc(strlen(fmt) + 1);
+      if(!pc->pFmt)
+         break;
+
+      strcpy(pc->pFmt, fmt);
+      ++pr->Chunks;
+   }
+
+   if(!pf || !pr->pChunks || *pf)
+   { /* no snprintf equivalent */
+      size_t i;
+
+      for(i = 0; pr->pChunks && (i < pr->Chunks); ++i)
+         free(pr->pChunks[i].pFmt);
+
+      free(pr->pChunks);
+      pr->pChunks = NULL;
+      pr->Chunks  = 0;
+      return (0);
+   }
+
+   return (1);
+} /* int trace_chunks(TRACE_RECORD * pr) */
+
+
+/* ------------------------------------------------------------------------- *\
+   trace_check returns 1 if every conversion of a format matches the type of
+   its argument. Traces may come from elsewhere, so only conversions that
+   read their argument are accepted: numbers of i:, u: and f:, strings of
+   s: for %s, %Js, %Qs and %qs, %p of any pointer and the bytes of x: for
+   the binary data formatters. %n, %@, %v, %V, wide strings and the other
+   named formatters are rejected.
+\* ------------------------------------------------------------------------- */
+static int trace_check(const char * pf, const char * pKinds, size_t Count)
+{
+   static const char * bytes[] = { "{hex}", "{hex_sp}", "{hexdump}", "{base64}", "{base32}" };
+   size_t              arg     = 0;
+
+   while(*pf)
+   {
+      char   kind;
+      size_t i;
+
+      if(*pf++ != '%')
+         continue;
 
-    TEST_VSPRINTF( "%5.2e%.0f",  "  inf3",   (double) inf ARG(3.0));
-    TEST_VSPRINTF( "%5.2e%.0f",  " -inf3",   (double) ninf ARG(3.0));
-    TEST_VSPRINTF( "%5.2e%.0f",  "  nan3",   (double) nan ARG(3.0));
-    TEST_VSPRINTF( "%5.2e%.0f",  " -nan3",   (double) nnan ARG(3.0));
-    TEST_VSPRINTF( "%5.2E%.0f",  "  INF-3",  (double) inf ARG(-3.0));
-    TEST_VSPRINTF( "%5.2E%.0f",  " -INF-3",  (double) ninf ARG(-3.0));
-    TEST_VSPRINTF( "%5.2E%.0f",  "  NAN-3",  (double) nan ARG(-3.0));
-    TEST_VSPRINTF( "%5.2E%.0f",  " -NAN-3",  (double) nnan ARG(-3.0));
+      if(*pf == '%')
+      {
+         ++pf;
+         continue;
+      }
 
-    TEST_VSPRINTF( "%5.2f%.0f",  "  inf3",   (double) inf ARG(3.0));
-    TEST_VSPRINTF( "%5.2f%.0f",  " -inf3",   (double) ninf ARG(3.0));
-    TEST_VSPRINTF( "%5.2f%.0f",  "  nan3",   (double) nan ARG(3.0));
-    TEST_VSPRINTF( "%5.2f%.0f",  " -nan3",   (double) nnan ARG(3.0));
-    TEST_VSPRINTF( "%5.2F%.0f",  "  INF-3",  (double) inf ARG(-3.0));
-    TEST_VSPRINTF( "%5.2F%.0f",  " -INF-3",  (double) ninf ARG(-3.0));
-    TEST_VSPRINTF( "%5.2F%.0f",  "  NAN-3",  (double) nan ARG(-3.0));
-    TEST_VSPRINTF( "%5.2F%.0f",  " -NAN-3",  (double) nnan ARG(-3.0));
+      while(*pf && strchr("-+ #0", *pf))
+         ++pf;
 
-    TEST_VSPRINTF( "%5.2Le%.0Lf", "  inf3",  (long double) inf ARG((long double) 3.0));
-    TEST_VSPRINTF( "%5.2Le%.0Lf", " -inf3",  (long double) ninf ARG((long double) 3.0));
-    TEST_VSPRINTF( "%5.2Le%.0Lf", "  nan3",  (long double) nan ARG((long double) 3.0));
-    TEST_VSPRINTF( "%5.2Le%.0Lf", " -nan3",  (long double) nnan ARG((long double) 3.0));
-    TEST_VSPRINTF( "%5.2LE%.0Lf", "  INF-3", (long double) inf ARG((long double) -3.0));
-    TEST_VSPRINTF( "%5.2LE%.0Lf", " -INF-3", (long double) ninf ARG((long double) -3.0));
-    TEST_VSPRINTF( "%5.2LE%.0Lf", "  NAN-3", (long double) nan ARG((long double) -3.0));
-    TEST_VSPRINTF( "%5.2LE%.0Lf", " -NAN-3", (long double) nnan ARG((long double) -3.0));
+      for(i = 0; i < 2; ++i)
+      { /* width and precision */
+         if(*pf == '*')
+         {
+            if((arg >= Count) || !strchr("iu", pKinds[arg++]))
+               return (0);
 
-    TEST_VSPRINTF( "%# 01.1g",    " 1.e+01", (double) 9.8);
-    TEST_VSPRINTF( "%# 01.1Lg",   " 1.e+01", (long double) 9.8l);
+            ++pf;
+         }
+         else
+         {
+            while((*pf >= '0') && (*pf <= '9'))
+               ++pf;
+         }
 
-    TEST_VSPRINTF( "%010.3g",  "0000003.33", (double) (10.0/3.0));
-    TEST_VSPRINTF( "%010.3Lg", "0000003.33", (long double) (10.0/3.0));
-    TEST_VSPRINTF( "%10.6g",   "   3.33333", (double) (10.0/3.0));
-    TEST_VSPRINTF( "%10.6Lg",  "   3.33333", (long double) (10.0/3.0));
-    TEST_VSPRINTF( "%10.6g",   " 0.0333333", (double) (0.1/3.0));
-    TEST_VSPRINTF( "%10.6Lg",  " 0.0333333", (long double) (0.1/3.0));
+         if(i || (*pf != '.'))
+            break;
 
-    TEST_VSPRINTF( "%#.1g",       "-4.e+04", (double) -40661.5);
-    TEST_VSPRINTF( "%#.1Lg",      "-4.e+04", (long double) -40661.5l);
-    TEST_VSPRINTF( "%#g",         "0.00000", (double) 0.0);
-    TEST_VSPRINTF( "%#Lg",        "0.00000", (long double) 0.0l);
-    TEST_VSPRINTF( "%g",          "0",       (double) 0.0);
-    TEST_VSPRINTF( "%Lg",         "0",       (long double) 0.0l);
-    TEST_VSPRINTF( "%g",          "490000",  (double) 490000.0l);
-    TEST_VSPRINTF( "%Lg",         "490000",  (long double) 490000.0l);
-    TEST_VSPRINTF( "%G",          "4.9E+06", (double) 4900000.0l);
-    TEST_VSPRINTF( "%LG",         "4.9E+06", (long double) 4900000.0l);
-    TEST_VSPRINTF( "%.7G",        "4900000", (double) 4900000.0l);
-    TEST_VSPRINTF( "%.7LG",       "4900000", (long double) 4900000.0l);
+         ++pf;
+      }
 
-//    TEST_VSPRINTF("%+5.10r2E %+10.10r2e %+10.10r7e %+10.10r4e %+10.0r0e %+10.0r0e ", "+1.1111001101E+01 +1.0001101111e-1111111001 +1.6250223006e+1030 +2.3300320211e+32     +8e-01    +2e-308 ",
-//                    (double) 3.9 ARG(7.89456123e-307) ARG(7.89456123e+307) ARG(789456123.0) ARG(0.789456123) ARG(DBL_MIN));
+      if(arg >= Count)
+         return (0);
 
-//    TEST_VSPRINTF("%+5.10r2LE %+10.10r2Le %+10.10r7Le %+10.10r4Le %+10.0r0Le %+10.0r0Le ", "+1.1111001101E+01 +1.0001101111e-1111111001 +1.6250223006e+1030 +2.3300320211e+32     +8e-01    +2e-308 ",
-//                    (long double) 3.9 ARG((long double) 7.89456123e-307) ARG((long double) 7.89456123e+307) ARG((long double) 789456123.0) ARG((long double) 0.789456123) ARG((long double) DBL_MIN));
+      kind = pKinds[arg++];
 
-    return (bRet);
-} /* run_tests() */
+      if(*pf == '{')
+      {
+         for(i = 0; i < sizeof(bytes) / sizeof(bytes[0]); ++i)
+         {
+            if(!strncmp(pf, bytes[i], strlen(bytes[i])))
+               break;
+         }
+
+         if((i >= sizeof(bytes) / sizeof(bytes[0])) || (kind != 'x'))
+            return (0);
+
+         pf += strlen(bytes[i]);
+         continue;
+      }
+
+      if(*pf && strchr("JQq", *pf) && (pf[1] == 's'))
+         ++pf;
+      else if((pf[0] == 'h') && (pf[1] == 'h'))
+         pf += 2;
+      else if((pf[0] == 'l') && (pf[1] == 'l'))
+         pf += 2;
+      else if(*pf && strchr("hlztjL", *pf))
+      {
+         if(pf[1] == 's')
+            return (0); /* wide strings */
+
+         ++pf;
+      }
+
+      if(*pf && strchr("diouxXbBceEfFgGaA", *pf))
+      {
+         if(!strchr("iuf", kind))
+            return (0);
+      }
+      else if(*pf == 's')
+      {
+         if(kind != 's')
+            return (0);
+      }
+      else if((*pf != 'p') || !strchr("sx", kind))
+         return (0); /* %n, %@, %v, %V and unknown conversions */
+
+      ++pf;
+   }
+
+   return (arg == Count);
+} /* int trace_check(const char * pf, const char * pKinds, size_t Count) */
+
+
+/* ------------------------------------------------------------------------- *\
+   trace_parse_record parses a line of a trace file into a record.
+\* ------------------------------------------------------------------------- */
+static int trace_parse_record(char * pLine, TRACE_RECORD * pr)
+{
+   char * pField = pLine;
+   char * pNext;
+   char   kinds[TRACE_MAX_ARGS]; /* type prefixes of the arguments */
+
+   memset(pr, 0, sizeof(*pr));
+
+   pr->pArgs = (PRINTF_ARG *) malloc(TRACE_MAX_ARGS * sizeof(PRINTF_ARG));
+   if(!pr->pArgs)
+      return (0);
+
+   pNext = strchr(pField, '\t');
+   if(pNext)
+      *pNext++ = '\0';
+
+   pr->pFmt = (char *) malloc(strlen(pField) + 1);
+   if(!pr->pFmt)
+      return (0);
+
+   strcpy(pr->pFmt, trace_unescape(pField));
+
+   while(pNext)
+   {
+      PRINTF_ARG * pa = &pr->pArgs[pr->Count];
+
+      pField = pNext;
+      pNext  = strchr(pField, '\t');
+      if(pNext)
+         *pNext++ = '\0';
+
+      if((pr->Count >= TRACE_MAX_ARGS) || !pField[0] || (pField[1] != ':'))
+         return (0);
+
+      if(pField[0] == 'i')
+      {
+         pa->Type = PRINTF_ARG_INT;
+         pa->v.i  = (int64_t) strtoll(pField + 2, NULL, 0);
+      }
+      else if(pField[0] == 'u')
+      {
+         pa->Type = PRINTF_ARG_UINT;
+         pa->v.u  = (uint64_t) strtoull(pField + 2, NULL, 0);
+      }
+      else if(pField[0] == 'f')
+      {
+         pa->Type = PRINTF_ARG_DOUBLE;
+         pa->v.d  = strtod(pField + 2, NULL);
+      }
+      else if(pField[0] == 's')
+      {
+         char * ps = (char *) malloc(strlen(pField + 2) + 1);
+
+         if(!ps)
+            return (0);
+
+         strcpy(ps, trace_unescape(pField + 2));
+         pa->Type = PRINTF_ARG_PTR;
+         pa->v.p  = ps;
+      }
+      else if(pField[0] == 'x')
+      { /* the bytes follow the CBK_BYTES in the same allocation */
+         size_t      len  = strlen(pField + 2) / 2;
+         CBK_BYTES * pb   = (CBK_BYTES *) malloc(sizeof(CBK_BYTES) + len + 1);
+         uint8_t *   pd;
+         size_t      i;
+
+         if(!pb)
+            return (0);
+
+         pd = (uint8_t *) (pb + 1);
+         for(i = 0; i < len; ++i)
+         {
+            char hex[3];
+
+            hex[0] = pField[2 + 2 * i];
+            hex[1] = pField[3 + 2 * i];
+            hex[2] = '\0';
+            pd[i]  = (uint8_t) strtoul(hex, NULL, 16);
+         }
+
+         pb->pData  = pd;
+         pb->Length = len;
+         pa->Type   = PRINTF_ARG_PTR;
+         pa->v.p    = pb;
+      }
+      else
+         return (0);
+
+      kinds[pr->Count++] = pField[0];
+   }
+
+   return (trace_check(pr->pFmt, kinds, pr->Count));
+} /* int trace_parse_record(char * pLine, TRACE_RECORD * pr) */
+
+
+/* trace_free releases a trace */
+static void trace_free(TRACE * pt)
+{
+   size_t i;
+
+   for(i = 0; i < pt->Count; ++i)
+      trace_free_record(&pt->pRecords[i]);
+
+   free(pt->pRecords);
+   memset(pt, 0, sizeof(*pt));
+} /* void trace_free(TRACE * pt) */
+
+
+/* ------------------------------------------------------------------------- *\
+   trace_load reads a trace file.
+\* ------------------------------------------------------------------------- */
+static int trace_load(const char * pName, TRACE * pt)
+{
+   FILE * pf    = fopen(pName, "r");
+   char * pLine = (char *) malloc(TRACE_MAX_LINE);
+   size_t line  = 0;
+   int    bRet  = 0;
+
+   memset(pt, 0, sizeof(*pt));
+
+   if(!pf || !pLine)
+   {
+      fprintf(stderr, "%s: %s\n", pName, strerror(errno));
+      goto Exit;
+   }
+
+   while(fgets(pLine, TRACE_MAX_LINE, pf))
+   {
+      size_t len = strlen(pLine);
+
+      ++line;
+
+      while(len && ((pLine[len - 1] == '\n') || (pLine[len - 1] == '\r')))
+         pLine[--len] = '\0';
+
+      if(!len || (pLine[0] == '#'))
+         continue;
+
+      if(pt->Count == pt->Size)
+      {
+         size_t         size = pt->Size ? 2 * pt->Size : 1024;
+         TRACE_RECORD * pr   = (TRACE_RECORD *) realloc(pt->pRecords, size * sizeof(TRACE_RECORD));
+
+         if(!pr)
+            goto Exit;
+
+         pt->pRecords = pr;
+         pt->Size     = size;
+      }
+
+      if(!trace_parse_record(pLine, &pt->pRecords[pt->Count]))
+      {
+         fprintf(stderr, "%s:%zu: invalid record\n", pName, line);
+         trace_free_record(&pt->pRecords[pt->Count]);
+         goto Exit;
+      }
+
+      if(trace_chunks(&pt->pRecords[pt->Count]))
+         ++pt->Libc;
+
+      ++pt->Count;
+   }
+
+   bRet = 1;
+
+   Exit:;
+   if(!bRet)
+      trace_free(pt);
+
+   if(pf)
+      fclose(pf);
+
+   free(pLine);
+   return (bRet);
+} /* int trace_load(const char * pName, TRACE * pt) */
+
+
+/* ------------------------------------------------------------------------- *\
+   TRACE_SINK is the bounded memory sink of the replay by callback_printfa
+\* ------------------------------------------------------------------------- */
+typedef struct TRACE_SINK_S TRACE_SINK;
+struct TRACE_SINK_S
+{
+   char * pDst; /* current write position */
+   size_t Left; /* remaining space */
+};
+
+static void trace_write(void * pUserData, const char * pSrc, size_t Length)
+{
+   TRACE_SINK * pts = (TRACE_SINK *) pUserData;
+
+   if(Length > pts->Left)
+      Length = pts->Left;
+
+   memcpy(pts->pDst, pSrc, Length);
+   pts->pDst += Length;
+   pts->Left -= Length;
+} /* void trace_write(void * pUserData, const char * pSrc, size_t Length) */
+
+/* trace_callback_printf prints a record by callback_printfa */
+static size_t trace_callback_printf(char * pDst, const TRACE_RECORD * pr)
+{
+   TRACE_SINK ts;
+   size_t     len;
+
+   ts.pDst = pDst;
+   ts.Left = TRACE_MAX_OUT - 1;
+   len     = callback_printfa(&ts, &trace_write, pr->pFmt, pr->pArgs, pr->Count);
+   *ts.pDst = '\0';
+
+   return (len);
+} /* size_t trace_callback_printf(char * pDst, const TRACE_RECORD * pr) */
+
+/* trace_snprintf prints a record by a snprintf call per chunk */
+static size_t trace_snprintf(char * pDst, const TRACE_RECORD * pr)
+{
+   size_t len = 0;
+   size_t i;
+
+   for(i = 0; i < pr->Chunks; ++i)
+   {
+      const TRACE_CHUNK * pc   = &pr->pChunks[i];
+      size_t              pos  = (len < TRACE_MAX_OUT) ? len : TRACE_MAX_OUT;
+      char *              pd   = pDst + pos;
+      size_t              left = TRACE_MAX_OUT - pos;
+      int                 n    = 0;
+
+      switch(pc->Class * 3 + pc->Stars)
+      {
+         case 0:
+            n = snprintf(pd, left, pc->pFmt, 0); /* text only, the argument is unused */
+            break;
+
+         case TRACE_INT * 3:      n = snprintf(pd, left, pc->pFmt, pc->v.ll); break;
+         case TRACE_INT * 3 + 1:  n = snprintf(pd, left, pc->pFmt, pc->Star[0], pc->v.ll); break;
+         case TRACE_INT * 3 + 2:  n = snprintf(pd, left, pc->pFmt, pc->Star[0], pc->Star[1], pc->v.ll); break;
+         case TRACE_CHAR * 3:     n = snprintf(pd, left, pc->pFmt, (int) pc->v.ll); break;
+         case TRACE_CHAR * 3 + 1: n = snprintf(pd, left, pc->pFmt, pc->Star[0], (int) pc->v.ll); break;
+         case TRACE_CHAR * 3 + 2: n = snprintf(pd, left, pc->pFmt, pc->Star[0], pc->Star[1], (int) pc->v.ll); break;
+         case TRACE_DBL * 3:      n = snprintf(pd, left, pc->pFmt, pc->v.d); break;
+         case TRACE_DBL * 3 + 1:  n = snprintf(pd, left, pc->pFmt, pc->Star[0], pc->v.d); break;
+         case TRACE_DBL * 3 + 2:  n = snprintf(pd, left, pc->pFmt, pc->Star[0], pc->Star[1], pc->v.d); break;
+         case TRACE_PTR * 3:      n = snprintf(pd, left, pc->pFmt, pc->v.p); break;
+         case TRACE_PTR * 3 + 1:  n = snprintf(pd, left, pc->pFmt, pc->Star[0], pc->v.p); break;
+         default:                 n = snprintf(pd, left, pc->pFmt, pc->Star[0], pc->Star[1], pc->v.p); break;
+      }
+
+      if(n > 0)
+         len += (size_t) n;
+   }
+
+   return (len);
+} /* size_t trace_snprintf(char * pDst, const TRACE_RECORD * pr) */
+
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_trace replays a trace by callback_printfa and by snprintf and
+   prints the records and bytes per second. Different outputs are counted
+   and the first one is printed but don't fail. snprintf can't take the
+   arguments of a record at once without a va_list, so it gets called for
+   every conversion. Records that use extensions of callback_printf are
+   replayed by callback_printfa only.
+\* ------------------------------------------------------------------------- */
+int bench_trace(const char * pName)
+{
+   static const char * engine[3] = { "callback_printfa", "callback_printfa", "snprintf" };
+   static const char * subset[3] = { "all", "libc", "libc" };
+   TRACE               trace;
+   char                out[TRACE_MAX_OUT];
+   char                ref[TRACE_MAX_OUT];
+   double              samples[BENCH_MAX_SAMPLES];
+   size_t              mismatch = 0;
+   size_t              i;
+   int                 e;
+
+   if(!pName)
+   {
+      fprintf(stderr, "--trace expects the name of a trace file\n");
+      return (0);
+   }
+
+   if(!trace_load(pName, &trace))
+      return (0);
+
+   cbk_formats_register(); /* for %{name} of the trace, EEXIST doesn't matter */
+
+   for(i = 0; i < trace.Count; ++i)
+   { /* both replays have to print the same */
+      const TRACE_RECORD * pr = &trace.pRecords[i];
+
+      if(pr->pChunks)
+      {
+         trace_callback_printf(out, pr);
+         trace_snprintf(ref, pr);
+
+         if(strcmp(out, ref) && !mismatch++)
+            printf("first different output of record %zu \"%s\": \"%s\" and \"%s\"\n", i + 1, pr->pFmt, out, ref);
+      }
+   }
+
+   printf("%zu records of %s, %zu with a libc equivalent, %zu different outputs\n", trace.Count, pName, trace.Libc, mismatch);
+   printf("engine           records   median ms/pass  Mrecords/s      MB/s\n");
+
+   for(e = 0; e < 3; ++e)
+   {
+      BENCH_STATS st;
+      size_t      records = 0;
+      size_t      bytes   = 0;
+      size_t      s;
+
+      for(s = 0; s < bench_options.Samples; ++s)
+      {
+         int64_t ts, te;
+
+         records = 0;
+         bytes   = 0;
+         ts      = bench_clock();
+         for(i = 0; i < trace.Count; ++i)
+         {
+            const TRACE_RECORD * pr = &trace.pRecords[i];
+
+            if(e && !pr->pChunks)
+               continue;
+
+            bytes += (e < 2) ? trace_callback_printf(out, pr) : trace_snprintf(out, pr);
+            ++records;
+         }
+         te      = bench_clock();
+
+         samples[s] = (double) (te - ts);
+      }
+
+      bench_stats(samples, bench_options.Samples, &st);
+
+      printf("%-16s %-4s %7zu %11.3f %11.2f %9.1f\n", engine[e], subset[e], records, st.Median / 1e6,
+             (double) records * 1e3 / st.Median, (double) bytes * 1e3 / st.Median);
+   }
+
+   printf("\n");
+   trace_free(&trace);
+   return (1);
+} /* int bench_trace(const char * pName) */
+
+
+/* ------------------------------------------------------------------------- *\
+   bench_trace_gen writes a synthetic trace of log lines, CSV rows, JSON
+   numbers and hex dumps.
+\* ------------------------------------------------------------------------- */
+static uint32_t trace_random(uint32_t * pSeed)
+{
+   *pSeed = *pSeed * 1103515245u + 12345u;
+   return (*pSeed >> 8);
+} /* uint32_t trace_random(uint32_t * pSeed) */
+
+int bench_trace_gen(const char * pName)
+{
+   static const char * level[4]  = { "info", "debug", "warn", "error" };
+   static const char * msg[4]    = { "request done", "cache miss for \"user\"", "slow query\ttook long", "connection reset by peer" };
+   static const char * item[4]   = { "apple", "banana split", "cherry", "\"dates\"" };
+   uint32_t            seed      = 4711;
+   size_t              records   = 10000;
+   FILE *              pf;
+   size_t              r;
+
+   if(!pName)
+   {
+      fprintf(stderr, "--trace-gen expects the name of the trace file\n");
+      return (0);
+   }
+
+   pf = fopen(pName, "w");
+   if(!pf)
+   {
+      fprintf(stderr, "%s: %s\n", pName, strerror(errno));
+      return (0);
+   }
+
+   fprintf(pf, "# synthetic trace of vsprintf_bench: 50%% log lines, 20%% CSV rows, 20%% JSON numbers, 10%% hex dumps\n");
+
+   for(r = 0; r < records; ++r)
+   {
+      uint32_t kind = trace_random(&seed) % 20;
+
+      if(kind < 10)
+      {
+         trace_put_escaped(pf, "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ %-5s [%s] %s id=%u latency=%.3fms\n");
+         fprintf(pf, "\ti:2026\ti:10\ti:19\ti:%u\ti:%u\ti:%u\ti:%u\ts:%s\ts:worker-%u\ts:",
+                 trace_random(&seed) % 24, trace_random(&seed) % 60, trace_random(&seed) % 60, trace_random(&seed) % 1000,
+                 level[trace_random(&seed) % 4], trace_random(&seed) % 16);
+         trace_put_escaped(pf, msg[trace_random(&seed) % 4]);
+         fprintf(pf, "\tu:%u\tf:%.6f\n", trace_random(&seed), trace_random(&seed) % 100000 / 1000.0);
+      }
+      else if(kind < 14)
+      {
+         trace_put_escaped(pf, "%d,%s,%.2f,%u,%s\n");
+         fprintf(pf, "\ti:%u\ts:", trace_random(&seed) % 100000);
+         trace_put_escaped(pf, item[trace_random(&seed) % 4]);
+         fprintf(pf, "\tf:%.4f\tu:%u\ts:%s\n", trace_random(&seed) % 100000 / 100.0, trace_random(&seed) % 1000, (kind & 1) ? "shipped" : "open");
+      }
+      else if(kind < 18)
+      {
+         trace_put_escaped(pf, "{\"id\":%llu,\"x\":%.17g,\"y\":%g,\"n\":%d}\n");
+         fprintf(pf, "\tu:%llu\tf:%.17g\tf:%.17g\ti:%d\n", (unsigned long long) trace_random(&seed) << 24 | trace_random(&seed),
+                 (double) trace_random(&seed) / 7.0, (double) trace_random(&seed) * 1e-9, (int) (trace_random(&seed) % 2001) - 1000);
+      }
+      else if(kind < 19)
+      {
+         char    ascii[17];
+         uint8_t data[16];
+         int     i;
+
+         trace_put_escaped(pf, "%08x  %02x %02x %02x %02x %02x %02x %02x %02x  %02x %02x %02x %02x %02x %02x %02x %02x  |%s|\n");
+         fprintf(pf, "\tu:%u", (unsigned int) r * 16);
+
+         for(i = 0; i < 16; ++i)
+         {
+            data[i]  = (uint8_t) trace_random(&seed);
+            ascii[i] = ((data[i] >= 0x20) && (data[i] < 0x7f)) ? (char) data[i] : '.';
+            fprintf(pf, "\tu:%u", data[i]);
+         }
+
+         ascii[16] = '\0';
+         fputs("\ts:", pf);
+         trace_put_escaped(pf, ascii);
+         fputs("\n", pf);
+      }
+      else
+      { /* a payload by %{hex} that only callback_printf can replay */
+         int i;
+
+         trace_put_escaped(pf, "payload %{hex}\n");
+         fputs("\tx:", pf);
+
+         for(i = 0; i < 32; ++i)
+            fprintf(pf, "%02x", trace_random(&seed) & 0xff);
+
+         fputs("\n", pf);
+      }
+   }
+
+   fclose(pf);
+   printf("%zu records written to %s\n", records, pName);
+   return (1);
+} /* int bench_trace_gen(const char * pName) */
 
 
 /* ------------------------------------------------------------------------- *\
@@ -565,14 +2980,167 @@ int run_tests()
 \* ------------------------------------------------------------------------- */
 int main(int argc, char * argv[])
 {
-    int iRet = 1;
+    int          iRet     = 1;
+    const char * pMode    = NULL; /* benchmark selected by the first argument that isn't an option of the harness */
+    const char * pModeArg = NULL; /* argument of the benchmark */
+    int          i;
+
+    for(i = 1; i < argc; ++i)
+    {
+        if(!strcmp(argv[i], "--filter") && (i + 1 < argc))
+            bench_options.pFilter = argv[++i];
+        else if(!strcmp(argv[i], "--repeat") && (i + 1 < argc))
+            bench_options.Samples = (size_t) strtoul(argv[++i], NULL, 10);
+        else if(!strcmp(argv[i], "--batch") && (i + 1 < argc))
+            bench_options.Batch = (size_t) strtoul(argv[++i], NULL, 10);
+        else if(!strcmp(argv[i], "--warmup") && (i + 1 < argc))
+            bench_options.Warmup = (size_t) strtoul(argv[++i], NULL, 10);
+        else if(!strcmp(argv[i], "--cpu") && (i + 1 < argc))
+            bench_options.Cpu = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--json"))
+            bench_options.Output = BENCH_OUT_JSON;
+        else if(!strcmp(argv[i], "--csv"))
+            bench_options.Output = BENCH_OUT_CSV;
+        else if(!strcmp(argv[i], "--perf"))
+            bench_options.Perf = 1;
+        else if(!strcmp(argv[i], "--max-threads") && (i + 1 < argc))
+            bench_options.Threads = atol(argv[++i]);
+        else if(!strcmp(argv[i], "--baseline") && (i + 1 < argc))
+            bench_baseline.pName = argv[++i];
+        else if(!strcmp(argv[i], "--write-baseline") && (i + 1 < argc))
+            bench_baseline.pOutName = argv[++i];
+        else if(!strcmp(argv[i], "--tolerance") && (i + 1 < argc))
+            bench_baseline.Tolerance = strtod(argv[++i], NULL);
+        else if(!pMode)
+            pMode = argv[i];
+        else if(!pModeArg)
+            pModeArg = argv[i];
+        else
+        {
+            fprintf(stderr, "unknown argument %s\n", argv[i]);
+            goto Exit;
+        }
+    }
+
+    if(!bench_options.Samples || (bench_options.Samples > BENCH_MAX_SAMPLES) || !bench_options.Batch)
+    {
+        fprintf(stderr, "--repeat expects 1 to %d samples and --batch at least one call\n", BENCH_MAX_SAMPLES);
+        goto Exit;
+    }
+
+    if((bench_options.Cpu >= 0) && !bench_pin_cpu(bench_options.Cpu))
+        fprintf(stderr, "binding to CPU %d failed\n", bench_options.Cpu);
+
+    if(bench_options.Perf)
+        bench_perf_open();
+
+    if(bench_baseline.pName && !bench_baseline_load(bench_baseline.pName))
+        goto Exit;
+
+    if(bench_baseline.pOutName && !(bench_baseline.pfOut = fopen(bench_baseline.pOutName, "w")))
+    {
+        fprintf(stderr, "%s: %s\n", bench_baseline.pOutName, strerror(errno));
+        goto Exit;
+    }
+
+#if !defined (_WIN32) && !defined (__CYGWIN__)
+    if(pMode && !strcmp(pMode, "--sfdprintf"))
+    {
+        iRet = bench_sfdprintf() ? 0 : 1;
+        goto Exit;
+    }
+
+    if(pMode && !strcmp(pMode, "--formats"))
+    {
+        iRet = bench_formats() ? 0 : 1;
+        goto Exit;
+    }
+
+    if(pMode && !strcmp(pMode, "--timestamps"))
+    {
+        iRet = bench_timestamps() ? 0 : 1;
+        goto Exit;
+    }
+
+    if(pMode && !strcmp(pMode, "--binary"))
+    {
+        iRet = bench_binary() ? 0 : 1;
+        goto Exit;
+    }
+
+    if(pMode && !strcmp(pMode, "--escape"))
+    {
+        iRet = bench_escape() ? 0 : 1;
+        goto Exit;
+    }
+
+    if(pMode && !strcmp(pMode, "--record"))
+    {
+        iRet = bench_record() ? 0 : 1;
+        goto Exit;
+    }
+
+    if(pMode && !strcmp(pMode, "--nested"))
+    {
+        iRet = bench_nested() ? 0 : 1;
+        goto Exit;
+    }
+
+    if(pMode && !strcmp(pMode, "--threads"))
+    {
+        iRet = bench_threads() ? 0 : 1;
+        goto Exit;
+    }
+#endif
+
+    if(pMode && !strcmp(pMode, "--trace"))
+    {
+        iRet = bench_trace(pModeArg) ? 0 : 1;
+        goto Exit;
+    }
+
+    if(pMode && !strcmp(pMode, "--trace-gen"))
+    {
+        iRet = bench_trace_gen(pModeArg) ? 0 : 1;
+        goto Exit;
+    }
+
+    if(pMode && !strcmp(pMode, "--fragments"))
+    {
+        bench_fragments("%d", 123456);
+        bench_fragments("%+08d|%-6x|%#o", -42, 0xbeefu, 8u);
+        bench_fragments("%s=%d, %s=%d, %s=%d", "a", 1, "bb", 22, "ccc", 333);
+        bench_fragments("%04d-%02d-%02d %02d:%02d:%02d [%5s] %s", 2026, 10, 19, 12, 0, 59, "info", "request done");
+        bench_fragments("%8.3f %-12.4e %g", 3.14159, -2.5e-10, 1e100);
+        bench_fragments("[%-40s] [%40s]", "left", "right");
+        bench_fragments("%100d", 42);
+        bench_fragments("%.20c|%5c", '-', 'x');
+        bench_fragments("%ls", L"wide characters");
+        bench_fragments("%Js", "a \"quoted\" \\ value\n");
+        iRet = 0;
+        goto Exit;
+    }
+
+    if(pMode && !strcmp(pMode, "--vectored"))
+    {
+        bench_vectored("%d", 123456);
+        bench_vectored("%+08d|%-6x|%#o", -42, 0xbeefu, 8u);
+        bench_vectored("%s=%d, %s=%d, %s=%d", "a", 1, "bb", 22, "ccc", 333);
+        bench_vectored("%04d-%02d-%02d %02d:%02d:%02d [%5s] %s", 2026, 10, 19, 12, 0, 59, "info", "request done");
+        bench_vectored("%8.3f %-12.4e %g", 3.14159, -2.5e-10, 1e100);
+        bench_vectored("Hello %s!", "world");
+        iRet = 0;
+        goto Exit;
+    }
 
-    if(!run_tests())
+    if(!run_tests() && !bench_baseline.pName && !bench_baseline.pOutName)
         goto Exit;
 
     iRet = 0;
 
     Exit:;
+    if(!bench_baseline_report())
+        iRet = 1;
 
 #if 0
     if(!iRet)
@@ -0,0 +1,328 @@
+/*****************************************************************************\
+*                                                                             *
+*  FILE NAME:     vsprintf_bench_cpp.cpp                                      *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  DESCRIPTION:   benchmark of the C++ front end callback_printf.hpp          *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  COPYRIGHT:     (c) 2026 Dipl.-Ing. Klaus Lux (Aachen, Germany)             *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+*  ORIGIN:        https://github.com/klux21/callback_printf                   *
+*                                                                             *
+* --------------------------------------------------------------------------- *
+*                                                                             *
+* Civil Usage Public License, Version 1.2, June 2026                          *
+*                                                                             *
+* Redistribution and use in source and binary forms, with or without          *
+* modification, are permitted provided that the following conditions are met: *
+*                                                                             *
+* 1. Redistributions of source code must retain the above copyright           *
+*    notice, this list of conditions, the explanation of terms                *
+*    and the following disclaimer.                                            *
+*                                                                             *
+* 2. Redistributions in binary form must reproduce the above copyright        *
+*    notice, this list of conditions and the following disclaimer in the      *
+*    documentation or other materials provided with the distribution.         *
+*                                                                             *
+* 3. All modified files must carry prominent notices stating that the         *
+*    files have been changed.                                                 *
+*                                                                             *
+* 4. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are designed or           *
+*    intended to harm, to kill or to forcibly immobilize people.              *
+*                                                                             *
+* 5. The source code and binary forms and any derivative works are not        *
+*    stored or executed in systems or devices which are intended to           *
+*    monitor, to track, to change or to control the behavior, the             *
+*    constitution, the location or the communication of any people or         *
+*    their property without the explicit and prior agreement of those         *
+*    people except those devices and systems are solely designed for          *
+*    saving or protecting peoples life or health.                             *
+*                                                                             *
+* 6. The source code and binary forms and any derivative works are not        *
+*    stored or executed in any systems or devices that are intended           *
+*    for the production of any of the systems or devices that                 *
+*    have been stated before except the ones for saving or protecting         *
+*    peoples life or health only.                                             *
+*                                                                             *
+* The term 'systems' in all clauses shall include all types and combinations  *
+* of physical, virtualized or simulated hardware and software and any kind    *
+* of data storage.                                                            *
+*                                                                             *
+* The term 'devices' shall include any kind of local or non-local control     *
+* system of the stated devices as part of that device as well. Any assembly   *
+* of more than one device is one and the same device regarding this license.  *
+*                                                                             *
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" *
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE   *
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE  *
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE   *
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR         *
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF        *
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    *
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN     *
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)     *
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE  *
+* POSSIBILITY OF SUCH DAMAGE.                                                 *
+*                                                                             *
+\*****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+
+#if defined(__has_include)
+#if __has_include(<format>)
+#include <format>
+#endif
+#if (__cplusplus >= 201703L) && __has_include(<charconv>)
+#include <charconv>
+#define BENCH_HAVE_TO_CHARS
+#endif
+#endif
+
+#include <callback_printf.h>
+#include <callback_printf.hpp>
+
+/* ------------------------------------------------------------------------- *\
+   now_ns returns a monotonic time stamp in nanoseconds
+\* ------------------------------------------------------------------------- */
+static int64_t now_ns()
+{
+   return (std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+} /* int64_t now_ns() */
+
+
+/* ------------------------------------------------------------------------- *\
+   result prints the time of a variant and checks its output
+\* ------------------------------------------------------------------------- */
+static int result(const char * name, int64_t tm, size_t loops, const char * pout, const char * pres)
+{
+   int failed = strcmp(pout, pres) != 0;
+   printf("%14s: %8.1fns %s \"%s\"\n", name, (double) tm / (double) loops, failed ? "!NOK!" : "  OK ", pres);
+   return (!failed);
+} /* int result(...) */
+
+
+/* ------------------------------------------------------------------------- *\
+   BENCH runs a format with ssprintf, std::snprintf, cbp::snprintf, the
+   compile time parsed cbp::fmt<> and std::format if the library provides
+   it. stdfmt is the std::format version of the format string.
+\* ------------------------------------------------------------------------- */
+#define BENCH_LOOPS 200000
+
+#if defined(__cpp_lib_format)
+#define BENCH_STD_FORMAT(pout, stdfmt, ...)                                      \
+   {                                                                            \
+      char *  pe;                                                               \
+      count = BENCH_LOOPS;                                                      \
+      ts = now_ns();                                                            \
+      while(count--)                                                            \
+      {                                                                         \
+         pe = std::format_to(buf, stdfmt, __VA_ARGS__);                         \
+         *pe = '\0';                                                            \
+      }                                                                         \
+      bRet &= result("std::format_to", now_ns() - ts, BENCH_LOOPS, pout, buf);  \
+   }
+#else
+#define BENCH_STD_FORMAT(pout, stdfmt, ...)
+#endif
+
+#if (__cplusplus >= 202002L)
+#define BENCH_CBP_FMT(pout, cfmt, ...)                                          \
+   {                                                                            \
+      count = BENCH_LOOPS;                                                      \
+      ts = now_ns();                                                            \
+      while(count--)                                                            \
+         cbp::snprintf(buf, sizeof(buf), cbp::fmt<cfmt>, __VA_ARGS__);          \
+      bRet &= result("cbp::fmt<>", now_ns() - ts, BENCH_LOOPS, pout, buf);      \
+   }
+#else
+#define BENCH_CBP_FMT(pout, cfmt, ...)
+#endif
+
+#define BENCH_VARIANTS(pout, fmt, stdfmt, ...)                                  \
+   count = BENCH_LOOPS;                                                         \
+   ts = now_ns();                                                               \
+   while(count--)                                                               \
+      ssnprintf(buf, sizeof(buf), fmt, __VA_ARGS__);                            \
+   bRet &= result("ssnprintf", now_ns() - ts, BENCH_LOOPS, pout, buf);          \
+   count = BENCH_LOOPS;                                                         \
+   ts = now_ns();                                                               \
+   while(count--)                                                               \
+      snprintf(buf, sizeof(buf), fmt, __VA_ARGS__);                             \
+   bRet &= result("std::snprintf", now_ns() - ts, BENCH_LOOPS, pout, buf);      \
+   count = BENCH_LOOPS;                                                         \
+   ts = now_ns();                                                               \
+   while(count--)                                                               \
+      cbp::snprintf(buf, sizeof(buf), fmt, __VA_ARGS__);                        \
+   bRet &= result("cbp::snprintf", now_ns() - ts, BENCH_LOOPS, pout, buf);      \
+   BENCH_CBP_FMT(pout, fmt, __VA_ARGS__)                                        \
+   BENCH_STD_FORMAT(pout, stdfmt, __VA_ARGS__)
+
+#define BENCH(pout, fmt, stdfmt, ...)                                           \
+   {                                                                            \
+      size_t  count;                                                            \
+      int64_t ts;                                                               \
+      printf("Call : %s\n", fmt);                                               \
+      BENCH_VARIANTS(pout, fmt, stdfmt, __VA_ARGS__)                            \
+      printf("\n");                                                             \
+   }
+
+
+/* ------------------------------------------------------------------------- *\
+   BENCH_INT and BENCH_FLOAT compare the conversion of a single number with
+   std::to_chars in addition to the variants of BENCH. tcargs are the
+   arguments of std::to_chars after the output range in parentheses with v
+   in place of the value, e.g. (v, 16) or (v, std::chars_format::fixed, 3),
+   so that every variant prints the same value with the same precision. v is
+   read from a volatile copy to keep the compiler from converting the
+   constant at compile time. The floating point overloads of std::to_chars
+   are used only if the library announces them by __cpp_lib_to_chars.
+\* ------------------------------------------------------------------------- */
+#define BENCH_UNPAREN(...) __VA_ARGS__
+
+#if defined(BENCH_HAVE_TO_CHARS)
+#define BENCH_TO_CHARS(pout, value, tcargs)                                     \
+   {                                                                            \
+      std::to_chars_result     tc;                                              \
+      volatile decltype(value) vv = value;                                      \
+      count = BENCH_LOOPS;                                                      \
+      ts = now_ns();                                                            \
+      while(count--)                                                            \
+      {                                                                         \
+         decltype(value) v = vv;                                                \
+         tc = std::to_chars(buf, buf + sizeof(buf) - 1, BENCH_UNPAREN tcargs);  \
+         *tc.ptr = '\0';                                                        \
+      }                                                                         \
+      bRet &= result("std::to_chars", now_ns() - ts, BENCH_LOOPS, pout, buf);   \
+   }
+#else
+#define BENCH_TO_CHARS(pout, value, tcargs)
+#endif
+
+#if defined(__cpp_lib_to_chars)
+#define BENCH_TO_CHARS_FLOAT(pout, value, tcargs) BENCH_TO_CHARS(pout, value, tcargs)
+#else
+#define BENCH_TO_CHARS_FLOAT(pout, value, tcargs)
+#endif
+
+#define BENCH_INT(pout, fmt, stdfmt, value, tcargs)                             \
+   {                                                                            \
+      size_t  count;                                                            \
+      int64_t ts;                                                               \
+      printf("Call : %s\n", fmt);                                               \
+      BENCH_VARIANTS(pout, fmt, stdfmt, value)                                  \
+      BENCH_TO_CHARS(pout, value, tcargs)                                       \
+      printf("\n");                                                             \
+   }
+
+#define BENCH_FLOAT(pout, fmt, stdfmt, value, tcargs)                           \
+   {                                                                            \
+      size_t  count;                                                            \
+      int64_t ts;                                                               \
+      printf("Call : %s\n", fmt);                                               \
+      BENCH_VARIANTS(pout, fmt, stdfmt, value)                                  \
+      BENCH_TO_CHARS_FLOAT(pout, value, tcargs)                                 \
+      printf("\n");                                                             \
+   }
+
+
+/* ------------------------------------------------------------------------- *\
+   BENCH_APPEND appends the output to a std::string by formatting into a
+   stack buffer and copying it, by cbp::format_append with a size_hint and by
+   cbp::format_append of a compile time parsed format. The string is cleared
+   but keeps its memory like a reused line buffer.
+\* ------------------------------------------------------------------------- */
+#if (__cplusplus >= 202002L)
+#define BENCH_APPEND_FMT(pout, cfmt, ...)                                       \
+   {                                                                            \
+      count = BENCH_LOOPS;                                                      \
+      ts = now_ns();                                                            \
+      while(count--)                                                            \
+      {                                                                         \
+         line.clear();                                                          \
+         cbp::format_append(line, cbp::fmt<cfmt>, __VA_ARGS__);                 \
+      }                                                                         \
+      bRet &= result("append fmt<>", now_ns() - ts, BENCH_LOOPS, pout, line.c_str()); \
+   }
+#else
+#define BENCH_APPEND_FMT(pout, cfmt, ...)
+#endif
+
+#define BENCH_APPEND(pout, fmt, ...)                                            \
+   {                                                                            \
+      size_t                count;                                              \
+      int64_t               ts;                                                 \
+      std::string           line;                                               \
+      static cbp::size_hint hint;                                               \
+      printf("Append : %s\n", fmt);                                             \
+      count = BENCH_LOOPS;                                                      \
+      ts = now_ns();                                                            \
+      while(count--)                                                            \
+      {                                                                         \
+         char   tmp[32];                                                        \
+         size_t n = ssnprintf(tmp, sizeof(tmp), fmt, __VA_ARGS__);              \
+         line.clear();                                                          \
+         if(n < sizeof(tmp))                                                    \
+            line.append(tmp, n);                                                \
+         else                                                                   \
+         { /* truncated, retry with the required size */                        \
+            line.resize(n);                                                     \
+            ssnprintf(&line[0], n + 1, fmt, __VA_ARGS__);                       \
+         }                                                                      \
+      }                                                                         \
+      bRet &= result("ssnprintf+copy", now_ns() - ts, BENCH_LOOPS, pout, line.c_str()); \
+      count = BENCH_LOOPS;                                                      \
+      ts = now_ns();                                                            \
+      while(count--)                                                            \
+      {                                                                         \
+         line.clear();                                                          \
+         cbp::format_append(line, hint, fmt, __VA_ARGS__);                      \
+      }                                                                         \
+      bRet &= result("format_append", now_ns() - ts, BENCH_LOOPS, pout, line.c_str()); \
+      BENCH_APPEND_FMT(pout, fmt, __VA_ARGS__)                                  \
+      printf("\n");                                                             \
+   }
+
+
+/* ------------------------------------------------------------------------- *\
+   main function
+\* ------------------------------------------------------------------------- */
+int main()
+{
+   int  bRet = 1;
+   char buf[1024];
+
+   BENCH("123456", "%d", "{}", 123456);
+   BENCH("-0000042|beef  |010", "%+08d|%-6x|%#o", "{:+08}|{:<6x}|{:#o}", -42, 0xbeefu, 8u);
+   BENCH("a=1, bb=22, ccc=333", "%s=%d, %s=%d, %s=%d", "{}={}, {}={}, {}={}", "a", 1, "bb", 22, "ccc", 333);
+   BENCH("2026-10-19 12:00:59 [ info] request done", "%04d-%02d-%02d %02d:%02d:%02d [%5s] %s", "{:04}-{:02}-{:02} {:02}:{:02}:{:02} [{:>5}] {}", 2026, 10, 19, 12, 0, 59, "info", "request done");
+   BENCH("   3.142 -2.5000e-10 ", "%8.3f %-12.4e", "{:8.3f} {:<12.4e}", 3.14159, -2.5e-10);
+   BENCH("Hello world!", "Hello %s!", "Hello {}!", "world");
+
+   BENCH_INT("123456", "%d", "{}", 123456, (v));
+   BENCH_INT("-2147483648", "%d", "{}", (int) -2147483647 - 1, (v));
+   BENCH_INT("18446744073709551615", "%llu", "{}", 18446744073709551615ull, (v));
+   BENCH_INT("deadbeef", "%x", "{:x}", 0xdeadbeefu, (v, 16));
+   BENCH_FLOAT("3.142", "%.3f", "{:.3f}", 3.14159, (v, std::chars_format::fixed, 3));
+   BENCH_FLOAT("-2.500000e-10", "%.6e", "{:.6e}", -2.5e-10, (v, std::chars_format::scientific, 6));
+   BENCH_FLOAT("2.71828182846", "%.12g", "{:.12g}", 2.718281828459045, (v, std::chars_format::general, 12));
+   BENCH_FLOAT("1234567.890625", "%.6f", "{:.6f}", 1234567.890625, (v, std::chars_format::fixed, 6));
+
+   BENCH_APPEND("2026-10-19 12:00:59 [ info] request done", "%04d-%02d-%02d %02d:%02d:%02d [%5s] %s", 2026, 10, 19, 12, 0, 59, "info", "request done");
+   BENCH_APPEND("GET /index.html 200 1234567 0.0031", "%s %s %d %zu %.4f", "GET", "/index.html", 200, (size_t) 1234567, 0.0031);
+
+   return (bRet ? 0 : 1);
+} /* int main() */
+
+
+/* ========================================================================= *\
+   END OF FILE
+\* ========================================================================= */